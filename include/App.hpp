@@ -25,6 +25,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <array>
+#include <fstream>
+#include <atomic>
 
 #include <SDL.h>
 #include <SDL_video.h>
@@ -36,10 +40,30 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "EventListener.hpp"
 #include "Settings.hpp"
 #include "Logger.hpp"
+#include "Profiler.hpp"
+#include "ResourceRegistry.hpp"
 #include "video/Surface.hpp"
+#include "video/DirtyRects.hpp"
+#include "video/BoardLayer.hpp"
+#include "video/Atlas.hpp"
+#include "video/TextRenderer.hpp"
+#include "video/AssetLoader.hpp"
+#include "video/TextureCache.hpp"
+#include "video/FrameScheduler.hpp"
+#include "video/RenderCommandList.hpp"
+#include "video/RenderThread.hpp"
+#include "video/Scene.hpp"
+#include "video/CursorOverlay.hpp"
+#include "video/Timeline.hpp"
+#include "video/ScreenLayout.hpp"
 #include "Grid.hpp"
+#include "GameLog.hpp"
+#include "GameRecord.hpp"
+#include "Tablebase.hpp"
+#include "players/Evaluation.hpp"
 #include "players/Joystick.hpp"
 #include "players/Player.hpp"
+#include "players/ScriptedInput.hpp"
 #include "video/Button.hpp"
 #include "video/Animation.hpp"
 #include "audio/Sample.hpp"
@@ -51,12 +75,18 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 class App : public EventListener    // Receive events in this class
 {
 public:
-    enum EState {STATE_START, STATE_SETTINGS, STATE_INGAME, STATE_PROMPT, STATE_END};    /**< Application states for the state machine */
+    enum EState {STATE_START, STATE_SETTINGS, STATE_LOADING, STATE_INGAME, STATE_PROMPT, STATE_END};    /**< Application states for the state machine */
 
 
     friend int32_t SDLCALL RunAI(void* pData);
 
 
+    typedef ResourceRegistry<Surface>::Handle SurfaceHandle;
+    typedef ResourceRegistry<Animation>::Handle AnimationHandle;
+    typedef ResourceRegistry<Button>::Handle ButtonHandle;
+    typedef ResourceRegistry<Sample>::Handle SampleHandle;
+
+
     static App& GetInstance();
 
     bool GetStopThreads() const noexcept;
@@ -73,7 +103,43 @@ public:
      */
     void OnExecute();
 
+    /**
+     * @brief Draws every screen for a number of frames as fast as possible and prints their frame times,
+     * instead of running the application. The clock advances one frame period per frame, so the same
+     * build always draws the same frames
+     *
+     * @param uiFrames the frames drawn of every screen
+     * @param CsScriptPath the path of a script of input events, see ScriptedInput, empty for none
+     * @param CsChecksumPath the path of a file that receives the checksum of every frame, empty for none
+     */
+    void OnBenchmark(uint32_t uiFrames, const std::string& CsScriptPath, const std::string& CsChecksumPath);
+
 private:
+    /**
+     * @brief One thing drawn on a menu screen, with its resources resolved once, see App_Scene.cpp
+     */
+    struct SceneItem
+    {
+        uint8_t uyItem;                 /**< The kind of item */
+        Scene::ELayer eLayer;
+        SurfaceHandle handleSurface;
+        ButtonHandle handleButton;
+        Atlas::Sprite sprite;           /**< The sprite, or the look of a button */
+        Atlas::Sprite spriteHover;      /**< The look of a button under the cursor */
+        bool bHasHover;                 /**< Whether a button has a second look */
+        int16_t rX, rY;
+    };
+
+    /**
+     * @brief Where a button goes on the preferred display, kept to place it again when the display changes
+     */
+    struct ButtonPlacement
+    {
+        int16_t rLeft, rTop, rRight, rBottom;
+        ScreenLayout::EAnchor eAnchor;  /**< The point of the display the button keeps its distance to */
+    };
+
+
     bool _bRunning;             /**< Marks whether the application should continue running */
     EState _eStateCurrent;      /**< The current state of the application for the state machine */
     Settings _settingsGlobal;   /**< The global settings of the application */
@@ -82,25 +148,92 @@ private:
     SDL_sem* _pSdlSemaphoreAI;  /**< Semaphore for the AI thread */
     bool _bStopThreads;         /**< Signal threads to stop */
 
-    std::random_device _randomDeviceGenerator;
+    std::mt19937 _mersenneTwisterGenerator;     /**< Random generator for the sounds of the menus */
+    std::mt19937 _mersenneTwisterGeneratorMoves;    /**< Random generator for the sounds of the moves only */
     std::uniform_int_distribution<int32_t> _uniformDistribution;
+    uint32_t _uiSeed;                           /**< The seed of the moves generator in this game */
+    std::atomic<int16_t> _rAIMove;              /**< The column chosen by the AI thread, -1 while it thinks */
 
     Grid _grid;                             /**< Main playing grid */
+    BoardLayer _boardLayer;                 /**< The board composited in one surface, listens to the grid */
     std::unordered_map<uint8_t, Joystick*>  _htJoysticks;   /**< The joysticks in use */
     std::vector<Player*> _vectorpPlayers;   /**< The current players in the game */
     uint8_t _uyCurrentPlayer;               /** The index for the current player */
     bool _bSingleController;                /** The main controller can be used for all players */
     int8_t _yPlayColumn;                    /**< The value of the column currently selected by the user */
 
+    GameLog _gameLog;                       /**< Log of every game played */
+    GameRecord _gameRecord;                 /**< Record of the moves of the current game */
+    GameLog::Game _gamePlayback;            /**< The game being played back */
+    std::size_t _uPlaybackMove;             /**< The index of the next move to play back */
+    bool _bPlaybackPending;                 /**< Signals that a playback must start from the main screen */
+    bool _bIsPlayback;                      /**< Signals that the current game is driven by the playback */
+    uint32_t _uiGameStartTime;              /**< Time in milliseconds when the current game started */
+    uint32_t _uiLastMoveTime;               /**< Time in milliseconds when the last move was played */
+    Tablebase* _pTablebase;                 /**< Solved positions for the current board, if there are any */
+    Evaluation _evaluation;                 /**< Evaluation used by the AI, with the weights tuned offline */
+
     int16_t _rInitialX, _rInitialY;
 
-    std::unordered_map<std::string, Surface*> _htSurfaces;
-    std::unordered_map<std::string, Animation*> _htAnimations;
-    std::unordered_map<std::string, Button*> _htButtons;
-    std::unordered_map<std::string, Sample*> _htSamples;
+    Surface* _pSurfaceDisplay;                      /**< The display, which is freed by SDL_Quit */
+    ResourceRegistry<Surface> _registrySurfaces;    /**< Backgrounds, board cells and texts */
+    Atlas* _pAtlasUI;                       /**< Buttons, cursors and banners packed in one surface */
+    TextureCache _textureCache;             /**< Textures converted in earlier runs */
+    AssetLoader _assetLoader;               /**< Decodes the textures of the game in the background */
+    ResourceRegistry<Animation> _registryAnimations;
+    ResourceRegistry<Button> _registryButtons;
+    ResourceRegistry<Sample> _registrySamples;
     SamplePlayer _samplePlayerGlobal;
 
+    /* Handles of the resources, resolved once on construction so drawing never looks up a name */
+    SurfaceHandle _handleSurfaceStart, _handleSurfaceSettings, _handleSurfaceBackground;
+    SurfaceHandle _handleSurfaceHourglass, _handleSurfaceEmptyCell;
+    SurfaceHandle _handleSurfacePlayerMarker1, _handleSurfacePlayerMarker2;
+    SurfaceHandle _handleSurfaceTextSingle, _handleSurfaceTextMulti, _handleSurfaceTextSettings;
+    SurfaceHandle _handleSurfaceTextPrompt, _handleSurfaceTextYes, _handleSurfaceTextNo;
+    SurfaceHandle _handleSurfaceTextWidth, _handleSurfaceTextWidthValue;
+    SurfaceHandle _handleSurfaceTextHeight, _handleSurfaceTextHeightValue;
+    SurfaceHandle _handleSurfaceTextStreak, _handleSurfaceTextStreakValue;
+    SurfaceHandle _handleSurfaceTextDifficulty, _handleSurfaceTextDifficultyValue;
+    SurfaceHandle _handleSurfaceTextDevTools;
+    AnimationHandle _handleAnimationLoading, _handleAnimationWin;
+    ButtonHandle _handleButtonSinglePlayer, _handleButtonMultiPlayer, _handleButtonSettings;
+    ButtonHandle _handleButtonExit, _handleButtonYes, _handleButtonNo;
+    ButtonHandle _handleButtonMinusWidth, _handleButtonPlusWidth;
+    ButtonHandle _handleButtonMinusHeight, _handleButtonPlusHeight;
+    ButtonHandle _handleButtonMinusStreak, _handleButtonPlusStreak;
+    ButtonHandle _handleButtonMinusDifficulty, _handleButtonPlusDifficulty;
+    SampleHandle _handleSampleMusic, _handleSampleWaitingLoop;
+    std::array<SampleHandle, 6> _ahandleSamplesSelect;  /**< The sounds of a selection, drawn at random */
+    std::array<SampleHandle, 6> _ahandleSamplesCancel;  /**< The sounds of a cancellation, drawn at random */
+    std::array<SampleHandle, 2> _ahandleSamplesError;   /**< The sounds of the end of a game, drawn at random */
+    std::array<SampleHandle, 3> _ahandleSamplesOpen;    /**< The sounds of the prompt, drawn at random */
+
+    /* Sprites of the UI atlas, resolved again every time the atlas is loaded */
+    Atlas::Sprite _spriteDefaultButton, _spriteHoverButton, _spriteHome, _spriteHomeHover, _spriteMinus;
+    Atlas::Sprite _spritePlus, _spritePrompt, _spriteDefaultYes, _spriteHoverYes;
+    Atlas::Sprite _spriteWinPlayer1, _spriteWinPlayer2, _spriteDraw;
+    Atlas::Sprite _spriteCursorHand, _spriteCursorShadow, _spriteCursorPlayer1, _spriteCursorPlayer2;
+
     TTF_Font* _ttfFontContinuum;
+    TextRenderer _textRenderer;     /**< Caches the glyphs and strings rendered with the fonts */
+
+    ScreenLayout _screenLayout; /**< Places the elements of the screens on the display */
+    SDL_Rect _sdlRectHourglass; /**< The region of the hourglass, placed again when the display changes */
+    std::vector<ButtonPlacement> _vectorButtonPlacements;   /**< Where every button goes, by handle */
+    DirtyRects _dirtyRects;     /**< The regions of the display to redraw in the current frame */
+    Scene _scene;               /**< The layers of the current menu, composited in advance */
+    std::array<std::vector<SceneItem>, STATE_END + 1> _avectorSceneItems;  /**< The items of every screen */
+    uint64_t _uRenderKey;       /**< Summary of the layout drawn in the last frame */
+    SDL_Rect _sdlRectCursor;    /**< The region where the cursor was drawn in the last frame */
+    uint8_t _uyDrawnPlayer;     /**< The player whose turn was drawn in the last frame */
+    SDL_Rect _sdlRectHover;     /**< The region of the button hovered in the last frame */
+    uint8_t _uyDrawnWinFrame;   /**< The frame of the blinking markers drawn in the last frame */
+    CursorOverlay _cursorOverlay;   /**< Keeps the pixels under the cursor to take it off the display */
+    FrameScheduler _frameScheduler; /**< Paces the main loop while the screen is animated */
+    Timeline _timeline;             /**< Advances the animations on screen */
+    Profiler _profiler;             /**< Times the frames while the dev tools are enabled */
+    RenderThread _renderThread;     /**< Draws the recorded frames while the main thread goes on */
     
 
     App();    /**< Default constructor */
@@ -111,7 +244,7 @@ private:
     /**
      * @brief Handles all the data updates between frames
      */
-    void OnLoop() noexcept;
+    void OnLoop();
 
     /**
      * @brief Handles all the rendering for each frame
@@ -315,11 +448,242 @@ private:
 
 
     void LoadGame();
+
+    /**
+     * @brief Lays out the board once every texture queued by LoadGame has been collected, starting the game
+     */
+    void OnGameLoaded();
+
+    /**
+     * @brief Centres the board on the display
+     */
+    void PlaceBoard();
+
     void LoadSettings();
+
+    /**
+     * @brief Loads the game and creates the second player
+     *
+     * @param bSinglePlayer true if the second player is the AI
+     */
+    void StartGame(bool bSinglePlayer);
+
+    /**
+     * @brief Plays a move for the current player and passes the turn
+     *
+     * @param uyColumn the column of the move, it must be valid
+     */
+    void PlayMove(uint8_t uyColumn);
+
+    /**
+     * @brief Records the last move made on the grid in the game log
+     *
+     * @param uyColumn the column of the move
+     */
+    void RecordMove(uint8_t uyColumn) noexcept;
+
+    /**
+     * @brief Plays the move chosen by the AI thread, the grid and the game log are only touched here
+     *
+     * @param uyColumn the column of the move
+     */
+    void OnAIMove(uint8_t uyColumn);
+
+    /**
+     * @brief Plays the recorded human moves when their time has come
+     */
+    void OnPlayback();
+
+    /**
+     * @brief Tells whether the screen changes without input, otherwise the main loop waits for events
+     *
+     * @return bool true if the next frame has to be drawn even if no event arrives
+     */
+    bool IsAnimating() const;
+
     Surface* LoadTexture(const std::string& CsPath) const;
-    Surface* GenerateText(const std::string& CsMessage, TTF_Font* ttfFontText, 
-        const SDL_Color& CsdlColorText) const;
-    void RenderGrid(Surface& pSurfaceDisplay) const;
+
+    /**
+     * @brief Loads a texture from the texture cache, decoding and storing it there if it is not cached yet
+     *
+     * @param CsFilePath the path of the image file
+     * @return Surface* the texture in the format of the display
+     */
+    Surface* LoadCachedTexture(const std::string& CsFilePath) const;
+
+    /**
+     * @brief Queues a texture to be loaded in the background, from the custom graphics path if it is there
+     *
+     * @param handle the slot of the registry that receives the texture
+     * @param CsPath the name of the texture file
+     * @param urFitWidth width to fill with an integer upscale, 0 to keep the size
+     * @param urFitHeight height to fill with an integer upscale, 0 to keep the size
+     */
+    void QueueTexture(SurfaceHandle handle, const std::string& CsPath, uint16_t urFitWidth = 0,
+        uint16_t urFitHeight = 0);
+
+    /**
+     * @brief Loads a texture atlas, from the custom graphics path if it is there, otherwise the default one
+     * with any sprite file of the custom graphics path drawn over its sprites
+     *
+     * @param CsName the name of the atlas, without extension
+     * @return Atlas* the loaded atlas
+     */
+    Atlas* LoadAtlas(const std::string& CsName) const;
+
+    /**
+     * @brief Finds the sprites drawn by the application in the UI atlas
+     */
+    void ResolveSprites();
+
+    /**
+     * @brief Resolves the surfaces, buttons and sprites of the items of every screen, after the UI atlas
+     */
+    void ResolveScene();
+
+    /**
+     * @brief Renders a text through the text cache
+     *
+     * @param CsMessage the UTF-8 text
+     * @param ttfFontText the font
+     * @param CsdlColorText the colour of the text
+     * @return Surface* the rendered text, owned by the caller
+     */
+    Surface* GenerateText(const std::string& CsMessage, TTF_Font* ttfFontText, const SDL_Color& CsdlColorText);
+
+    /**
+     * @brief Creates a button placed on the display, and keeps its placement for when the display changes
+     *
+     * @param handleButton the button
+     * @param rLeft the X coordinate of the left side of the button on the preferred display
+     * @param rTop the Y coordinate of the top side of the button on the preferred display
+     * @param rRight the X coordinate of the right side of the button on the preferred display
+     * @param rBottom the Y coordinate of the bottom side of the button on the preferred display
+     * @param eAnchor the point of the display the button keeps its distance to
+     */
+    void SetButton(ButtonHandle handleButton, int16_t rLeft, int16_t rTop, int16_t rRight, int16_t rBottom,
+        ScreenLayout::EAnchor eAnchor = ScreenLayout::ANCHOR_CENTRE);
+
+    /**
+     * @brief Places the hourglass and the loaded buttons again, after the size of the display changed
+     */
+    void PlaceButtons();
+
+    /**
+     * @brief Draws the board
+     *
+     * @param renderCommandList the list of the frame
+     */
+    void RenderGrid(RenderCommandList& renderCommandList);
+
+    /**
+     * @brief Describes again the layers of the current screen whose contents changed, and composites them
+     *
+     * @param CvectorMouse the position of the cursor
+     */
+    void UpdateScene(const Vector3& CvectorMouse);
+
+    /**
+     * @brief Checks whether a button can be pressed on the current screen, the settings hide the buttons that
+     * would take a value out of its range
+     *
+     * @param handleButton the button
+     * @return true if the button is drawn
+     */
+    bool IsButtonShown(ButtonHandle handleButton) const noexcept;
+
+    /**
+     * @brief Gets the region of the button under the cursor, which covers both of its looks
+     *
+     * @param CvectorMouse the position of the cursor
+     * @return SDL_Rect the region of the display, empty if no button that changes its look is hovered
+     */
+    SDL_Rect GetHoverRect(const Vector3& CvectorMouse) const;
+
+    /**
+     * @brief Draws the current screen, without the cursor
+     *
+     * @param renderCommandList the list of the frame
+     * @param CvectorMouse the position of the cursor
+     */
+    void RenderScene(RenderCommandList& renderCommandList, const Vector3& CvectorMouse);
+
+    /**
+     * @brief Draws the cursor of the current screen
+     *
+     * @param renderCommandList the list of the frame
+     * @param iMouseX the X coordinate of the cursor
+     * @param iMouseY the Y coordinate of the cursor
+     */
+    void RenderCursor(RenderCommandList& renderCommandList, int32_t iMouseX, int32_t iMouseY) const;
+
+    /**
+     * @brief Draws the frame times of the profiler as a graph, with a line at the frame budget
+     *
+     * @param renderCommandList the list of the frame
+     */
+    void RenderProfiler(RenderCommandList& renderCommandList) const;
+
+    /**
+     * @brief Writes the frame times of the profiler to the profile file
+     */
+    void DumpProfile() noexcept;
+
+    /**
+     * @brief Writes the events traced by every thread to the trace file
+     */
+    void FlushTrace() noexcept;
+
+    /**
+     * @brief Runs the main loop on the current screen for a number of frames and prints their frame times
+     *
+     * @param CpName the name of the screen in the report and in the checksums
+     * @param uiFrames the frames to draw
+     * @param bLoop false to draw the frames without updating the state, so the screen stays the same
+     * @param scriptedInput the input events of the benchmark
+     * @param ofstreamChecksums the file of checksums, if it is open
+     * @param uiFrame the frame of the whole benchmark, which is advanced
+     */
+    void BenchmarkScreen(const char* CpName, uint32_t uiFrames, bool bLoop, ScriptedInput& scriptedInput,
+        std::ofstream& ofstreamChecksums, uint32_t& uiFrame);
+
+    /**
+     * @brief Gets the region covered by the cursor
+     *
+     * @param iMouseX the X coordinate of the cursor
+     * @param iMouseY the Y coordinate of the cursor
+     * @return SDL_Rect the region of the display where the cursor is drawn
+     */
+    SDL_Rect GetCursorRect(int32_t iMouseX, int32_t iMouseY) const;
+
+    /**
+     * @brief Gets the region of the progress bar shown while the game loads
+     *
+     * @return SDL_Rect the region of the display, frame included
+     */
+    SDL_Rect GetLoadingBarRect() const;
+
+    /**
+     * @brief Gets the region of the frame time graph shown in dev mode
+     *
+     * @return SDL_Rect the region of the display in the bottom right corner
+     */
+    SDL_Rect GetProfilerRect() const;
+
+    /**
+     * @brief Gets the sprite of the cursor inside a game, which shows whose turn it is
+     *
+     * @return Atlas::Sprite the sprite in the UI atlas
+     */
+    Atlas::Sprite GetCursorSprite() const;
+
+    /**
+     * @brief Summarises everything that changes the layout of the current screen. The hovered buttons and the
+     * blinking markers are left out, they only mark their own regions
+     *
+     * @return uint64_t a value that changes whenever the screen must be redrawn whole
+     */
+    uint64_t GetRenderKey() const;
 
 };
 
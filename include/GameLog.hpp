@@ -0,0 +1,127 @@
+/*
+GameLog.hpp --- Append-only log of played games
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GAMELOG_HPP_
+#define _GAMELOG_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Grid.hpp"
+#include "GameRecord.hpp"
+
+
+/**
+ * @brief Append-only text log of every game played, with enough information to replay it.
+ *
+ * Each game is written as a "GAME <seed> <W>x<H>x<K> <difficulty> <AI|Human>" line, one
+ * "MOVE <milliseconds> <mark> <AI|Human> <column>" line per move and an "END <mark> <record>" line.
+ * Columns are 1-based, as in the game record text notation.
+ */
+class GameLog
+{
+public:
+    /**
+     * @brief A move as it was played
+     */
+    struct Move
+    {
+        uint32_t uiTime;                /**< Milliseconds since the start of the game */
+        Grid::EPlayerMark ePlayerMark;  /**< The mark of the player that made the move */
+        bool bIsAI;                     /**< Signals if the move was made by the AI */
+        uint8_t uyColumn;               /**< The 0-based column of the move */
+    };
+
+    /**
+     * @brief A game as it was played
+     */
+    struct Game
+    {
+        uint32_t uiSeed;                /**< Seed of the random generator used during the game */
+        uint8_t uyWidth;                /**< Width of the grid */
+        uint8_t uyHeight;               /**< Height of the grid */
+        uint8_t uyCellsToWin;           /**< Number of markers in a row required to win */
+        uint8_t uyAIDifficulty;         /**< AI difficulty level */
+        bool bSinglePlayer;             /**< Signals if the second player is the AI */
+        std::vector<Move> vectorMoves;  /**< The moves of the game, in order */
+    };
+
+
+    /* Getters and setters */
+    const std::string& GetLogPath() const noexcept;
+    void SetLogPath(const std::string& CsLogPath) noexcept;
+
+
+    /**
+     * @brief Construct a new game log
+     *
+     * @param CsPath the path of the log file, new games are appended to it
+     */
+    explicit GameLog(const std::string& CsPath);
+
+
+    /**
+     * @brief Reads the first game of a log file
+     *
+     * @param CsPath the path of the log file
+     * @return Game the game read, including all its moves
+     */
+    static Game Load(const std::string& CsPath);
+
+    /**
+     * @brief Logs the start of a game
+     *
+     * @param Cgame the game that starts, its moves are ignored
+     */
+    void StartGame(const Game& Cgame) const;
+
+    /**
+     * @brief Logs a move of the current game
+     *
+     * @param Cmove the move played
+     */
+    void RecordMove(const Move& Cmove) const;
+
+    /**
+     * @brief Logs the end of the current game
+     *
+     * @param CePlayerMarkWinner the mark of the player that won, or empty on a draw
+     * @param CgameRecord the record of the whole game
+     */
+    void EndGame(const Grid::EPlayerMark& CePlayerMarkWinner, const GameRecord& CgameRecord) const;
+
+private:
+    std::string _sLogPath;  /**< The path of the log file */
+
+    /**
+     * @brief Appends a line to the log file
+     *
+     * @param CsLine the line to append
+     */
+    void Append(const std::string& CsLine) const;
+
+};
+
+
+inline const std::string& GameLog::GetLogPath() const noexcept { return _sLogPath; }
+inline void GameLog::SetLogPath(const std::string& CsLogPath) noexcept { _sLogPath = CsLogPath; }
+
+
+#endif
@@ -0,0 +1,182 @@
+/*
+GameRecord.hpp --- Compact game records for ConnectX
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GAMERECORD_HPP_
+#define _GAMERECORD_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+
+#include "Grid.hpp"
+
+
+/**
+ * @brief Read-only view over a serialised game record. It does not copy the data, so the buffer it was
+ * built from must outlive it.
+ *
+ * The binary encoding is a 3 byte header (width and height nibbles, cells to win, number of moves) followed
+ * by the moves packed as 4 bit column indexes, high nibble first.
+ * The text encoding is "WxHxK:" followed by one 1-based column digit per move, e.g. "7x6x4:4453".
+ */
+class GameRecordView
+{
+public:
+    static const uint8_t SCuyBinaryHeaderSize{3};  /**< Size in bytes of the binary header */
+
+    /* Getters */
+    uint8_t GetWidth() const noexcept;
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+    uint8_t GetMoveCount() const noexcept;
+    std::size_t GetSize() const noexcept;
+
+    /**
+     * @brief Parses a binary record at the start of a buffer
+     *
+     * @param CspanuyData the buffer holding the record, it may hold more records after this one
+     */
+    explicit GameRecordView(std::span<const uint8_t> CspanuyData);
+
+    /**
+     * @brief Parses a text record
+     *
+     * @param CsvText the text holding the record
+     */
+    explicit GameRecordView(std::string_view CsvText);
+
+    /**
+     * @brief Gets a move of the game
+     *
+     * @param uyIndex the index of the move, in the order it was played
+     * @return uint8_t the 0-based column of the move
+     */
+    uint8_t GetMove(uint8_t uyIndex) const noexcept;
+
+    /**
+     * @brief Builds the grid that results from playing every move of the record
+     *
+     * @return Grid the final position of the record
+     */
+    Grid ToGrid() const;
+
+private:
+    const uint8_t* _puyMoves;   /**< The first move inside the parsed buffer */
+    std::size_t _uSize;         /**< Size of the whole record inside the parsed buffer */
+    uint8_t _uyWidth;           /**< Width of the grid */
+    uint8_t _uyHeight;          /**< Height of the grid */
+    uint8_t _uyCellsToWin;      /**< Number of markers in a row required to win */
+    uint8_t _uyMoveCount;       /**< Number of moves in the record */
+    bool _bIsText;              /**< Signals if the record was parsed from the text encoding */
+
+};
+
+
+/**
+ * @brief Owning game record that can be built move by move and serialised
+ */
+class GameRecord
+{
+public:
+    /* Getters */
+    uint8_t GetWidth() const noexcept;
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+    const std::vector<uint8_t>& GetMoves() const noexcept;
+
+    /**
+     * @brief Construct a new empty record
+     *
+     * @param uyWidth the width of the grid
+     * @param uyHeight the height of the grid
+     * @param uyCellsToWin the number of cells in a row required to win
+     */
+    explicit GameRecord(uint8_t uyWidth = 7, uint8_t uyHeight = 6, uint8_t uyCellsToWin = 4);
+
+    /**
+     * @brief Construct a new record from a parsed one
+     *
+     * @param CgameRecordView the parsed record to copy
+     */
+    explicit GameRecord(const GameRecordView& CgameRecordView);
+
+    /**
+     * @brief Appends a move to the record
+     *
+     * @param uyColumn the 0-based column of the move
+     */
+    void AddMove(uint8_t uyColumn);
+
+    /**
+     * @brief Gets the size of the binary encoding of this record
+     *
+     * @return std::size_t the number of bytes Serialise will write
+     */
+    std::size_t GetBinarySize() const noexcept;
+
+    /**
+     * @brief Writes the binary encoding of this record
+     *
+     * @param spanuyBuffer the buffer where the record will be written
+     * @return std::size_t the number of bytes written
+     */
+    std::size_t Serialise(std::span<uint8_t> spanuyBuffer) const;
+
+    /**
+     * @brief Gets the text encoding of this record
+     *
+     * @return std::string the move string of the record
+     */
+    std::string ToString() const;
+
+private:
+    uint8_t _uyWidth;       /**< Width of the grid */
+    uint8_t _uyHeight;      /**< Height of the grid */
+    uint8_t _uyCellsToWin;  /**< Number of markers in a row required to win */
+    std::vector<uint8_t> _vectoruyMoves;    /**< The columns played, in order */
+
+};
+
+
+inline uint8_t GameRecordView::GetWidth() const noexcept { return _uyWidth; }
+inline uint8_t GameRecordView::GetHeight() const noexcept { return _uyHeight; }
+inline uint8_t GameRecordView::GetCellsToWin() const noexcept { return _uyCellsToWin; }
+inline uint8_t GameRecordView::GetMoveCount() const noexcept { return _uyMoveCount; }
+inline std::size_t GameRecordView::GetSize() const noexcept { return _uSize; }
+
+inline uint8_t GameRecordView::GetMove(uint8_t uyIndex) const noexcept
+{
+    if (_bIsText) return _puyMoves[uyIndex] - '1';
+    return (uyIndex & 1 ? _puyMoves[uyIndex >> 1] & 0x0F : _puyMoves[uyIndex >> 1] >> 4);
+}
+
+
+inline uint8_t GameRecord::GetWidth() const noexcept { return _uyWidth; }
+inline uint8_t GameRecord::GetHeight() const noexcept { return _uyHeight; }
+inline uint8_t GameRecord::GetCellsToWin() const noexcept { return _uyCellsToWin; }
+inline const std::vector<uint8_t>& GameRecord::GetMoves() const noexcept { return _vectoruyMoves; }
+
+inline std::size_t GameRecord::GetBinarySize() const noexcept
+{ return GameRecordView::SCuyBinaryHeaderSize + ((_vectoruyMoves.size() + 1) >> 1); }
+
+
+#endif
@@ -32,12 +32,19 @@ class Globals
 public:
     static const uint16_t SCurAppWidth{640};   /**< Preferred pixel width of the application */
     static const uint16_t SCurAppHeight{480};  /**< Preferred pixel height of the application */
+    static const uint16_t SCurTargetFPS{60};   /**< Frames per second the main loop is paced to */
 
     static const std::string SCsLogDefaultPath;         /**< Default path for storing the application's log */
     static const std::string SCsSettingsDefaultPath;    /**< Default path for storing the application's settings */
     static const std::string SCsGraphicsDefaultPath;    /**< Default path for storing the application's graphics */
     static const std::string SCsAudioDefaultPath;
     static const std::string SCsFontsDefaultPath;
+    static const std::string SCsGameLogDefaultPath;     /**< Default path for storing the log of played games */
+    static const std::string SCsTablebasesDefaultPath;  /**< Default path for storing the tablebases */
+    static const std::string SCsWeightsDefaultPath;     /**< Default path for storing the evaluation weights */
+    static const std::string SCsTextureCacheDefaultPath;    /**< Default path for caching converted textures */
+    static const std::string SCsProfileDefaultPath;     /**< Default path for dumping the frame times */
+    static const std::string SCsTraceDefaultPath;       /**< Default path for writing the event trace */
 
     /* Settings */
     static const uint8_t SCuyBoardWidthDefault{7};         /**< Default board width */
@@ -48,12 +55,16 @@ public:
     static const uint8_t SCuyBoardHeightMax{9};
     static const uint8_t SCuyCellsToWinDefault{4};         /**< Default number of game pieces to win */
     static const uint8_t SCuyCellsToWinMin{2};
-    static const uint8_t SCuyAIDifficultyDefault{4};       /**< Default AI exploration depth */
+    static const uint8_t SCuyAIDifficultyDefault{4};       /**< Default AI difficulty level */
     static const uint8_t SCuyAIDifficultyMin{1};
     static const uint8_t SCuyAIDifficultyMax{7};
+    static constexpr uint32_t SCauiAINodeBudgets[SCuyAIDifficultyMax]{500, 2000, 8000, 25000, 60000, 
+        120000, 250000};                                   /**< Nodes the AI may search per move at each difficulty */
+    static const uint8_t SCuyAINodeBudgetCells{42};        /**< Board size in cells the node budgets refer to (7x6) */
 
     static const std::string SCsGraphicsCustomPath; /**< Default custom path for storing the application's graphics */
     static const bool SCbIsDev{false};              /**< Default dev configuration */
+    static const std::string SCsPlaybackDefaultPath;    /**< Default game log to play back, empty to disable */
 
 };
 
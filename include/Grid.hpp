@@ -27,6 +27,9 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <ostream>
 
 
+class GridListener;
+
+
 /**
  * @brief Grid class
  */
@@ -44,6 +47,8 @@ public:
     int8_t GetNextCell(uint8_t uyColumn) const noexcept;
     const std::pair<uint8_t, uint8_t>& GetWinCell() const noexcept;
     const std::pair<int8_t, int8_t>& GetWinDirection() const noexcept;
+    GridListener* GetListener() const noexcept;
+    void SetListener(GridListener* pGridListener) noexcept;
 
 
     /**
@@ -54,7 +59,12 @@ public:
      * @param uyCellsToWin the number of cells in a row required to win
      */
     explicit Grid(uint8_t uyWidth = 7, uint8_t uyHeight = 6, uint8_t uyCellsToWin = 4);
-    
+
+    Grid(const Grid& CgridOther);               /**< Copy constructor, the copy has no listener */
+    Grid(Grid&& gridOther) noexcept;            /**< Move constructor, the new grid has no listener */
+
+    Grid& operator =(const Grid& CgridOther);   /**< Copy assignment operator, the listener is kept */
+    Grid& operator =(Grid&& gridOther) noexcept;    /**< Move assignment operator, the listener is kept */
 
     const std::vector<EPlayerMark>& operator [](uint8_t uyIndex) const noexcept; /**< Bracket operator */
 
@@ -100,6 +110,7 @@ private:
     EPlayerMark _ePlayerMarkWinner;         /**< The marker of the player who won the game, or empty */
     std::pair<uint8_t, uint8_t> _pairWinCell;
     std::pair<int8_t, int8_t> _pairWinDirection;
+    GridListener* _pGridListener;           /**< Notified of every change to this grid, or null */
 
     /**
      * @brief Checks if a given move has won the game
@@ -122,6 +133,8 @@ inline const std::vector<std::vector<Grid::EPlayerMark> >& Grid::GetCells() cons
 inline int8_t Grid::GetNextCell(uint8_t uyColumn) const noexcept { return _ayNextCell[uyColumn]; }
 inline const std::pair<uint8_t, uint8_t>& Grid::GetWinCell() const noexcept { return _pairWinCell; }
 inline const std::pair<int8_t, int8_t>& Grid::GetWinDirection() const noexcept { return _pairWinDirection; }
+inline GridListener* Grid::GetListener() const noexcept { return _pGridListener; }
+inline void Grid::SetListener(GridListener* pGridListener) noexcept { _pGridListener = pGridListener; }
 
 
 inline const std::vector<Grid::EPlayerMark>& Grid::operator [](uint8_t uyIndex) const noexcept 
@@ -0,0 +1,58 @@
+/*
+GridListener.hpp --- Grid Listener abstract class
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GRIDLISTENER_HPP_
+#define _GRIDLISTENER_HPP_
+
+
+#include <cstdint>
+
+#include "Grid.hpp"
+
+
+/**
+ * @brief Grid Listener abstract class
+ * @details Classes that wish to know about the changes of a grid should inherit this class and register to
+ * the grid. Copies of a grid are not listened to, so the searches of the AI are never notified
+ */
+class GridListener
+{
+public:
+    virtual ~GridListener() = default;  /**< Destructor */
+
+    /**
+     * @brief Handles a marker being placed on the grid
+     *
+     * @param Cgrid the grid that changed
+     * @param uyRow the row of the new marker
+     * @param uyColumn the column of the new marker
+     */
+    virtual void OnMove(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn) = 0;
+
+    /**
+     * @brief Handles the grid being replaced by another one
+     *
+     * @param Cgrid the grid that changed
+     */
+    virtual void OnReset(const Grid& Cgrid) = 0;
+
+};
+
+
+#endif
@@ -0,0 +1,194 @@
+/*
+Profiler.hpp --- Per-frame timing of the main loop
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PROFILER_HPP_
+#define _PROFILER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <array>
+#include <vector>
+#include <chrono>
+
+
+/**
+ * @brief Times the sections of every frame of the main loop and keeps the last frames in a ring buffer.
+ * Sections may nest, like the grid inside the in-game screen, and each one adds up every time it runs in
+ * a frame. Only the main thread may use it
+ */
+class Profiler
+{
+public:
+    /**
+     * @brief The timed parts of a frame
+     */
+    enum ESection {SECTION_EVENTS, SECTION_LOOP, SECTION_RENDER_START, SECTION_RENDER_SETTINGS,
+        SECTION_RENDER_LOADING, SECTION_RENDER_INGAME, SECTION_RENDER_PROMPT, SECTION_RENDER_END,
+        SECTION_GRID, SECTION_PRESENT, SECTION_COUNT};
+
+    static const uint16_t SCurFrames{256};     /**< Frames kept in the ring buffer */
+
+
+    /**
+     * @brief Summary of a section over the frames in the ring buffer, in milliseconds
+     */
+    struct Stats
+    {
+        float fMin;
+        float fAverage;
+        float fP99;     /**< 99% of the frames took this long or less */
+    };
+
+
+    /**
+     * @brief Adds the time from its construction to its destruction to a section of the current frame
+     */
+    class ScopedTimer
+    {
+    public:
+        /**
+         * @brief Starts timing a section
+         *
+         * @param profiler the profiler of the frame
+         * @param eSection the section
+         */
+        ScopedTimer(Profiler& profiler, ESection eSection) noexcept;
+
+        ScopedTimer(const ScopedTimer& CtimerOther) = delete;               /**< Copy constructor */
+        ScopedTimer& operator =(const ScopedTimer& CtimerOther) = delete;   /**< Copy assignment operator */
+
+        ~ScopedTimer() noexcept;    /**< Destructor, adds the elapsed time */
+
+    private:
+        Profiler& _profiler;
+        ESection _eSection;
+        std::chrono::steady_clock::time_point _timeStart;
+
+    };
+
+
+    /* Getters and setters */
+    bool IsEnabled() const noexcept;
+    void SetEnabled(bool bEnabled) noexcept;
+    uint16_t GetFrameCount() const noexcept;
+
+
+    Profiler() noexcept;    /**< Default constructor */
+
+
+    /**
+     * @brief Gets the name of a section, as written in the dumps
+     *
+     * @param eSection the section
+     * @return const char* the name
+     */
+    static const char* GetSectionName(ESection eSection) noexcept;
+
+    /**
+     * @brief Summarises any number of times, for runs longer than the ring buffer
+     *
+     * @param vectoruiTimes the times, in microseconds, which are reordered
+     * @return Stats the summary
+     */
+    static Stats Summarise(std::vector<uint32_t>& vectoruiTimes);
+
+    /**
+     * @brief Starts timing a frame
+     */
+    void BeginFrame() noexcept;
+
+    /**
+     * @brief Stops timing the current frame and stores it in the ring buffer
+     */
+    void EndFrame() noexcept;
+
+    /**
+     * @brief Adds time to a section of the current frame
+     *
+     * @param eSection the section
+     * @param uiMicroseconds the time to add
+     */
+    void Add(ESection eSection, uint32_t uiMicroseconds) noexcept;
+
+    /**
+     * @brief Gets the time of a stored frame
+     *
+     * @param urAge 0 for the last frame, 1 for the one before and so on, it must be below GetFrameCount
+     * @return uint32_t the time from BeginFrame to EndFrame, in microseconds
+     */
+    uint32_t GetFrameTime(uint16_t urAge) const noexcept;
+
+    /**
+     * @brief Summarises the time of whole frames
+     *
+     * @return Stats the summary over the stored frames
+     */
+    Stats GetFrameStats() const;
+
+    /**
+     * @brief Summarises the time of a section
+     *
+     * @param eSection the section
+     * @return Stats the summary over the stored frames
+     */
+    Stats GetSectionStats(ESection eSection) const;
+
+    /**
+     * @brief Writes the stored frames and their summary as CSV
+     *
+     * @param CsPath the path of the file, which is overwritten
+     */
+    void Dump(const std::string& CsPath) const;
+
+private:
+    /**
+     * @brief Times of a frame, in microseconds
+     */
+    struct Frame
+    {
+        uint32_t uiTotal;                                   /**< Time from BeginFrame to EndFrame */
+        std::array<uint32_t, SECTION_COUNT> auiSections;    /**< Time spent in every section */
+    };
+
+
+    bool _bEnabled;             /**< Whether the frames are being timed */
+    std::array<Frame, SCurFrames> _aframes;     /**< The ring buffer of frames */
+    uint16_t _urNext;           /**< The slot of the next frame stored */
+    uint16_t _urCount;          /**< The number of frames stored */
+    Frame _frameCurrent;        /**< The frame being timed */
+    std::chrono::steady_clock::time_point _timeFrameStart;  /**< When the current frame began */
+
+
+    /**
+     * @brief Summarises one time of every stored frame
+     *
+     * @param iSection the section, or -1 for the whole frame
+     * @return Stats the summary
+     */
+    Stats GetStats(int32_t iSection) const;
+
+};
+
+
+inline bool Profiler::IsEnabled() const noexcept { return _bEnabled; }
+inline void Profiler::SetEnabled(bool bEnabled) noexcept { _bEnabled = bEnabled; }
+inline uint16_t Profiler::GetFrameCount() const noexcept { return _urCount; }
+
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ResourceRegistry.hpp --- Dense storage of resources addressed by handles
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RESOURCEREGISTRY_HPP_
+#define _RESOURCEREGISTRY_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+
+
+/**
+ * @brief Owns resources of one type in a vector. Names are resolved into handles once, when the resources
+ * are loaded, and from then on every lookup is an index into the vector
+ *
+ * @tparam T the type of the resources
+ */
+template <typename T>
+class ResourceRegistry
+{
+public:
+    /**
+     * @brief Position of a resource in the registry that resolved it
+     */
+    struct Handle
+    {
+        uint16_t urIndex;   /**< The index of the resource */
+
+        bool operator ==(const Handle& ChandleOther) const noexcept = default;
+    };
+
+
+    std::size_t GetSize() const noexcept;
+    const std::string& GetName(Handle handle) const;
+
+
+    ResourceRegistry() noexcept;    /**< Default constructor */
+
+    ResourceRegistry(const ResourceRegistry& CregistryOther) = delete;              /**< Copy constructor */
+    ResourceRegistry& operator =(const ResourceRegistry& CregistryOther) = delete;  /**< Copy assignment */
+
+    ~ResourceRegistry() noexcept;   /**< Destructor */
+
+
+    /**
+     * @brief Gets the resource of a handle
+     *
+     * @param handle the handle of the resource
+     * @return T* the resource, nullptr if it is not loaded
+     */
+    T* operator [](Handle handle) const noexcept;
+
+    /**
+     * @brief Gets the resource of a handle, which must be loaded
+     *
+     * @param handle the handle of the resource
+     * @return T& the resource
+     * @throw std::out_of_range if the handle was not resolved by this registry
+     * @throw std::runtime_error if the resource is not loaded
+     */
+    T& At(Handle handle) const;
+
+
+    /**
+     * @brief Gets the handle bound to a name, reserving an empty slot the first time the name is seen
+     *
+     * @param CsName the name of the resource
+     * @return Handle the handle bound to the name, valid for the lifetime of the registry
+     */
+    Handle Resolve(const std::string& CsName);
+
+    /**
+     * @brief Stores a resource, deleting the one it replaces
+     *
+     * @param handle the handle of the resource
+     * @param pResource the new resource, owned by the registry from now on
+     */
+    void Set(Handle handle, T* pResource) noexcept;
+
+    /**
+     * @brief Deletes a resource, keeping its handle bound to the name
+     *
+     * @param handle the handle of the resource
+     */
+    void Erase(Handle handle) noexcept;
+
+    /**
+     * @brief Deletes every resource
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Deletes every resource but one
+     *
+     * @param handleKept the handle of the resource that is kept
+     */
+    void ClearExcept(Handle handleKept) noexcept;
+
+    /**
+     * @brief Marks a resource as shared between states, so that Release keeps it
+     *
+     * @param handle the handle of the resource
+     * @param bResident whether the resource is kept by Release
+     */
+    void SetResident(Handle handle, bool bResident = true) noexcept;
+
+    /**
+     * @brief Deletes every resource that is not resident
+     */
+    void Release() noexcept;
+
+    typename std::vector<T*>::const_iterator begin() const noexcept;   /**< First slot, which may be empty */
+    typename std::vector<T*>::const_iterator end() const noexcept;     /**< Past the last slot */
+
+private:
+    std::vector<T*> _vectorpResources;                      /**< The resources, indexed by handle */
+    std::vector<std::string> _vectorsNames;                 /**< The name of every handle */
+    std::vector<bool> _vectorbResident;                     /**< Whether every handle survives Release */
+    std::unordered_map<std::string, uint16_t> _htHandles;   /**< The handle of every name */
+
+};
+
+
+template <typename T>
+ResourceRegistry<T>::ResourceRegistry() noexcept : _vectorpResources{}, _vectorsNames{},
+    _vectorbResident{}, _htHandles{} {}
+
+
+template <typename T>
+ResourceRegistry<T>::~ResourceRegistry() noexcept { Clear(); }
+
+
+template <typename T>
+typename ResourceRegistry<T>::Handle ResourceRegistry<T>::Resolve(const std::string& CsName)
+{
+    typename std::unordered_map<std::string, uint16_t>::const_iterator i = _htHandles.find(CsName);
+    if (i != _htHandles.end()) return Handle{i->second};
+
+    if (_vectorpResources.size() == UINT16_MAX) throw std::length_error("Too many resources");
+
+    Handle handleNew{static_cast<uint16_t>(_vectorpResources.size())};
+    _vectorpResources.push_back(nullptr);
+    _vectorsNames.push_back(CsName);
+    _vectorbResident.push_back(false);
+    _htHandles.insert(std::make_pair(CsName, handleNew.urIndex));
+
+    return handleNew;
+}
+
+
+template <typename T>
+T& ResourceRegistry<T>::At(Handle handle) const
+{
+    if (handle.urIndex >= _vectorpResources.size()) throw std::out_of_range("Unknown resource handle");
+    if (_vectorpResources[handle.urIndex] == nullptr)
+        throw std::runtime_error("Resource " + _vectorsNames[handle.urIndex] + " is not loaded");
+
+    return *_vectorpResources[handle.urIndex];
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::Set(Handle handle, T* pResource) noexcept
+{
+    if (_vectorpResources[handle.urIndex] != pResource) delete _vectorpResources[handle.urIndex];
+    _vectorpResources[handle.urIndex] = pResource;
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::Erase(Handle handle) noexcept
+{
+    delete _vectorpResources[handle.urIndex];
+    _vectorpResources[handle.urIndex] = nullptr;
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::Clear() noexcept
+{
+    for (T*& pResource : _vectorpResources)
+    {
+        delete pResource;
+        pResource = nullptr;
+    }
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::ClearExcept(Handle handleKept) noexcept
+{
+    for (std::size_t i = 0; i < _vectorpResources.size(); ++i)
+    {
+        if (i != handleKept.urIndex)
+        {
+            delete _vectorpResources[i];
+            _vectorpResources[i] = nullptr;
+        }
+    }
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::SetResident(Handle handle, bool bResident) noexcept
+{
+    _vectorbResident[handle.urIndex] = bResident;
+}
+
+
+template <typename T>
+void ResourceRegistry<T>::Release() noexcept
+{
+    for (std::size_t i = 0; i < _vectorpResources.size(); ++i)
+    {
+        if (!_vectorbResident[i])
+        {
+            delete _vectorpResources[i];
+            _vectorpResources[i] = nullptr;
+        }
+    }
+}
+
+
+template <typename T>
+inline std::size_t ResourceRegistry<T>::GetSize() const noexcept { return _vectorpResources.size(); }
+template <typename T>
+inline const std::string& ResourceRegistry<T>::GetName(Handle handle) const
+{ return _vectorsNames.at(handle.urIndex); }
+template <typename T>
+inline T* ResourceRegistry<T>::operator [](Handle handle) const noexcept
+{ return _vectorpResources[handle.urIndex]; }
+template <typename T>
+inline typename std::vector<T*>::const_iterator ResourceRegistry<T>::begin() const noexcept
+{ return _vectorpResources.begin(); }
+template <typename T>
+inline typename std::vector<T*>::const_iterator ResourceRegistry<T>::end() const noexcept
+{ return _vectorpResources.end(); }
+
+
+#endif
@@ -45,6 +45,8 @@ public:
     void SetCustomPath(const std::string& CsCustomPath) noexcept;
     bool GetIsDev() const noexcept;
     void SetIsDev(bool bHasLogging) noexcept;
+    const std::string& GetPlaybackPath() const noexcept;
+    void SetPlaybackPath(const std::string& CsPlaybackPath) noexcept;
 
 
     /**
@@ -55,7 +57,8 @@ public:
         uint8_t uyCellsToWin = Globals::SCuyCellsToWinDefault,
         uint8_t uyAIDifficulty = Globals::SCuyAIDifficultyDefault, 
         const std::string& sCustomPath = Globals::SCsGraphicsCustomPath, 
-        bool bIsDev = Globals::SCbIsDev) noexcept;
+        bool bIsDev = Globals::SCbIsDev,
+        const std::string& sPlaybackPath = Globals::SCsPlaybackDefaultPath) noexcept;
 
     /**
      * @brief Constructs a new object by reading a settings file
@@ -74,9 +77,10 @@ private:
     uint8_t _uyBoardWidth;      /**< Game board width */
     uint8_t _uyBoardHeight;     /**< Game board height */
     uint8_t _uyCellsToWin;      /**< Number of game pieces to win */
-    uint8_t _uyAIDifficulty;    /**< AI exploration depth */
+    uint8_t _uyAIDifficulty;    /**< AI difficulty level, selects the search node budget */
     std::string _sCustomPath;   /**< Custom path for sprites */
     bool _bIsDev;               /**< Enable dev tools */
+    std::string _sPlaybackPath; /**< Game log to play back on start, empty to disable */
     
 };
 
@@ -94,5 +98,8 @@ inline void Settings::SetCustomPath(const std::string& CsCustomPath) noexcept
 { _sCustomPath = CsCustomPath; }
 inline bool Settings::GetIsDev() const noexcept { return _bIsDev; }
 inline void Settings::SetIsDev(bool bIsDev) noexcept { _bIsDev = bIsDev; }
+inline const std::string& Settings::GetPlaybackPath() const noexcept { return _sPlaybackPath; }
+inline void Settings::SetPlaybackPath(const std::string& CsPlaybackPath) noexcept 
+{ _sPlaybackPath = CsPlaybackPath; }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+/*
+Tablebase.hpp --- Solved positions for small boards
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TABLEBASE_HPP_
+#define _TABLEBASE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Grid.hpp"
+
+
+/**
+ * @brief Read-only table with the perfect-play result of every position of a board configuration.
+ *
+ * Each position has one entry byte holding the result for the player to move in the 2 low bits and the
+ * number of moves until the end of the game in the 6 high bits. Entries are stored in zlib-compressed blocks,
+ * so a probe only inflates the block that holds it. On Linux the file is memory-mapped; on the Wii the
+ * blocks are read from the file on demand. Probing is not thread-safe.
+ */
+class Tablebase
+{
+public:
+    enum EResult {RESULT_UNKNOWN = 0, RESULT_LOSS, RESULT_DRAW, RESULT_WIN};   /**< Results for the player to move */
+
+    static const uint32_t SCuiBlockEntries{4096};           /**< Number of entries in a compressed block */
+    static const uint64_t SCuMaxEntries{1ull << 30};        /**< Biggest table that can be generated */
+
+
+    /* Getters */
+    uint8_t GetWidth() const noexcept;
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+
+
+    /**
+     * @brief Opens a tablebase file
+     *
+     * @param CsPath the path of the tablebase file
+     */
+    explicit Tablebase(const std::string& CsPath);
+
+    Tablebase(const Tablebase& CtablebaseOther) = delete;               /**< Copy constructor */
+    Tablebase& operator =(const Tablebase& CtablebaseOther) = delete;   /**< Copy assignment operator */
+
+    ~Tablebase() noexcept;  /**< Destructor */
+
+
+    /**
+     * @brief Gets the entry of a position
+     *
+     * @param Cgrid the position to look up, it must match the configuration of the table
+     * @return uint8_t the entry of the position, or 0 if it is not in the table
+     */
+    uint8_t Probe(const Grid& Cgrid) const;
+
+
+    /**
+     * @brief Gets the index of a position inside the table. Every column is coded as a 1 followed by
+     * one bit per marker, from the bottom up, and the columns are combined as digits of a mixed radix number
+     *
+     * @param Cgrid the position
+     * @return uint64_t the index of the position
+     */
+    static uint64_t GetIndex(const Grid& Cgrid) noexcept;
+
+    /**
+     * @brief Gets the number of entries of a table
+     *
+     * @param uyWidth the width of the grid
+     * @param uyHeight the height of the grid
+     * @return uint64_t the number of entries, or 0 if the table would be bigger than SCuMaxEntries
+     */
+    static uint64_t GetEntryCount(uint8_t uyWidth, uint8_t uyHeight) noexcept;
+
+    /**
+     * @brief Gets the name of the file of a table
+     *
+     * @param uyWidth the width of the grid
+     * @param uyHeight the height of the grid
+     * @param uyCellsToWin the number of cells in a row required to win
+     * @return std::string the file name, without directory
+     */
+    static std::string GetFileName(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin);
+
+    /**
+     * @brief Builds an entry
+     *
+     * @param CeResult the result for the player to move
+     * @param uyDepth the number of moves until the end of the game
+     * @return uint8_t the entry
+     */
+    static uint8_t MakeEntry(const EResult& CeResult, uint8_t uyDepth) noexcept;
+
+    static EResult GetResult(uint8_t uyEntry) noexcept;
+    static uint8_t GetDepth(uint8_t uyEntry) noexcept;
+
+    /**
+     * @brief Compresses and writes a table to a file
+     *
+     * @param CsPath the path of the tablebase file
+     * @param uyWidth the width of the grid
+     * @param uyHeight the height of the grid
+     * @param uyCellsToWin the number of cells in a row required to win
+     * @param CvectoruyEntries the entries of every position, indexed as GetIndex
+     */
+    static void Write(const std::string& CsPath, uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin,
+        const std::vector<uint8_t>& CvectoruyEntries);
+
+private:
+    static const uint8_t SCuyVersion{1};        /**< Version of the file format */
+    static const uint8_t SCuyHeaderSize{24};    /**< Size in bytes of the file header */
+
+    uint8_t _uyWidth;       /**< Width of the grid */
+    uint8_t _uyHeight;      /**< Height of the grid */
+    uint8_t _uyCellsToWin;  /**< Number of markers in a row required to win */
+    uint64_t _uEntryCount;  /**< Number of entries of the table */
+    std::vector<uint32_t> _vectoruiBlockOffsets;    /**< Offsets of every compressed block inside the file */
+
+#ifdef __wii__
+    std::FILE* _pFile;                          /**< The open tablebase file */
+#else
+    const uint8_t* _puyMapping;                 /**< The memory-mapped tablebase file */
+    std::size_t _uMappingSize;                  /**< Size of the memory mapping */
+#endif
+
+    mutable std::vector<uint8_t> _vectoruyBlock;    /**< The last block that was inflated */
+    mutable int64_t _lBlockCached;                  /**< Index of the last block that was inflated, or -1 */
+
+};
+
+
+inline uint8_t Tablebase::GetWidth() const noexcept { return _uyWidth; }
+inline uint8_t Tablebase::GetHeight() const noexcept { return _uyHeight; }
+inline uint8_t Tablebase::GetCellsToWin() const noexcept { return _uyCellsToWin; }
+
+inline uint8_t Tablebase::MakeEntry(const EResult& CeResult, uint8_t uyDepth) noexcept
+{ return static_cast<uint8_t>((uyDepth << 2) | CeResult); }
+inline Tablebase::EResult Tablebase::GetResult(uint8_t uyEntry) noexcept
+{ return static_cast<EResult>(uyEntry & 0x03); }
+inline uint8_t Tablebase::GetDepth(uint8_t uyEntry) noexcept { return uyEntry >> 2; }
+
+
+#endif
@@ -0,0 +1,150 @@
+/*
+Trace.hpp --- Event tracing of every thread in the Chrome trace format
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TRACE_HPP_
+#define _TRACE_HPP_
+
+#include <cstdint>
+#include <string>
+
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/** Traces a span from here to the end of the enclosing scope */
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__){name}
+#define TRACE_BEGIN(name) Trace::Begin(name)
+#define TRACE_END(name) Trace::End(name)
+#define TRACE_INSTANT(name) Trace::Instant(name)
+#define TRACE_COUNTER(name, value) Trace::Counter(name, value)
+#define TRACE_THREAD_NAME(name) Trace::SetThreadName(name)
+#define TRACE_THREAD_RELEASE() Trace::ReleaseThread()
+
+
+/**
+ * @brief Records begin, end, instant and counter events of every thread and writes them as a Chrome trace,
+ * which chrome://tracing and Perfetto open. Every thread writes to its own ring buffer without locks, so only
+ * the latest events of each thread are kept. The names must be string literals, since only the pointers
+ * are stored
+ */
+class Trace
+{
+public:
+    static const uint8_t SCuyMaxThreads{8};         /**< Threads that can be traced at the same time */
+    static const uint32_t SCuiBufferEvents{16384};  /**< Events kept per thread */
+
+
+    /**
+     * @brief Traces a span from its construction to its destruction
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Begins the span
+         *
+         * @param CpName the name of the span
+         */
+        explicit Scope(const char* CpName) noexcept;
+
+        Scope(const Scope& CscopeOther) = delete;               /**< Copy constructor */
+        Scope& operator =(const Scope& CscopeOther) = delete;   /**< Copy assignment operator */
+
+        ~Scope() noexcept;  /**< Destructor, ends the span */
+
+    private:
+        const char* _CpName;
+        bool _bBegun;       /**< Whether the span was begun, so it is ended even if tracing is disabled */
+
+    };
+
+
+    /* Getters and setters */
+    static bool IsEnabled() noexcept;
+    static void SetEnabled(bool bEnabled) noexcept;
+
+
+    Trace() = delete;
+
+
+    /**
+     * @brief Names the calling thread in the trace. No buffer is claimed while tracing is disabled, so the
+     * threads name themselves whenever they start some work
+     *
+     * @param CpName the name of the thread
+     */
+    static void SetThreadName(const char* CpName) noexcept;
+
+    /**
+     * @brief Releases the buffer of the calling thread, which must not trace anymore. Its events are still
+     * written by Flush until another thread claims the buffer
+     */
+    static void ReleaseThread() noexcept;
+
+    /**
+     * @brief Begins a span in the calling thread
+     *
+     * @param CpName the name of the span
+     */
+    static void Begin(const char* CpName) noexcept;
+
+    /**
+     * @brief Ends the last span begun in the calling thread, even if tracing has been disabled since then
+     *
+     * @param CpName the name of the span
+     */
+    static void End(const char* CpName) noexcept;
+
+    /**
+     * @brief Marks an instant in the calling thread
+     *
+     * @param CpName the name of the event
+     */
+    static void Instant(const char* CpName) noexcept;
+
+    /**
+     * @brief Records the value of a counter
+     *
+     * @param CpName the name of the counter
+     * @param lValue the value
+     */
+    static void Counter(const char* CpName, int64_t lValue) noexcept;
+
+    /**
+     * @brief Writes the events of every thread as a Chrome trace. The threads may keep tracing meanwhile,
+     * the events they overwrite while they are read are left out
+     *
+     * @param CsPath the path of the file, which is overwritten
+     */
+    static void Flush(const std::string& CsPath);
+
+private:
+    /**
+     * @brief Stores an event in the buffer of the calling thread
+     *
+     * @param cPhase the type of the event in the Chrome trace format
+     * @param CpName the name of the event
+     * @param lValue the value of a counter
+     */
+    static void Write(char cPhase, const char* CpName, int64_t lValue) noexcept;
+
+};
+
+
+#endif
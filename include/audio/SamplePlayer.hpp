@@ -114,6 +114,15 @@ public:
      */
     void SetReverseStereo(bool bReverse);
 
+
+    /**
+     * @brief Callback of SDL_mixer when a channel stops playing, run from the audio thread, so it must not
+     * call SDL_mixer
+     * 
+     * @param iChannel the channel that stopped
+     */
+    static void OnChannelFinished(int32_t iChannel) noexcept;
+
 private:
     Sample* _pSample;   /**< The sample to be played */
     int32_t _iVolume;   /**< The volume of the playback */
@@ -22,9 +22,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstdint>
 #include <limits>
-#include <queue>
 #include "Player.hpp"
+#include "Evaluation.hpp"
 #include "../Grid.hpp"
+#include "../Tablebase.hpp"
 
 
 /**
@@ -33,26 +34,41 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 class AI : public Player
 {
 public:
-    uint8_t GetSearchLimit() const noexcept;
+    uint32_t GetNodeBudget() const noexcept;
+    void SetTablebase(const Tablebase* CpTablebase) noexcept;
+    const Evaluation& GetEvaluation() const noexcept;
+    void SetEvaluation(const Evaluation& Cevaluation) noexcept;
 
     /**
      * @brief Construct a new AI player
      * 
      * @param CePlayerMark the mark assigned to this player
-     * @param uySearchLimit the depth of levels that the AI will explore
+     * @param uiNodeBudget the number of nodes that the AI will explore per move on a reference board
      */
     explicit AI(const Grid::EPlayerMark& CePlayerMark, 
-        uint8_t uySearchLimit = std::numeric_limits<uint8_t>::max());
+        uint32_t uiNodeBudget = std::numeric_limits<uint32_t>::max());
 
     /**
      * @brief Makes the AI choose a play on the board
      * 
      * @param grid the main game board
+     * @return uint8_t the column played, or the width of the board if no move was possible
      */
-    void ChooseMove(Grid& grid) const noexcept;
+    uint8_t ChooseMove(Grid& grid) const noexcept;
 
 private:
-    uint8_t _uySearchLimit; /**< The levels of depth that the AI will explore */
+    uint32_t _uiNodeBudget; /**< The number of nodes that the AI will explore per move on a reference board */
+    const Tablebase* _pTablebase;   /**< Solved positions for the current board, or null */
+    Evaluation _evaluation;         /**< Evaluation of the positions where the search stops */
+
+
+    /**
+     * @brief Looks up the best move in the tablebase
+     * 
+     * @param Cgrid the main game board
+     * @return uint8_t the best column, or the width of the board if the position is not in the tablebase
+     */
+    uint8_t ProbeTablebase(const Grid& Cgrid) const noexcept;
 
 
     /**
@@ -65,10 +81,13 @@ private:
      * @param iAlpha alpha value for the AB-Pruning algorithm
      * @param iBeta beta value for the AB-Pruning algorithm
      * @param bIsMinNode signals if the current node is a Min node
+     * @param uiNodeCount the number of nodes explored so far in the current move
+     * @param uiNodeBudget the maximum number of nodes to explore in the current move
      * @return int32_t the value of the current node
      */
     int32_t AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, 
-        uint8_t uyCurrentDepth, uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode) const noexcept;
+        uint8_t uyCurrentDepth, uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode,
+        uint32_t& uiNodeCount, uint32_t uiNodeBudget) const noexcept;
 
     /**
      * @brief Evaluation function
@@ -78,25 +97,6 @@ private:
      */
     int32_t Heuristic(const Grid& Cgrid) const noexcept;
 
-    /**
-     * @brief Helper function for the heuristic function. Used to build and keep track of free sectors, 
-     * where there is only one type of player marker and where such player still has the chance to win
-     * 
-     * @param Cgrid the main game board
-     * @param uyRow the row of the next cell to be added to the sector
-     * @param uyColumn the column of the next cell to be added to the sector
-     * @param quPlayerMarks the queue of cells that form the sector
-     * @param ePlayerMarkLast the type of the last  non-empty cell that was found
-     * @param uySamePlayerMarkCount the number of player marks of the same type that have been found in the
-     *  current sector
-     * @param uyEmptyCellCount the number of empty cells that have been found since the last non-empty cell
-     * @return int32_t the heuristic evaluation for the current sector
-     */
-    int32_t EvaluateSector(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn, 
-        std::queue<Grid::EPlayerMark>& quPlayerMarks, Grid::EPlayerMark& ePlayerMarkLast,
-        uint8_t& uySamePlayerMarkCount, uint8_t& uyEmptyCellCount) const noexcept;
-
-
     /**
      * @brief Gets the mark of the next player
      * 
@@ -105,18 +105,13 @@ private:
      */
     Grid::EPlayerMark NextPlayer(const Grid::EPlayerMark& CePlayerMark) const noexcept;
 
-
-    /**
-     * @brief Converts a player mark into a value for the evaluation function
-     * 
-     * @param CePlayerMark the player mark to convert
-     * @return int8_t a numeric representation of the player mark for the evaluation function
-     */
-    int8_t PlayerMark2Heuristic(const Grid::EPlayerMark& CePlayerMark) const noexcept;
 };
 
 
-inline uint8_t AI::GetSearchLimit() const noexcept { return _uySearchLimit; }
+inline uint32_t AI::GetNodeBudget() const noexcept { return _uiNodeBudget; }
+inline void AI::SetTablebase(const Tablebase* CpTablebase) noexcept { _pTablebase = CpTablebase; }
+inline const Evaluation& AI::GetEvaluation() const noexcept { return _evaluation; }
+inline void AI::SetEvaluation(const Evaluation& Cevaluation) noexcept { _evaluation = Cevaluation; }
 
 
 /**
@@ -0,0 +1,108 @@
+/*
+Evaluation.hpp --- Weighted-feature evaluation of positions
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _EVALUATION_HPP_
+#define _EVALUATION_HPP_
+
+#include <cstdint>
+#include <array>
+#include <string>
+
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Linear evaluation of a position as the sum of weighted features, counted for the player that
+ * evaluates minus its opponent:
+ * - Open windows of cells to win, by the number of cells still missing
+ * - Cells that would complete a window, by the player that owns them and whether their row is odd or even
+ * - Markers, by the distance of their column from the centre
+ */
+class Evaluation
+{
+public:
+    static const uint8_t SCuyMissingFeatures{8};    /**< Open windows missing 1 to 8 cells */
+    static const uint8_t SCuyThreatFeatures{4};     /**< Threats of each player on odd and even rows */
+    static const uint8_t SCuyColumnFeatures{9};     /**< Markers at 0 to 8 half-columns from the centre */
+    static const uint8_t SCuyFirstMissing{0};
+    static const uint8_t SCuyFirstThreat{SCuyFirstMissing + SCuyMissingFeatures};
+    static const uint8_t SCuyFirstColumn{SCuyFirstThreat + SCuyThreatFeatures};
+    static const uint8_t SCuyFeatureCount{SCuyFirstColumn + SCuyColumnFeatures};
+
+    typedef std::array<int32_t, SCuyFeatureCount> Weights;     /**< One weight per feature */
+    typedef std::array<int16_t, SCuyFeatureCount> Features;    /**< The value of every feature in a position */
+
+
+    /* Getters and setters */
+    const Weights& GetWeights() const noexcept;
+    void SetWeights(const Weights& CaiWeights) noexcept;
+
+
+    /**
+     * @brief Creates an evaluation with the default weights
+     */
+    Evaluation() noexcept;
+
+    /**
+     * @brief Creates an evaluation by reading a weights file
+     *
+     * @param CsFilePath the path to the binary file holding the weights
+     */
+    explicit Evaluation(const std::string& CsFilePath);
+
+
+    /**
+     * @brief Saves the weights on disk
+     *
+     * @param CsPath the path where the weights are to be stored
+     */
+    void Dump(const std::string& CsPath) const;
+
+    /**
+     * @brief Evaluates a position
+     *
+     * @param Cgrid the position to evaluate
+     * @param CePlayerMark the mark of the player that evaluates
+     * @return int32_t the evaluation, positive if the position favours the player
+     */
+    int32_t Evaluate(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark) const noexcept;
+
+    /**
+     * @brief Computes the features of a position
+     *
+     * @param Cgrid the position
+     * @param CePlayerMark the mark of the player that evaluates
+     * @param arFeatures the features of the position
+     */
+    static void ExtractFeatures(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark,
+        Features& arFeatures) noexcept;
+
+private:
+    static const Weights SCaiDefaultWeights;    /**< Weights used when no weights file is available */
+
+    Weights _aiWeights;     /**< The weight of every feature */
+
+};
+
+
+inline const Evaluation::Weights& Evaluation::GetWeights() const noexcept { return _aiWeights; }
+inline void Evaluation::SetWeights(const Weights& CaiWeights) noexcept { _aiWeights = CaiWeights; }
+
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ScriptedInput.hpp --- Input events read from a script, for automated runs
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SCRIPTEDINPUT_HPP_
+#define _SCRIPTEDINPUT_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+/**
+ * @brief Feeds input events from a script to the SDL event queue on the frames they are due, so a run can
+ * be repeated without a player. Every line of the script is a frame number followed by an action:
+ *
+ *     <frame> MOVE <x> <y>             moves the cursor
+ *     <frame> CLICK <x> <y>            moves the cursor and clicks the left mouse button
+ *     <frame> KEY <key>                presses and releases a key, given as its SDLKey value
+ *     <frame> BUTTON <which> <button>  presses and releases a joystick button
+ *
+ * Empty lines and lines starting with # are ignored
+ */
+class ScriptedInput
+{
+public:
+    ScriptedInput() noexcept;   /**< Default constructor, an empty script */
+
+    /**
+     * @brief Reads a script
+     *
+     * @param CsPath the path of the script file
+     */
+    explicit ScriptedInput(const std::string& CsPath);
+
+
+    /**
+     * @brief Pushes the events of the actions due up to a frame
+     *
+     * @param uiFrame the frame about to be processed
+     */
+    void Inject(uint32_t uiFrame) noexcept;
+
+private:
+    /**
+     * @brief Type of a scripted action
+     */
+    enum EAction {ACTION_MOVE, ACTION_CLICK, ACTION_KEY, ACTION_BUTTON};
+
+    /**
+     * @brief A scripted action
+     */
+    struct Action
+    {
+        uint32_t uiFrame;
+        EAction eAction;
+        int32_t iFirst;     /**< X coordinate, key or joystick */
+        int32_t iSecond;    /**< Y coordinate or button */
+
+        bool operator <(const Action& CactionOther) const noexcept { return uiFrame < CactionOther.uiFrame; }
+    };
+
+
+    std::vector<Action> _vectorActions;     /**< The actions, sorted by frame */
+    std::size_t _uNext;                     /**< The next action to perform */
+
+};
+
+
+#endif
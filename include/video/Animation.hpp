@@ -37,28 +37,36 @@ public:
     void SetInterval(uint16_t urInterval) noexcept;
     bool IsOscillate() const noexcept;
     void SetOscillate(bool bOscillate) noexcept;
+    bool IsLoop() const noexcept;
+    void SetLoop(bool bLoop) noexcept;
     uint8_t GetCurrentFrame() const noexcept;
     void SetCurrentFrame(int8_t yFrame);
     int8_t GetFrameIncrement() const noexcept;
     void SetFrameIncrement(int8_t yFrameIncrement) noexcept;
+    uint32_t GetTimeToNextFrame() const noexcept;
+    float GetProgress() const noexcept;
+    bool IsFinished() const noexcept;
 
 
     /**
      * @brief Construct a new Animation
      * 
      * @param uyMaxFrames the number of frames the animation has
-     * @param urInterval the time between frame changes, in milliseconds
+     * @param urInterval the time between frame changes, in milliseconds, it must not be 0
      * @param bOscillate signals if the animation goes back and forth
      * @param yFrameIncrement the distance between frames in the animation
+     * @param bLoop false to stop on the last frame instead of going back to the first one
      */
     Animation(uint8_t uyMaxFrames, uint16_t urInterval, bool bOscillate = false, 
-        int8_t yFrameIncrement = 1) noexcept;
+        int8_t yFrameIncrement = 1, bool bLoop = true) noexcept;
 
 
     /**
-     * @brief Goes to the next frame if enough time has passed
+     * @brief Moves the animation forward, going through every frame change that falls in the time given
+     *
+     * @param uiDeltaTime the time that has passed, in milliseconds
      */
-    void OnAnimate() noexcept;
+    void Advance(uint32_t uiDeltaTime) noexcept;
 
 
 private:
@@ -67,7 +75,8 @@ private:
     bool _bOscillate;           /**< Signals if the animation goes back and forth */
     int8_t _yCurrentFrame;      /**< The current frame that the animation is in */
     int8_t _yFrameIncrement;    /**< The distance between frames in the animation */
-    uint32_t _uiOldTime;        /**< The last time the animation changed frames */
+    bool _bLoop;                /**< Signals if the animation goes back to the first frame after the last one */
+    uint32_t _uiElapsed;        /**< The time spent in the current frame, in milliseconds */
 
 };
 
@@ -78,10 +87,20 @@ inline uint16_t Animation::GetInterval() const noexcept { return _urInterval; }
 inline void Animation::SetInterval(uint16_t urInterval) noexcept { _urInterval = urInterval; }
 inline bool Animation::IsOscillate() const noexcept { return _bOscillate; }
 inline void Animation::SetOscillate(bool bOscillate) noexcept { _bOscillate = bOscillate; }
+inline bool Animation::IsLoop() const noexcept { return _bLoop; }
+inline void Animation::SetLoop(bool bLoop) noexcept { _bLoop = bLoop; }
 inline uint8_t Animation::GetCurrentFrame() const noexcept { return _yCurrentFrame; }
 inline int8_t Animation::GetFrameIncrement() const noexcept { return _yFrameIncrement; }
 inline void Animation::SetFrameIncrement(int8_t yFrameIncrement) noexcept 
 { _yFrameIncrement = yFrameIncrement; }
+inline uint32_t Animation::GetTimeToNextFrame() const noexcept
+{ return (_uiElapsed < _urInterval ? _urInterval - _uiElapsed : 0); }
+inline float Animation::GetProgress() const noexcept { return static_cast<float>(_uiElapsed) / _urInterval; }
+inline bool Animation::IsFinished() const noexcept
+{ 
+    return (!_bLoop && !_bOscillate && (_yCurrentFrame + _yFrameIncrement >= _uyMaxFrames || 
+        _yCurrentFrame + _yFrameIncrement < 0)); 
+}
 
  
 #endif
\ No newline at end of file
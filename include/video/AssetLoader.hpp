@@ -0,0 +1,154 @@
+/*
+AssetLoader.hpp --- Background decoding and scaling of textures
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ASSETLOADER_HPP_
+#define _ASSETLOADER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+#include "TextureCache.hpp"
+#include "../ResourceRegistry.hpp"
+
+
+/**
+ * @brief Decodes and scales textures in a worker thread. The main thread queues the textures, then collects
+ * the finished ones every frame, converting them to the format of the display, which SDL only allows from
+ * the thread that set the video mode. Textures found in the cache skip both the decoding and the conversion,
+ * the rest are written to the cache by the worker once no texture is waiting to be decoded
+ */
+class AssetLoader
+{
+public:
+    typedef ResourceRegistry<Surface>::Handle SurfaceHandle;
+
+
+    /**
+     * @brief A texture to load
+     */
+    struct Request
+    {
+        SurfaceHandle handle;                   /**< The slot of the registry that receives the texture */
+        std::vector<std::string> vectorsPaths;  /**< The paths to try, in order */
+        uint16_t urFitWidth;    /**< Width to fill with an integer upscale, 0 to keep the size */
+        uint16_t urFitHeight;   /**< Height to fill with an integer upscale, 0 to keep the size */
+    };
+
+
+    /* Getters */
+    uint32_t GetQueued() const noexcept;
+    uint32_t GetCompleted() const noexcept;
+    bool IsDone() const noexcept;
+
+
+    /**
+     * @brief Constructor
+     *
+     * @param CpTextureCache the cache of converted textures, nullptr to always decode them
+     */
+    explicit AssetLoader(const TextureCache* CpTextureCache = nullptr);
+
+    AssetLoader(const AssetLoader& CassetLoaderOther) = delete;             /**< Copy constructor */
+    AssetLoader& operator =(const AssetLoader& CassetLoaderOther) = delete; /**< Copy assignment operator */
+
+    ~AssetLoader() noexcept;    /**< Destructor */
+
+
+    /**
+     * @brief Queues a texture, starting the worker thread the first time
+     *
+     * @param Crequest the texture to load
+     */
+    void Queue(const Request& Crequest);
+
+    /**
+     * @brief Converts the textures finished by the worker and stores them, from the main thread
+     *
+     * @param registrySurfaces the registry that receives the textures
+     */
+    void Collect(ResourceRegistry<Surface>& registrySurfaces);
+
+    /**
+     * @brief Stops the worker thread and drops every pending texture, which must be done before SDL_Quit
+     */
+    void Stop() noexcept;
+
+private:
+    /**
+     * @brief A texture decoded by the worker
+     */
+    struct Result
+    {
+        SurfaceHandle handle;   /**< The slot of the registry that receives the texture */
+        Surface* pSurface;      /**< The texture, nullptr if it could not be loaded */
+        std::string sError;     /**< Why the texture could not be loaded */
+        std::string sPath;      /**< The image file the texture came from */
+        uint16_t urFitWidth;    /**< Width the texture was scaled to fill */
+        uint16_t urFitHeight;   /**< Height the texture was scaled to fill */
+        bool bConverted;        /**< The texture came from the cache, already in the format of the display */
+    };
+
+
+    SDL_Thread* _pSdlThread;    /**< The worker thread */
+    SDL_mutex* _pSdlMutex;      /**< Guards the queues */
+    SDL_sem* _pSdlSemaphore;    /**< Counts the requests and entries waiting for the worker */
+    bool _bStop;                /**< Signals the worker to stop */
+    const TextureCache* _pTextureCache;     /**< Converted textures of earlier runs, or null */
+    SDL_PixelFormat _sdlPixelFormatDisplay; /**< Format of the display, read by the worker */
+    SDL_PixelFormat _sdlPixelFormatDisplayAlpha;    /**< Format of the display for textures with alpha */
+
+    std::deque<Request> _dequeRequests; /**< The textures waiting for the worker */
+    std::deque<TextureCache::Entry> _dequeEntries;  /**< The converted textures waiting to be cached */
+    std::vector<Result> _vectorResults; /**< The textures waiting for the main thread */
+    uint32_t _uiQueued;         /**< Textures queued since the last time every texture was collected */
+    uint32_t _uiCompleted;      /**< Textures collected since the last time every texture was collected */
+
+
+    /**
+     * @brief Loop of the worker thread
+     *
+     * @param pData the loader
+     * @return int32_t error code of the thread
+     */
+    static int32_t SDLCALL Run(void* pData);
+
+    /**
+     * @brief Loads a texture from the cache, or else decodes and scales it, from the worker thread
+     *
+     * @param Crequest the texture to load
+     * @param result receives the texture, in the format of the display only if it came from the cache
+     */
+    void Decode(const Request& Crequest, Result& result) const;
+
+};
+
+
+inline uint32_t AssetLoader::GetQueued() const noexcept { return _uiQueued; }
+inline uint32_t AssetLoader::GetCompleted() const noexcept { return _uiCompleted; }
+inline bool AssetLoader::IsDone() const noexcept { return _uiCompleted == _uiQueued; }
+
+
+#endif
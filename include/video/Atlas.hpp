@@ -0,0 +1,139 @@
+/*
+Atlas.hpp --- Texture atlas with named sprites
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ATLAS_HPP_
+#define _ATLAS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+#include "RenderCommandList.hpp"
+
+
+/**
+ * @brief One surface holding many sprites, each one found by its name. The atlas is built offline by the
+ * atlas packer, which writes the image and an index with one "name x y width height" line per sprite, followed
+ * by the file the sprite was packed from and its position there when the packer knows them
+ */
+class Atlas
+{
+public:
+    /**
+     * @brief Position of a sprite in the atlas that resolved it
+     */
+    struct Sprite
+    {
+        uint16_t urIndex;   /**< The index of the sprite */
+    };
+
+
+    /* Getters */
+    Surface& GetSurface() noexcept;
+    uint16_t GetSpriteCount() const noexcept;
+
+
+    /**
+     * @brief Loads an atlas from the filesystem
+     *
+     * @param CsImagePath the path to the image of the atlas
+     * @param CsIndexPath the path to the index of the atlas
+     */
+    Atlas(const std::string& CsImagePath, const std::string& CsIndexPath);
+
+    Atlas(const Atlas& CatlasOther) = delete;               /**< Copy constructor */
+    Atlas& operator =(const Atlas& CatlasOther) = delete;   /**< Copy assignment operator */
+
+
+    /**
+     * @brief Finds a sprite by its name, which is meant to be done once after loading the atlas
+     *
+     * @param CsName the name of the sprite
+     * @return Sprite the sprite, valid for the lifetime of the atlas
+     */
+    Sprite Resolve(const std::string& CsName) const;
+
+    /**
+     * @brief Gets the rectangle of a sprite inside the atlas
+     *
+     * @param sprite the sprite
+     * @return const SDL_Rect& the rectangle of the sprite
+     */
+    const SDL_Rect& GetRect(Sprite sprite) const noexcept;
+
+    /**
+     * @brief Gets the name of the file a sprite was packed from
+     *
+     * @param sprite the sprite
+     * @return const std::string& the name of the file, empty if the index does not tell
+     */
+    const std::string& GetFile(Sprite sprite) const noexcept;
+
+    /**
+     * @brief Overwrites a sprite with the same rectangle of another copy of the file it was packed from
+     *
+     * @param sprite the sprite
+     * @param surfaceFile the other copy of the file, in the format of the atlas, which loses its blending
+     * @return true if the sprite was overwritten
+     * @return false if the file is too small to hold the sprite where it was packed from
+     */
+    bool Replace(Sprite sprite, Surface& surfaceFile);
+
+    /**
+     * @brief Blits a sprite into another surface
+     *
+     * @param sprite the sprite
+     * @param surfaceDestination the destination surface
+     * @param rDestinationX the X component of the top left coordinate where the sprite will be blitted
+     * @param rDestinationY the Y component of the top left coordinate where the sprite will be blitted
+     */
+    void OnDraw(Sprite sprite, Surface& surfaceDestination, int16_t rDestinationX = 0,
+        int16_t rDestinationY = 0);
+
+    /**
+     * @brief Records a blit of a sprite on the display
+     *
+     * @param sprite the sprite
+     * @param renderCommandList the list of the frame
+     * @param rDestinationX the X component of the top left coordinate where the sprite will be blitted
+     * @param rDestinationY the Y component of the top left coordinate where the sprite will be blitted
+     */
+    void OnDraw(Sprite sprite, RenderCommandList& renderCommandList, int16_t rDestinationX = 0,
+        int16_t rDestinationY = 0) const;
+
+private:
+    Surface _surfaceAtlas;                                  /**< The image holding every sprite */
+    std::vector<SDL_Rect> _vectorSdlRects;                  /**< The rectangle of every sprite */
+    std::vector<std::string> _vectorsFiles;                 /**< The file every sprite was packed from */
+    std::vector<SDL_Rect> _vectorSdlRectsFiles;             /**< The rectangle of every sprite in its file */
+    std::unordered_map<std::string, uint16_t> _htSprites;   /**< The index of every sprite name */
+
+};
+
+
+inline Surface& Atlas::GetSurface() noexcept { return _surfaceAtlas; }
+inline uint16_t Atlas::GetSpriteCount() const noexcept { return static_cast<uint16_t>(_vectorSdlRects.size()); }
+inline const SDL_Rect& Atlas::GetRect(Sprite sprite) const noexcept { return _vectorSdlRects[sprite.urIndex]; }
+inline const std::string& Atlas::GetFile(Sprite sprite) const noexcept { return _vectorsFiles[sprite.urIndex]; }
+
+
+#endif
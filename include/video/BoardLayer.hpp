@@ -0,0 +1,175 @@
+/*
+BoardLayer.hpp --- Pre-composited surface of the board
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BOARDLAYER_HPP_
+#define _BOARDLAYER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+#include <SDL_mutex.h>
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+#include "RenderCommandList.hpp"
+#include "DirtyRects.hpp"
+#include "PieceDrop.hpp"
+#include "Timeline.hpp"
+#include "../Grid.hpp"
+#include "../GridListener.hpp"
+
+
+/**
+ * @brief Keeps the background and every cell of the board composited in one surface, so a frame only needs
+ * one blit to draw the board. The moves are notified by the grid and they are composited on the next draw.
+ * Inside a game the new markers fall down their column first, drawn over the board, and they are composited
+ * once they reach their cell
+ */
+class BoardLayer : public GridListener
+{
+public:
+    /**
+     * @brief Construct a new Board Layer
+     *
+     * @param timeline the timeline that plays the falling markers
+     */
+    explicit BoardLayer(Timeline& timeline);
+
+    BoardLayer(const BoardLayer& CboardLayerOther) = delete;                /**< Copy constructor */
+    BoardLayer& operator =(const BoardLayer& CboardLayerOther) = delete;    /**< Copy assignment operator */
+
+    virtual ~BoardLayer() noexcept override;    /**< Destructor */
+
+
+    /**
+     * @brief Sets the surfaces the board is made of, which forces the board to be composited again
+     *
+     * @param pSurfaceBackground the background of the screen
+     * @param pSurfaceEmptyCell an empty cell
+     * @param pSurfaceMarker1 a cell with a marker of the first player
+     * @param pSurfaceMarker2 a cell with a marker of the second player
+     * @param rInitialX the X coordinate of the top left cell
+     * @param rInitialY the Y coordinate of the top left cell
+     */
+    void SetSurfaces(Surface* pSurfaceBackground, Surface* pSurfaceEmptyCell, Surface* pSurfaceMarker1,
+        Surface* pSurfaceMarker2, int16_t rInitialX, int16_t rInitialY);
+
+    /**
+     * @brief Handles a marker being placed on the grid
+     *
+     * @param Cgrid the grid that changed
+     * @param uyRow the row of the new marker
+     * @param uyColumn the column of the new marker
+     */
+    virtual void OnMove(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn) override;
+
+    /**
+     * @brief Handles the grid being replaced by another one
+     *
+     * @param Cgrid the grid that changed
+     */
+    virtual void OnReset(const Grid& Cgrid) override;
+
+    /**
+     * @brief Brings the board up to date
+     *
+     * @param Cgrid the grid that is drawn
+     * @param bDropMarkers true to let the new markers fall before they are composited, false to composite
+     * every marker at once, the falling ones included
+     * @return Surface* the composited board, nullptr if the surfaces were not set
+     */
+    Surface* Update(const Grid& Cgrid, bool bDropMarkers = false);
+
+    /**
+     * @brief Marks the regions of the board changed by the falling markers, which are the columns they fall
+     * down, from the last time they were marked
+     *
+     * @param dirtyRects the regions of the display to redraw
+     */
+    void MarkChanged(DirtyRects& dirtyRects);
+
+    /**
+     * @brief Brings the board up to date, letting the new markers fall, and records a blit of it and of the
+     * falling markers
+     *
+     * @param Cgrid the grid that is drawn
+     * @param renderCommandList the list of the frame
+     */
+    void OnDraw(const Grid& Cgrid, RenderCommandList& renderCommandList);
+
+    /**
+     * @brief Gets the region of the screen covered by a cell
+     *
+     * @param uyRow the row of the cell
+     * @param uyColumn the column of the cell
+     * @return SDL_Rect the region of the cell
+     */
+    SDL_Rect GetCellRect(uint8_t uyRow, uint8_t uyColumn) const noexcept;
+
+    /**
+     * @brief Draws one cell as an empty cell or with its marker, straight on a surface
+     *
+     * @param Cgrid the grid that is drawn
+     * @param uyRow the row of the cell
+     * @param uyColumn the column of the cell
+     * @param bShowMarker false to draw the cell empty whatever it holds
+     * @param surfaceDestination the destination surface
+     */
+    void DrawCell(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn, bool bShowMarker,
+        Surface& surfaceDestination) const;
+
+private:
+    Surface* _pSurfaceBoard;        /**< The composited board */
+    Surface* _pSurfaceBackground;   /**< The background of the screen */
+    Surface* _pSurfaceEmptyCell;    /**< An empty cell */
+    Surface* _pSurfaceMarker1;      /**< A cell with a marker of the first player */
+    Surface* _pSurfaceMarker2;      /**< A cell with a marker of the second player */
+    int16_t _rInitialX, _rInitialY; /**< The coordinates of the top left cell */
+    Timeline& _timeline;        /**< Plays the falling markers, it must be cleared before the layer is freed */
+    std::vector<PieceDrop*> _vectorpPieceDrops; /**< The markers falling down their column */
+    std::vector<SDL_Rect> _vectorSdlRectsLanded;    /**< Columns of the markers composited since last marked */
+
+    SDL_mutex* _pSdlMutex;      /**< Guards the changes notified by the grid */
+    std::vector<std::pair<uint8_t, uint8_t> > _vectorpairPendingCells;  /**< Cells changed since the last draw */
+    bool _bIsStale;             /**< The whole board must be composited again */
+
+
+    /**
+     * @brief Gets the region of the screen a marker falls through, from the top of the board to its cell
+     *
+     * @param uyRow the row of the cell of the marker
+     * @param uyColumn the column of the marker
+     * @return SDL_Rect the region of the column
+     */
+    SDL_Rect GetColumnRect(uint8_t uyRow, uint8_t uyColumn) const noexcept;
+
+    /**
+     * @brief Composites the falling markers that reached their cell, or all of them
+     *
+     * @param Cgrid the grid that is drawn
+     * @param bOnlyFinished false to composite every falling marker at once
+     * @param yColumn the only column whose marker is composited, -1 for every column
+     */
+    void Land(const Grid& Cgrid, bool bOnlyFinished, int8_t yColumn = -1);
+
+};
+
+
+#endif
@@ -0,0 +1,113 @@
+/*
+CursorOverlay.hpp --- Pixels saved under the cursor
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CURSOROVERLAY_HPP_
+#define _CURSOROVERLAY_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <array>
+
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+#include "RenderCommandList.hpp"
+
+
+/**
+ * @brief Draws the cursor the way a hardware cursor would, over whatever is on the display: the pixels under
+ * the cursor are saved before it is drawn and given back before it moves, so moving the cursor over a screen
+ * that does not change costs a few small blits instead of redrawing the regions it crosses. A double buffered
+ * display keeps one copy of the pixels for each buffer, as each of them shows the cursor where it was drawn
+ * the last time that buffer was drawn
+ */
+class CursorOverlay
+{
+public:
+    CursorOverlay() noexcept;   /**< Default constructor */
+
+    CursorOverlay(const CursorOverlay& CcursorOverlayOther) = delete;               /**< Copy constructor */
+    CursorOverlay& operator =(const CursorOverlay& CcursorOverlayOther) = delete;
+        /**< Copy assignment operator */
+
+    ~CursorOverlay() noexcept;  /**< Destructor */
+
+
+    /**
+     * @brief Records giving back the pixels under the cursor drawn the last time on the buffer being drawn,
+     * which must be done before anything else is drawn in the frame
+     *
+     * @param renderCommandList the list of the frame
+     * @param CsurfaceDisplay the display surface
+     * @param vectorSdlRectsPresent the regions sent to the screen, which receive the region given back
+     */
+    void Restore(RenderCommandList& renderCommandList, const Surface& CsurfaceDisplay,
+        std::vector<SDL_Rect>& vectorSdlRectsPresent);
+
+    /**
+     * @brief Records saving the pixels under the cursor, which must be done after the rest of the frame is
+     * drawn and right before the cursor
+     *
+     * @param renderCommandList the list of the frame
+     * @param CsdlRectCursor the region where the cursor is drawn
+     * @param CsurfaceDisplay the display surface, whose format the copy takes
+     * @param vectorSdlRectsPresent the regions sent to the screen, which receive the region of the cursor
+     */
+    void Save(RenderCommandList& renderCommandList, const SDL_Rect& CsdlRectCursor,
+        const Surface& CsurfaceDisplay, std::vector<SDL_Rect>& vectorSdlRectsPresent);
+
+    /**
+     * @brief Starts a new frame
+     *
+     * @param CsurfaceDisplay the display surface
+     * @param bIsPresented whether the frame was sent to the screen, which swaps the buffers of a double
+     * buffered display
+     */
+    void EndFrame(const Surface& CsurfaceDisplay, bool bIsPresented) noexcept;
+
+private:
+    /**
+     * @brief The pixels under the cursor on one buffer of the display
+     */
+    struct Saved
+    {
+        Surface* pSurface;  /**< The copy of the pixels, nullptr before the first save */
+        SDL_Rect sdlRect;   /**< The region of the display the copy was taken from */
+        bool bIsSaved;      /**< Whether the buffer has the cursor drawn over the copy */
+    };
+
+
+    std::array<Saved, 2> _asaveds;  /**< The copies of each buffer */
+    uint8_t _uyBuffer;              /**< The buffer of the display being drawn */
+
+
+    /**
+     * @brief Cuts a region to the display
+     *
+     * @param CsdlRect the region
+     * @param CsurfaceDisplay the display surface
+     * @param vectorSdlRects receives the region if any of it is on the display
+     */
+    static void AddClipped(const SDL_Rect& CsdlRect, const Surface& CsurfaceDisplay,
+        std::vector<SDL_Rect>& vectorSdlRects);
+
+};
+
+
+#endif
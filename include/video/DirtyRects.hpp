@@ -0,0 +1,94 @@
+/*
+DirtyRects.hpp --- Tracking of the display regions that changed between frames
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _DIRTYRECTS_HPP_
+#define _DIRTYRECTS_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+
+
+/**
+ * @brief Collects the regions of the display that must be redrawn in the current frame. Overlapping regions
+ * are merged, and too many of them fall back to a full redraw. When the display is double buffered the back
+ * buffer holds the frame before the last one, so the regions of the previous frame are redrawn as well
+ */
+class DirtyRects
+{
+public:
+    static const uint8_t SCuyMaxRects{8};   /**< Regions above which the whole display is redrawn */
+
+
+    /* Getters */
+    const std::vector<SDL_Rect>& GetRects() const noexcept;
+
+
+    DirtyRects() noexcept;  /**< Default constructor */
+
+
+    /**
+     * @brief Marks a region of the display as changed
+     *
+     * @param iX the X coordinate of the top left corner of the region
+     * @param iY the Y coordinate of the top left corner of the region
+     * @param iWidth the width of the region
+     * @param iHeight the height of the region
+     */
+    void Add(int32_t iX, int32_t iY, int32_t iWidth, int32_t iHeight);
+
+    /**
+     * @brief Marks the whole display as changed
+     */
+    void Invalidate() noexcept;
+
+    /**
+     * @brief Builds the list of regions to redraw in this frame
+     *
+     * @param CsurfaceDisplay the display surface
+     */
+    void Prepare(const Surface& CsurfaceDisplay);
+
+    /**
+     * @brief Starts a new frame, once the regions of this one were recorded to be sent to the screen
+     */
+    void EndFrame() noexcept;
+
+private:
+    std::vector<SDL_Rect> _vectorSdlRectsMarked;    /**< The regions marked in this frame */
+    std::vector<SDL_Rect> _vectorSdlRectsPrevious;  /**< The regions marked in the previous frame */
+    std::vector<SDL_Rect> _vectorSdlRects;          /**< The regions to redraw in this frame */
+    bool _bIsFull;              /**< The whole display was marked in this frame */
+    bool _bWasFull;             /**< The whole display was marked in the previous frame */
+
+
+    /**
+     * @brief Merges every pair of overlapping regions into their bounding box until none overlap
+     */
+    void Merge() noexcept;
+
+};
+
+
+inline const std::vector<SDL_Rect>& DirtyRects::GetRects() const noexcept { return _vectorSdlRects; }
+
+
+#endif
@@ -0,0 +1,73 @@
+/*
+FrameScheduler.hpp --- Frame pacing of the main loop
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRAMESCHEDULER_HPP_
+#define _FRAMESCHEDULER_HPP_
+
+#include <cstdint>
+
+
+/**
+ * @brief Paces the main loop to a target frame rate. Deadlines are counted from the start of the run of
+ * frames, so the rounding of the period to milliseconds never drifts, and a frame that misses its deadline
+ * starts a new run instead of rushing the following frames to catch up
+ */
+class FrameScheduler
+{
+public:
+    /* Getters */
+    uint16_t GetTargetFPS() const noexcept;
+    uint32_t GetOverruns() const noexcept;
+    uint32_t GetLastLateness() const noexcept;
+
+
+    /**
+     * @brief Constructor
+     *
+     * @param urTargetFPS the frames per second to pace the loop to, it must not be 0
+     */
+    explicit FrameScheduler(uint16_t urTargetFPS) noexcept;
+
+
+    /**
+     * @brief Sleeps until the deadline of the next frame, or counts an overrun if it has already passed
+     */
+    void WaitForNextFrame() noexcept;
+
+    /**
+     * @brief Starts a new run of frames from now, after the loop has been blocked waiting for events
+     */
+    void Resync() noexcept;
+
+private:
+    uint16_t _urTargetFPS;      /**< Frames per second the loop is paced to */
+    uint32_t _uiRunStart;       /**< Time in milliseconds when the current run of frames started */
+    uint32_t _uiRunFrames;      /**< Frames finished in the current run */
+    uint32_t _uiOverruns;       /**< Frames that missed their deadline */
+    uint32_t _uiLastLateness;   /**< Milliseconds the last overrun missed its deadline by */
+
+};
+
+
+inline uint16_t FrameScheduler::GetTargetFPS() const noexcept { return _urTargetFPS; }
+inline uint32_t FrameScheduler::GetOverruns() const noexcept { return _uiOverruns; }
+inline uint32_t FrameScheduler::GetLastLateness() const noexcept { return _uiLastLateness; }
+
+
+#endif
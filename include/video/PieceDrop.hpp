@@ -0,0 +1,83 @@
+/*
+PieceDrop.hpp --- Trajectory of a marker falling down a column
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PIECEDROP_HPP_
+#define _PIECEDROP_HPP_
+
+#include <cstdint>
+#include <array>
+
+#include "Animation.hpp"
+
+
+/**
+ * @brief A marker falling from the top of its column to its cell, bouncing once or twice before it rests.
+ * The position of every frame is worked out when the drop starts and kept in a table of fixed size, so
+ * drawing a frame only reads the table. The frames are stepped by an animation that stops on the last one,
+ * which is the cell of the marker
+ */
+class PieceDrop
+{
+public:
+    static const uint8_t SCuyMaxFrames{48};     /**< Frames of the longest drop, the last one is the cell */
+    static const uint16_t SCurFrameInterval{16};    /**< The time between frames, in milliseconds */
+
+
+    /* Getters */
+    uint8_t GetRow() const noexcept;
+    uint8_t GetColumn() const noexcept;
+    uint8_t GetFrames() const noexcept;
+    int16_t GetY() const noexcept;
+    Animation& GetAnimation() noexcept;
+    bool IsFinished() const noexcept;
+
+
+    /**
+     * @brief Construct a new Piece Drop, working out its trajectory
+     *
+     * @param uyRow the row of the cell of the marker
+     * @param uyColumn the column of the marker
+     * @param rStartY the Y coordinate the marker falls from
+     * @param rEndY the Y coordinate of the cell of the marker
+     * @param urCellHeight the height of a cell, which sets the gravity so every board falls alike
+     */
+    PieceDrop(uint8_t uyRow, uint8_t uyColumn, int16_t rStartY, int16_t rEndY, uint16_t urCellHeight) noexcept;
+
+    PieceDrop(const PieceDrop& CpieceDropOther) = delete;               /**< Copy constructor */
+    PieceDrop& operator =(const PieceDrop& CpieceDropOther) = delete;   /**< Copy assignment operator */
+
+private:
+    uint8_t _uyRow;             /**< The row of the cell of the marker */
+    uint8_t _uyColumn;          /**< The column of the marker */
+    uint8_t _uyFrames;          /**< The frames of the table in use */
+    std::array<int16_t, SCuyMaxFrames> _arY;    /**< The Y coordinate of the marker in every frame */
+    Animation _animation;       /**< Steps through the table, played by the timeline */
+
+};
+
+
+inline uint8_t PieceDrop::GetRow() const noexcept { return _uyRow; }
+inline uint8_t PieceDrop::GetColumn() const noexcept { return _uyColumn; }
+inline uint8_t PieceDrop::GetFrames() const noexcept { return _uyFrames; }
+inline int16_t PieceDrop::GetY() const noexcept { return _arY[_animation.GetCurrentFrame()]; }
+inline Animation& PieceDrop::GetAnimation() noexcept { return _animation; }
+inline bool PieceDrop::IsFinished() const noexcept { return _animation.IsFinished(); }
+
+
+#endif
@@ -0,0 +1,120 @@
+/*
+PixelBlend.hpp --- Blending of premultiplied-alpha pixel buffers
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PIXELBLEND_HPP_
+#define _PIXELBLEND_HPP_
+
+#include <cstdint>
+
+
+/**
+ * @brief Blends 32-bit sources whose colour components were multiplied by their alpha beforehand, so every
+ * destination component is the source one plus the destination one scaled by the inverse alpha, the same
+ * operation for the four bytes of a pixel whatever their order. Fully transparent and fully opaque pixels
+ * are skipped and copied, and the 32-bit blend uses SSE2 or NEON when the target has them. The alpha is
+ * found by its shift inside the pixel value, which is the only part of the pixel format needed
+ */
+class PixelBlend
+{
+public:
+    PixelBlend() = delete;  /**< Only static functions */
+
+
+    /**
+     * @brief Multiplies the colour components of a 32-bit buffer by their alpha, in place
+     *
+     * @param pPixels the first pixel of the buffer
+     * @param uiPitch the length in bytes of a row
+     * @param uiWidth the width in pixels of the buffer
+     * @param uiHeight the height in pixels of the buffer
+     * @param uyAlphaShift the shift of the alpha component inside the pixel value
+     */
+    static void Premultiply(void* pPixels, uint32_t uiPitch, uint32_t uiWidth, uint32_t uiHeight,
+        uint8_t uyAlphaShift) noexcept;
+
+    /**
+     * @brief Blends a premultiplied 32-bit buffer over a 32-bit buffer with the same colour components, with
+     * the fastest path available
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the blended region
+     * @param uiHeight the height in pixels of the blended region
+     * @param pDestination the first pixel of the destination
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     */
+    static void BlendOver(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+        void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift) noexcept;
+
+    /**
+     * @brief Blends a premultiplied 32-bit buffer over a 32-bit buffer without vector instructions, which
+     * gives the same result as BlendOver
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the blended region
+     * @param uiHeight the height in pixels of the blended region
+     * @param pDestination the first pixel of the destination
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     */
+    static void BlendOverScalar(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth,
+        uint32_t uiHeight, void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift) noexcept;
+
+    /**
+     * @brief Blends a premultiplied 32-bit buffer over a 16-bit RGB565 buffer, widening every destination
+     * component to 8 bits and dropping the low bits of the result, as SDL does
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the blended region
+     * @param uiHeight the height in pixels of the blended region
+     * @param pDestination the first pixel of the destination
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     * @param uyRedShift the shift of the red component inside the source pixel value
+     * @param uyGreenShift the shift of the green component inside the source pixel value
+     * @param uyBlueShift the shift of the blue component inside the source pixel value
+     */
+    static void BlendOver565(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+        void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift, uint8_t uyRedShift,
+        uint8_t uyGreenShift, uint8_t uyBlueShift) noexcept;
+
+    /**
+     * @brief Blends one premultiplied component over another one
+     *
+     * @param uySource the source component, already multiplied by its alpha
+     * @param uyDestination the destination component
+     * @param uyAlpha the alpha of the source
+     * @return uint8_t the blended component
+     */
+    static uint8_t BlendComponent(uint8_t uySource, uint8_t uyDestination, uint8_t uyAlpha) noexcept;
+
+    /**
+     * @brief Gets the name of the vector instructions used by BlendOver
+     *
+     * @return const char* "SSE2", "NEON" or "scalar"
+     */
+    static const char* GetPath() noexcept;
+
+};
+
+
+#endif
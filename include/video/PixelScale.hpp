@@ -0,0 +1,84 @@
+/*
+PixelScale.hpp --- Nearest-neighbour scaling of raw pixel buffers
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PIXELSCALE_HPP_
+#define _PIXELSCALE_HPP_
+
+#include <cstdint>
+
+
+/**
+ * @brief Upscales pixel buffers by integer factors, copying every pixel into a block of the destination.
+ * Each source row is expanded once, with SSE2 or NEON when the target has them and they beat the scalar code
+ * at that pixel size and factor, and then copied into the remaining rows of its block. No pixel format is
+ * needed since the pixel values are copied as they are
+ */
+class PixelScale
+{
+public:
+    PixelScale() = delete;  /**< Only static functions */
+
+
+    /**
+     * @brief Upscales a buffer with the fastest path available
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the source
+     * @param uiHeight the height in pixels of the source
+     * @param pDestination the first pixel of the destination, of at least uiWidth * urScaleX by
+     * uiHeight * urScaleY pixels
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyBytesPerPixel the size of a pixel, from 1 to 4 bytes
+     * @param urScaleX the scale factor for the X axis
+     * @param urScaleY the scale factor for the Y axis
+     */
+    static void ScaleNearest(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+        void* pDestination, uint32_t uiDestinationPitch, uint8_t uyBytesPerPixel, uint16_t urScaleX,
+        uint16_t urScaleY);
+
+    /**
+     * @brief Upscales a buffer without vector instructions, which gives the same result as ScaleNearest
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the source
+     * @param uiHeight the height in pixels of the source
+     * @param pDestination the first pixel of the destination, of at least uiWidth * urScaleX by
+     * uiHeight * urScaleY pixels
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyBytesPerPixel the size of a pixel, from 1 to 4 bytes
+     * @param urScaleX the scale factor for the X axis
+     * @param urScaleY the scale factor for the Y axis
+     */
+    static void ScaleNearestScalar(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth,
+        uint32_t uiHeight, void* pDestination, uint32_t uiDestinationPitch, uint8_t uyBytesPerPixel,
+        uint16_t urScaleX, uint16_t urScaleY);
+
+    /**
+     * @brief Gets the name of the vector instructions used by ScaleNearest
+     *
+     * @return const char* "SSE2", "NEON" or "scalar"
+     */
+    static const char* GetPath() noexcept;
+
+};
+
+
+#endif
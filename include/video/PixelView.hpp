@@ -0,0 +1,444 @@
+/*
+PixelView.hpp --- Locked, typed access to the pixels of a surface
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PIXELVIEW_HPP_
+#define _PIXELVIEW_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <SDL_video.h>
+#include <SDL_endian.h>
+
+#include "Surface.hpp"
+
+
+/**
+ * @brief A pixel of a 24-bit surface, which has no integer type of its own
+ */
+struct Pixel24
+{
+    uint8_t auyBytes[3];    /**< The bytes of the pixel, in the byte order of the machine */
+};
+
+static_assert(sizeof(Pixel24) == 3, "24-bit pixels must be packed");
+
+
+/**
+ * @brief Converts the pixels stored in a surface from and into their 32-bit values
+ *
+ * @tparam T the type of a pixel: uint8_t, uint16_t, Pixel24 or uint32_t
+ */
+template <typename T>
+struct PixelTraits
+{
+    static constexpr uint8_t SCuyBytesPerPixel{sizeof(T)};  /**< The size of a pixel */
+
+    static uint32_t Load(T pixel) noexcept { return pixel; }                                /**< Pixel value */
+    static T Store(uint32_t uiPixelValue) noexcept { return static_cast<T>(uiPixelValue); } /**< Make pixel */
+};
+
+
+/**
+ * @brief Converts 24-bit pixels, whose bytes are laid out in the byte order of the machine
+ */
+template <>
+struct PixelTraits<Pixel24>
+{
+    static constexpr uint8_t SCuyBytesPerPixel{3};  /**< The size of a pixel */
+
+    /**
+     * @brief Gets the value of a pixel
+     *
+     * @param pixel the pixel
+     * @return uint32_t the value of the pixel
+     */
+    static uint32_t Load(Pixel24 pixel) noexcept
+    {
+        if constexpr (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+            return pixel.auyBytes[0] << 16 | pixel.auyBytes[1] << 8 | pixel.auyBytes[2];
+        else return pixel.auyBytes[0] | pixel.auyBytes[1] << 8 | pixel.auyBytes[2] << 16;
+    }
+
+    /**
+     * @brief Makes a pixel from its value
+     *
+     * @param uiPixelValue the value of the pixel
+     * @return Pixel24 the pixel
+     */
+    static Pixel24 Store(uint32_t uiPixelValue) noexcept
+    {
+        if constexpr (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+            return Pixel24{{static_cast<uint8_t>(uiPixelValue >> 16), static_cast<uint8_t>(uiPixelValue >> 8),
+                static_cast<uint8_t>(uiPixelValue)}};
+        else return Pixel24{{static_cast<uint8_t>(uiPixelValue), static_cast<uint8_t>(uiPixelValue >> 8),
+            static_cast<uint8_t>(uiPixelValue >> 16)}};
+    }
+};
+
+
+/**
+ * @brief Keeps a surface locked for as long as it lives and hands out its rows as spans of pixels of one
+ * format. The format is fixed at compile time, so the bulk operations pay the lock and the switch on the
+ * bytes per pixel once instead of once per pixel. VisitPixels makes the view that matches a surface
+ *
+ * @tparam T the type of a pixel: uint8_t, uint16_t, Pixel24 or uint32_t
+ */
+template <typename T>
+class PixelView
+{
+public:
+    typedef T Pixel;    /**< The type of a pixel */
+
+
+    int32_t GetWidth() const noexcept;
+    int32_t GetHeight() const noexcept;
+    uint16_t GetPitch() const noexcept;
+    SDL_PixelFormat* GetPixelFormat() const noexcept;
+
+
+    /**
+     * @brief Locks a surface
+     *
+     * @param surface the surface, which must have PixelTraits<T>::SCuyBytesPerPixel bytes per pixel
+     */
+    explicit PixelView(Surface& surface);
+
+    PixelView(const PixelView& CviewOther) = delete;                /**< Copy constructor */
+    PixelView& operator =(const PixelView& CviewOther) = delete;    /**< Copy assignment */
+
+    ~PixelView() noexcept;  /**< Destructor, which unlocks the surface */
+
+
+    /**
+     * @brief Gets a row of pixels
+     *
+     * @param iY the Y coordinate of the row
+     * @return std::span<T> the pixels of the row
+     */
+    std::span<T> operator [](int32_t iY) const noexcept;
+
+
+    /**
+     * @brief Gets the value of the pixel at (iX, iY)
+     *
+     * @param iX the X coordinate of the pixel
+     * @param iY the Y coordinate of the pixel
+     * @return uint32_t the value of the pixel in the format of the surface
+     */
+    uint32_t Read(int32_t iX, int32_t iY) const noexcept;
+
+    /**
+     * @brief Sets the pixel at (iX, iY)
+     *
+     * @param iX the X coordinate of the pixel
+     * @param iY the Y coordinate of the pixel
+     * @param uiPixelValue the value of the pixel in the format of the surface
+     */
+    void Write(int32_t iX, int32_t iY, uint32_t uiPixelValue) noexcept;
+
+
+    /**
+     * @brief Sets every pixel of the surface
+     *
+     * @param uiPixelValue the value of the pixels in the format of the surface
+     */
+    void Fill(uint32_t uiPixelValue) noexcept;
+
+    /**
+     * @brief Sets every pixel of a rectangle, clipped to the surface
+     *
+     * @param CsdlRect the rectangle
+     * @param uiPixelValue the value of the pixels in the format of the surface
+     */
+    void Fill(const SDL_Rect& CsdlRect, uint32_t uiPixelValue) noexcept;
+
+
+    /**
+     * @brief Copies a rectangle of pixels of the same format, clipped to both surfaces. The source may be this
+     * view, even when both rectangles overlap
+     *
+     * @param CviewSource the view of the source surface
+     * @param CsdlRectSource the rectangle of the source surface that will be copied
+     * @param iDestinationX the X component of the top left coordinate where the pixels will be copied
+     * @param iDestinationY the Y component of the top left coordinate where the pixels will be copied
+     */
+    void CopyFrom(const PixelView<T>& CviewSource, const SDL_Rect& CsdlRectSource, int32_t iDestinationX,
+        int32_t iDestinationY) noexcept;
+
+
+    /**
+     * @brief Converts the pixels of a surface of the same size and any format into the format of this one
+     *
+     * @tparam U the type of a pixel of the source
+     * @param CviewSource the view of the source surface
+     */
+    template <typename U>
+    void ConvertFrom(const PixelView<U>& CviewSource);
+
+
+    /**
+     * @brief Makes a mask of the pixels that are not the colour key, one byte per pixel and row after row
+     *
+     * @param uiColourKey the value of the colour key in the format of the surface
+     * @return std::vector<uint8_t> the mask, with 1 for the opaque pixels and 0 for the transparent ones
+     */
+    std::vector<uint8_t> MaskColourKey(uint32_t uiColourKey) const;
+
+private:
+    Surface& _surface;      /**< The locked surface */
+    uint8_t* _puyPixels;    /**< The first byte of the pixels */
+    uint16_t _urPitch;      /**< The length in bytes of a row */
+    int32_t _iWidth;        /**< The width in pixels */
+    int32_t _iHeight;       /**< The height in pixels */
+
+};
+
+
+/**
+ * @brief Locks a surface
+ *
+ * @param surface the surface, which must have PixelTraits<T>::SCuyBytesPerPixel bytes per pixel
+ */
+template <typename T>
+PixelView<T>::PixelView(Surface& surface) : _surface{surface}, _puyPixels{nullptr},
+    _urPitch{surface.GetPitch()}, _iWidth{surface.GetWidth()}, _iHeight{surface.GetHeight()}
+{
+    if (static_cast<SDL_Surface*>(surface) == nullptr) throw std::invalid_argument("Surface is null");
+    if (surface.GetPixelFormat()->BytesPerPixel != PixelTraits<T>::SCuyBytesPerPixel)
+        throw std::invalid_argument("The view does not match the bytes per pixel of the surface");
+
+    _surface.Lock();
+    _puyPixels = static_cast<uint8_t*>(_surface.GetPixels());
+}
+
+
+/**
+ * @brief Destructor, which unlocks the surface
+ */
+template <typename T>
+PixelView<T>::~PixelView() noexcept { _surface.Unlock(); }
+
+
+/**
+ * @brief Gets the value of the pixel at (iX, iY)
+ *
+ * @param iX the X coordinate of the pixel
+ * @param iY the Y coordinate of the pixel
+ * @return uint32_t the value of the pixel in the format of the surface
+ */
+template <typename T>
+uint32_t PixelView<T>::Read(int32_t iX, int32_t iY) const noexcept
+{ return PixelTraits<T>::Load((*this)[iY][iX]); }
+
+
+/**
+ * @brief Sets the pixel at (iX, iY)
+ *
+ * @param iX the X coordinate of the pixel
+ * @param iY the Y coordinate of the pixel
+ * @param uiPixelValue the value of the pixel in the format of the surface
+ */
+template <typename T>
+void PixelView<T>::Write(int32_t iX, int32_t iY, uint32_t uiPixelValue) noexcept
+{ (*this)[iY][iX] = PixelTraits<T>::Store(uiPixelValue); }
+
+
+/**
+ * @brief Sets every pixel of the surface
+ *
+ * @param uiPixelValue the value of the pixels in the format of the surface
+ */
+template <typename T>
+void PixelView<T>::Fill(uint32_t uiPixelValue) noexcept
+{
+    Fill(SDL_Rect{0, 0, static_cast<Uint16>(_iWidth), static_cast<Uint16>(_iHeight)}, uiPixelValue);
+}
+
+
+/**
+ * @brief Sets every pixel of a rectangle, clipped to the surface
+ *
+ * @param CsdlRect the rectangle
+ * @param uiPixelValue the value of the pixels in the format of the surface
+ */
+template <typename T>
+void PixelView<T>::Fill(const SDL_Rect& CsdlRect, uint32_t uiPixelValue) noexcept
+{
+    int32_t iLeft{std::max<int32_t>(CsdlRect.x, 0)}, iTop{std::max<int32_t>(CsdlRect.y, 0)};
+    int32_t iRight{std::min<int32_t>(CsdlRect.x + CsdlRect.w, _iWidth)};
+    int32_t iBottom{std::min<int32_t>(CsdlRect.y + CsdlRect.h, _iHeight)};
+    if (iLeft >= iRight || iTop >= iBottom) return;
+
+    // The first row is filled pixel by pixel and the rest are copies of it
+    std::span<T> spanFirst{(*this)[iTop].subspan(iLeft, iRight - iLeft)};
+    std::fill(spanFirst.begin(), spanFirst.end(), PixelTraits<T>::Store(uiPixelValue));
+
+    for (int32_t i = iTop + 1; i < iBottom; ++i)
+        std::memcpy((*this)[i].data() + iLeft, spanFirst.data(), spanFirst.size_bytes());
+}
+
+
+/**
+ * @brief Copies a rectangle of pixels of the same format, clipped to both surfaces. The source may be this
+ * view, even when both rectangles overlap
+ *
+ * @param CviewSource the view of the source surface
+ * @param CsdlRectSource the rectangle of the source surface that will be copied
+ * @param iDestinationX the X component of the top left coordinate where the pixels will be copied
+ * @param iDestinationY the Y component of the top left coordinate where the pixels will be copied
+ */
+template <typename T>
+void PixelView<T>::CopyFrom(const PixelView<T>& CviewSource, const SDL_Rect& CsdlRectSource,
+    int32_t iDestinationX, int32_t iDestinationY) noexcept
+{
+    int32_t iSourceX{CsdlRectSource.x}, iSourceY{CsdlRectSource.y};
+    int32_t iWidth{CsdlRectSource.w}, iHeight{CsdlRectSource.h};
+
+    // Clip the rectangle to the source, then to the destination
+    if (iSourceX < 0) { iWidth += iSourceX; iDestinationX -= iSourceX; iSourceX = 0; }
+    if (iSourceY < 0) { iHeight += iSourceY; iDestinationY -= iSourceY; iSourceY = 0; }
+    if (iDestinationX < 0) { iWidth += iDestinationX; iSourceX -= iDestinationX; iDestinationX = 0; }
+    if (iDestinationY < 0) { iHeight += iDestinationY; iSourceY -= iDestinationY; iDestinationY = 0; }
+    iWidth = std::min({iWidth, CviewSource._iWidth - iSourceX, _iWidth - iDestinationX});
+    iHeight = std::min({iHeight, CviewSource._iHeight - iSourceY, _iHeight - iDestinationY});
+    if (iWidth <= 0 || iHeight <= 0) return;
+
+    // Rows are copied from the bottom up when they would overwrite rows not copied yet
+    bool bBottomUp{&CviewSource == this && iDestinationY > iSourceY};
+    for (int32_t i = 0; i < iHeight; ++i)
+    {
+        int32_t iRow{bBottomUp ? iHeight - 1 - i : i};
+        std::memmove((*this)[iDestinationY + iRow].data() + iDestinationX,
+            CviewSource[iSourceY + iRow].data() + iSourceX, iWidth * sizeof(T));
+    }
+}
+
+
+/**
+ * @brief Converts the pixels of a surface of the same size and any format into the format of this one
+ *
+ * @tparam U the type of a pixel of the source
+ * @param CviewSource the view of the source surface
+ */
+template <typename T>
+template <typename U>
+void PixelView<T>::ConvertFrom(const PixelView<U>& CviewSource)
+{
+    if (CviewSource.GetWidth() != _iWidth || CviewSource.GetHeight() != _iHeight)
+        throw std::invalid_argument("Surfaces of different sizes");
+
+    const SDL_PixelFormat* CpSdlPixelFormatSource{CviewSource.GetPixelFormat()};
+    const SDL_PixelFormat* CpSdlPixelFormatDestination{GetPixelFormat()};
+
+    if constexpr (std::is_same_v<T, U>)
+    {
+        if (CpSdlPixelFormatSource->Rmask == CpSdlPixelFormatDestination->Rmask &&
+            CpSdlPixelFormatSource->Gmask == CpSdlPixelFormatDestination->Gmask &&
+            CpSdlPixelFormatSource->Bmask == CpSdlPixelFormatDestination->Bmask &&
+            CpSdlPixelFormatSource->Amask == CpSdlPixelFormatDestination->Amask &&
+            CpSdlPixelFormatSource->palette == nullptr && CpSdlPixelFormatDestination->palette == nullptr)
+        {
+            CopyFrom(CviewSource, SDL_Rect{0, 0, static_cast<Uint16>(_iWidth), static_cast<Uint16>(_iHeight)},
+                0, 0);
+            return;
+        }
+    }
+
+    SDL_PixelFormat* pSdlPixelFormatSource{const_cast<SDL_PixelFormat*>(CpSdlPixelFormatSource)};
+    SDL_PixelFormat* pSdlPixelFormatDestination{const_cast<SDL_PixelFormat*>(CpSdlPixelFormatDestination)};
+
+    uint8_t uyRed{0}, uyGreen{0}, uyBlue{0}, uyAlpha{0};
+    for (int32_t i = 0; i < _iHeight; ++i)
+    {
+        std::span<const U> spanSource{CviewSource[i]};
+        std::span<T> spanDestination{(*this)[i]};
+
+        for (int32_t j = 0; j < _iWidth; ++j)
+        {
+            SDL_GetRGBA(PixelTraits<U>::Load(spanSource[j]), pSdlPixelFormatSource, &uyRed, &uyGreen, &uyBlue,
+                &uyAlpha);
+            spanDestination[j] = PixelTraits<T>::Store(SDL_MapRGBA(pSdlPixelFormatDestination, uyRed, uyGreen,
+                uyBlue, uyAlpha));
+        }
+    }
+}
+
+
+/**
+ * @brief Makes a mask of the pixels that are not the colour key, one byte per pixel and row after row
+ *
+ * @param uiColourKey the value of the colour key in the format of the surface
+ * @return std::vector<uint8_t> the mask, with 1 for the opaque pixels and 0 for the transparent ones
+ */
+template <typename T>
+std::vector<uint8_t> PixelView<T>::MaskColourKey(uint32_t uiColourKey) const
+{
+    std::vector<uint8_t> vectoruyMask(static_cast<std::size_t>(_iWidth) * _iHeight);
+    std::vector<uint8_t>::iterator i = vectoruyMask.begin();
+
+    for (int32_t j = 0; j < _iHeight; ++j)
+        for (T pixel : (*this)[j]) *i++ = (PixelTraits<T>::Load(pixel) != uiColourKey);
+
+    return vectoruyMask;
+}
+
+
+/**
+ * @brief Locks a surface and calls a function with the view that matches its bytes per pixel
+ *
+ * @param surface the surface
+ * @param function the function, which takes a PixelView<T>& for every pixel type
+ * @return decltype(auto) the value returned by the function
+ */
+template <typename F>
+decltype(auto) VisitPixels(Surface& surface, F&& function)
+{
+    if (static_cast<SDL_Surface*>(surface) == nullptr) throw std::invalid_argument("Surface is null");
+
+    switch (surface.GetPixelFormat()->BytesPerPixel)
+    {
+    case 1: { PixelView<uint8_t> view{surface}; return function(view); }
+    case 2: { PixelView<uint16_t> view{surface}; return function(view); }
+    case 3: { PixelView<Pixel24> view{surface}; return function(view); }
+    case 4: { PixelView<uint32_t> view{surface}; return function(view); }
+    default: throw std::runtime_error("Unknown bytes per pixel");
+    }
+}
+
+
+template <typename T>
+inline int32_t PixelView<T>::GetWidth() const noexcept { return _iWidth; }
+template <typename T>
+inline int32_t PixelView<T>::GetHeight() const noexcept { return _iHeight; }
+template <typename T>
+inline uint16_t PixelView<T>::GetPitch() const noexcept { return _urPitch; }
+template <typename T>
+inline SDL_PixelFormat* PixelView<T>::GetPixelFormat() const noexcept { return _surface.GetPixelFormat(); }
+template <typename T>
+inline std::span<T> PixelView<T>::operator [](int32_t iY) const noexcept
+{ return std::span<T>(reinterpret_cast<T*>(_puyPixels + iY * _urPitch), _iWidth); }
+
+
+#endif
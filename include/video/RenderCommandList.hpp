@@ -0,0 +1,140 @@
+/*
+RenderCommandList.hpp --- Recorded drawing commands of a frame
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RENDERCOMMANDLIST_HPP_
+#define _RENDERCOMMANDLIST_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+
+
+/**
+ * @brief The blits and fills of a frame, recorded by the main thread and executed on the display by the
+ * render thread, followed by the presentation of the changed regions. Every blit holds a reference to its
+ * source surface, so the main thread may free the surface while the list is executed. The list must only
+ * be recorded and cleared while it is not being executed
+ */
+class RenderCommandList
+{
+public:
+    /* Getters */
+    std::size_t GetSize() const noexcept;
+
+
+    RenderCommandList() noexcept;   /**< Default constructor */
+
+    RenderCommandList(const RenderCommandList& CrenderCommandListOther) = delete;   /**< Copy constructor */
+    RenderCommandList& operator =(const RenderCommandList& CrenderCommandListOther) = delete;
+        /**< Copy assignment operator */
+
+    ~RenderCommandList() noexcept;  /**< Destructor */
+
+
+    /**
+     * @brief Drops every command, releasing the references to the surfaces
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Records a blit of part of a surface
+     *
+     * @param Csurface the source surface
+     * @param rDestinationX the X coordinate on the display of the top left corner
+     * @param rDestinationY the Y coordinate on the display of the top left corner
+     * @param rSourceX the X component of the origin coordinate of the portion of the source surface
+     * @param rSourceY the Y component of the origin coordinate of the portion of the source surface
+     * @param rSourceWidth the width of the portion of the source surface, -1 for the whole surface
+     * @param rSourceHeight the height of the portion of the source surface, -1 for the whole surface
+     */
+    void Blit(const Surface& Csurface, int16_t rDestinationX = 0, int16_t rDestinationY = 0,
+        int16_t rSourceX = 0, int16_t rSourceY = 0, int16_t rSourceWidth = -1, int16_t rSourceHeight = -1);
+
+    /**
+     * @brief Records a copy of a region of the display into a surface, which reads what the commands before
+     * it drew
+     *
+     * @param surfaceDestination the surface that receives the region at its top left corner
+     * @param CsdlRect the region of the display
+     */
+    void Save(Surface& surfaceDestination, const SDL_Rect& CsdlRect);
+
+    /**
+     * @brief Records a fill with a solid colour
+     *
+     * @param CpSdlRect the region to fill, nullptr for the whole clipping region
+     * @param uiColour the colour, in the pixel format of the display
+     */
+    void Fill(const SDL_Rect* CpSdlRect, uint32_t uiColour);
+
+    /**
+     * @brief Records a change of the clipping region of the display
+     *
+     * @param CpSdlRect the region the following commands are clipped to, nullptr for the whole display
+     */
+    void SetClip(const SDL_Rect* CpSdlRect);
+
+    /**
+     * @brief Sets the regions sent to the screen after the commands are executed
+     *
+     * @param CvectorSdlRects the regions, an empty list leaves the screen as it is
+     */
+    void SetPresentRects(const std::vector<SDL_Rect>& CvectorSdlRects);
+
+    /**
+     * @brief Runs the commands on the display and presents the changed regions
+     *
+     * @param surfaceDisplay the display surface
+     */
+    void Execute(Surface& surfaceDisplay);
+
+private:
+    /**
+     * @brief Type of a command
+     */
+    enum ECommand : uint8_t {COMMAND_BLIT, COMMAND_SAVE, COMMAND_FILL, COMMAND_CLIP, COMMAND_CLIP_NONE};
+
+    /**
+     * @brief A recorded command
+     */
+    struct Command
+    {
+        ECommand eCommand;
+        SDL_Surface* pSdlSurface;       /**< The blitted or saved surface, referenced until cleared */
+        SDL_Rect sdlRectSource;         /**< The portion of the source of a blit, the saved region */
+        SDL_Rect sdlRectDestination;    /**< The destination of a blit, the filled or clipping region */
+        uint32_t uiColour;              /**< The colour of a fill */
+        bool bWholeClip;                /**< Whether a fill covers the whole clipping region */
+        bool bIsPremultiplied;          /**< Whether the source of a blit is blended by Surface */
+    };
+
+
+    std::vector<Command> _vectorCommands;       /**< The commands in the order they are run */
+    std::vector<SDL_Rect> _vectorSdlRectsPresent;   /**< The regions sent to the screen */
+
+};
+
+
+inline std::size_t RenderCommandList::GetSize() const noexcept { return _vectorCommands.size(); }
+
+
+#endif
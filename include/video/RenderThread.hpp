@@ -0,0 +1,164 @@
+/*
+RenderThread.hpp --- Thread that executes the recorded frames on the display
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RENDERTHREAD_HPP_
+#define _RENDERTHREAD_HPP_
+
+#include <cstdint>
+#include <string>
+#include <array>
+#include <atomic>
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_events.h>
+
+#include "Surface.hpp"
+#include "RenderCommandList.hpp"
+
+
+/**
+ * @brief Executes the command lists recorded by the main thread on the display, blits and presentation
+ * included, so the main thread handles the input and updates the game while the frame reaches the screen.
+ * There are two lists: the main thread records the back one while the front one is executed, and a frame
+ * is only recorded once the previous one is on the screen. SDL does not allow the events to be pumped while
+ * the display is being drawn, so the main thread must get its events through this class
+ */
+class RenderThread
+{
+public:
+    /* Getters */
+    bool IsBusy() const noexcept;
+    uint32_t GetLastExecuteTime() const noexcept;
+
+
+    RenderThread();     /**< Default constructor */
+
+    RenderThread(const RenderThread& CrenderThreadOther) = delete;              /**< Copy constructor */
+    RenderThread& operator =(const RenderThread& CrenderThreadOther) = delete;  /**< Copy assignment operator */
+
+    ~RenderThread() noexcept;   /**< Destructor */
+
+
+    /**
+     * @brief Gets the list to record the next frame in, which must only be done while the thread is not busy
+     *
+     * @return RenderCommandList& the back list, empty
+     */
+    RenderCommandList& BeginFrame() noexcept;
+
+    /**
+     * @brief Hands the back list to the thread to be executed, starting the thread the first time
+     *
+     * @param surfaceDisplay the display surface
+     */
+    void Submit(Surface& surfaceDisplay);
+
+    /**
+     * @brief Waits until the last list submitted is on the screen
+     */
+    void Wait() noexcept;
+
+    /**
+     * @brief Replaces SDL_PollEvent, new events are only pumped while the display is not being drawn
+     *
+     * @param pSdlEvent receives the event
+     * @return true if there was an event
+     */
+    bool PollEvent(SDL_Event* pSdlEvent) noexcept;
+
+    /**
+     * @brief Replaces SDL_WaitEvent
+     *
+     * @param pSdlEvent receives the event
+     * @return true if there was an event, false on error
+     */
+    bool WaitEvent(SDL_Event* pSdlEvent) noexcept;
+
+    /**
+     * @brief Replaces SDL_WaitEvent, giving up after a while
+     *
+     * @param pSdlEvent receives the event
+     * @param uiTimeout the longest wait, in milliseconds
+     * @return true if there was an event, false on error or if the time ran out
+     */
+    bool WaitEventTimeout(SDL_Event* pSdlEvent, uint32_t uiTimeout) noexcept;
+
+    /**
+     * @brief Replaces SDL_WarpMouse, which waits for the display to be free
+     *
+     * @param urX the X coordinate of the cursor
+     * @param urY the Y coordinate of the cursor
+     */
+    void WarpMouse(uint16_t urX, uint16_t urY) noexcept;
+
+    /**
+     * @brief Stops the thread and drops both lists, which must be done before the surfaces are freed
+     */
+    void Stop() noexcept;
+
+private:
+    /**
+     * @brief The thread using the display
+     */
+    enum EVideoOwner : uint8_t {VIDEO_OWNER_NONE, VIDEO_OWNER_MAIN, VIDEO_OWNER_RENDER};
+
+
+    SDL_Thread* _pSdlThread;        /**< The render thread */
+    SDL_sem* _pSdlSemaphoreWork;    /**< Counts the lists waiting for the thread */
+    SDL_sem* _pSdlSemaphoreIdle;    /**< Is 1 while no list is waiting or being executed */
+    bool _bStop;                    /**< Signals the thread to stop */
+    Surface* _pSurfaceDisplay;      /**< The display surface, set on every submission */
+
+    std::array<RenderCommandList, 2> _arenderCommandLists;  /**< The back and front lists */
+    uint8_t _uyBack;                /**< The index of the list recorded by the main thread */
+    std::string _sError;            /**< Why the last list could not be executed, read while idle */
+
+    std::atomic<uint8_t> _uyVideoOwner;         /**< The thread using the display, see EVideoOwner */
+    std::atomic<uint32_t> _uiLastExecuteTime;   /**< Time the last list took, in microseconds */
+
+
+    /**
+     * @brief Loop of the render thread
+     *
+     * @param pData the render thread
+     * @return int32_t error code of the thread
+     */
+    static int32_t SDLCALL Run(void* pData);
+
+    /**
+     * @brief Tries to take the display for the main thread
+     *
+     * @return true if the display was free
+     */
+    bool TryClaimVideo() noexcept;
+
+    /**
+     * @brief Frees the display taken by the main thread
+     */
+    void ReleaseVideo() noexcept;
+
+};
+
+
+inline bool RenderThread::IsBusy() const noexcept { return SDL_SemValue(_pSdlSemaphoreIdle) == 0; }
+inline uint32_t RenderThread::GetLastExecuteTime() const noexcept { return _uiLastExecuteTime; }
+
+
+#endif
@@ -0,0 +1,143 @@
+/*
+Scene.hpp --- Screen made of layers composited in advance
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SCENE_HPP_
+#define _SCENE_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <array>
+
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+#include "Atlas.hpp"
+#include "RenderCommandList.hpp"
+
+
+/**
+ * @brief A screen made of stacked layers, each one cached as a surface holding it composited over the layers
+ * below, so drawing the screen takes one blit. Every layer is described again only when its key changes, and
+ * then it is composited again along with the layers above it, while the layers below keep their cache. The
+ * keys summarise whatever the elements of a layer depend on, like the settings shown or the hovered buttons
+ */
+class Scene
+{
+public:
+    /**
+     * @brief The layers, from the bottom up
+     */
+    enum ELayer : uint8_t {LAYER_BACKGROUND, LAYER_BUTTONS, LAYER_LABELS, LAYER_COUNT};
+
+
+    Scene() noexcept;   /**< Default constructor */
+
+    Scene(const Scene& CsceneOther) = delete;               /**< Copy constructor */
+    Scene& operator =(const Scene& CsceneOther) = delete;   /**< Copy assignment operator */
+
+    ~Scene() noexcept;  /**< Destructor */
+
+
+    /**
+     * @brief Checks whether a layer changed, emptying it if it did so its elements are added again
+     *
+     * @param eLayer the layer
+     * @param uKey summary of everything the elements of the layer depend on
+     * @return true if the key is not the one the layer was described with, and the layer was emptied
+     */
+    bool BeginLayer(ELayer eLayer, uint64_t uKey) noexcept;
+
+    /**
+     * @brief Adds part of a surface to a layer being described
+     *
+     * @param eLayer the layer
+     * @param surface the surface, which must live until the layer is described again
+     * @param rDestinationX the X coordinate on the screen of the top left corner
+     * @param rDestinationY the Y coordinate on the screen of the top left corner
+     * @param rSourceX the X component of the origin coordinate of the portion of the surface
+     * @param rSourceY the Y component of the origin coordinate of the portion of the surface
+     * @param rSourceWidth the width of the portion of the surface, -1 for the whole surface
+     * @param rSourceHeight the height of the portion of the surface, -1 for the whole surface
+     */
+    void Add(ELayer eLayer, Surface& surface, int16_t rDestinationX = 0, int16_t rDestinationY = 0,
+        int16_t rSourceX = 0, int16_t rSourceY = 0, int16_t rSourceWidth = -1, int16_t rSourceHeight = -1);
+
+    /**
+     * @brief Adds a sprite to a layer being described
+     *
+     * @param eLayer the layer
+     * @param atlas the atlas of the sprite, which must live until the layer is described again
+     * @param sprite the sprite
+     * @param rDestinationX the X coordinate on the screen of the top left corner
+     * @param rDestinationY the Y coordinate on the screen of the top left corner
+     */
+    void Add(ELayer eLayer, Atlas& atlas, Atlas::Sprite sprite, int16_t rDestinationX = 0,
+        int16_t rDestinationY = 0);
+
+    /**
+     * @brief Forgets every layer, so all of them are described again, which must be done before the surfaces
+     * of the elements are freed
+     */
+    void Invalidate() noexcept;
+
+    /**
+     * @brief Composites the layers that changed and the ones above them
+     *
+     * @param CsurfaceDisplay the display surface, whose format and size the caches take
+     */
+    void Composite(const Surface& CsurfaceDisplay);
+
+    /**
+     * @brief Records a blit of the whole scene
+     *
+     * @param renderCommandList the list of the frame
+     */
+    void OnDraw(RenderCommandList& renderCommandList) const;
+
+private:
+    /**
+     * @brief A portion of a surface placed on the screen
+     */
+    struct Element
+    {
+        Surface* pSurface;
+        int16_t rDestinationX, rDestinationY;
+        int16_t rSourceX, rSourceY;
+        int16_t rSourceWidth, rSourceHeight;    /**< -1 for the whole surface */
+    };
+
+    /**
+     * @brief A layer and its cache
+     */
+    struct Layer
+    {
+        std::vector<Element> vectorElements;
+        uint64_t uKey;          /**< The key the elements were added with */
+        bool bHasKey;           /**< Whether the layer was described since it was last invalidated */
+        bool bIsStale;          /**< The cache does not match the elements */
+        Surface* pSurfaceCache; /**< This layer over the ones below, nullptr before the first composite */
+    };
+
+
+    std::array<Layer, LAYER_COUNT> _alayers;    /**< The layers, from the bottom up */
+
+};
+
+
+#endif
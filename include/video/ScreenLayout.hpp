@@ -0,0 +1,98 @@
+/*
+ScreenLayout.hpp --- Placement of the screen elements for any display size
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SCREENLAYOUT_HPP_
+#define _SCREENLAYOUT_HPP_
+
+#include <cstdint>
+#include <array>
+
+#include <SDL_video.h>
+
+
+/**
+ * @brief Places the elements of the screens, which are given in the coordinates of the preferred display of
+ * the application, on a display of any size. Every element keeps its distance to one anchor, a corner, the
+ * middle of a side or the centre of the display, and the shift of every anchor is worked out once when the
+ * size of the display is set, so placing an element is one addition
+ */
+class ScreenLayout
+{
+public:
+    /**
+     * @brief The points of the display an element keeps its distance to
+     */
+    enum EAnchor : uint8_t
+    {
+        ANCHOR_TOP_LEFT,
+        ANCHOR_TOP,
+        ANCHOR_TOP_RIGHT,
+        ANCHOR_LEFT,
+        ANCHOR_CENTRE,
+        ANCHOR_RIGHT,
+        ANCHOR_BOTTOM_LEFT,
+        ANCHOR_BOTTOM,
+        ANCHOR_BOTTOM_RIGHT,
+        ANCHOR_COUNT
+    };
+
+
+    /* Getters */
+    uint16_t GetWidth() const noexcept;
+    uint16_t GetHeight() const noexcept;
+
+
+    ScreenLayout() noexcept;    /**< Default constructor, for the preferred display */
+
+
+    /**
+     * @brief Sets the size of the display, working out the shift of every anchor if it changed
+     *
+     * @param urWidth the width of the display
+     * @param urHeight the height of the display
+     * @return true if the size changed, so whatever was placed before must be placed again
+     */
+    bool Resize(uint16_t urWidth, uint16_t urHeight) noexcept;
+
+    /**
+     * @brief Places an element on the display
+     *
+     * @param eAnchor the point of the display the element keeps its distance to
+     * @param rX the X coordinate of the top left corner of the element on the preferred display
+     * @param rY the Y coordinate of the top left corner of the element on the preferred display
+     * @param urWidth the width of the element
+     * @param urHeight the height of the element
+     * @return SDL_Rect the region of the element on the display
+     */
+    SDL_Rect Place(EAnchor eAnchor, int16_t rX, int16_t rY, uint16_t urWidth = 0, 
+        uint16_t urHeight = 0) const noexcept;
+
+private:
+    uint16_t _urWidth, _urHeight;   /**< The size of the display */
+    std::array<int16_t, ANCHOR_COUNT> _arShiftsX;   /**< The distance every anchor moved horizontally */
+    std::array<int16_t, ANCHOR_COUNT> _arShiftsY;   /**< The distance every anchor moved vertically */
+
+};
+
+
+inline uint16_t ScreenLayout::GetWidth() const noexcept { return _urWidth; }
+inline uint16_t ScreenLayout::GetHeight() const noexcept { return _urHeight; }
+
+
+#endif
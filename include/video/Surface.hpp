@@ -38,6 +38,7 @@ public:
     int32_t GetHeight() const noexcept;
     uint16_t GetPitch() const noexcept;
     void* GetPixels() const noexcept;
+    bool IsPremultiplied() const noexcept;
 
 
     /**
@@ -115,13 +116,34 @@ public:
     void SetTransparentPixel(uint8_t uyRed, uint8_t uyGreen, uint8_t uyBlue);
 
 
+    /**
+     * @brief Converts the surface to the pixel format of the display, which must be done from the main thread
+     *
+     * @param uyAlpha the alpha value of the whole surface
+     * @param rColourKeyRed the red RGB component of the colour key, -1 to keep the current one
+     * @param rColourKeyGreen the green RGB component of the colour key, -1 to keep the current one
+     * @param rColourKeyBlue the blue RGB component of the colour key, -1 to keep the current one
+     */
+    void ConvertToDisplay(uint8_t uyAlpha = SDL_ALPHA_OPAQUE, int16_t rColourKeyRed = -1,
+        int16_t rColourKeyGreen = -1, int16_t rColourKeyBlue = -1);
+
+
     /**
      * @brief Upscales a surface
      *
      * @param urScaleX the scale factor for the X axis
      * @param urScaleY the scale factor for the Y axis
+     * @param bDisplayFormat true to convert the result to the format of the display, false to keep the format,
+     * which lets surfaces be scaled outside the main thread
+     */
+    void Scale(uint16_t urScaleX, uint16_t urScaleY, bool bDisplayFormat = true);
+
+
+    /**
+     * @brief Multiplies the colour components by the alpha, so the surface is blended by
+     * BlitPremultiplied instead of SDL. Only 32-bit surfaces with an alpha channel can be premultiplied
      */
-    void Scale(uint16_t urScaleX, uint16_t urScaleY);
+    void Premultiply();
 
 
     /**
@@ -138,9 +160,50 @@ public:
     void OnDraw(Surface& sdlSurfaceDestination, int16_t rDestinationX = 0, int16_t rDestinationY = 0,
         int16_t rSourceX = 0, int16_t rSourceY = 0, int16_t rSourceWidth = -1, int16_t rSourceHeight = -1);
 
+
+    /**
+     * @brief Makes another surface over the same pixels, counted by SDL so they are freed along with the
+     * last surface using them. Neither surface may be changed from then on, since both would change
+     *
+     * @return Surface* the new surface, owned by the caller
+     */
+    Surface* Share() const;
+
+
+    /**
+     * @brief Computes the CRC-32 of the pixels, leaving out the padding at the end of the rows
+     *
+     * @return uint32_t the checksum, the same one zlib computes for the same bytes
+     */
+    uint32_t GetChecksum() noexcept;
+
+
+    /**
+     * @brief Blends part of a premultiplied surface into another surface, clipped like SDL_BlitSurface.
+     * 32-bit destinations with the same colour components and RGB565 ones have their own kernels, any other
+     * format is blended one pixel at a time
+     *
+     * @param pSdlSurfaceSource the premultiplied source surface
+     * @param CsdlRectSource the portion of the source surface
+     * @param surfaceDestination the destination surface
+     * @param rDestinationX the X component of the top left coordinate where the portion will be blended
+     * @param rDestinationY the Y component of the top left coordinate where the portion will be blended
+     */
+    static void BlitPremultiplied(SDL_Surface* pSdlSurfaceSource, const SDL_Rect& CsdlRectSource,
+        Surface& surfaceDestination, int16_t rDestinationX, int16_t rDestinationY);
+
+    /**
+     * @brief Gets the pixel format that surfaces with an alpha channel take when they are converted to the
+     * display, which must be done from the main thread
+     *
+     * @return SDL_PixelFormat the format, without a palette
+     */
+    static SDL_PixelFormat GetDisplayAlphaFormat();
+
 private:
     std::string _sPath;     /**< The path to the image in the filesystem */
     SDL_Surface* _pSdlSurface;  /**< The raw surface */
+    bool _bIsPremultiplied;     /**< Whether the colour components were multiplied by the alpha */
 
 };
 
@@ -155,6 +218,7 @@ inline uint16_t Surface::GetPitch() const noexcept
 { return (_pSdlSurface != nullptr ? _pSdlSurface->pitch : 0); }
 inline void* Surface::GetPixels() const noexcept
 { return (_pSdlSurface != nullptr ? _pSdlSurface->pixels : nullptr); }
+inline bool Surface::IsPremultiplied() const noexcept { return _bIsPremultiplied; }
 
 
 inline Surface::operator SDL_Surface*() const noexcept { return _pSdlSurface; }
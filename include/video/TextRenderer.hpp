@@ -0,0 +1,119 @@
+/*
+TextRenderer.hpp --- Text rendering with cached glyphs and strings
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TEXTRENDERER_HPP_
+#define _TEXTRENDERER_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <list>
+#include <utility>
+#include <unordered_map>
+#include <SDL_video.h>
+#include <SDL_ttf.h>
+
+#include "Surface.hpp"
+
+
+/**
+ * @brief Renders UTF-8 text into surfaces, keeping the last strings rendered in an LRU cache keyed by text,
+ * font and colour. Strings that miss the cache are composed from cached glyphs, so FreeType only rasterises a
+ * glyph the first time it is drawn in a font and colour
+ */
+class TextRenderer
+{
+public:
+    static constexpr std::size_t SCuStringCapacity{64};     /**< Strings kept in the cache */
+
+
+    /* Getters */
+    std::size_t GetStringCount() const noexcept;
+    std::size_t GetGlyphCount() const noexcept;
+
+
+    TextRenderer() noexcept;    /**< Default constructor */
+
+    TextRenderer(const TextRenderer& CtextRendererOther) = delete;              /**< Copy constructor */
+    TextRenderer& operator =(const TextRenderer& CtextRendererOther) = delete;  /**< Copy assignment */
+
+
+    /**
+     * @brief Renders a string
+     *
+     * @param CsText the UTF-8 text
+     * @param pTtfFont the font
+     * @param CsdlColor the colour of the text
+     * @return Surface* a surface with the text on a transparent background, owned by the caller, which
+     * shares its pixels with the cache and must not be changed
+     */
+    Surface* Render(const std::string& CsText, TTF_Font* pTtfFont, const SDL_Color& CsdlColor);
+
+    /**
+     * @brief Drops every cached glyph and string, which must be done before closing a font
+     */
+    void Clear() noexcept;
+
+private:
+    typedef std::pair<std::string, Surface> StringEntry;    /**< A cached string and its key */
+
+    std::list<StringEntry> _listStrings;    /**< The cached strings, from the most to the least recently used */
+    std::unordered_map<std::string, std::list<StringEntry>::iterator> _htStrings;   /**< The strings by key */
+    std::unordered_map<std::string, Surface> _htGlyphs;     /**< The cached glyphs by key */
+
+
+    /**
+     * @brief Makes the key of a text in a font and colour
+     *
+     * @param CsText the UTF-8 text
+     * @param pTtfFont the font
+     * @param CsdlColor the colour of the text
+     * @return std::string the key
+     */
+    static std::string MakeKey(const std::string& CsText, const TTF_Font* pTtfFont,
+        const SDL_Color& CsdlColor);
+
+    /**
+     * @brief Gets a glyph, rendering it the first time
+     *
+     * @param CsGlyph the UTF-8 bytes of the glyph
+     * @param pTtfFont the font
+     * @param CsdlColor the colour of the text
+     * @return Surface& the glyph on a transparent background, rendered on its own
+     */
+    Surface& GetGlyph(const std::string& CsGlyph, TTF_Font* pTtfFont, const SDL_Color& CsdlColor);
+
+    /**
+     * @brief Composes a string from its glyphs
+     *
+     * @param CsText the UTF-8 text
+     * @param pTtfFont the font
+     * @param CsdlColor the colour of the text
+     * @return Surface the text on a transparent background
+     */
+    Surface Compose(const std::string& CsText, TTF_Font* pTtfFont, const SDL_Color& CsdlColor);
+
+};
+
+
+inline std::size_t TextRenderer::GetStringCount() const noexcept { return _listStrings.size(); }
+inline std::size_t TextRenderer::GetGlyphCount() const noexcept { return _htGlyphs.size(); }
+
+
+#endif
@@ -0,0 +1,143 @@
+/*
+TextureCache.hpp --- On-disk cache of converted textures
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TEXTURECACHE_HPP_
+#define _TEXTURECACHE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SDL_video.h>
+
+#include "Surface.hpp"
+
+
+/**
+ * @brief Keeps the pixels of textures already decoded, scaled and converted to the format of the display,
+ * so the next run copies them into a surface instead of decoding the image again.
+ *
+ * Every entry is keyed by the image file, its modification time, the size it was scaled to fit and the
+ * depth and masks of the pixel format. A changed image overwrites its own entry. On Linux the entries are
+ * memory-mapped; on the Wii they are read straight into the surface. Loading and storing are thread-safe for
+ * different images.
+ */
+class TextureCache
+{
+public:
+    /**
+     * @brief A texture ready to be written, so its pixels can be copied on one thread and written on another
+     */
+    struct Entry
+    {
+        std::string sPath;                  /**< The path of the entry */
+        std::vector<uint8_t> vectoruyData;  /**< The header and the pixels */
+    };
+
+
+    /* Getters */
+    const std::string& GetDirectory() const noexcept;
+
+
+    /**
+     * @brief Constructor
+     *
+     * @param CsDirectory the directory of the entries, created on the first store
+     */
+    explicit TextureCache(const std::string& CsDirectory);
+
+
+    /**
+     * @brief Loads a texture stored by an earlier run
+     *
+     * @param CsPath the path of the image file
+     * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+     * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+     * @param CsdlPixelFormat the pixel format the texture was converted to
+     * @return Surface* the texture, nullptr if there is no entry or the image changed since it was stored
+     */
+    Surface* Load(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+        const SDL_PixelFormat& CsdlPixelFormat) const noexcept;
+
+    /**
+     * @brief Stores a texture converted to the format of the display, errors are ignored
+     *
+     * @param CsPath the path of the image file
+     * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+     * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+     * @param Csurface the texture
+     */
+    void Store(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+        const Surface& Csurface) const noexcept;
+
+    /**
+     * @brief Copies a texture converted to the format of the display into an entry, to be written later
+     *
+     * @param CsPath the path of the image file
+     * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+     * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+     * @param Csurface the texture
+     * @param entry receives the entry
+     * @return bool false if the texture cannot be cached
+     */
+    bool Prepare(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight, const Surface& Csurface,
+        Entry& entry) const noexcept;
+
+    /**
+     * @brief Writes an entry, replacing the one of an older image, errors are ignored
+     *
+     * @param Centry the entry
+     */
+    void Write(const Entry& Centry) const noexcept;
+
+private:
+    static const uint8_t SCuyVersion{1};        /**< Version of the entry layout */
+    static const uint8_t SCuyHeaderSize{44};    /**< Bytes before the pixels of an entry */
+
+    std::string _sDirectory;    /**< The directory of the entries */
+
+
+    /**
+     * @brief Gets the path of the entry of a texture
+     *
+     * @param CsPath the path of the image file
+     * @param urFitWidth the width the texture was scaled to fit
+     * @param urFitHeight the height the texture was scaled to fit
+     * @param CsdlPixelFormat the pixel format of the texture
+     * @return std::string the path of the entry
+     */
+    std::string GetEntryPath(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+        const SDL_PixelFormat& CsdlPixelFormat) const;
+
+    /**
+     * @brief Gets the modification time of a file
+     *
+     * @param CsPath the path of the file
+     * @param uTime the modification time, in the units of the filesystem clock
+     * @return bool false if the file could not be read
+     */
+    static bool GetModificationTime(const std::string& CsPath, uint64_t& uTime) noexcept;
+
+};
+
+
+inline const std::string& TextureCache::GetDirectory() const noexcept { return _sDirectory; }
+
+
+#endif
@@ -66,12 +66,22 @@ class Time
          */
         void OnLoop();
 
+        /**
+         * @brief Makes the time advance by a fixed step on every frame instead of following the clock, so
+         * the frames of automated runs are the same every time
+         * 
+         * @param urStep the milliseconds per frame, 0 to follow the clock again
+         */
+        void SetFixedStep(uint16_t urStep) noexcept;
+
     private:
         uint32_t _uiOldTime;        /**< The absolute time in milliseconds until the start of the current second */
         uint32_t _uiLastTime;       /**< The absolute time in milliseconds since the start of the application */
         float _fDeltaTime;          /**< The time in seconds since the last frame */
         uint16_t _urNumFrames;      /**< The number of frames in the past second */
         uint16_t _urFrameCount;     /**< The number of frames in the current second */
+        uint16_t _urFixedStep;      /**< The milliseconds per frame when the clock is not followed, or 0 */
+        uint32_t _uiFixedTime;      /**< The time in milliseconds when the clock is not followed */
 
 
         Time() noexcept;  /**< Default constructor */
@@ -79,7 +89,7 @@ class Time
 };
 
 
-inline uint32_t Time::GetTime() const noexcept { return SDL_GetTicks(); }
+inline uint32_t Time::GetTime() const noexcept { return (_urFixedStep != 0 ? _uiFixedTime : SDL_GetTicks()); }
 inline float Time::GetDeltaTime() const noexcept { return _fDeltaTime; }
 inline uint16_t Time::GetFPS() const noexcept { return _urNumFrames; }
 
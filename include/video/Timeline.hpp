@@ -0,0 +1,94 @@
+/*
+Timeline.hpp --- Clock shared by the animations on screen
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TIMELINE_HPP_
+#define _TIMELINE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "Animation.hpp"
+
+
+/**
+ * @brief Advances every animation being played by the same delta time once per loop, instead of each one
+ * reading the clock on its own. The timeline knows when the next frame change of any of them is due, so the
+ * main loop can sleep until then when nothing else changes the screen
+ */
+class Timeline
+{
+public:
+    /* Getters */
+    bool IsIdle() const noexcept;
+
+
+    Timeline() noexcept;    /**< Default constructor */
+
+    Timeline(const Timeline& CtimelineOther) = delete;              /**< Copy constructor */
+    Timeline& operator =(const Timeline& CtimelineOther) = delete;  /**< Copy assignment operator */
+
+
+    /**
+     * @brief Starts or stops playing an animation. A new animation starts counting from the last time the
+     * timeline was moved
+     *
+     * @param animation the animation, which must live until it is stopped or the timeline is cleared
+     * @param bIsPlaying true to play the animation, false to stop it where it is
+     */
+    void SetPlaying(Animation& animation, bool bIsPlaying);
+
+    /**
+     * @brief Tells whether an animation is being played
+     *
+     * @param Canimation the animation
+     * @return true if the animation is advanced by the timeline
+     */
+    bool IsPlaying(const Animation& Canimation) const noexcept;
+
+    /**
+     * @brief Stops every animation, which must be done before they are freed
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Moves the timeline to a time, advancing every animation being played by the time passed since
+     * it was last moved
+     *
+     * @param uiTime the current time in milliseconds
+     */
+    void Advance(uint32_t uiTime) noexcept;
+
+    /**
+     * @brief Gets the time of the next frame change of any animation being played
+     *
+     * @return uint32_t the time in milliseconds, only meaningful if the timeline is not idle
+     */
+    uint32_t GetNextDeadline() const noexcept;
+
+private:
+    std::vector<Animation*> _vectorpAnimations; /**< The animations being played */
+    uint32_t _uiTime;                           /**< The time the timeline was last moved to */
+
+};
+
+
+inline bool Timeline::IsIdle() const noexcept { return _vectorpAnimations.empty(); }
+
+
+#endif
@@ -25,6 +25,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <string>
 #include <sstream>
+#include <random>
+#include <exception>
 
 #include <SDL.h>
 #include <SDL_config.h>
@@ -55,9 +57,12 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "../../include/App.hpp"
 #include "../../include/Globals.hpp"
+#include "../../include/GameLog.hpp"
 #include "../../include/players/Human.hpp"
 #include "../../include/video/Vector3.hpp"
+#include "../../include/video/Time.hpp"
 #include "../../include/EventManager.hpp"
+#include "../../include/Trace.hpp"
 
 
 App& App::GetInstance()
@@ -72,12 +77,70 @@ App& App::GetInstance()
  */
 App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_START}, _settingsGlobal{},
     _loggerApp{"App", Globals::SCsLogDefaultPath}, _pSdlThreadAI{nullptr}, _pSdlSemaphoreAI{nullptr},
-    _bStopThreads{false}, _randomDeviceGenerator{}, _uniformDistribution{1, 6}, _grid{}, _htJoysticks{}, 
-    _vectorpPlayers{}, _uyCurrentPlayer{}, _bSingleController{true}, _yPlayColumn{0}, _rInitialX{0}, 
-    _rInitialY{0}, _htSurfaces{}, _htAnimations{}, _htButtons{}, _htSamples{}, _samplePlayerGlobal{nullptr}, 
-    _ttfFontContinuum{nullptr}
+    _bStopThreads{false}, _mersenneTwisterGenerator{std::random_device{}()}, 
+    _mersenneTwisterGeneratorMoves{}, _uniformDistribution{1, 6}, _uiSeed{0}, _rAIMove{-1}, 
+    _grid{}, _boardLayer{_timeline}, _htJoysticks{}, _vectorpPlayers{}, _uyCurrentPlayer{}, 
+    _bSingleController{true}, 
+    _yPlayColumn{0}, _gameLog{Globals::SCsGameLogDefaultPath}, _gameRecord{}, _gamePlayback{}, 
+    _uPlaybackMove{0}, _bPlaybackPending{false}, _bIsPlayback{false}, _uiGameStartTime{0}, 
+    _uiLastMoveTime{0}, _pTablebase{nullptr}, _evaluation{}, _rInitialX{0}, _rInitialY{0}, 
+    _pSurfaceDisplay{nullptr}, _registrySurfaces{}, _pAtlasUI{nullptr}, 
+    _textureCache{Globals::SCsTextureCacheDefaultPath}, _assetLoader{&_textureCache}, 
+    _registryAnimations{}, 
+    _registryButtons{}, _registrySamples{}, _samplePlayerGlobal{nullptr}, 
+    _handleSurfaceStart{_registrySurfaces.Resolve("Start")}, 
+    _handleSurfaceSettings{_registrySurfaces.Resolve("Settings")}, 
+    _handleSurfaceBackground{_registrySurfaces.Resolve("Background")}, 
+    _handleSurfaceHourglass{_registrySurfaces.Resolve("Hourglass")}, 
+    _handleSurfaceEmptyCell{_registrySurfaces.Resolve("EmptyCell")}, 
+    _handleSurfacePlayerMarker1{_registrySurfaces.Resolve("PlayerMarker1")}, 
+    _handleSurfacePlayerMarker2{_registrySurfaces.Resolve("PlayerMarker2")}, 
+    _handleSurfaceTextSingle{_registrySurfaces.Resolve("TextSingle")}, 
+    _handleSurfaceTextMulti{_registrySurfaces.Resolve("TextMulti")}, 
+    _handleSurfaceTextSettings{_registrySurfaces.Resolve("TextSettings")}, 
+    _handleSurfaceTextPrompt{_registrySurfaces.Resolve("TextPrompt")}, 
+    _handleSurfaceTextYes{_registrySurfaces.Resolve("TextYes")}, 
+    _handleSurfaceTextNo{_registrySurfaces.Resolve("TextNo")}, 
+    _handleSurfaceTextWidth{_registrySurfaces.Resolve("TextWidth")}, 
+    _handleSurfaceTextWidthValue{_registrySurfaces.Resolve("TextWidthValue")}, 
+    _handleSurfaceTextHeight{_registrySurfaces.Resolve("TextHeight")}, 
+    _handleSurfaceTextHeightValue{_registrySurfaces.Resolve("TextHeightValue")}, 
+    _handleSurfaceTextStreak{_registrySurfaces.Resolve("TextStreak")}, 
+    _handleSurfaceTextStreakValue{_registrySurfaces.Resolve("TextStreakValue")}, 
+    _handleSurfaceTextDifficulty{_registrySurfaces.Resolve("TextDifficulty")}, 
+    _handleSurfaceTextDifficultyValue{_registrySurfaces.Resolve("TextDifficultyValue")}, 
+    _handleSurfaceTextDevTools{_registrySurfaces.Resolve("TextDevTools")}, 
+    _handleAnimationLoading{_registryAnimations.Resolve("Loading")}, 
+    _handleAnimationWin{_registryAnimations.Resolve("Win")}, 
+    _handleButtonSinglePlayer{_registryButtons.Resolve("SinglePlayer")}, 
+    _handleButtonMultiPlayer{_registryButtons.Resolve("MultiPlayer")}, 
+    _handleButtonSettings{_registryButtons.Resolve("Settings")}, 
+    _handleButtonExit{_registryButtons.Resolve("Exit")}, 
+    _handleButtonYes{_registryButtons.Resolve("Yes")}, 
+    _handleButtonNo{_registryButtons.Resolve("No")}, 
+    _handleButtonMinusWidth{_registryButtons.Resolve("MinusWidth")}, 
+    _handleButtonPlusWidth{_registryButtons.Resolve("PlusWidth")}, 
+    _handleButtonMinusHeight{_registryButtons.Resolve("MinusHeight")}, 
+    _handleButtonPlusHeight{_registryButtons.Resolve("PlusHeight")}, 
+    _handleButtonMinusStreak{_registryButtons.Resolve("MinusStreak")}, 
+    _handleButtonPlusStreak{_registryButtons.Resolve("PlusStreak")}, 
+    _handleButtonMinusDifficulty{_registryButtons.Resolve("MinusDifficulty")}, 
+    _handleButtonPlusDifficulty{_registryButtons.Resolve("PlusDifficulty")}, 
+    _handleSampleMusic{_registrySamples.Resolve("Music")}, 
+    _handleSampleWaitingLoop{_registrySamples.Resolve("WaitingLoop")}, 
+    _ahandleSamplesSelect{}, _ahandleSamplesCancel{}, _ahandleSamplesError{}, _ahandleSamplesOpen{}, 
+    _spriteDefaultButton{}, _spriteHoverButton{}, _spriteHome{}, _spriteHomeHover{}, _spriteMinus{}, 
+    _spritePlus{}, _spritePrompt{}, _spriteDefaultYes{}, _spriteHoverYes{}, _spriteWinPlayer1{}, 
+    _spriteWinPlayer2{}, _spriteDraw{}, _spriteCursorHand{}, _spriteCursorShadow{}, _spriteCursorPlayer1{}, _spriteCursorPlayer2{}, 
+    _ttfFontContinuum{nullptr}, _textRenderer{}, _screenLayout{}, _sdlRectHourglass{0, 0, 0, 0}, 
+    _vectorButtonPlacements{}, _dirtyRects{}, _scene{}, _avectorSceneItems{}, _uRenderKey{0}, 
+    _sdlRectCursor{0, 0, 0, 0}, _uyDrawnPlayer{0}, _sdlRectHover{0, 0, 0, 0}, _uyDrawnWinFrame{0},
+    _cursorOverlay{}, _frameScheduler{Globals::SCurTargetFPS},
+    _timeline{},
+    _profiler{}, _renderThread{}
 {
     std::ios_base::sync_with_stdio();
+    _grid.SetListener(&_boardLayer);  // Moves are composited into the cached board
 
 	uint32_t uiSDLInitFlags = SDL_INIT_EVERYTHING;
 
@@ -113,6 +176,7 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
         int32_t iWidth{CpGXRMode->fbWidth}, iHeight{CpGXRMode->xfbHeight};
     #else
         int32_t iWidth{Globals::SCurAppWidth}, iHeight{Globals::SCurAppHeight};
+        uiSDLInitFlags |= SDL_RESIZABLE;    // The screens are placed again when the window changes its size
     #endif
 
     if (!SDL_VideoModeOK(iWidth, iHeight, CpSdlVideoInfoBest->vfmt->BitsPerPixel, uiSDLInitFlags))
@@ -141,11 +205,17 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
     if (Mix_Init(iInitFlags) != iInitFlags)
         throw std::runtime_error("Error initialising SDL_mixer support");
 
+    Mix_ChannelFinished(SamplePlayer::OnChannelFinished);
+
     if (!TTF_WasInit() && TTF_Init() == -1)
         throw std::runtime_error("Error initialising SDL_ttf support");
 
     Surface* pSurfaceDisplay{new Surface(SDL_GetVideoSurface())};
-    _htSurfaces.insert(std::make_pair("Display", pSurfaceDisplay));
+    _pSurfaceDisplay = pSurfaceDisplay;
+
+    // The screens are given for the preferred display, and they are placed on this one
+    _screenLayout.Resize(pSurfaceDisplay->GetWidth(), pSurfaceDisplay->GetHeight());
+    PlaceButtons();
     
     SDL_ShowCursor(SDL_DISABLE);    // Default cursor is rendered directly to video memory
     SDL_JoystickEventState(SDL_ENABLE);
@@ -180,18 +250,29 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
     try { _settingsGlobal = Settings{Globals::SCsSettingsDefaultPath}; }   // Load settings
     catch (...) {}
 
+    try { _evaluation = Evaluation{Globals::SCsWeightsDefaultPath}; }      // Load tuned weights
+    catch (...) {}  // The AI falls back to the default weights
+
+    if (!_settingsGlobal.GetPlaybackPath().empty())    // The game is started from the main screen
+    {
+        try 
+        { 
+            _gamePlayback = GameLog::Load(_settingsGlobal.GetPlaybackPath());
+            _bPlaybackPending = true;
+        }
+        catch (const std::exception& Cexception) { _loggerApp.Error(Cexception.what()); }
+    }
+
     /* Retrieve resources from the filesystem */
 
     try
     {
         // Surfaces
 
-        _htSurfaces.insert(std::make_pair("Start", LoadTexture("start.png")));
-        _htSurfaces.insert(std::make_pair("DefaultHome", LoadTexture("68370.png")));
-        _htSurfaces.insert(std::make_pair("DefaultButton", LoadTexture("defaultbutton.png")));
-        _htSurfaces.insert(std::make_pair("HoverButton", LoadTexture("hoverbutton.png")));
-        _htSurfaces.insert(std::make_pair("CursorHand", LoadTexture("cursorhand.png")));
-        _htSurfaces.insert(std::make_pair("CursorShadow", LoadTexture("cursorshadow.png")));
+        _registrySurfaces.Set(_handleSurfaceStart, LoadTexture("start.png"));
+        _pAtlasUI = LoadAtlas("ui");    // Buttons, cursors and banners
+        ResolveSprites();
+        ResolveScene();
 
         // Fonts and texts
 
@@ -204,17 +285,23 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
         sdlColorText.g = 3;
         sdlColorText.b = 3;
 
-        _htSurfaces.insert(std::make_pair("TextSingle", GenerateText("Single Player (vs AI)", 
-            _ttfFontContinuum, sdlColorText)));
-        _htSurfaces.insert(std::make_pair("TextMulti", GenerateText("2 Players", 
-            _ttfFontContinuum, sdlColorText)));
-        _htSurfaces.insert(std::make_pair("TextSettings", GenerateText("Settings", 
-            _ttfFontContinuum, sdlColorText)));
+        _registrySurfaces.Set(_handleSurfaceTextSingle, GenerateText("Single Player (vs AI)", 
+            _ttfFontContinuum, sdlColorText));
+        _registrySurfaces.Set(_handleSurfaceTextMulti, GenerateText("2 Players", 
+            _ttfFontContinuum, sdlColorText));
+        _registrySurfaces.Set(_handleSurfaceTextSettings, GenerateText("Settings", 
+            _ttfFontContinuum, sdlColorText));
+
+        // Shared between states, so they are loaded once
+        _registrySurfaces.SetResident(_handleSurfaceStart);
+        _registrySurfaces.SetResident(_handleSurfaceTextSingle);
+        _registrySurfaces.SetResident(_handleSurfaceTextMulti);
+        _registrySurfaces.SetResident(_handleSurfaceTextSettings);
 
         // Music
 
         Sample* pSampleTemp{new Sample(Globals::SCsAudioDefaultPath + "thinking.wav")};
-        _htSamples.insert(std::make_pair("Music", pSampleTemp));
+        _registrySamples.Set(_handleSampleMusic, pSampleTemp);
         _samplePlayerGlobal.SetSample(pSampleTemp);
         _samplePlayerGlobal.Play(-1, 2000, -1);
 
@@ -222,28 +309,32 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
         for (int32_t i = 1; i <= 6; i++)
         {
             ossTemp << "cancel" << i;
-            _htSamples.insert(std::make_pair(ossTemp.str(), new Sample(Globals::SCsAudioDefaultPath + 
-                "sfx/" + ossTemp.str() + ".wav")));
+            _ahandleSamplesCancel[i - 1] = _registrySamples.Resolve(ossTemp.str());
+            _registrySamples.Set(_ahandleSamplesCancel[i - 1], new Sample(Globals::SCsAudioDefaultPath + 
+                "sfx/" + ossTemp.str() + ".wav"));
             ossTemp.str("");
 
             ossTemp << "select" << i;
-            _htSamples.insert(std::make_pair(ossTemp.str(), new Sample(Globals::SCsAudioDefaultPath + 
-                "sfx/" + ossTemp.str() + ".wav")));
+            _ahandleSamplesSelect[i - 1] = _registrySamples.Resolve(ossTemp.str());
+            _registrySamples.Set(_ahandleSamplesSelect[i - 1], new Sample(Globals::SCsAudioDefaultPath + 
+                "sfx/" + ossTemp.str() + ".wav"));
             ossTemp.str("");
 
             if (i <= 2)
             {
                 ossTemp << "error" << i;
-                _htSamples.insert(std::make_pair(ossTemp.str(), new Sample(Globals::SCsAudioDefaultPath + 
-                    "sfx/" + ossTemp.str() + ".wav")));
+                _ahandleSamplesError[i - 1] = _registrySamples.Resolve(ossTemp.str());
+                _registrySamples.Set(_ahandleSamplesError[i - 1], new Sample(Globals::SCsAudioDefaultPath + 
+                    "sfx/" + ossTemp.str() + ".wav"));
                 ossTemp.str("");
             }
 
             if (i <= 3)
             {
                 ossTemp << "open" << i;
-                _htSamples.insert(std::make_pair(ossTemp.str(), new Sample(Globals::SCsAudioDefaultPath + 
-                    "sfx/" + ossTemp.str() + ".wav")));
+                _ahandleSamplesOpen[i - 1] = _registrySamples.Resolve(ossTemp.str());
+                _registrySamples.Set(_ahandleSamplesOpen[i - 1], new Sample(Globals::SCsAudioDefaultPath + 
+                    "sfx/" + ossTemp.str() + ".wav"));
                 ossTemp.str("");
             }
         }
@@ -251,19 +342,20 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
     catch(...)
     {
         /* Delete surfaces */
-        for (std::unordered_map<std::string, Surface*>::iterator i = _htSurfaces.begin();
-            i != _htSurfaces.end(); ++i) if (i->first != "Display") delete i->second;   // The display surface must be freed by SDL_Quit
+        _registrySurfaces.Clear();  // The display surface must be freed by SDL_Quit
+        delete _pAtlasUI;
         
+        _textRenderer.Clear();
         if (_ttfFontContinuum) TTF_CloseFont(_ttfFontContinuum);
 
         throw;
     }
 
     /* Create main buttons */
-    _htButtons.insert(std::make_pair("SinglePlayer", new Button(Vector3(240, 150), Vector3(393, 223))));
-    _htButtons.insert(std::make_pair("MultiPlayer", new Button(Vector3(240, 230), Vector3(393, 303))));
-    _htButtons.insert(std::make_pair("Settings", new Button(Vector3(240, 310), Vector3(393, 383))));
-    _htButtons.insert(std::make_pair("Exit", new Button(Vector3(25, 381), Vector3(97, 453))));
+    SetButton(_handleButtonSinglePlayer, 240, 150, 393, 223);
+    SetButton(_handleButtonMultiPlayer, 240, 230, 393, 303);
+    SetButton(_handleButtonSettings, 240, 310, 393, 383);
+    SetButton(_handleButtonExit, 25, 381, 97, 453, ScreenLayout::ANCHOR_BOTTOM_LEFT);
 
     // Receive events
     EventManager::GetInstance().AttachListener(*this);
@@ -277,6 +369,7 @@ App::App() : EventListener(), _bRunning{true}, _eStateCurrent{EState::STATE_STAR
 App::~App() noexcept
 {
     /* Signal threads to stop */
+    _renderThread.Stop();   // Gives back the surfaces held by the recorded frames
     _bStopThreads = true;
 
     while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
@@ -293,25 +386,32 @@ App::~App() noexcept
     for (std::vector<Player*>::iterator i = _vectorpPlayers.begin(); i != _vectorpPlayers.end(); ++i)
         delete *i;
 
+    delete _pTablebase;
+
     /* Delete surfaces */
-    for (std::unordered_map<std::string, Surface*>::iterator i = _htSurfaces.begin();
-        i != _htSurfaces.end(); ++i) if (i->first != "Display") delete i->second;   // The display surface must be freed by SDL_Quit
+    _assetLoader.Stop();
+    _registrySurfaces.Clear();  // The display surface must be freed by SDL_Quit
+    delete _pAtlasUI;
 
-    /* Delete buttons */
-    for (std::unordered_map<std::string, Button*>::iterator i = _htButtons.begin(); 
-        i != _htButtons.end(); ++i) delete i->second;
+    /* Delete buttons and animations */
+    _registryButtons.Clear();
+    _timeline.Clear();
+    _registryAnimations.Clear();
 
     /* Delete samples */
-    for (std::unordered_map<std::string, Sample*>::iterator i = _htSamples.begin(); 
-        i != _htSamples.end(); ++i) 
+    for (Sample* pSample : _registrySamples)
     {
-        _samplePlayerGlobal.SetSample(i->second);
-        _samplePlayerGlobal.Stop();
-        delete i->second;
+        if (pSample)
+        {
+            _samplePlayerGlobal.SetSample(pSample);
+            _samplePlayerGlobal.Stop();
+        }
     }
     _samplePlayerGlobal.SetSample(nullptr);
+    _registrySamples.Clear();
 
     // Close fonts
+    _textRenderer.Clear();
     TTF_CloseFont(_ttfFontContinuum);
 
     // Unload text libraries
@@ -321,6 +421,9 @@ App::~App() noexcept
     while (Mix_Init(0)) Mix_Quit();
     while (Mix_QuerySpec(nullptr, nullptr, nullptr)) Mix_CloseAudio();
 
+    // Every thread is gone, so the trace covers the whole run
+    if (Trace::IsEnabled()) FlushTrace();
+
     // Unload image libraries
     IMG_Quit();
 
@@ -340,11 +443,40 @@ void App::OnExecute()
     
     while(_bRunning)
     {
-        while(SDL_PollEvent(&sdlEvent)) CeventManager.OnEvent(&sdlEvent);
+        _profiler.SetEnabled(_settingsGlobal.GetIsDev());
+        Trace::SetEnabled(_settingsGlobal.GetIsDev());
+        TRACE_THREAD_NAME("Main");
+        _profiler.BeginFrame();
 
-        OnLoop();
-        OnRender();
+        {
+            Profiler::ScopedTimer timerEvents{_profiler, Profiler::ESection::SECTION_EVENTS};
+            while(_renderThread.PollEvent(&sdlEvent)) CeventManager.OnEvent(&sdlEvent);
+        }
+
+        {
+            Profiler::ScopedTimer timerLoop{_profiler, Profiler::ESection::SECTION_LOOP};
+            OnLoop();
+        }
+
+        // A frame still being drawn is never waited for, the regions changed meanwhile go in the next one
+        bool bIsRenderBusy{_renderThread.IsBusy()};
+        if (!bIsRenderBusy) OnRender();
+        _profiler.EndFrame();
 
-        SDL_Delay(10);  // Give up some CPU to allow events to arrive
+        if (IsAnimating() || bIsRenderBusy) _frameScheduler.WaitForNextFrame();
+        else if (_bRunning)     // Nothing changes on screen until an event arrives or an animation moves on
+        {
+            bool bHasEvent{false};
+            if (_timeline.IsIdle()) bHasEvent = _renderThread.WaitEvent(&sdlEvent);
+            else
+            {
+                int32_t iRemaining{static_cast<int32_t>(_timeline.GetNextDeadline() -
+                    Time::GetInstance().GetTime())};
+                bHasEvent = _renderThread.WaitEventTimeout(&sdlEvent, std::max<int32_t>(iRemaining, 0));
+            }
+
+            if (bHasEvent) CeventManager.OnEvent(&sdlEvent);
+            _frameScheduler.Resync();
+        }
     }
 }
@@ -0,0 +1,167 @@
+/*
+App_Benchmark.cpp --- App rendering benchmark
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+
+#include <SDL_events.h>
+#include <SDL_timer.h>
+
+#include "../../include/App.hpp"
+#include "../../include/Settings.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/Profiler.hpp"
+#include "../../include/Trace.hpp"
+#include "../../include/EventManager.hpp"
+#include "../../include/video/Time.hpp"
+#include "../../include/players/ScriptedInput.hpp"
+
+
+/**
+ * @brief Draws every screen for a number of frames as fast as possible and prints their frame times,
+ * instead of running the application. The clock advances one frame period per frame, so the same
+ * build always draws the same frames
+ *
+ * @param uiFrames the frames drawn of every screen
+ * @param CsScriptPath the path of a script of input events, see ScriptedInput, empty for none
+ * @param CsChecksumPath the path of a file that receives the checksum of every frame, empty for none
+ */
+void App::OnBenchmark(uint32_t uiFrames, const std::string& CsScriptPath, const std::string& CsChecksumPath)
+{
+    ScriptedInput scriptedInput{};
+    if (!CsScriptPath.empty()) scriptedInput = ScriptedInput{CsScriptPath};
+
+    std::ofstream ofstreamChecksums{};
+    if (!CsChecksumPath.empty())
+    {
+        ofstreamChecksums.open(CsChecksumPath, std::ios_base::out | std::ios_base::trunc);
+        if (!ofstreamChecksums) throw std::ios_base::failure("Error opening file " + CsChecksumPath);
+        ofstreamChecksums << "screen,frame,crc32\n";
+    }
+
+    // The frames must not depend on the settings of the machine nor on the speed of the loop
+    _settingsGlobal = Settings{};
+    _bPlaybackPending = false;
+    Time::GetInstance().SetFixedStep(1000 / Globals::SCurTargetFPS);
+    TRACE_THREAD_NAME("Main");
+
+    std::printf("%-10s %8s %10s %10s %10s\n", "Screen", "Frames", "Min ms", "Avg ms", "P99 ms");
+    uint32_t uiFrame{0};
+
+    BenchmarkScreen("Start", uiFrames, true, scriptedInput, ofstreamChecksums, uiFrame);
+
+    LoadSettings();
+    BenchmarkScreen("Settings", uiFrames, true, scriptedInput, ofstreamChecksums, uiFrame);
+    Reset();
+
+    // Nothing is collected while the loading screen is measured, so its progress bar stays still
+    StartGame(false);
+    BenchmarkScreen("Loading", uiFrames, false, scriptedInput, ofstreamChecksums, uiFrame);
+    while (!_assetLoader.IsDone())
+    {
+        _assetLoader.Collect(_registrySurfaces);
+        SDL_Delay(1);
+    }
+    OnGameLoaded();
+
+    // A few pieces on the board, without a winner yet
+    for (uint8_t i = 0; i < 6 && _eStateCurrent == EState::STATE_INGAME; ++i)
+        if (_grid.IsValidMove(i % 2)) PlayMove(i % 2);
+    BenchmarkScreen("InGame", uiFrames, true, scriptedInput, ofstreamChecksums, uiFrame);
+
+    _eStateCurrent = EState::STATE_PROMPT;
+    BenchmarkScreen("Prompt", uiFrames, true, scriptedInput, ofstreamChecksums, uiFrame);
+    _eStateCurrent = EState::STATE_INGAME;
+
+    // The first player completes the column
+    while (_eStateCurrent == EState::STATE_INGAME && _grid.IsValidMove(0)) PlayMove(0);
+    BenchmarkScreen("End", uiFrames, true, scriptedInput, ofstreamChecksums, uiFrame);
+    Reset();
+
+    Time::GetInstance().SetFixedStep(0);
+    if (ofstreamChecksums.is_open() && !ofstreamChecksums)
+        throw std::ios_base::failure("Error writing file " + CsChecksumPath);
+}
+
+
+/**
+ * @brief Runs the main loop on the current screen for a number of frames and prints their frame times
+ *
+ * @param CpName the name of the screen in the report and in the checksums
+ * @param uiFrames the frames to draw
+ * @param bLoop false to draw the frames without updating the state, so the screen stays the same
+ * @param scriptedInput the input events of the benchmark
+ * @param ofstreamChecksums the file of checksums, if it is open
+ * @param uiFrame the frame of the whole benchmark, which is advanced
+ */
+void App::BenchmarkScreen(const char* CpName, uint32_t uiFrames, bool bLoop, ScriptedInput& scriptedInput,
+    std::ofstream& ofstreamChecksums, uint32_t& uiFrame)
+{
+    SDL_Event sdlEvent{};
+    const EventManager& CeventManager{EventManager::GetInstance()};
+
+    // Every screen is summarised on its own, over all its frames, which may be more than the profiler keeps
+    _profiler = Profiler{};
+    _profiler.SetEnabled(true);
+    _dirtyRects.Invalidate();
+
+    std::vector<uint32_t> vectoruiFrameTimes{};
+    vectoruiFrameTimes.reserve(uiFrames);
+
+    for (uint32_t i = 0; i < uiFrames && _bRunning; ++i, ++uiFrame)
+    {
+        _profiler.BeginFrame();
+        scriptedInput.Inject(uiFrame);
+
+        {
+            Profiler::ScopedTimer timerEvents{_profiler, Profiler::ESection::SECTION_EVENTS};
+            while(_renderThread.PollEvent(&sdlEvent)) CeventManager.OnEvent(&sdlEvent);
+        }
+
+        {
+            Profiler::ScopedTimer timerLoop{_profiler, Profiler::ESection::SECTION_LOOP};
+            if (bLoop) OnLoop();
+            else Time::GetInstance().OnLoop();
+        }
+
+        // Every frame is drawn whole before the next one, so none is skipped and the checksums are stable
+        OnRender();
+        _renderThread.Wait();
+        _profiler.EndFrame();
+        vectoruiFrameTimes.push_back(_profiler.GetFrameTime(0));
+
+        if (ofstreamChecksums.is_open())
+        {
+            ofstreamChecksums << CpName << ',' << i << ',' << std::hex << std::setw(8) << std::setfill('0') <<
+                _pSurfaceDisplay->GetChecksum() << std::dec << '\n';
+        }
+    }
+
+    Profiler::Stats statsFrame{Profiler::Summarise(vectoruiFrameTimes)};
+    std::printf("%-10s %8u %10.3f %10.3f %10.3f\n", CpName, static_cast<uint32_t>(vectoruiFrameTimes.size()),
+        statsFrame.fMin, statsFrame.fAverage, statsFrame.fP99);
+    _loggerApp.Info(std::string(CpName) + ": " + std::to_string(statsFrame.fAverage) + " ms average, " +
+        std::to_string(statsFrame.fP99) + " ms p99");
+}
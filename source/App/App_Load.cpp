@@ -25,6 +25,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <ios>
 #include <stdexcept>
+#include <random>
+#include <initializer_list>
 
 #include <SDL_mutex.h>
 #include <SDL_thread.h>
@@ -39,7 +41,15 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "../../include/players/AI.hpp"
 #include "../../include/players/Human.hpp"
 #include "../../include/Grid.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/GameLog.hpp"
+#include "../../include/GameRecord.hpp"
+#include "../../include/Tablebase.hpp"
+#include "../../include/Trace.hpp"
+#include "../../include/video/Time.hpp"
 #include "../../include/video/Button.hpp"
+#include "../../include/video/Vector3.hpp"
+#include "../../include/video/ScreenLayout.hpp"
 #include "../../include/video/Surface.hpp"
 
 
@@ -54,6 +64,7 @@ void App::Reset()
     while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
     SDL_WaitThread(_pSdlThreadAI, nullptr);
     _pSdlThreadAI = nullptr;
+    _rAIMove = -1;  // A move chosen for the game being left
 
     _bStopThreads = false;
 
@@ -71,6 +82,9 @@ void App::Reset()
         delete *i;
     _vectorpPlayers = std::vector<Player*>();
 
+    delete _pTablebase;
+    _pTablebase = nullptr;
+
     #ifdef __wii__
         /* Create a new main player */
         WiiController* pJoystickWii{new WiiController(0)};
@@ -89,263 +103,287 @@ void App::Reset()
 
     _vectorpPlayers.push_back(pPlayerMain);
 
-    // Reload surfaces
-    std::unordered_map<std::string, Surface*>::iterator i = _htSurfaces.begin();
-    while (i != _htSurfaces.end()) 
+    // Release surfaces, the start screen and the UI atlas stay resident
+    _assetLoader.Stop();
+    _scene.Invalidate();
+    _registrySurfaces.Release();
+
+    // Reload animations
+    _timeline.Clear();
+    _registryAnimations.Clear();
+
+    // Reload buttons
+    _registryButtons.Clear();
+
+    SetButton(_handleButtonSinglePlayer, 240, 150, 393, 223);
+    SetButton(_handleButtonMultiPlayer, 240, 230, 393, 303);
+    SetButton(_handleButtonSettings, 240, 310, 393, 383);
+    SetButton(_handleButtonExit, 25, 380, 97, 452, ScreenLayout::ANCHOR_BOTTOM_LEFT);
+
+    // Reload music
+    if (_registrySamples[_handleSampleWaitingLoop])
     {
-        if (i->first != "Display") 
-        {
-            delete i->second;
-            i = _htSurfaces.erase(i);
-        }
-        else ++i;
+        _samplePlayerGlobal.SetSample(_registrySamples[_handleSampleWaitingLoop]);
+        _samplePlayerGlobal.Stop();
+        _registrySamples.Erase(_handleSampleWaitingLoop);
     }
 
-    _htSurfaces.insert(std::make_pair("Start", LoadTexture("start.png")));
-    _htSurfaces.insert(std::make_pair("DefaultHome", LoadTexture("68370.png")));
-    _htSurfaces.insert(std::make_pair("DefaultButton", LoadTexture("defaultbutton.png")));
-    _htSurfaces.insert(std::make_pair("HoverButton", LoadTexture("hoverbutton.png")));
-    _htSurfaces.insert(std::make_pair("CursorHand", LoadTexture("cursorhand.png")));
-    _htSurfaces.insert(std::make_pair("CursorShadow", LoadTexture("cursorshadow.png")));
+    _uyCurrentPlayer = 0;
+    _bIsPlayback = false;
+    _eStateCurrent = EState::STATE_START;
+}
+
+
+void App::LoadGame()
+{
+    // Release surfaces, the ones shared with the start screen stay resident
+    _scene.Invalidate();
+    _registrySurfaces.Release();
+
+    const Surface* CpSurfaceDisplay{_pSurfaceDisplay};
+
+    // Decoded and scaled in the background, the board is laid out when every texture is in
+    QueueTexture(_handleSurfaceBackground, "background.png", CpSurfaceDisplay->GetWidth(),
+        CpSurfaceDisplay->GetHeight());
+    QueueTexture(_handleSurfaceHourglass, "hourglass.png");
+
+    // The grid cells and markers are scaled to fill the display
+    uint16_t urFitWidth{static_cast<uint16_t>(CpSurfaceDisplay->GetWidth() / 
+        _settingsGlobal.GetBoardWidth())};
+    uint16_t urFitHeight{static_cast<uint16_t>(CpSurfaceDisplay->GetHeight() / 
+        _settingsGlobal.GetBoardHeight())};
+
+    QueueTexture(_handleSurfaceEmptyCell, "emptycell.png", urFitWidth, urFitHeight);
+    QueueTexture(_handleSurfacePlayerMarker1, "playermarker1.png", urFitWidth, urFitHeight);
+    QueueTexture(_handleSurfacePlayerMarker2, "playermarker2.png", urFitWidth, urFitHeight);
 
     // Reload texts
+
     SDL_Color sdlColorText{};
     sdlColorText.r = 252;
     sdlColorText.g = 3;
     sdlColorText.b = 3;
 
-    _htSurfaces.insert(std::make_pair("TextSingle", GenerateText("Single Player (vs AI)", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextMulti", GenerateText("2 Players", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextSettings", GenerateText("Settings", 
-        _ttfFontContinuum, sdlColorText)));
+    _registrySurfaces.Set(_handleSurfaceTextPrompt, GenerateText("Are you sure you want to quit?", 
+            _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextYes, GenerateText("Yes", _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextNo, GenerateText("No", _ttfFontContinuum, sdlColorText));
 
     // Reload animations
-    for (std::unordered_map<std::string, Animation*>::iterator j = _htAnimations.begin(); 
-        j != _htAnimations.end(); ++j) delete j->second;
-    _htAnimations.clear();
+    _timeline.Clear();
+    _registryAnimations.Clear();
+    
+    _registryAnimations.Set(_handleAnimationLoading, new Animation(16, 100));
+    _registryAnimations.Set(_handleAnimationWin, new Animation(2, 500));
 
     // Reload buttons
-    for (std::unordered_map<std::string, Button*>::iterator j = _htButtons.begin(); 
-        j != _htButtons.end(); ++j) delete j->second;
-    _htButtons.clear();
+    _registryButtons.ClearExcept(_handleButtonExit);
 
-    _htButtons.insert(std::make_pair("SinglePlayer", new Button(Vector3(240, 150), Vector3(393, 223))));
-    _htButtons.insert(std::make_pair("MultiPlayer", new Button(Vector3(240, 230), Vector3(393, 303))));
-    _htButtons.insert(std::make_pair("Settings", new Button(Vector3(240, 310), Vector3(393, 383))));
-    _htButtons.insert(std::make_pair("Exit", new Button(Vector3(25, 380), Vector3(97, 452))));
+    SetButton(_handleButtonYes, 250, 240, 292, 276);
+    SetButton(_handleButtonNo, 350, 240, 392, 276);
 
     // Reload music
-    std::unordered_map<std::string, Sample*>::iterator k = _htSamples.begin();
-    while (k != _htSamples.end()) 
-    {
-        if (k->first != "Music" && !k->first.starts_with("cancel") && !k->first.starts_with("error")
-            && !k->first.starts_with("open") && !k->first.starts_with("select")) 
-        {
-            _samplePlayerGlobal.SetSample(k->second);
-            _samplePlayerGlobal.Stop();
-            delete k->second;
-            k = _htSamples.erase(k);
-        }
-        else ++k;
-    }
+    _registrySamples.Erase(_handleSampleWaitingLoop);
+    _registrySamples.Set(_handleSampleWaitingLoop, new Sample(Globals::SCsAudioDefaultPath + 
+        "waitingloop.wav"));
 
-    _uyCurrentPlayer = 0;
-    _eStateCurrent = EState::STATE_START;
+    // Create grid and wait for the textures
+
+    _grid = Grid{_settingsGlobal.GetBoardWidth(), _settingsGlobal.GetBoardHeight(), // Create grid
+        _settingsGlobal.GetCellsToWin()};
+
+    _eStateCurrent = EState::STATE_LOADING;
 }
 
 
-void App::LoadGame()
+/**
+ * @brief Lays out the board once every texture queued by LoadGame has been collected, starting the game
+ */
+void App::OnGameLoaded()
 {
-    // Reload surfaces
-    std::unordered_map<std::string, Surface*>::iterator i = _htSurfaces.begin();
-    while (i != _htSurfaces.end()) 
+    const Surface* CpSurfaceDisplay{_pSurfaceDisplay};
+
+    // The board is composited over a copy of the background, so one that does not cover the display after
+    // its upscale is centred once on a black surface of the size of the display
+    Surface& surfaceBackground{_registrySurfaces.At(_handleSurfaceBackground)};
+    if (surfaceBackground.GetWidth() < CpSurfaceDisplay->GetWidth() ||
+        surfaceBackground.GetHeight() < CpSurfaceDisplay->GetHeight())
     {
-        if (i->first != "Display" && i->first != "DefaultHome" && i->first != "CursorHand" &&
-            i->first != "CursorShadow" && i->first != "TextSettings") 
-        {
-            delete i->second;
-            i = _htSurfaces.erase(i);
-        }
-        else ++i;
+        const SDL_PixelFormat* CpSdlPixelFormat{CpSurfaceDisplay->GetPixelFormat()};
+        SDL_Surface* pSdlSurfaceFit{SDL_CreateRGBSurface(SDL_SWSURFACE, CpSurfaceDisplay->GetWidth(),
+            CpSurfaceDisplay->GetHeight(), CpSdlPixelFormat->BitsPerPixel, CpSdlPixelFormat->Rmask,
+            CpSdlPixelFormat->Gmask, CpSdlPixelFormat->Bmask, 0)};
+        if (pSdlSurfaceFit == nullptr) throw std::runtime_error(SDL_GetError());
+
+        Surface* pSurfaceFit{new Surface(pSdlSurfaceFit)};
+        surfaceBackground.OnDraw(*pSurfaceFit, 
+            (CpSurfaceDisplay->GetWidth() - surfaceBackground.GetWidth()) / 2,
+            (CpSurfaceDisplay->GetHeight() - surfaceBackground.GetHeight()) / 2);
+        _registrySurfaces.Set(_handleSurfaceBackground, pSurfaceFit);
+    }
+
+    // The cells are blended over the board every time a marker is placed
+    for (SurfaceHandle handle : {_handleSurfaceEmptyCell, _handleSurfacePlayerMarker1,
+        _handleSurfacePlayerMarker2})
+    {
+        Surface& surfaceCell{_registrySurfaces.At(handle)};
+        if (surfaceCell.GetPixelFormat()->Amask != 0) surfaceCell.Premultiply();
     }
 
-    const Surface* CpSurfaceDisplay{_htSurfaces.at("Display")};
-
-    _htSurfaces.insert(std::make_pair("Background", LoadTexture("background.png")));
-    _htSurfaces.insert(std::make_pair("Hourglass", LoadTexture("hourglass.png")));
-    _htSurfaces.insert(std::make_pair("Prompt", LoadTexture("prompt.png")));
-    _htSurfaces.insert(std::make_pair("DefaultYes", LoadTexture("defaultyes.png")));
-    _htSurfaces.insert(std::make_pair("HoverYes", LoadTexture("hoveryes.png")));
-    _htSurfaces.insert(std::make_pair("WinPlayer1", LoadTexture("winplayer1.png")));
-    _htSurfaces.insert(std::make_pair("WinPlayer2", LoadTexture("winplayer2.png")));
-    _htSurfaces.insert(std::make_pair("Draw", LoadTexture("draw.png")));
-    _htSurfaces.insert(std::make_pair("CursorPlayer1", LoadTexture("cursorplayer1.png")));
-    _htSurfaces.insert(std::make_pair("CursorPlayer2", LoadTexture("cursorplayer2.png")));
-
-    Surface* pSurfaceTemp{LoadTexture("emptycell.png")};
-
-    // Adjust the grid cells and markers
-    uint16_t urScale{static_cast<uint16_t>(std::min(
-        CpSurfaceDisplay->GetWidth() / pSurfaceTemp->GetWidth() / _settingsGlobal.GetBoardWidth(),
-        CpSurfaceDisplay->GetHeight() / pSurfaceTemp->GetHeight() / 
-        _settingsGlobal.GetBoardHeight()))};
-        
-    pSurfaceTemp->Scale(urScale, urScale);
-    _htSurfaces.insert(std::make_pair("EmptyCell", pSurfaceTemp));
-
-    pSurfaceTemp = LoadTexture("playermarker1.png");
-    pSurfaceTemp->Scale(urScale, urScale);
-    _htSurfaces.insert(std::make_pair("PlayerMarker1", pSurfaceTemp));
-
-    pSurfaceTemp = LoadTexture("playermarker2.png");
-    pSurfaceTemp->Scale(urScale, urScale);
-    _htSurfaces.insert(std::make_pair("PlayerMarker2", pSurfaceTemp));
+    PlaceBoard();
+
+    // The clock of the game starts when it can be seen
+    _uiGameStartTime = _uiLastMoveTime = Time::GetInstance().GetTime();
+
+    _eStateCurrent = EState::STATE_INGAME; // Start the game
+}
+
+
+/**
+ * @brief Centres the board on the display
+ */
+void App::PlaceBoard()
+{
+    const Surface* CpSurfaceDisplay{_pSurfaceDisplay};
+    const Surface& CsurfaceMarker{_registrySurfaces.At(_handleSurfacePlayerMarker2)};
 
     uint8_t uyBoardWidth{_settingsGlobal.GetBoardWidth()};
     _rInitialX = (CpSurfaceDisplay->GetWidth() >> 1) - 
-        ((uyBoardWidth >> 1) * pSurfaceTemp->GetWidth());
-    if (uyBoardWidth % 2 != 0) _rInitialX -= pSurfaceTemp->GetWidth() >> 1;
+        ((uyBoardWidth >> 1) * CsurfaceMarker.GetWidth());
+    if (uyBoardWidth % 2 != 0) _rInitialX -= CsurfaceMarker.GetWidth() >> 1;
 
     uint8_t uyBoardHeight{_settingsGlobal.GetBoardHeight()};
     _rInitialY = (CpSurfaceDisplay->GetHeight() >> 1) - 
-        ((uyBoardHeight >> 1) * pSurfaceTemp->GetHeight());
-    if (uyBoardHeight % 2 != 0) _rInitialY -= pSurfaceTemp->GetHeight() >> 1;
-
-    // Reload texts
-
-    SDL_Color sdlColorText{};
-    sdlColorText.r = 252;
-    sdlColorText.g = 3;
-    sdlColorText.b = 3;
+        ((uyBoardHeight >> 1) * CsurfaceMarker.GetHeight());
+    if (uyBoardHeight % 2 != 0) _rInitialY -= CsurfaceMarker.GetHeight() >> 1;
 
-    _htSurfaces.insert(std::make_pair("TextPrompt", GenerateText("Are you sure you want to quit?", 
-            _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextYes", GenerateText("Yes", _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextNo", GenerateText("No", _ttfFontContinuum, sdlColorText)));
+    _boardLayer.SetSurfaces(_registrySurfaces[_handleSurfaceBackground],
+        _registrySurfaces[_handleSurfaceEmptyCell], _registrySurfaces[_handleSurfacePlayerMarker1],
+        _registrySurfaces[_handleSurfacePlayerMarker2], _rInitialX, _rInitialY);
+}
 
-    // Reload animations
-    for (std::unordered_map<std::string, Animation*>::iterator j = _htAnimations.begin(); 
-        j != _htAnimations.end(); ++j) delete j->second;
-    _htAnimations.clear();
-    
-    _htAnimations.insert(std::make_pair("Loading", new Animation(16, 100)));
-    _htAnimations.insert(std::make_pair("Win", new Animation(2, 500)));
 
-    // Reload buttons
-    std::unordered_map<std::string, Button*>::iterator j = _htButtons.begin();
-    while (j != _htButtons.end()) 
+/**
+ * @brief Loads the game and creates the second player
+ *
+ * @param bSinglePlayer true if the second player is the AI
+ */
+void App::StartGame(bool bSinglePlayer)
+{
+    if (_bIsPlayback)   // Replay the game with the configuration it was recorded with
     {
-        if (j->first != "Exit") 
-        {
-            delete j->second;
-            j = _htButtons.erase(j);
-        }
-        else ++j;
+        _settingsGlobal.SetBoardWidth(_gamePlayback.uyWidth);
+        _settingsGlobal.SetBoardHeight(_gamePlayback.uyHeight);
+        _settingsGlobal.SetCellsToWin(_gamePlayback.uyCellsToWin);
+        _settingsGlobal.SetAIDifficulty(_gamePlayback.uyAIDifficulty);
+        bSinglePlayer = _gamePlayback.bSinglePlayer;
     }
 
-    _htButtons.insert(std::make_pair("Yes", new Button(Vector3(250, 240), Vector3(292, 276))));
-    _htButtons.insert(std::make_pair("No", new Button(Vector3(350, 240), Vector3(392, 276))));
+    LoadGame();
 
-    // Reload music
-    std::unordered_map<std::string, Sample*>::iterator k = _htSamples.begin();
-    while (k != _htSamples.end()) 
+    // Every game gets its own seed so the sounds of the moves can be reproduced from the log
+    _uiSeed = (_bIsPlayback ? _gamePlayback.uiSeed : std::random_device{}());
+    _mersenneTwisterGeneratorMoves.seed(_uiSeed);
+
+    if (bSinglePlayer)
     {
-        if (k->first != "Music" && !k->first.starts_with("cancel") && !k->first.starts_with("error")
-            && !k->first.starts_with("open") && !k->first.starts_with("select")) 
+        // Small boards are solved offline, the AI plays them perfectly if their tablebase is installed
+        if (Tablebase::GetEntryCount(_grid.GetWidth(), _grid.GetHeight()) != 0)
         {
-            delete k->second;
-            k = _htSamples.erase(k);
+            try 
+            { 
+                _pTablebase = new Tablebase(Globals::SCsTablebasesDefaultPath + Tablebase::GetFileName(
+                    _grid.GetWidth(), _grid.GetHeight(), _grid.GetCellsToWin())); 
+            }
+            catch (...) { _pTablebase = nullptr; }
         }
-        else ++k;
+
+        // Create an AI player
+        AI* pAI{new AI(Grid::EPlayerMark::PLAYER2,
+            Globals::SCauiAINodeBudgets[_settingsGlobal.GetAIDifficulty() - 1])};
+        pAI->SetTablebase(_pTablebase);
+        pAI->SetEvaluation(_evaluation);
+        _vectorpPlayers.push_back(pAI);
+        _pSdlThreadAI = SDL_CreateThread(RunAI, nullptr);
     }
-    Sample* pSampleTemp{new Sample(Globals::SCsAudioDefaultPath + "waitingloop.wav")};
-    _htSamples.insert(std::make_pair("WaitingLoop", pSampleTemp));
+    else
+    {
+        // Create another human player
+        Human* pSecondPlayer{new Human(Grid::EPlayerMark::PLAYER2)};
 
-    // Create grid and jump to state
+        #ifdef __wii__
+            WiiController* pJoystickWii{new WiiController(1)};
+            _htJoysticks.insert(std::make_pair(pJoystickWii->GetIndex(), pJoystickWii));
 
-    _grid = Grid{_settingsGlobal.GetBoardWidth(), _settingsGlobal.GetBoardHeight(), // Create grid
-        _settingsGlobal.GetCellsToWin()};
+            GameCubeController* pJoystickGameCube{new GameCubeController(1)};
+            _htJoysticks.insert(std::make_pair(pJoystickGameCube->GetIndex(), pJoystickGameCube));
 
-    _eStateCurrent = EState::STATE_INGAME; // Start the game
+            pSecondPlayer->AssociateJoystick(*pJoystickWii);
+            pSecondPlayer->AssociateJoystick(*pJoystickGameCube);
+        #endif
+
+        _vectorpPlayers.push_back(pSecondPlayer);
+    }
+
+    _gameRecord = GameRecord{_grid.GetWidth(), _grid.GetHeight(), _grid.GetCellsToWin()};
+    _uPlaybackMove = 0;
+    _uiGameStartTime = _uiLastMoveTime = Time::GetInstance().GetTime();
+
+    try 
+    { 
+        _gameLog.StartGame(GameLog::Game{_uiSeed, _grid.GetWidth(), _grid.GetHeight(), _grid.GetCellsToWin(),
+            _settingsGlobal.GetAIDifficulty(), bSinglePlayer, {}}); 
+    }
+    catch (...) {}  // The game can be played without a log
 }
 
 
 void App::LoadSettings()
 {
     // Reload surfaces
-    std::unordered_map<std::string, Surface*>::iterator i = _htSurfaces.begin();
-    while (i != _htSurfaces.end()) 
-    {
-        if (i->first != "Display" && i->first != "DefaultHome" && i->first != "CursorHand" &&
-            i->first != "CursorShadow" && i->first != "TextSettings") 
-        {
-            delete i->second;
-            i = _htSurfaces.erase(i);
-        }
-        else ++i;
-    }
+    _scene.Invalidate();
+    _registrySurfaces.Release();
 
-    _htSurfaces.insert(std::make_pair("Settings", LoadTexture("settings.png")));
+    _registrySurfaces.Set(_handleSurfaceSettings, LoadTexture("settings.png"));
 
     SDL_Color sdlColorText{};
     sdlColorText.r = 252;
     sdlColorText.g = 3;
     sdlColorText.b = 3;
 
-    _htSurfaces.insert(std::make_pair("TextWidth", GenerateText("Board width", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextWidthValue", GenerateText(
-        std::to_string(_settingsGlobal.GetBoardWidth()), _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextHeight", GenerateText("Board height", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextHeightValue", GenerateText(
-        std::to_string(_settingsGlobal.GetBoardHeight()), _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextStreak", GenerateText("Win length", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextStreakValue", GenerateText(
-        std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextDifficulty", GenerateText("AI Difficulty", 
-        _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextDifficultyValue", GenerateText(
-        std::to_string(_settingsGlobal.GetAIDifficulty()), _ttfFontContinuum, sdlColorText)));
-    _htSurfaces.insert(std::make_pair("TextDevTools", GenerateText("Enable dev tools", 
-        _ttfFontContinuum, sdlColorText)));
+    _registrySurfaces.Set(_handleSurfaceTextWidth, GenerateText("Board width", 
+        _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextWidthValue, GenerateText(
+        std::to_string(_settingsGlobal.GetBoardWidth()), _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextHeight, GenerateText("Board height", 
+        _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextHeightValue, GenerateText(
+        std::to_string(_settingsGlobal.GetBoardHeight()), _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextStreak, GenerateText("Win length", 
+        _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextStreakValue, GenerateText(
+        std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextDifficulty, GenerateText("AI Difficulty", 
+        _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextDifficultyValue, GenerateText(
+        std::to_string(_settingsGlobal.GetAIDifficulty()), _ttfFontContinuum, sdlColorText));
+    _registrySurfaces.Set(_handleSurfaceTextDevTools, GenerateText("Enable dev tools", 
+        _ttfFontContinuum, sdlColorText));
 
     // Reload buttons
-    std::unordered_map<std::string, Button*>::iterator j = _htButtons.begin();
-    while (j != _htButtons.end()) 
-    {
-        if (j->first != "Exit") 
-        {
-            delete j->second;
-            j = _htButtons.erase(j);
-        }
-        else ++j;
-    }
+    _registryButtons.ClearExcept(_handleButtonExit);
 
-    _htButtons.insert(std::make_pair("MinusWidth", new Button(Vector3(320, 75), Vector3(396, 152))));
-    _htButtons.insert(std::make_pair("PlusWidth", new Button(Vector3(440, 75), Vector3(517, 152))));
-    _htButtons.insert(std::make_pair("MinusHeight", new Button(Vector3(320, 164), Vector3(396, 241))));
-    _htButtons.insert(std::make_pair("PlusHeight", new Button(Vector3(440, 164), Vector3(517, 241))));
-    _htButtons.insert(std::make_pair("MinusStreak", new Button(Vector3(320, 253), Vector3(396, 330))));
-    _htButtons.insert(std::make_pair("PlusStreak", new Button(Vector3(440, 253), Vector3(517, 330))));
-    _htButtons.insert(std::make_pair("MinusDifficulty", new Button(Vector3(320, 342), Vector3(396, 419))));
-    _htButtons.insert(std::make_pair("PlusDifficulty", new Button(Vector3(440, 342), Vector3(517, 419))));
+    SetButton(_handleButtonMinusWidth, 320, 75, 396, 152);
+    SetButton(_handleButtonPlusWidth, 440, 75, 517, 152);
+    SetButton(_handleButtonMinusHeight, 320, 164, 396, 241);
+    SetButton(_handleButtonPlusHeight, 440, 164, 517, 241);
+    SetButton(_handleButtonMinusStreak, 320, 253, 396, 330);
+    SetButton(_handleButtonPlusStreak, 440, 253, 517, 330);
+    SetButton(_handleButtonMinusDifficulty, 320, 342, 396, 419);
+    SetButton(_handleButtonPlusDifficulty, 440, 342, 517, 419);
 
     // Reload music
-    std::unordered_map<std::string, Sample*>::iterator k = _htSamples.begin();
-    while (k != _htSamples.end()) 
-    {
-        if (k->first != "Music" && !k->first.starts_with("cancel") && !k->first.starts_with("error")
-            && !k->first.starts_with("open") && !k->first.starts_with("select")) 
-        {
-            delete k->second;
-            k = _htSamples.erase(k);
-        }
-        else ++k;
-    }
+    _registrySamples.Erase(_handleSampleWaitingLoop);
 
     _eStateCurrent = EState::STATE_SETTINGS;
 }
@@ -353,16 +391,17 @@ void App::LoadSettings()
 
 Surface* App::LoadTexture(const std::string& CsPath) const
 {
+    TRACE_SCOPE("App::LoadTexture");
     Surface* pSurfaceNew{nullptr};
 
     try
     { 
-        pSurfaceNew = new Surface(std::filesystem::path(_settingsGlobal.GetCustomPath() + CsPath)
+        pSurfaceNew = LoadCachedTexture(std::filesystem::path(_settingsGlobal.GetCustomPath() + CsPath)
             .lexically_normal().string()); 
     }
     catch (const std::ios_base::failure& CiosBaseFailure)
     { 
-        pSurfaceNew = new Surface(std::filesystem::path(Globals::SCsGraphicsDefaultPath + CsPath)
+        pSurfaceNew = LoadCachedTexture(std::filesystem::path(Globals::SCsGraphicsDefaultPath + CsPath)
             .lexically_normal().string());
     }
 
@@ -370,11 +409,169 @@ Surface* App::LoadTexture(const std::string& CsPath) const
 }
 
 
-Surface* App::GenerateText(const std::string& CsMessage, TTF_Font* ttfFontText, 
-    const SDL_Color& CsdlColorText) const
+/**
+ * @brief Loads a texture from the texture cache, decoding and storing it there if it is not cached yet
+ *
+ * @param CsFilePath the path of the image file
+ * @return Surface* the texture in the format of the display
+ */
+Surface* App::LoadCachedTexture(const std::string& CsFilePath) const
+{
+    // The entry is kept in the format the texture was converted to, which depends on its alpha channel
+    for (const SDL_PixelFormat& CsdlPixelFormat : {Surface::GetDisplayAlphaFormat(),
+        *_pSurfaceDisplay->GetPixelFormat()})
+    {
+        Surface* pSurfaceCached{_textureCache.Load(CsFilePath, 0, 0, CsdlPixelFormat)};
+        if (pSurfaceCached) return pSurfaceCached;
+    }
+
+    Surface* pSurfaceCached{new Surface(CsFilePath)};
+    _textureCache.Store(CsFilePath, 0, 0, *pSurfaceCached);
+
+    return pSurfaceCached;
+}
+
+
+/**
+ * @brief Queues a texture to be loaded in the background, from the custom graphics path if it is there
+ *
+ * @param handle the slot of the registry that receives the texture
+ * @param CsPath the name of the texture file
+ * @param urFitWidth width to fill with an integer upscale, 0 to keep the size
+ * @param urFitHeight height to fill with an integer upscale, 0 to keep the size
+ */
+void App::QueueTexture(SurfaceHandle handle, const std::string& CsPath, uint16_t urFitWidth, 
+    uint16_t urFitHeight)
 {
-    SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(ttfFontText, CsMessage.c_str(), CsdlColorText)};
-    if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-    
-    return new Surface(pSdlSurfaceTemp);
+    _assetLoader.Queue(AssetLoader::Request{handle, {
+        std::filesystem::path(_settingsGlobal.GetCustomPath() + CsPath).lexically_normal().string(),
+        std::filesystem::path(Globals::SCsGraphicsDefaultPath + CsPath).lexically_normal().string()},
+        urFitWidth, urFitHeight});
+}
+
+
+/**
+ * @brief Loads a texture atlas, from the custom graphics path if it is there, otherwise the default one
+ * with any sprite file of the custom graphics path drawn over its sprites
+ *
+ * @param CsName the name of the atlas, without extension
+ * @return Atlas* the loaded atlas
+ */
+Atlas* App::LoadAtlas(const std::string& CsName) const
+{
+    Atlas* pAtlasNew{nullptr};
+
+    try
+    {
+        pAtlasNew = new Atlas(std::filesystem::path(_settingsGlobal.GetCustomPath() + CsName + ".png")
+            .lexically_normal().string(), std::filesystem::path(_settingsGlobal.GetCustomPath() + CsName +
+            ".atlas").lexically_normal().string());
+    }
+    catch (const std::ios_base::failure& CiosBaseFailure)
+    {
+        pAtlasNew = new Atlas(std::filesystem::path(Globals::SCsGraphicsDefaultPath + CsName + ".png")
+            .lexically_normal().string(), std::filesystem::path(Globals::SCsGraphicsDefaultPath + CsName +
+            ".atlas").lexically_normal().string());
+
+        // Custom graphics made for the loose files still override their sprites in the default atlas
+        std::unordered_map<std::string, Surface> htSurfacesCustom{};
+        for (uint16_t i = 0; i < pAtlasNew->GetSpriteCount(); ++i)
+        {
+            const std::string& CsFile{pAtlasNew->GetFile(Atlas::Sprite{i})};
+            std::string sPath{std::filesystem::path(_settingsGlobal.GetCustomPath() + CsFile)
+                .lexically_normal().string()};
+            if (CsFile.empty() || !std::filesystem::is_regular_file(sPath)) continue;
+
+            if (!htSurfacesCustom.contains(CsFile)) htSurfacesCustom.emplace(CsFile, Surface(sPath));
+            if (!pAtlasNew->Replace(Atlas::Sprite{i}, htSurfacesCustom.at(CsFile)))
+                _loggerApp.Warn("Custom " + CsFile + " is too small for its sprite, the default one is used");
+        }
+    }
+
+    // Buttons and cursors are blended on every frame they change
+    Surface& surfaceAtlas{pAtlasNew->GetSurface()};
+    if (surfaceAtlas.GetPixelFormat()->Amask != 0) surfaceAtlas.Premultiply();
+
+    return pAtlasNew;
+}
+
+
+/**
+ * @brief Finds the sprites drawn by the application in the UI atlas
+ */
+void App::ResolveSprites()
+{
+    _spriteDefaultButton = _pAtlasUI->Resolve("DefaultButton");
+    _spriteHoverButton = _pAtlasUI->Resolve("HoverButton");
+    _spriteHome = _pAtlasUI->Resolve("Home");
+    _spriteHomeHover = _pAtlasUI->Resolve("HomeHover");
+    _spriteMinus = _pAtlasUI->Resolve("Minus");
+    _spritePlus = _pAtlasUI->Resolve("Plus");
+    _spritePrompt = _pAtlasUI->Resolve("Prompt");
+    _spriteDefaultYes = _pAtlasUI->Resolve("DefaultYes");
+    _spriteHoverYes = _pAtlasUI->Resolve("HoverYes");
+    _spriteWinPlayer1 = _pAtlasUI->Resolve("WinPlayer1");
+    _spriteWinPlayer2 = _pAtlasUI->Resolve("WinPlayer2");
+    _spriteDraw = _pAtlasUI->Resolve("Draw");
+    _spriteCursorHand = _pAtlasUI->Resolve("CursorHand");
+    _spriteCursorShadow = _pAtlasUI->Resolve("CursorShadow");
+    _spriteCursorPlayer1 = _pAtlasUI->Resolve("CursorPlayer1");
+    _spriteCursorPlayer2 = _pAtlasUI->Resolve("CursorPlayer2");
+}
+
+
+/**
+ * @brief Renders a text through the text cache
+ *
+ * @param CsMessage the UTF-8 text
+ * @param ttfFontText the font
+ * @param CsdlColorText the colour of the text
+ * @return Surface* the rendered text, owned by the caller
+ */
+Surface* App::GenerateText(const std::string& CsMessage, TTF_Font* ttfFontText, const SDL_Color& CsdlColorText)
+{ return _textRenderer.Render(CsMessage, ttfFontText, CsdlColorText); }
+
+
+/**
+ * @brief Creates a button placed on the display, and keeps its placement for when the display changes
+ *
+ * @param handleButton the button
+ * @param rLeft the X coordinate of the left side of the button on the preferred display
+ * @param rTop the Y coordinate of the top side of the button on the preferred display
+ * @param rRight the X coordinate of the right side of the button on the preferred display
+ * @param rBottom the Y coordinate of the bottom side of the button on the preferred display
+ * @param eAnchor the point of the display the button keeps its distance to
+ */
+void App::SetButton(ButtonHandle handleButton, int16_t rLeft, int16_t rTop, int16_t rRight, int16_t rBottom,
+    ScreenLayout::EAnchor eAnchor)
+{
+    if (handleButton.urIndex >= _vectorButtonPlacements.size())
+        _vectorButtonPlacements.resize(handleButton.urIndex + 1);
+    _vectorButtonPlacements[handleButton.urIndex] = ButtonPlacement{rLeft, rTop, rRight, rBottom, eAnchor};
+
+    SDL_Rect sdlRectButton{_screenLayout.Place(eAnchor, rLeft, rTop, rRight - rLeft, rBottom - rTop)};
+    _registryButtons.Set(handleButton, new Button(Vector3(sdlRectButton.x, sdlRectButton.y), 
+        Vector3(sdlRectButton.x + sdlRectButton.w, sdlRectButton.y + sdlRectButton.h)));
+}
+
+
+/**
+ * @brief Places the hourglass and the loaded buttons again, after the size of the display changed
+ */
+void App::PlaceButtons()
+{
+    _sdlRectHourglass = _screenLayout.Place(ScreenLayout::ANCHOR_TOP_RIGHT, 552, 25, 88, 72);
+
+    for (uint16_t i = 0; i < _vectorButtonPlacements.size(); ++i)
+    {
+        Button* pButton{_registryButtons[ButtonHandle{i}]};
+        if (pButton == nullptr) continue;
+
+        const ButtonPlacement& CbuttonPlacement{_vectorButtonPlacements[i]};
+        SDL_Rect sdlRectButton{_screenLayout.Place(CbuttonPlacement.eAnchor, CbuttonPlacement.rLeft,
+            CbuttonPlacement.rTop, CbuttonPlacement.rRight - CbuttonPlacement.rLeft,
+            CbuttonPlacement.rBottom - CbuttonPlacement.rTop)};
+        pButton->SetTopLeft(Vector3(sdlRectButton.x, sdlRectButton.y));
+        pButton->SetBottomRight(Vector3(sdlRectButton.x + sdlRectButton.w, sdlRectButton.y + sdlRectButton.h));
+    }
 }
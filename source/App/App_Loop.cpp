@@ -18,28 +18,259 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <sstream>
+#include <typeinfo>
+#include <exception>
+
 #include "../../include/App.hpp"
+#include "../../include/GameLog.hpp"
 #include "../../include/video/Time.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/Profiler.hpp"
+#include "../../include/Trace.hpp"
 #include "../../include/players/AI.hpp"
+#include "../../include/players/Human.hpp"
 
 
 /**
  * @brief Handles all the data updates between frames
  */
-void App::OnLoop() noexcept
+void App::OnLoop()
 {
     Time::GetInstance().OnLoop();
+    _timeline.Advance(Time::GetInstance().GetTime());
 
     switch (_eStateCurrent)
     {
+    case EState::STATE_START:
+    {
+        if (_bPlaybackPending)  // Start the recorded game as soon as the main screen is ready
+        {
+            _bPlaybackPending = false;
+            _bIsPlayback = true;
+            StartGame(_gamePlayback.bSinglePlayer);
+        }
+        break;
+    }
+    case EState::STATE_LOADING:
+    {
+        _assetLoader.Collect(_registrySurfaces);
+        if (_assetLoader.IsDone()) OnGameLoaded();
+        break;
+    }
     case EState::STATE_INGAME:
     case EState::STATE_PROMPT:
     {
-        if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
-            _htAnimations.at("Loading")->OnAnimate();
+        // The AI thread only chooses its move, a prompt on screen does not hold it back
+        int16_t rAIMove{_rAIMove.exchange(-1)};
+        if (rAIMove >= 0) OnAIMove(static_cast<uint8_t>(rAIMove));
+
+        if (_bIsPlayback && _eStateCurrent == EState::STATE_INGAME &&
+            typeid(*(_vectorpPlayers[_uyCurrentPlayer])) != typeid(AI)) OnPlayback();
         break;
     }
-    case EState::STATE_END: _htAnimations.at("Win")->OnAnimate(); break;
     default: break;
     }
+
+    // Only the animations on screen are played, so they are the only ones that wake the loop up
+    Animation* pAnimationLoading{_registryAnimations[_handleAnimationLoading]};
+    if (pAnimationLoading)
+    {
+        bool bIsAIThinking{(_eStateCurrent == EState::STATE_INGAME || _eStateCurrent == EState::STATE_PROMPT) &&
+            typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI)};
+        _timeline.SetPlaying(*pAnimationLoading, bIsAIThinking);
+    }
+
+    Animation* pAnimationWin{_registryAnimations[_handleAnimationWin]};
+    if (pAnimationWin) _timeline.SetPlaying(*pAnimationWin, _eStateCurrent == EState::STATE_END);
+}
+
+
+/**
+ * @brief Tells whether the screen changes without input, otherwise the main loop waits for events
+ *
+ * @return bool true if the next frame has to be drawn even if no event arrives
+ */
+bool App::IsAnimating() const
+{
+    switch (_eStateCurrent)
+    {
+    case EState::STATE_START: return _bPlaybackPending;
+    case EState::STATE_LOADING: return true;
+    case EState::STATE_INGAME:  // Recorded moves play on time, the animations wake the loop up on their own
+        return _bIsPlayback;
+    default: return false;
+    }
+}
+
+
+/**
+ * @brief Writes the frame times of the profiler to the profile file
+ */
+void App::DumpProfile() noexcept
+{
+    try 
+    { 
+        _profiler.Dump(Globals::SCsProfileDefaultPath);
+        _loggerApp.Info("Frame times written to " + Globals::SCsProfileDefaultPath);
+    }
+    catch (const std::exception& Cexception) 
+    { 
+        try { _loggerApp.Error(Cexception.what()); }
+        catch (...) {}
+    }
+}
+
+
+/**
+ * @brief Writes the events traced by every thread to the trace file
+ */
+void App::FlushTrace() noexcept
+{
+    try 
+    { 
+        Trace::Flush(Globals::SCsTraceDefaultPath);
+        _loggerApp.Info("Event trace written to " + Globals::SCsTraceDefaultPath);
+    }
+    catch (const std::exception& Cexception) 
+    { 
+        try { _loggerApp.Error(Cexception.what()); }
+        catch (...) {}
+    }
+}
+
+
+/**
+ * @brief Plays the recorded human moves when their time has come
+ */
+void App::OnPlayback()
+{
+    if (_uPlaybackMove >= _gamePlayback.vectorMoves.size()) return;
+
+    // Human moves keep the delay they had since the previous move, so a slower AI does not skip them
+    const GameLog::Move& CmovePlayback{_gamePlayback.vectorMoves[_uPlaybackMove]};
+    uint32_t uiDelay{CmovePlayback.uiTime - (_uPlaybackMove > 0 ? 
+        _gamePlayback.vectorMoves[_uPlaybackMove - 1].uiTime : 0)};
+
+    if (Time::GetInstance().GetTime() - _uiLastMoveTime < uiDelay) return;
+
+    if (!_grid.IsValidMove(CmovePlayback.uyColumn))
+    {
+        std::ostringstream ossError{"Playback stopped, invalid move ", std::ios_base::ate};
+        ossError << _uPlaybackMove + 1 << " in column " << CmovePlayback.uyColumn + 1;
+        try { _loggerApp.Error(ossError.str()); }
+        catch (...) {}
+
+        _bIsPlayback = false;
+        return;
+    }
+
+    // Draw the same sound as a click so the random sequence matches the recorded one
+    _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+        _uniformDistribution(_mersenneTwisterGeneratorMoves) - 1]]);
+    _samplePlayerGlobal.Play();
+
+    PlayMove(CmovePlayback.uyColumn);
+}
+
+
+/**
+ * @brief Plays a move for the current player and passes the turn
+ *
+ * @param uyColumn the column of the move, it must be valid
+ */
+void App::PlayMove(uint8_t uyColumn)
+{
+    _grid.MakeMove(_vectorpPlayers[_uyCurrentPlayer]->GetPlayerMark(), uyColumn);
+    RecordMove(uyColumn);
+    ++_uyCurrentPlayer %= _vectorpPlayers.size();
+
+    // If the game is won or there is a draw go to the corresponding state
+    if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
+        _eStateCurrent = EState::STATE_END;
+    else if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
+    {
+        _samplePlayerGlobal.SetSample(_registrySamples[_handleSampleWaitingLoop]);
+        _samplePlayerGlobal.Play(-1, 0, -1);
+
+        while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
+    }
+}
+
+
+/**
+ * @brief Plays the move chosen by the AI thread, the grid and the game log are only touched here
+ *
+ * @param uyColumn the column of the move
+ */
+void App::OnAIMove(uint8_t uyColumn)
+{
+    _samplePlayerGlobal.SetSample(_registrySamples[_handleSampleWaitingLoop]);
+    _samplePlayerGlobal.Stop();
+
+    // The AI always finds a move while the board has room, which it has on its turn
+    if (!_grid.IsValidMove(uyColumn))
+    {
+        std::ostringstream ossError{"The AI chose the invalid column ", std::ios_base::ate};
+        ossError << uyColumn + 1;
+        try { _loggerApp.Error(ossError.str()); }
+        catch (...) {}
+
+        return;
+    }
+
+    PlayMove(uyColumn);
+
+    // The moves draw from their own generator, so a playback repeats them whatever the menus played
+    if (_eStateCurrent == EState::STATE_END)
+    {
+        int32_t iRandom{_uniformDistribution(_mersenneTwisterGeneratorMoves)};
+        _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesError[
+            (iRandom > 2 ? iRandom / 3 : iRandom) - 1]]);
+    }
+    else _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+        _uniformDistribution(_mersenneTwisterGeneratorMoves) - 1]]);
+    _samplePlayerGlobal.Play();
+}
+
+
+/**
+ * @brief Records the last move made on the grid in the game log
+ *
+ * @param uyColumn the column of the move
+ */
+void App::RecordMove(uint8_t uyColumn) noexcept
+{
+    const Player* CpPlayer{_vectorpPlayers[_uyCurrentPlayer]};
+    uint32_t uiTime{Time::GetInstance().GetTime()};
+
+    if (_bIsPlayback && _uPlaybackMove < _gamePlayback.vectorMoves.size())
+    {
+        // The AI recomputes its moves, so any difference with the recording is reported
+        if (_gamePlayback.vectorMoves[_uPlaybackMove].uyColumn != uyColumn)
+        {
+            std::ostringstream ossWarning{"Playback diverged at move ", std::ios_base::ate};
+            ossWarning << _uPlaybackMove + 1 << ": recorded column " << 
+                _gamePlayback.vectorMoves[_uPlaybackMove].uyColumn + 1 << ", played column " << uyColumn + 1;
+            try { _loggerApp.Warn(ossWarning.str()); }
+            catch (...) {}
+        }
+        ++_uPlaybackMove;
+    }
+
+    try
+    {
+        _gameRecord.AddMove(uyColumn);
+        _gameLog.RecordMove(GameLog::Move{uiTime - _uiGameStartTime, CpPlayer->GetPlayerMark(), 
+            typeid(*CpPlayer) == typeid(AI), uyColumn});
+
+        if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
+            _gameLog.EndGame(_grid.CheckWinner(), _gameRecord);
+    }
+    catch (...) {}  // The game can be played without a log
+
+    _uiLastMoveTime = uiTime;
 }
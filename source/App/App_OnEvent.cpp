@@ -19,11 +19,13 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstdint>
 #include <unordered_map>
-#include <sstream>
 #include <utility>
+#include <algorithm>
+#include <stdexcept>
 
 #include <SDL_events.h>
 #include <SDL_mouse.h>
+#include <SDL_video.h>
 
 #include "../../include/App.hpp"
 #include "../../include/Globals.hpp"
@@ -59,7 +61,7 @@ void App::OnInputBlur() {}
 /**
  * @brief Handles events where the window is restored to its size
  */
-void App::OnRestore() {}
+void App::OnRestore() { _dirtyRects.Invalidate(); }
 
 
 /**
@@ -77,24 +79,27 @@ void App::OnMinimize() {}
  */
 void App::OnKeyDown(SDLKey sdlKeySymbol, SDLMod sdlMod, uint16_t urUnicode)
 {
+    if (sdlKeySymbol == SDLK_F2 && _settingsGlobal.GetIsDev()) DumpProfile();
+    if (sdlKeySymbol == SDLK_F3 && _settingsGlobal.GetIsDev()) FlushTrace();
+
     switch (_eStateCurrent)
     {
     case EState::STATE_INGAME:
     {
         //if (_apPlayer.at(uyWhich)->GetPlayerMark() == _ePlayerMarkCurrent)
         {
-            const Surface* CpSurfaceDisplay{_htSurfaces.at("Display")};
+            const Surface* CpSurfaceDisplay{_pSurfaceDisplay};
 
             switch (sdlKeySymbol)
             {
             case SDLK_LEFT:
                 if (--_yPlayColumn < 0) _yPlayColumn = _grid.GetWidth() - 1;
-                SDL_WarpMouse(_yPlayColumn * (CpSurfaceDisplay->GetWidth() / _grid.GetWidth()),
+                _renderThread.WarpMouse(_yPlayColumn * (CpSurfaceDisplay->GetWidth() / _grid.GetWidth()),
                     _grid.GetNextCell(_yPlayColumn) * (CpSurfaceDisplay->GetHeight() / _grid.GetHeight()));
                 break;
             case SDLK_RIGHT:
                 if (++_yPlayColumn >= _grid.GetWidth()) _yPlayColumn = 0;
-                SDL_WarpMouse(_yPlayColumn * (CpSurfaceDisplay->GetWidth() / _grid.GetWidth()),
+                _renderThread.WarpMouse(_yPlayColumn * (CpSurfaceDisplay->GetWidth() / _grid.GetWidth()),
                     _grid.GetNextCell(_yPlayColumn) * (CpSurfaceDisplay->GetHeight() / _grid.GetHeight()));
                 break;
             default: break;
@@ -137,7 +142,7 @@ void App::OnMouseMove(uint16_t urMouseX, uint16_t urMouseY, int16_t rRelX, int16
         case EState::STATE_START:
             break;
         case EState::STATE_INGAME:  // Select the column in the grid that the mouse is pointing at
-            _yPlayColumn = urMouseX / ((*_htSurfaces.at("Display")).GetWidth() / _grid.GetWidth());
+            _yPlayColumn = urMouseX / (_pSurfaceDisplay->GetWidth() / _grid.GetWidth());
             break;
         default: break;
         }
@@ -167,42 +172,19 @@ void App::OnLButtonDown(uint16_t urMouseX, uint16_t urMouseY)
         {
         case EState::STATE_START:
         {
-            if (/*urMouseX >= 0 && */urMouseX < (Globals::SCurAppWidth >> 1) &&/* urMouseY >= 0 &&*/
-                urMouseY < Globals::SCurAppHeight)   // If the controller is pointing at the left half of the screen
-            {
-                _eStateCurrent = EState::STATE_INGAME; // Start the game
-
-                // Create an AI player
-                _vectorpPlayers.push_back(new AI(Grid::EPlayerMark::PLAYER2,
-                    _settingsGlobal.GetAIDifficulty()));
-                _pSdlThreadAI = SDL_CreateThread(RunAI, nullptr);
-            }
-            else if (urMouseX >= (Globals::SCurAppWidth >> 1) && urMouseX < Globals::SCurAppWidth &&
-                /*urMouseY >= 0 && */urMouseY < Globals::SCurAppHeight) // If the controller is pointing at the right half of the screen
-            {
-                _eStateCurrent = EState::STATE_INGAME; // Start the game
-
-                // Create another human player
-                Human* pSecondPlayer{new Human(Grid::EPlayerMark::PLAYER2)};
-                _vectorpPlayers.push_back(pSecondPlayer);
-            }
+            if (/*urMouseX >= 0 && */urMouseX < (_screenLayout.GetWidth() >> 1) &&/* urMouseY >= 0 &&*/
+                urMouseY < _screenLayout.GetHeight())   // If the controller is pointing at the left half of the screen
+                StartGame(true);    // Start the game against the AI
+            else if (urMouseX >= (_screenLayout.GetWidth() >> 1) && urMouseX < _screenLayout.GetWidth() &&
+                /*urMouseY >= 0 && */urMouseY < _screenLayout.GetHeight()) // If the controller is pointing at the right half of the screen
+                StartGame(false);   // Start the game against another human player
             break;
         }
         case EState::STATE_INGAME:
         {
-            if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(Human))
+            if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(Human) && !_bIsPlayback)
             {
-                if (_grid.IsValidMove(_yPlayColumn)) // Make the play if it's valid
-                {
-                    _grid.MakeMove(_vectorpPlayers[_uyCurrentPlayer]->GetPlayerMark(), _yPlayColumn);
-                    ++_uyCurrentPlayer %= _vectorpPlayers.size();
-
-                    // If the game is won or there is a draw go to the corresponding state
-                    if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
-                        _eStateCurrent = EState::STATE_END;
-                    else if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
-                        while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
-                }
+                if (_grid.IsValidMove(_yPlayColumn)) PlayMove(_yPlayColumn);  // Make the play if it's valid
             }
             break;
         }
@@ -212,6 +194,7 @@ void App::OnLButtonDown(uint16_t urMouseX, uint16_t urMouseY)
 
             break;
         }
+        case EState::STATE_LOADING: break;
         }
     #endif
 }
@@ -296,6 +279,9 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
     SDL_GetMouseState(&iMouseX, &iMouseY);
     Vector3 vectorMouse{static_cast<float>(iMouseX), static_cast<float>(iMouseY)};
 
+    if (uyButton == 3 && _settingsGlobal.GetIsDev()) DumpProfile();    // Button 2 press
+    if (uyButton == 2 && _settingsGlobal.GetIsDev()) FlushTrace();     // Button 1 press
+
     switch (_eStateCurrent)
     {
     case EState::STATE_START:  // In the starting state we handle the clicks on any of the gamemodes
@@ -304,55 +290,34 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         {
         case 0: // Button A press
         {
-            if (_htButtons.at("SinglePlayer")->IsInside(vectorMouse))
+            if (_registryButtons.At(_handleButtonSinglePlayer).IsInside(vectorMouse))
             {
                 // Play a random sound
-                std::ostringstream ossSound{"select", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
 
-                LoadGame();
-
-                // Create an AI player
-                _vectorpPlayers.push_back(new AI(Grid::EPlayerMark::PLAYER2,
-                    _settingsGlobal.GetAIDifficulty()));
-                _pSdlThreadAI = SDL_CreateThread(RunAI, nullptr);
+                StartGame(true);    // Start the game against the AI
             }
-            else if (_htButtons.at("MultiPlayer")->IsInside(vectorMouse))
+            else if (_registryButtons.At(_handleButtonMultiPlayer).IsInside(vectorMouse))
             {
                 // Play a random sound
-                std::ostringstream ossSound{"select", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
 
-                LoadGame();
-
-                // Create another human player
-                WiiController* pJoystickWii{new WiiController(1)};
-                _htJoysticks.insert(std::make_pair(pJoystickWii->GetIndex(), pJoystickWii));
-
-                GameCubeController* pJoystickGameCube{new GameCubeController(1)};
-                _htJoysticks.insert(std::make_pair(pJoystickGameCube->GetIndex(), pJoystickGameCube));
-
-                Human* pSecondPlayer{new Human(Grid::EPlayerMark::PLAYER2)};
-                pSecondPlayer->AssociateJoystick(*pJoystickWii);
-                pSecondPlayer->AssociateJoystick(*pJoystickGameCube);
-
-                _vectorpPlayers.push_back(pSecondPlayer);
+                StartGame(false);   // Start the game against another human player
             }
-            else if (_htButtons.at("Settings")->IsInside(vectorMouse)) 
+            else if (_registryButtons.At(_handleButtonSettings).IsInside(vectorMouse)) 
             {
                 // Play a random sound
-                std::ostringstream ossSound{"select", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
                 
                 LoadSettings();
             }
-            else if (_htButtons.at("Exit")->IsInside(vectorMouse)) _bRunning = false;
+            else if (_registryButtons.At(_handleButtonExit).IsInside(vectorMouse)) _bRunning = false;
 
             break;
         }
@@ -366,169 +331,120 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         sdlColorSingle.g = 3;
         sdlColorSingle.b = 3;
 
-        if (_htButtons.at("Exit")->IsInside(vectorMouse))
+        if (_registryButtons.At(_handleButtonExit).IsInside(vectorMouse))
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             try { _settingsGlobal.Dump(Globals::SCsSettingsDefaultPath); }
             catch(...) {}
             Reset();
         }
-        else if (_htButtons.at("MinusWidth")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonMinusWidth).IsInside(vectorMouse) && 
             _settingsGlobal.GetBoardWidth() > Globals::SCuyBoardWidthMin)
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetBoardWidth(_settingsGlobal.GetBoardWidth() - 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetBoardWidth()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextWidthValue");
-            _htSurfaces["TextWidthValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextWidthValue, GenerateText(
+                std::to_string(_settingsGlobal.GetBoardWidth()), _ttfFontContinuum, sdlColorSingle));
 
             if (_settingsGlobal.GetBoardWidth() < _settingsGlobal.GetCellsToWin() && 
                 _settingsGlobal.GetBoardHeight() < _settingsGlobal.GetCellsToWin())
             {
                 _settingsGlobal.SetCellsToWin(_settingsGlobal.GetBoardWidth());
-                pSdlSurfaceTemp = TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                    std::to_string(_settingsGlobal.GetCellsToWin()).c_str(), sdlColorSingle);
-                if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-                delete _htSurfaces.at("TextStreakValue");
-                _htSurfaces["TextStreakValue"] = new Surface(pSdlSurfaceTemp);
+                _registrySurfaces.Set(_handleSurfaceTextStreakValue, GenerateText(
+                    std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorSingle));
             }
         }
-        else if (_htButtons.at("PlusWidth")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonPlusWidth).IsInside(vectorMouse) && 
             _settingsGlobal.GetBoardWidth() < Globals::SCuyBoardWidthMax)
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetBoardWidth(_settingsGlobal.GetBoardWidth() + 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetBoardWidth()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextWidthValue");
-            _htSurfaces["TextWidthValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextWidthValue, GenerateText(
+                std::to_string(_settingsGlobal.GetBoardWidth()), _ttfFontContinuum, sdlColorSingle));
         }
-        else if (_htButtons.at("MinusHeight")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonMinusHeight).IsInside(vectorMouse) && 
             _settingsGlobal.GetBoardHeight() > Globals::SCuyBoardHeightMin)
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetBoardHeight(_settingsGlobal.GetBoardHeight() - 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetBoardHeight()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextHeightValue");
-            _htSurfaces["TextHeightValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextHeightValue, GenerateText(
+                std::to_string(_settingsGlobal.GetBoardHeight()), _ttfFontContinuum, sdlColorSingle));
 
             if (_settingsGlobal.GetBoardWidth() < _settingsGlobal.GetCellsToWin() && 
                 _settingsGlobal.GetBoardHeight() < _settingsGlobal.GetCellsToWin())
             {
                 _settingsGlobal.SetCellsToWin(_settingsGlobal.GetBoardHeight());
-                pSdlSurfaceTemp = TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                    std::to_string(_settingsGlobal.GetCellsToWin()).c_str(), sdlColorSingle);
-                if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-                delete _htSurfaces.at("TextStreakValue");
-                _htSurfaces["TextStreakValue"] = new Surface(pSdlSurfaceTemp);
+                _registrySurfaces.Set(_handleSurfaceTextStreakValue, GenerateText(
+                    std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorSingle));
             }
         }
-        else if (_htButtons.at("PlusHeight")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonPlusHeight).IsInside(vectorMouse) && 
             _settingsGlobal.GetBoardHeight() < Globals::SCuyBoardHeightMax) 
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetBoardHeight(_settingsGlobal.GetBoardHeight() + 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetBoardHeight()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextHeightValue");
-            _htSurfaces["TextHeightValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextHeightValue, GenerateText(
+                std::to_string(_settingsGlobal.GetBoardHeight()), _ttfFontContinuum, sdlColorSingle));
         }
-        else if (_htButtons.at("MinusStreak")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonMinusStreak).IsInside(vectorMouse) && 
             _settingsGlobal.GetCellsToWin() > Globals::SCuyCellsToWinMin) 
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetCellsToWin(_settingsGlobal.GetCellsToWin() - 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetCellsToWin()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextStreakValue");
-            _htSurfaces["TextStreakValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextStreakValue, GenerateText(
+                std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorSingle));
         }
-        else if (_htButtons.at("PlusStreak")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonPlusStreak).IsInside(vectorMouse) && 
             _settingsGlobal.GetCellsToWin() < std::max(
                 _settingsGlobal.GetBoardWidth(), _settingsGlobal.GetBoardHeight())) 
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetCellsToWin(_settingsGlobal.GetCellsToWin() + 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetCellsToWin()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextStreakValue");
-            _htSurfaces["TextStreakValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextStreakValue, GenerateText(
+                std::to_string(_settingsGlobal.GetCellsToWin()), _ttfFontContinuum, sdlColorSingle));
         }
-        else if (_htButtons.at("MinusDifficulty")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonMinusDifficulty).IsInside(vectorMouse) && 
             _settingsGlobal.GetAIDifficulty() > Globals::SCuyAIDifficultyMin) 
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetAIDifficulty(_settingsGlobal.GetAIDifficulty() - 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetAIDifficulty()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextDifficultyValue");
-            _htSurfaces["TextDifficultyValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextDifficultyValue, GenerateText(
+                std::to_string(_settingsGlobal.GetAIDifficulty()), _ttfFontContinuum, sdlColorSingle));
         }
-        else if (_htButtons.at("PlusDifficulty")->IsInside(vectorMouse) && 
+        else if (_registryButtons.At(_handleButtonPlusDifficulty).IsInside(vectorMouse) && 
             _settingsGlobal.GetAIDifficulty() < Globals::SCuyAIDifficultyMax) 
         {
-            std::ostringstream ossSound{"select", std::ios_base::ate};
-            ossSound << _uniformDistribution(_randomDeviceGenerator);
-            _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+            _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
             _samplePlayerGlobal.Play();
 
             _settingsGlobal.SetAIDifficulty(_settingsGlobal.GetAIDifficulty() + 1);
-            SDL_Surface* pSdlSurfaceTemp{TTF_RenderUTF8_Blended(_ttfFontContinuum, 
-                std::to_string(_settingsGlobal.GetAIDifficulty()).c_str(), sdlColorSingle)};
-            if (!pSdlSurfaceTemp) throw std::runtime_error(TTF_GetError());
-
-            delete _htSurfaces.at("TextDifficultyValue");
-            _htSurfaces["TextDifficultyValue"] = new Surface(pSdlSurfaceTemp);
+            _registrySurfaces.Set(_handleSurfaceTextDifficultyValue, GenerateText(
+                std::to_string(_settingsGlobal.GetAIDifficulty()), _ttfFontContinuum, sdlColorSingle));
         }
 
         break;
@@ -539,46 +455,38 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         {
         case 0: // Button A
         {
-            if (_htButtons.at("Exit")->IsInside(vectorMouse)) 
+            if (_registryButtons.At(_handleButtonExit).IsInside(vectorMouse)) 
             {
-                std::ostringstream ossSound{"open", std::ios_base::ate};
-                int32_t iRandom{_uniformDistribution(_randomDeviceGenerator)};
-                ossSound << (iRandom > 3 ? iRandom - 3 : iRandom);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                int32_t iRandom{_uniformDistribution(_mersenneTwisterGenerator)};
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesOpen[
+                    (iRandom > 3 ? iRandom - 3 : iRandom) - 1]]);
                 _samplePlayerGlobal.Play();
 
                 _eStateCurrent = EState::STATE_PROMPT;
             }
-            else if (const Human* CpHuman = dynamic_cast<Human*>(_vectorpPlayers[_uyCurrentPlayer]))
+            else if (const Human* CpHuman = (_bIsPlayback ? nullptr : 
+                dynamic_cast<Human*>(_vectorpPlayers[_uyCurrentPlayer])))
             {
                 if (CpHuman->GetJoysticks().contains(uyWhich) ||
                     ((uyWhich == 0 || uyWhich == 4) && _bSingleController))
                 {
-                    _yPlayColumn = (iMouseX - _rInitialX) / _htSurfaces.at("EmptyCell")->GetWidth();
+                    _yPlayColumn = (iMouseX - _rInitialX) / 
+                        _registrySurfaces.At(_handleSurfaceEmptyCell).GetWidth();
 
                     
                     if (_grid.IsValidMove(_yPlayColumn)) // Make the play if it's valid
                     {
-                        std::ostringstream ossSound{"select", std::ios_base::ate};
-                        ossSound << _uniformDistribution(_randomDeviceGenerator);
-                        _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                        _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                            _uniformDistribution(_mersenneTwisterGeneratorMoves) - 1]]);
                         _samplePlayerGlobal.Play();
 
-                        _grid.MakeMove(_vectorpPlayers[_uyCurrentPlayer]->GetPlayerMark(), _yPlayColumn);
-                        ++_uyCurrentPlayer %= _vectorpPlayers.size();
-
-                        // If the game is won or there is a draw go to the corresponding state
-                        if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
-                            _eStateCurrent = EState::STATE_END;
-                        else if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
-                            while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
+                        PlayMove(_yPlayColumn);
                     }
                     else
                     {
-                        std::ostringstream ossSound{"error", std::ios_base::ate};
-                        int32_t iRandom{_uniformDistribution(_randomDeviceGenerator)};
-                        ossSound << (iRandom > 2 ? iRandom / 3 : iRandom);
-                        _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                        int32_t iRandom{_uniformDistribution(_mersenneTwisterGenerator)};
+                        _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesError[
+                            (iRandom > 2 ? iRandom / 3 : iRandom) - 1]]);
                         _samplePlayerGlobal.Play();
                     }
                 }
@@ -594,19 +502,17 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         {
         case 0: // Button A
         {
-            if (_htButtons.at("Yes")->IsInside(vectorMouse)) 
+            if (_registryButtons.At(_handleButtonYes).IsInside(vectorMouse)) 
             {
-                std::ostringstream ossSound{"select", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
                 Reset();
             }
-            else if (_htButtons.at("No")->IsInside(vectorMouse))  
+            else if (_registryButtons.At(_handleButtonNo).IsInside(vectorMouse))  
             {
-                std::ostringstream ossSound{"cancel", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesCancel[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
                 _eStateCurrent = EState::STATE_INGAME;
             }
@@ -622,11 +528,10 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         {
         case 0: // Button A
         {
-            if (_htButtons.at("Exit")->IsInside(vectorMouse)) 
+            if (_registryButtons.At(_handleButtonExit).IsInside(vectorMouse)) 
             {
-                std::ostringstream ossSound{"select", std::ios_base::ate};
-                ossSound << _uniformDistribution(_randomDeviceGenerator);
-                _samplePlayerGlobal.SetSample(_htSamples.at(ossSound.str()));
+                _samplePlayerGlobal.SetSample(_registrySamples[_ahandleSamplesSelect[
+                    _uniformDistribution(_mersenneTwisterGenerator) - 1]]);
                 _samplePlayerGlobal.Play();
 
                 Reset();
@@ -637,6 +542,7 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton)
         }
         break;
     }
+    case EState::STATE_LOADING: break;   // Input waits until the board is shown
     }
 }
 
@@ -665,7 +571,7 @@ void App::OnJoyHat(uint8_t uyWhich, uint8_t uyHat, uint8_t uyValue) noexcept
     {
         //if (((uyWhich == 0 || uyWhich == 4) && _bSingleController))
         {
-            const Surface* CpSurfaceEmptyCell{_htSurfaces.at("EmptyCell")};
+            const Surface& CsurfaceEmptyCell{_registrySurfaces.At(_handleSurfaceEmptyCell)};
 
             switch (uyValue)
             {
@@ -674,9 +580,9 @@ void App::OnJoyHat(uint8_t uyWhich, uint8_t uyHat, uint8_t uyValue) noexcept
             default:                                                                        break;
             }
 
-            SDL_WarpMouse(_rInitialX + _yPlayColumn * CpSurfaceEmptyCell->GetWidth() + 
-                (CpSurfaceEmptyCell->GetWidth() >> 1), _rInitialY + _grid.GetNextCell(_yPlayColumn) * 
-                CpSurfaceEmptyCell->GetHeight() + (CpSurfaceEmptyCell->GetHeight() >> 1));
+            _renderThread.WarpMouse(_rInitialX + _yPlayColumn * CsurfaceEmptyCell.GetWidth() + 
+                (CsurfaceEmptyCell.GetWidth() >> 1), _rInitialY + _grid.GetNextCell(_yPlayColumn) * 
+                CsurfaceEmptyCell.GetHeight() + (CsurfaceEmptyCell.GetHeight() >> 1));
         }
         break;
     }
@@ -697,13 +603,38 @@ void App::OnExit() noexcept { _bRunning = false; }
  * @param iWidth the new width of the window
  * @param iHeight the new height of the window
  */
-void App::OnResize(int32_t iWidth, int32_t iHeight) {}
+void App::OnResize(int32_t iWidth, int32_t iHeight)
+{
+    // The screens are made for the preferred display, so the window does not get any smaller
+    iWidth = std::max<int32_t>(iWidth, Globals::SCurAppWidth);
+    iHeight = std::max<int32_t>(iHeight, Globals::SCurAppHeight);
+    if (iWidth == _pSurfaceDisplay->GetWidth() && iHeight == _pSurfaceDisplay->GetHeight()) return;
+
+    // SDL frees the display when the mode changes, so the render thread must be done with it. The wrapper
+    // lets it go first, SDL_FreeSurface leaves the display alone
+    _renderThread.Wait();
+    uint32_t uiFlags{static_cast<SDL_Surface*>(*_pSurfaceDisplay)->flags};
+    uint8_t uyBitsPerPixel{_pSurfaceDisplay->GetPixelFormat()->BitsPerPixel};
+    *_pSurfaceDisplay = static_cast<SDL_Surface*>(nullptr);
+
+    if (!SDL_SetVideoMode(iWidth, iHeight, uyBitsPerPixel, uiFlags)) throw std::runtime_error(SDL_GetError());
+    *_pSurfaceDisplay = SDL_GetVideoSurface();
+
+    // Everything placed on the display moves with its anchor, and the composited layers are of the old size
+    _screenLayout.Resize(_pSurfaceDisplay->GetWidth(), _pSurfaceDisplay->GetHeight());
+    PlaceButtons();
+    if (_eStateCurrent == EState::STATE_INGAME || _eStateCurrent == EState::STATE_PROMPT ||
+        _eStateCurrent == EState::STATE_END) PlaceBoard();
+
+    _scene.Invalidate();
+    _dirtyRects.Invalidate();
+}
 
 
 /**
  * @brief Handles window redraw events
  */
-void App::OnExpose() {}
+void App::OnExpose() { _dirtyRects.Invalidate(); }
 
 
 /**
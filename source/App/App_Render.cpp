@@ -19,325 +19,424 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include <typeinfo>
 
 #include <SDL_video.h>
 
 #include "../../include/App.hpp"
 #include "../../include/video/Surface.hpp"
+#include "../../include/video/Atlas.hpp"
+#include "../../include/video/DirtyRects.hpp"
+#include "../../include/video/CursorOverlay.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+#include "../../include/video/Button.hpp"
 #include "../../include/video/Vector3.hpp"
 #include "../../include/players/AI.hpp"
 #include "../../include/video/Time.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/Profiler.hpp"
+#include "../../include/Trace.hpp"
 
 /**
  * @brief Handles all the rendering for each frame
  */
 void App::OnRender()
 {
-    // Clear framebuffer
-    Surface* pSurfaceDisplay{_htSurfaces.at("Display")};
-    SDL_FillRect(*pSurfaceDisplay, nullptr, SDL_MapRGB(pSurfaceDisplay->GetPixelFormat(), 0, 0, 0));
+    TRACE_SCOPE("App::OnRender");
+    Surface* pSurfaceDisplay{_pSurfaceDisplay};
+    RenderCommandList& renderCommandList{_renderThread.BeginFrame()};
 
     // Get the position of the main Wiimote's IR
     int32_t iMouseX{}, iMouseY{};
     SDL_GetMouseState(&iMouseX, &iMouseY);
+
+    // Anything that changes the layout of the screen redraws it whole, the rest only marks its own region
     Vector3 vectorMouse{static_cast<float>(iMouseX), static_cast<float>(iMouseY)};
+    uint64_t uRenderKey{GetRenderKey()};
+    if (uRenderKey != _uRenderKey) _dirtyRects.Invalidate();
+    _uRenderKey = uRenderKey;
 
-    switch (_eStateCurrent)
+    // The frame time graph takes a new column every frame it is drawn
+    if (_settingsGlobal.GetIsDev())
     {
-    case EState::STATE_START:  // In the starting state we just draw the starting surface
+        SDL_Rect sdlRectProfiler{GetProfilerRect()};
+        _dirtyRects.Add(sdlRectProfiler.x, sdlRectProfiler.y, sdlRectProfiler.w, sdlRectProfiler.h);
+    }
+
+    // A button changes its look under the cursor, which takes the button left and the one entered
+    SDL_Rect sdlRectHover{GetHoverRect(vectorMouse)};
+    if (sdlRectHover.x != _sdlRectHover.x || sdlRectHover.y != _sdlRectHover.y ||
+        sdlRectHover.w != _sdlRectHover.w || sdlRectHover.h != _sdlRectHover.h)
     {
-        _htSurfaces.at("Start")->OnDraw(*pSurfaceDisplay);
-
-        // Draw buttons
-        Surface* pSurfaceDefaultButton{_htSurfaces.at("DefaultButton")};
-        Surface* pSurfaceHoverButton{_htSurfaces.at("HoverButton")};
-        Surface* pSurfaceExit{_htSurfaces.at("DefaultHome")};
-        const Button* CpButtonSingle{_htButtons.at("SinglePlayer")};
-        const Button* CpButtonMulti{_htButtons.at("MultiPlayer")};
-        const Button* CpButtonSettings{_htButtons.at("Settings")};
-        const Button* CpButtonExit{_htButtons.at("Exit")};
-
-        if (CpButtonSingle->IsInside(vectorMouse)) pSurfaceHoverButton->OnDraw(*pSurfaceDisplay, 
-            CpButtonSingle->GetTopLeft().fX, CpButtonSingle->GetTopLeft().fY);
-        else pSurfaceDefaultButton->OnDraw(*pSurfaceDisplay, CpButtonSingle->GetTopLeft().fX, 
-            CpButtonSingle->GetTopLeft().fY);
-
-        if (CpButtonMulti->IsInside(vectorMouse)) pSurfaceHoverButton->OnDraw(*pSurfaceDisplay, 
-            CpButtonMulti->GetTopLeft().fX, CpButtonMulti->GetTopLeft().fY);
-        else pSurfaceDefaultButton->OnDraw(*pSurfaceDisplay, CpButtonMulti->GetTopLeft().fX, 
-            CpButtonMulti->GetTopLeft().fY);
-
-        if (CpButtonSettings->IsInside(vectorMouse)) pSurfaceHoverButton->OnDraw(*pSurfaceDisplay, 
-            CpButtonSettings->GetTopLeft().fX, CpButtonSettings->GetTopLeft().fY);
-        else pSurfaceDefaultButton->OnDraw(*pSurfaceDisplay, CpButtonSettings->GetTopLeft().fX, 
-            CpButtonSettings->GetTopLeft().fY);
-
-        if (CpButtonExit->IsInside(vectorMouse)) pSurfaceExit->OnDraw(*pSurfaceDisplay, 
-            CpButtonExit->GetTopLeft().fX, CpButtonExit->GetTopLeft().fY, 29, 327, 72, 73);
-        else pSurfaceExit->OnDraw(*pSurfaceDisplay, CpButtonExit->GetTopLeft().fX, 
-            CpButtonExit->GetTopLeft().fY, 276, 327, 72, 73);
-
-        _htSurfaces.at("TextSingle")->OnDraw(*pSurfaceDisplay, 250, 170);
-        _htSurfaces.at("TextMulti")->OnDraw(*pSurfaceDisplay, 280, 250);
-        _htSurfaces.at("TextSettings")->OnDraw(*pSurfaceDisplay, 290, 330);
-
-        // We need to draw the cursor because SDL-wii draws directly to video memory
-        _htSurfaces.at("CursorShadow")->OnDraw(*pSurfaceDisplay, iMouseX - 47, iMouseY - 46);
-        _htSurfaces.at("CursorHand")->OnDraw(*pSurfaceDisplay, iMouseX - 48, iMouseY - 48);
-        break;
+        _dirtyRects.Add(_sdlRectHover.x, _sdlRectHover.y, _sdlRectHover.w, _sdlRectHover.h);
+        _dirtyRects.Add(sdlRectHover.x, sdlRectHover.y, sdlRectHover.w, sdlRectHover.h);
     }
-    case EState::STATE_SETTINGS:
+    _sdlRectHover = sdlRectHover;
+
+    // The cursor is not part of the scene, moving it only takes the overlay. Its colour tells whose turn it is
+    SDL_Rect sdlRectCursor{GetCursorRect(iMouseX, iMouseY)};
+    bool bHasTurnChanged{_uyCurrentPlayer != _uyDrawnPlayer};
+    bool bHasCursorMoved{sdlRectCursor.x != _sdlRectCursor.x || sdlRectCursor.y != _sdlRectCursor.y ||
+        sdlRectCursor.w != _sdlRectCursor.w || sdlRectCursor.h != _sdlRectCursor.h || bHasTurnChanged};
+    _sdlRectCursor = sdlRectCursor;
+    _uyDrawnPlayer = _uyCurrentPlayer;
+
+    // The hourglass is taken off as well when the turn of the AI ends
+    if ((_eStateCurrent == EState::STATE_INGAME || _eStateCurrent == EState::STATE_PROMPT) &&
+        (bHasTurnChanged || typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI)))
+        _dirtyRects.Add(_sdlRectHourglass.x, _sdlRectHourglass.y, _sdlRectHourglass.w,
+            _sdlRectHourglass.h);
+
+    // The new markers start falling here, and only the columns they fall down are drawn again
+    if (_eStateCurrent == EState::STATE_INGAME)
     {
-        // Draw buttons
-        Surface* pSurfaceButtons{_htSurfaces.at("DefaultHome")};
-        const Button* CpButtonExit{_htButtons.at("Exit")};
-
-        _htSurfaces.at("Settings")->OnDraw(*pSurfaceDisplay);
-        _htSurfaces.at("TextSettings")->OnDraw(*pSurfaceDisplay, 300, 40);
+        _boardLayer.Update(_grid, true);
+        _boardLayer.MarkChanged(_dirtyRects);
+    }
 
-        _htSurfaces.at("TextWidth")->OnDraw(*pSurfaceDisplay, 170, 100);
-        if (_settingsGlobal.GetBoardWidth() > Globals::SCuyBoardWidthMin) 
-        {
-            const Button* CpButtonMinusWidth{_htButtons.at("MinusWidth")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonMinusWidth->GetTopLeft().fX, 
-                CpButtonMinusWidth->GetTopLeft().fY, 157, 129, 77, 77);
-        }
-        _htSurfaces.at("TextWidthValue")->OnDraw(*pSurfaceDisplay, 410, 100);
-        if (_settingsGlobal.GetBoardWidth() < Globals::SCuyBoardWidthMax)
+    // The winning markers blink at the end of the game, which only takes their cells
+    if (_eStateCurrent == EState::STATE_END)
+    {
+        uint8_t uyWinFrame{_registryAnimations.At(_handleAnimationWin).GetCurrentFrame()};
+        if (uyWinFrame != _uyDrawnWinFrame && _grid.CheckWinner() != Grid::EPlayerMark::EMPTY)
         {
-            const Button* CpButtonPlusWidth{_htButtons.at("PlusWidth")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonPlusWidth->GetTopLeft().fX, 
-                CpButtonPlusWidth->GetTopLeft().fY, 30, 129, 77, 77);
+            std::pair<uint8_t, uint8_t> pairWinCell{_grid.GetWinCell()};
+            std::pair<int8_t, int8_t> pairWinDirection{_grid.GetWinDirection()};
+            for (uint8_t k = 0; k < _grid.GetCellsToWin(); ++k)
+            {
+                SDL_Rect sdlRectCell{_boardLayer.GetCellRect(pairWinCell.first + k * pairWinDirection.first,
+                    pairWinCell.second + k * pairWinDirection.second)};
+                _dirtyRects.Add(sdlRectCell.x, sdlRectCell.y, sdlRectCell.w, sdlRectCell.h);
+            }
         }
+        _uyDrawnWinFrame = uyWinFrame;
+    }
 
-        _htSurfaces.at("TextHeight")->OnDraw(*pSurfaceDisplay, 170, 190);
-        if (_settingsGlobal.GetBoardHeight() > Globals::SCuyBoardHeightMin) 
-        {
-            const Button* CpButtonMinusHeight{_htButtons.at("MinusHeight")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonMinusHeight->GetTopLeft().fX, 
-                CpButtonMinusHeight->GetTopLeft().fY, 157, 129, 77, 77);
-        }
-        _htSurfaces.at("TextHeightValue")->OnDraw(*pSurfaceDisplay, 410, 190);
-        if (_settingsGlobal.GetBoardHeight() < Globals::SCuyBoardHeightMax) 
-        {
-            const Button* CpButtonPlusHeight{_htButtons.at("PlusHeight")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonPlusHeight->GetTopLeft().fX, 
-                CpButtonPlusHeight->GetTopLeft().fY, 30, 129, 77, 77);
-        }
+    if (_eStateCurrent == EState::STATE_LOADING)
+    {
+        SDL_Rect sdlRectBar{GetLoadingBarRect()};
+        _dirtyRects.Add(sdlRectBar.x, sdlRectBar.y, sdlRectBar.w, sdlRectBar.h);
+    }
 
-        _htSurfaces.at("TextStreak")->OnDraw(*pSurfaceDisplay, 170, 275);
-        if (_settingsGlobal.GetCellsToWin() > Globals::SCuyCellsToWinMin) 
-        {
-            const Button* CpButtonMinusStreak{_htButtons.at("MinusStreak")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, 
-            CpButtonMinusStreak->GetTopLeft().fX, CpButtonMinusStreak->GetTopLeft().fY, 157, 129, 77, 77);
-        }
-        _htSurfaces.at("TextStreakValue")->OnDraw(*pSurfaceDisplay, 410, 275);
-        if (_settingsGlobal.GetCellsToWin() < std::max(_settingsGlobal.GetBoardWidth(), 
-            _settingsGlobal.GetBoardHeight()))
-        {
-            const Button* CpButtonPlusStreak{_htButtons.at("PlusStreak")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonPlusStreak->GetTopLeft().fX, 
-                CpButtonPlusStreak->GetTopLeft().fY, 30, 129, 77, 77);
-        }
+    _dirtyRects.Prepare(*pSurfaceDisplay);
+    UpdateScene(vectorMouse);
 
-        _htSurfaces.at("TextDifficulty")->OnDraw(*pSurfaceDisplay, 170, 375);
-        if (_settingsGlobal.GetAIDifficulty() > Globals::SCuyAIDifficultyMin) 
-        {
-            const Button* CpButtonMinusDifficulty{_htButtons.at("MinusDifficulty")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonMinusDifficulty->GetTopLeft().fX, 
-                CpButtonMinusDifficulty->GetTopLeft().fY, 157, 129, 77, 77);
-        }
-        _htSurfaces.at("TextDifficultyValue")->OnDraw(*pSurfaceDisplay, 410, 375);
-        if (_settingsGlobal.GetAIDifficulty() < Globals::SCuyAIDifficultyMax) 
-        {
-            const Button* CpButtonPlusDifficulty{_htButtons.at("PlusDifficulty")};
-            pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonPlusDifficulty->GetTopLeft().fX, 
-                CpButtonPlusDifficulty->GetTopLeft().fY, 30, 129, 77, 77);
-        }
+    // Every region is drawn with the whole scene clipped to it, SDL drops the blits that fall outside. The
+    // cursor is taken off the display first, and drawn again over everything else
+    std::vector<SDL_Rect> vectorSdlRectsPresent{_dirtyRects.GetRects()};
+    bool bIsDrawn{!vectorSdlRectsPresent.empty() || bHasCursorMoved};
+    if (bIsDrawn) _cursorOverlay.Restore(renderCommandList, *pSurfaceDisplay, vectorSdlRectsPresent);
+
+    for (const SDL_Rect& CsdlRect : _dirtyRects.GetRects())
+    {
+        renderCommandList.SetClip(&CsdlRect);
+        renderCommandList.Fill(nullptr, SDL_MapRGB(pSurfaceDisplay->GetPixelFormat(), 0, 0, 0));
+        RenderScene(renderCommandList, vectorMouse);
+    }
+    renderCommandList.SetClip(nullptr);
 
-        if (CpButtonExit->IsInside(vectorMouse)) pSurfaceButtons->OnDraw(*pSurfaceDisplay, 
-            CpButtonExit->GetTopLeft().fX, CpButtonExit->GetTopLeft().fY, 29, 327, 72, 73);
-        else pSurfaceButtons->OnDraw(*pSurfaceDisplay, CpButtonExit->GetTopLeft().fX, 
-            CpButtonExit->GetTopLeft().fY, 276, 327, 72, 73);
+    if (_settingsGlobal.GetIsDev())
+    {
+        RenderProfiler(renderCommandList);  // Its region was marked with the rest
 
-        // We need to draw the cursor because SDL-wii draws directly to video memory
-        _htSurfaces.at("CursorShadow")->OnDraw(*pSurfaceDisplay, iMouseX - 47, iMouseY - 46);
-        _htSurfaces.at("CursorHand")->OnDraw(*pSurfaceDisplay, iMouseX - 48, iMouseY - 48);
+        Profiler::Stats statsFrame{_profiler.GetFrameStats()};
+        std::printf("\x1b[2;0H");
+        std::printf("Cursor: %i, %i\n", iMouseX, iMouseY);
+        std::printf("FPS: %u\n", Time::GetInstance().GetFPS());
+        std::printf("Overruns: %u (last %u ms)\n", _frameScheduler.GetOverruns(), 
+            _frameScheduler.GetLastLateness());
+        std::printf("Frame: %.2f min, %.2f avg, %.2f p99 ms", statsFrame.fMin, statsFrame.fAverage, 
+            statsFrame.fP99);
+    }
+
+    if (bIsDrawn)
+    {
+        _cursorOverlay.Save(renderCommandList, sdlRectCursor, *pSurfaceDisplay, vectorSdlRectsPresent);
+        RenderCursor(renderCommandList, iMouseX, iMouseY);
+    }
+
+    // The render thread blits and refreshes the screen while the main thread goes on with the next frame,
+    // so the time it took to draw the previous frame is the one known here
+    renderCommandList.SetPresentRects(vectorSdlRectsPresent);
+    _renderThread.Submit(*pSurfaceDisplay);
+    _dirtyRects.EndFrame();
+    _cursorOverlay.EndFrame(*pSurfaceDisplay, !vectorSdlRectsPresent.empty());
+    _profiler.Add(Profiler::ESection::SECTION_PRESENT, _renderThread.GetLastExecuteTime());
+}
+
+
+/**
+ * @brief Draws the current screen, without the cursor
+ *
+ * @param renderCommandList the list of the frame
+ * @param CvectorMouse the position of the cursor
+ */
+void App::RenderScene(RenderCommandList& renderCommandList, const Vector3& CvectorMouse)
+{
+    const Surface* CpSurfaceDisplay{_pSurfaceDisplay};
+
+    switch (_eStateCurrent)
+    {
+    case EState::STATE_START:  // The menus are composited in advance, see UpdateScene
+    {
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_START};
+        _scene.OnDraw(renderCommandList);
+        break;
+    }
+    case EState::STATE_SETTINGS:
+    {
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_SETTINGS};
+        _scene.OnDraw(renderCommandList);
+        break;
+    }
+    case EState::STATE_LOADING:    // While the game textures load we show how many are ready
+    {
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_LOADING};
+        SDL_Rect sdlRectBar{GetLoadingBarRect()};
+        uint32_t uiColourBar{SDL_MapRGB(CpSurfaceDisplay->GetPixelFormat(), 252, 3, 3)};
+        renderCommandList.Fill(&sdlRectBar, uiColourBar);
+
+        // The inside of the frame fills up from the left
+        sdlRectBar.x += 2;
+        sdlRectBar.y += 2;
+        sdlRectBar.w -= 4;
+        sdlRectBar.h -= 4;
+        renderCommandList.Fill(&sdlRectBar, SDL_MapRGB(CpSurfaceDisplay->GetPixelFormat(), 0, 0, 0));
+
+        if (_assetLoader.GetQueued() > 0)
+        {
+            sdlRectBar.w = static_cast<Uint16>(sdlRectBar.w * _assetLoader.GetCompleted() / 
+                _assetLoader.GetQueued());
+            renderCommandList.Fill(&sdlRectBar, uiColourBar);
+        }
         break;
     }
     case EState::STATE_INGAME: // Inside the game we draw the grid and as many markers as necessary
     {
-        RenderGrid(*pSurfaceDisplay);
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_INGAME};
+        RenderGrid(renderCommandList);
 
-        Surface* pSurfaceExit{_htSurfaces.at("DefaultHome")};
-        Surface* pSurfaceCursor{nullptr};
-        const Button* CpButtonExit{_htButtons.at("Exit")};
+        const Button& CbuttonExit{_registryButtons.At(_handleButtonExit)};
 
         if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
         {
-            _htSurfaces.at("Hourglass")->OnDraw(*pSurfaceDisplay, 552, 25, 
-                88 * _htAnimations.at("Loading")->GetCurrentFrame(), 7, 88, 72);
-            pSurfaceCursor = _htSurfaces.at("CursorPlayer1");
+            renderCommandList.Blit(_registrySurfaces.At(_handleSurfaceHourglass), _sdlRectHourglass.x, 
+                _sdlRectHourglass.y, 88 * _registryAnimations.At(_handleAnimationLoading).GetCurrentFrame(), 7,
+                _sdlRectHourglass.w, _sdlRectHourglass.h);
         }
-        else if (_uyCurrentPlayer == 0) pSurfaceCursor = _htSurfaces.at("CursorPlayer1");
-        else if (_uyCurrentPlayer == 1) pSurfaceCursor = _htSurfaces.at("CursorPlayer2");
-
-        if (CpButtonExit->IsInside(vectorMouse)) pSurfaceExit->OnDraw(*pSurfaceDisplay, 
-            CpButtonExit->GetTopLeft().fX, CpButtonExit->GetTopLeft().fY, 29, 327, 72, 73);
-        else pSurfaceExit->OnDraw(*pSurfaceDisplay, CpButtonExit->GetTopLeft().fX, 
-            CpButtonExit->GetTopLeft().fY, 276, 327, 72, 73);
 
-        // We need to draw the cursor because SDL-wii draws directly to video memory
-        pSurfaceCursor->OnDraw(*pSurfaceDisplay, iMouseX - (pSurfaceCursor->GetWidth() >> 1), 
-            iMouseY - (pSurfaceCursor->GetHeight() >> 1));
+        _pAtlasUI->OnDraw(CbuttonExit.IsInside(CvectorMouse) ? _spriteHomeHover : _spriteHome,
+            renderCommandList, CbuttonExit.GetTopLeft().fX, CbuttonExit.GetTopLeft().fY);
         break;
     }
     case EState::STATE_PROMPT:
     {
-        RenderGrid(*pSurfaceDisplay);
-
-        Surface* pSurfaceDefaultYes{_htSurfaces.at("DefaultYes")};
-        Surface* pSurfaceHoverYes{_htSurfaces.at("HoverYes")};
-        Surface* pSurfaceExit{_htSurfaces.at("DefaultHome")};
-        const Button* CpButtonYes{_htButtons.at("Yes")};
-        const Button* CpButtonNo{_htButtons.at("No")};
-        const Button* CpButtonExit{_htButtons.at("Exit")};
-
-        _htSurfaces.at("Prompt")->OnDraw(*pSurfaceDisplay, 170, 140);
-
-        // Draw buttons
-        if (CpButtonYes->IsInside(vectorMouse)) pSurfaceHoverYes->OnDraw(*pSurfaceDisplay, 
-            CpButtonYes->GetTopLeft().fX, CpButtonYes->GetTopLeft().fY);
-        else pSurfaceDefaultYes->OnDraw(*pSurfaceDisplay, CpButtonYes->GetTopLeft().fX, 
-            CpButtonYes->GetTopLeft().fY);
-
-        if (CpButtonNo->IsInside(vectorMouse)) pSurfaceHoverYes->OnDraw(*pSurfaceDisplay, 
-            CpButtonNo->GetTopLeft().fX, CpButtonNo->GetTopLeft().fY);
-        else pSurfaceDefaultYes->OnDraw(*pSurfaceDisplay, CpButtonNo->GetTopLeft().fX, 
-            CpButtonNo->GetTopLeft().fY);
-
-        _htSurfaces.at("TextPrompt")->OnDraw(*pSurfaceDisplay, 210, 150);
-        _htSurfaces.at("TextYes")->OnDraw(*pSurfaceDisplay, 260, 250);
-        _htSurfaces.at("TextNo")->OnDraw(*pSurfaceDisplay, 360, 250);
-
-        if (CpButtonExit->IsInside(vectorMouse)) pSurfaceExit->OnDraw(*pSurfaceDisplay, 
-            CpButtonExit->GetTopLeft().fX, CpButtonExit->GetTopLeft().fY, 29, 327, 72, 73);
-        else pSurfaceExit->OnDraw(*pSurfaceDisplay, CpButtonExit->GetTopLeft().fX, 
-            CpButtonExit->GetTopLeft().fY, 276, 327, 72, 73);
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_PROMPT};
+        _scene.OnDraw(renderCommandList);
 
         if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
         {
-            _htSurfaces.at("Hourglass")->OnDraw(*pSurfaceDisplay, 552, 25, 
-                88 * _htAnimations.at("Loading")->GetCurrentFrame(), 7, 88, 72);
+            renderCommandList.Blit(_registrySurfaces.At(_handleSurfaceHourglass), _sdlRectHourglass.x, 
+                _sdlRectHourglass.y, 88 * _registryAnimations.At(_handleAnimationLoading).GetCurrentFrame(), 7,
+                _sdlRectHourglass.w, _sdlRectHourglass.h);
         }
-
-        // We need to draw the cursor because SDL-wii draws directly to video memory
-        _htSurfaces.at("CursorShadow")->OnDraw(*pSurfaceDisplay, iMouseX - 47, iMouseY - 46);
-        _htSurfaces.at("CursorHand")->OnDraw(*pSurfaceDisplay, iMouseX - 48, iMouseY - 48);
         break;
     }
     case EState::STATE_END:    // In the win state we show a surface depending on who won
     {
-        RenderGrid(*pSurfaceDisplay);
+        Profiler::ScopedTimer timerScene{_profiler, Profiler::ESection::SECTION_RENDER_END};
+        _scene.OnDraw(renderCommandList);
 
-        Surface* pSurfaceWinPlayer1{_htSurfaces.at("WinPlayer1")};
-        Surface* pSurfaceExit{_htSurfaces.at("DefaultHome")};
-        const Button* CpButtonExit{_htButtons.at("Exit")};
+        if (_grid.CheckWinner() == Grid::EPlayerMark::EMPTY ||
+            _registryAnimations.At(_handleAnimationWin).GetCurrentFrame() != 0) break;
 
-        int32_t iInitialX{(pSurfaceDisplay->GetWidth() >> 1) - (pSurfaceWinPlayer1->GetWidth() >> 1)};
-        //int32_t iInitialY{(pSurfaceDisplay->GetHeight() >> 1) - (pSurfaceWinPlayer1->GetHeight() >> 1)};
+        // The winning cells are shown empty every other frame of the animation. They are drawn over the
+        // composited scene so the blinking does not rebuild its layers
+        std::pair<uint8_t, uint8_t> pairWinCell{_grid.GetWinCell()};
+        std::pair<int8_t, int8_t> pairWinDirection{_grid.GetWinDirection()};
+        const Surface& CsurfaceBackground{_registrySurfaces.At(_handleSurfaceBackground)};
+        const Surface& CsurfaceEmptyCell{_registrySurfaces.At(_handleSurfaceEmptyCell)};
 
-        switch (_grid.CheckWinner())
+        for (uint8_t k = 0; k < _grid.GetCellsToWin(); ++k)
         {
-        case Grid::EPlayerMark::PLAYER1: 
-            pSurfaceWinPlayer1->OnDraw(*pSurfaceDisplay, iInitialX, 50);            break;
-        case Grid::EPlayerMark::PLAYER2: 
-            _htSurfaces.at("WinPlayer2")->OnDraw(*pSurfaceDisplay, iInitialX, 50);  break;
-        case Grid::EPlayerMark::EMPTY:   
-            _htSurfaces.at("Draw")->OnDraw(*pSurfaceDisplay, iInitialX, 50);        break;
+            SDL_Rect sdlRectCell{_boardLayer.GetCellRect(pairWinCell.first + k * pairWinDirection.first,
+                pairWinCell.second + k * pairWinDirection.second)};
+
+            renderCommandList.Blit(CsurfaceBackground, sdlRectCell.x, sdlRectCell.y, sdlRectCell.x,
+                sdlRectCell.y, sdlRectCell.w, sdlRectCell.h);
+            renderCommandList.Blit(CsurfaceEmptyCell, sdlRectCell.x, sdlRectCell.y);
         }
+        break;
+    }
+    }
 
-        if (CpButtonExit->IsInside(vectorMouse)) pSurfaceExit->OnDraw(*pSurfaceDisplay, 
-            CpButtonExit->GetTopLeft().fX, CpButtonExit->GetTopLeft().fY, 29, 327, 72, 73);
-        else pSurfaceExit->OnDraw(*pSurfaceDisplay, CpButtonExit->GetTopLeft().fX, 
-            CpButtonExit->GetTopLeft().fY, 276, 327, 72, 73);
+}
 
-        // We need to draw the cursor because SDL-wii draws directly to video memory
-        _htSurfaces.at("CursorShadow")->OnDraw(*pSurfaceDisplay, iMouseX - 47, iMouseY - 46);
-        _htSurfaces.at("CursorHand")->OnDraw(*pSurfaceDisplay, iMouseX - 48, iMouseY - 48);
 
-        break;
+/**
+ * @brief Draws the cursor of the current screen
+ *
+ * @param renderCommandList the list of the frame
+ * @param iMouseX the X coordinate of the cursor
+ * @param iMouseY the Y coordinate of the cursor
+ */
+void App::RenderCursor(RenderCommandList& renderCommandList, int32_t iMouseX, int32_t iMouseY) const
+{
+    // We need to draw the cursor because SDL-wii draws directly to video memory
+    if (_eStateCurrent == EState::STATE_INGAME)
+    {
+        SDL_Rect sdlRectCursor{GetCursorRect(iMouseX, iMouseY)};
+        _pAtlasUI->OnDraw(GetCursorSprite(), renderCommandList, sdlRectCursor.x, sdlRectCursor.y);
+        return;
     }
+
+    _pAtlasUI->OnDraw(_spriteCursorShadow, renderCommandList, iMouseX - 47, iMouseY - 46);
+    _pAtlasUI->OnDraw(_spriteCursorHand, renderCommandList, iMouseX - 48, iMouseY - 48);
+}
+
+
+/**
+ * @brief Draws the frame times of the profiler as a graph, with a line at the frame budget
+ *
+ * @param renderCommandList the list of the frame
+ */
+void App::RenderProfiler(RenderCommandList& renderCommandList) const
+{
+    // The height of the graph covers two frame budgets
+    const uint32_t CuiBudget{1000000u / Globals::SCurTargetFPS};
+    const SDL_PixelFormat* CpSdlPixelFormat{_pSurfaceDisplay->GetPixelFormat()};
+
+    SDL_Rect sdlRectGraph{GetProfilerRect()};
+    const uint16_t CurGraphHeight{sdlRectGraph.h};
+    renderCommandList.Fill(&sdlRectGraph, SDL_MapRGB(CpSdlPixelFormat, 16, 16, 16));
+
+    uint32_t uiColourFast{SDL_MapRGB(CpSdlPixelFormat, 3, 200, 3)};
+    uint32_t uiColourSlow{SDL_MapRGB(CpSdlPixelFormat, 252, 3, 3)};
+    for (uint16_t i = 0; i < _profiler.GetFrameCount(); ++i)
+    {
+        uint32_t uiFrameTime{_profiler.GetFrameTime(i)};
+        uint16_t urHeight{static_cast<uint16_t>(std::min<uint32_t>(CurGraphHeight, 
+            uiFrameTime * (CurGraphHeight >> 1) / CuiBudget))};
+
+        // The newest frame is on the right
+        SDL_Rect sdlRectFrame{static_cast<Sint16>(sdlRectGraph.x + sdlRectGraph.w - 1 - i), 
+            static_cast<Sint16>(sdlRectGraph.y + CurGraphHeight - urHeight), 1, urHeight};
+        renderCommandList.Fill(&sdlRectFrame, uiFrameTime > CuiBudget ? uiColourSlow : uiColourFast);
     }
 
-    if (_settingsGlobal.GetIsDev())
+    SDL_Rect sdlRectBudget{sdlRectGraph.x, static_cast<Sint16>(sdlRectGraph.y + (CurGraphHeight >> 1)), 
+        sdlRectGraph.w, 1};
+    renderCommandList.Fill(&sdlRectBudget, SDL_MapRGB(CpSdlPixelFormat, 255, 255, 255));
+}
+
+
+/**
+ * @brief Gets the region covered by the cursor
+ *
+ * @param iMouseX the X coordinate of the cursor
+ * @param iMouseY the Y coordinate of the cursor
+ * @return SDL_Rect the region of the display where the cursor is drawn
+ */
+SDL_Rect App::GetCursorRect(int32_t iMouseX, int32_t iMouseY) const
+{
+    if (_eStateCurrent == EState::STATE_INGAME)
     {
-        std::printf("\x1b[2;0H");
-        std::printf("Cursor: %i, %i\n", iMouseX, iMouseY);
-        std::printf("FPS: %u", Time::GetInstance().GetFPS());
+        const SDL_Rect& CsdlRectCursor{_pAtlasUI->GetRect(GetCursorSprite())};
+
+        return SDL_Rect{static_cast<Sint16>(iMouseX - (CsdlRectCursor.w >> 1)),
+            static_cast<Sint16>(iMouseY - (CsdlRectCursor.h >> 1)), CsdlRectCursor.w, CsdlRectCursor.h};
     }
 
-    SDL_Flip(*pSurfaceDisplay);  // Refreshes the screen
+    // The hand and its shadow, which is drawn one pixel right and two pixels down
+    const SDL_Rect& CsdlRectHand{_pAtlasUI->GetRect(_spriteCursorHand)};
+    const SDL_Rect& CsdlRectShadow{_pAtlasUI->GetRect(_spriteCursorShadow)};
+
+    return SDL_Rect{static_cast<Sint16>(iMouseX - 48), static_cast<Sint16>(iMouseY - 48),
+        static_cast<Uint16>(std::max(CsdlRectHand.w, static_cast<Uint16>(CsdlRectShadow.w + 1))),
+        static_cast<Uint16>(std::max(CsdlRectHand.h, static_cast<Uint16>(CsdlRectShadow.h + 2)))};
+}
+
+
+/**
+ * @brief Gets the region of the progress bar shown while the game loads
+ *
+ * @return SDL_Rect the region of the display, frame included
+ */
+SDL_Rect App::GetLoadingBarRect() const
+{
+    return SDL_Rect{static_cast<Sint16>((_pSurfaceDisplay->GetWidth() - 300) >> 1),
+        static_cast<Sint16>((_pSurfaceDisplay->GetHeight() - 20) >> 1), 300, 20};
 }
 
 
-void App::RenderGrid(Surface& pSurfaceDisplay) const
+/**
+ * @brief Gets the region of the frame time graph shown in dev mode
+ *
+ * @return SDL_Rect the region of the display in the bottom right corner
+ */
+SDL_Rect App::GetProfilerRect() const
 {
-    Surface* pSurfaceEmptyFill{_htSurfaces.at("EmptyCell")};
-    Surface* pSurfaceMarker1{_htSurfaces.at("PlayerMarker1")};
-    Surface* pSurfaceMarker2{_htSurfaces.at("PlayerMarker2")};
+    // One column per stored frame
+    return SDL_Rect{static_cast<Sint16>(_pSurfaceDisplay->GetWidth() - Profiler::SCurFrames - 8),
+        static_cast<Sint16>(_pSurfaceDisplay->GetHeight() - 64 - 8), Profiler::SCurFrames, 64};
+}
 
-    _htSurfaces.at("Background")->OnDraw(pSurfaceDisplay);
 
-    for(int32_t i = 0; i < _grid.GetHeight(); ++i)  // Search for markers and draw them
-    {
-        // Surface coordinate of the i'th row of the grid
-        int32_t iY{_rInitialY + i * pSurfaceMarker1->GetHeight()};
+/**
+ * @brief Gets the sprite of the cursor inside a game, which shows whose turn it is
+ *
+ * @return Atlas::Sprite the sprite in the UI atlas
+ */
+Atlas::Sprite App::GetCursorSprite() const
+{
+    return (_uyCurrentPlayer == 1 && typeid(*(_vectorpPlayers[_uyCurrentPlayer])) != typeid(AI) ?
+        _spriteCursorPlayer2 : _spriteCursorPlayer1);
+}
 
-        for (int32_t j = 0; j < _grid.GetWidth(); ++j)
-        {
-            // Surface coordinate of the j'th column of the grid
-            int32_t iX{_rInitialX + j * pSurfaceMarker1->GetWidth()};
 
-            if (_eStateCurrent != EState::STATE_END)
-            {
-                if(_grid[i][j] == Grid::EPlayerMark::PLAYER1)
-                    pSurfaceMarker1->OnDraw(pSurfaceDisplay, iX, iY);
-                else if(_grid[i][j] == Grid::EPlayerMark::PLAYER2)
-                    pSurfaceMarker2->OnDraw(pSurfaceDisplay, iX, iY);
-                else pSurfaceEmptyFill->OnDraw(pSurfaceDisplay, iX, iY);
-            }
-            else
-            {
-                std::pair<uint8_t, uint8_t> pairWinCell{_grid.GetWinCell()};
-                std::pair<int8_t, int8_t> pairWinDirection{_grid.GetWinDirection()};
-
-                bool bIsWinner{false};
-                for (uint8_t k = 0; k < _grid.GetCellsToWin() && !bIsWinner; k++)
-                {
-                    if (i == pairWinCell.first + k * pairWinDirection.first &&
-                        j == pairWinCell.second + k * pairWinDirection.second) bIsWinner = true;
-                }
-
-                if (bIsWinner)
-                {
-                    if (_htAnimations.at("Win")->GetCurrentFrame() != 0)
-                    {
-                        if(_grid[i][j] == Grid::EPlayerMark::PLAYER1)
-                            pSurfaceMarker1->OnDraw(pSurfaceDisplay, iX, iY);
-                        else if(_grid[i][j] == Grid::EPlayerMark::PLAYER2)
-                            pSurfaceMarker2->OnDraw(pSurfaceDisplay, iX, iY);
-                    }
-                    else pSurfaceEmptyFill->OnDraw(pSurfaceDisplay, iX, iY);
-                }
-                else if(_grid[i][j] == Grid::EPlayerMark::PLAYER1)
-                    pSurfaceMarker1->OnDraw(pSurfaceDisplay, iX, iY);
-                else if(_grid[i][j] == Grid::EPlayerMark::PLAYER2)
-                    pSurfaceMarker2->OnDraw(pSurfaceDisplay, iX, iY);
-                else pSurfaceEmptyFill->OnDraw(pSurfaceDisplay, iX, iY);
-            }
-        }
+/**
+ * @brief Summarises everything that changes the layout of the current screen. The hovered buttons and the
+ * blinking markers are left out, they only mark their own regions
+ *
+ * @return uint64_t a value that changes whenever the screen must be redrawn whole
+ */
+uint64_t App::GetRenderKey() const
+{
+    uint64_t uRenderKey{static_cast<uint64_t>(_eStateCurrent)};
+
+    // The markers only ever grow during a game, so their count tells whether the grid changed. Inside the
+    // game the new markers fall down their column, which only marks the column
+    if (_eStateCurrent != EState::STATE_INGAME)
+    {
+        uint8_t uyMarkers{0};
+        for (uint8_t i = 0; i < _grid.GetWidth(); ++i) 
+            uyMarkers += _grid.GetHeight() - 1 - _grid.GetNextCell(i);
+
+        uRenderKey = (uRenderKey << 8) | uyMarkers;
+        uRenderKey = (uRenderKey << 1) | (_uyCurrentPlayer & 1);
     }
+    uRenderKey = (uRenderKey << 4) | _settingsGlobal.GetBoardWidth();
+    uRenderKey = (uRenderKey << 4) | _settingsGlobal.GetBoardHeight();
+    uRenderKey = (uRenderKey << 4) | _settingsGlobal.GetCellsToWin();
+    uRenderKey = (uRenderKey << 4) | _settingsGlobal.GetAIDifficulty();
+
+    return uRenderKey;
+}
+
+
+/**
+ * @brief Draws the board
+ *
+ * @param renderCommandList the list of the frame
+ */
+void App::RenderGrid(RenderCommandList& renderCommandList)
+{
+    Profiler::ScopedTimer timerGrid{_profiler, Profiler::ESection::SECTION_GRID};
+
+    _boardLayer.OnDraw(_grid, renderCommandList);
 }
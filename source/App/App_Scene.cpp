@@ -0,0 +1,343 @@
+/*
+App_Scene.cpp --- App layouts of the menus
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <SDL_video.h>
+
+#include "../../include/App.hpp"
+#include "../../include/video/Scene.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/Atlas.hpp"
+#include "../../include/video/Button.hpp"
+#include "../../include/video/Vector3.hpp"
+#include "../../include/video/ScreenLayout.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/Trace.hpp"
+
+
+namespace
+{
+    /**
+     * @brief The kinds of things a screen is made of
+     */
+    enum EItem : uint8_t
+    {
+        ITEM_SURFACE,   /**< A surface of the registry, by name */
+        ITEM_SPRITE,    /**< A sprite of the UI atlas, by name */
+        ITEM_BUTTON,    /**< A button of the registry, by name, drawn where it is with one of two sprites */
+        ITEM_BOARD,     /**< The board, without the blinking of the winning markers */
+        ITEM_RESULT     /**< The banner of the winner, centred */
+    };
+
+    /**
+     * @brief One thing drawn on a screen
+     */
+    struct Item
+    {
+        EItem eItem;
+        Scene::ELayer eLayer;
+        const char* CpName;         /**< The surface or button, if any */
+        const char* CpSprite;       /**< The sprite, or the look of a button */
+        const char* CpSpriteHover;  /**< The look of a button under the cursor, nullptr if it has only one */
+        int16_t rX, rY;             /**< Where surfaces, sprites and the banner are drawn on the preferred
+                                         display, the banner keeps its distance to the top of the display
+                                         and the rest to its centre */
+    };
+
+    /**
+     * @brief The things drawn on the screen of a state, from the bottom up
+     */
+    struct Layout
+    {
+        App::EState eState;
+        const Item* CpItems;
+        uint8_t uyItems;
+    };
+
+
+    const Item SCaitemsStart[]
+    {
+        {ITEM_SURFACE, Scene::LAYER_BACKGROUND, "Start", nullptr, nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "SinglePlayer", "DefaultButton", "HoverButton", 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "MultiPlayer", "DefaultButton", "HoverButton", 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Settings", "DefaultButton", "HoverButton", 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Exit", "Home", "HomeHover", 0, 0},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextSingle", nullptr, nullptr, 250, 170},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextMulti", nullptr, nullptr, 280, 250},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextSettings", nullptr, nullptr, 290, 330}
+    };
+
+    const Item SCaitemsSettings[]
+    {
+        {ITEM_SURFACE, Scene::LAYER_BACKGROUND, "Settings", nullptr, nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "MinusWidth", "Minus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "PlusWidth", "Plus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "MinusHeight", "Minus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "PlusHeight", "Plus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "MinusStreak", "Minus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "PlusStreak", "Plus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "MinusDifficulty", "Minus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "PlusDifficulty", "Plus", nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Exit", "Home", "HomeHover", 0, 0},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextSettings", nullptr, nullptr, 300, 40},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextWidth", nullptr, nullptr, 170, 100},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextWidthValue", nullptr, nullptr, 410, 100},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextHeight", nullptr, nullptr, 170, 190},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextHeightValue", nullptr, nullptr, 410, 190},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextStreak", nullptr, nullptr, 170, 275},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextStreakValue", nullptr, nullptr, 410, 275},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextDifficulty", nullptr, nullptr, 170, 375},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextDifficultyValue", nullptr, nullptr, 410, 375}
+    };
+
+    const Item SCaitemsPrompt[]
+    {
+        {ITEM_BOARD, Scene::LAYER_BACKGROUND, nullptr, nullptr, nullptr, 0, 0},
+        {ITEM_SPRITE, Scene::LAYER_BACKGROUND, nullptr, "Prompt", nullptr, 170, 140},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Yes", "DefaultYes", "HoverYes", 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "No", "DefaultYes", "HoverYes", 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Exit", "Home", "HomeHover", 0, 0},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextPrompt", nullptr, nullptr, 210, 150},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextYes", nullptr, nullptr, 260, 250},
+        {ITEM_SURFACE, Scene::LAYER_LABELS, "TextNo", nullptr, nullptr, 360, 250}
+    };
+
+    const Item SCaitemsEnd[]
+    {
+        {ITEM_BOARD, Scene::LAYER_BACKGROUND, nullptr, nullptr, nullptr, 0, 0},
+        {ITEM_BUTTON, Scene::LAYER_BUTTONS, "Exit", "Home", "HomeHover", 0, 0},
+        {ITEM_RESULT, Scene::LAYER_LABELS, nullptr, nullptr, nullptr, 0, 50}
+    };
+
+    const Layout SCalayouts[]
+    {
+        {App::EState::STATE_START, SCaitemsStart, static_cast<uint8_t>(std::size(SCaitemsStart))},
+        {App::EState::STATE_SETTINGS, SCaitemsSettings, static_cast<uint8_t>(std::size(SCaitemsSettings))},
+        {App::EState::STATE_PROMPT, SCaitemsPrompt, static_cast<uint8_t>(std::size(SCaitemsPrompt))},
+        {App::EState::STATE_END, SCaitemsEnd, static_cast<uint8_t>(std::size(SCaitemsEnd))}
+    };
+}
+
+
+/**
+ * @brief Resolves the surfaces, buttons and sprites of the items of every screen, after the UI atlas
+ */
+void App::ResolveScene()
+{
+    for (const Layout& Clayout : SCalayouts)
+    {
+        std::vector<SceneItem>& vectorItems{_avectorSceneItems[Clayout.eState]};
+        vectorItems.clear();
+
+        for (uint8_t i = 0; i < Clayout.uyItems; ++i)
+        {
+            const Item& Citem{Clayout.CpItems[i]};
+            SceneItem sceneItem{Citem.eItem, Citem.eLayer, {}, {}, {}, {}, Citem.CpSpriteHover != nullptr,
+                Citem.rX, Citem.rY};
+
+            if (Citem.eItem == EItem::ITEM_SURFACE) sceneItem.handleSurface = _registrySurfaces.Resolve(
+                Citem.CpName);
+            else if (Citem.eItem == EItem::ITEM_BUTTON) sceneItem.handleButton = _registryButtons.Resolve(
+                Citem.CpName);
+            if (Citem.CpSprite) sceneItem.sprite = _pAtlasUI->Resolve(Citem.CpSprite);
+            if (Citem.CpSpriteHover) sceneItem.spriteHover = _pAtlasUI->Resolve(Citem.CpSpriteHover);
+
+            vectorItems.push_back(sceneItem);
+        }
+    }
+}
+
+
+/**
+ * @brief Describes again the layers of the current screen whose contents changed, and composites them
+ *
+ * @param CvectorMouse the position of the cursor
+ */
+void App::UpdateScene(const Vector3& CvectorMouse)
+{
+    const std::vector<SceneItem>& CvectorItems{_avectorSceneItems[_eStateCurrent]};
+    if (CvectorItems.empty())
+    {
+        _scene.Invalidate();    // The board changes during a game, so it is not worth keeping
+        return;
+    }
+
+    TRACE_SCOPE("App::UpdateScene");
+
+    // One key per layer, made of whatever its items depend on
+    uint64_t uKeyLabels{static_cast<uint64_t>(_eStateCurrent)};
+    uKeyLabels = (uKeyLabels << 4) | _settingsGlobal.GetBoardWidth();
+    uKeyLabels = (uKeyLabels << 4) | _settingsGlobal.GetBoardHeight();
+    uKeyLabels = (uKeyLabels << 4) | _settingsGlobal.GetCellsToWin();
+    uKeyLabels = (uKeyLabels << 4) | _settingsGlobal.GetAIDifficulty();
+
+    uint8_t uyMarkers{0};
+    for (uint8_t i = 0; i < _grid.GetWidth(); ++i) uyMarkers += _grid.GetHeight() - 1 - _grid.GetNextCell(i);
+
+    uint64_t uKeyBackground{(static_cast<uint64_t>(_eStateCurrent) << 8) | uyMarkers};
+
+    uint64_t uKeyButtons{uKeyLabels};
+    for (const SceneItem& CsceneItem : CvectorItems)
+    {
+        if (CsceneItem.uyItem != EItem::ITEM_BUTTON || !CsceneItem.bHasHover) continue;
+
+        const Button* CpButton{_registryButtons[CsceneItem.handleButton]};
+        uKeyButtons = (uKeyButtons << 1) | (CpButton && CpButton->IsInside(CvectorMouse));
+    }
+
+    std::array<bool, Scene::ELayer::LAYER_COUNT> abIsDescribed{
+        _scene.BeginLayer(Scene::ELayer::LAYER_BACKGROUND, uKeyBackground),
+        _scene.BeginLayer(Scene::ELayer::LAYER_BUTTONS, uKeyButtons),
+        _scene.BeginLayer(Scene::ELayer::LAYER_LABELS, uKeyLabels)};
+
+    for (const SceneItem& Citem : CvectorItems)
+    {
+        if (!abIsDescribed[Citem.eLayer]) continue;
+
+        switch (Citem.uyItem)
+        {
+        case EItem::ITEM_SURFACE:
+        {
+            Surface* pSurface{_registrySurfaces[Citem.handleSurface]};
+            SDL_Rect sdlRectItem{_screenLayout.Place(ScreenLayout::ANCHOR_CENTRE, Citem.rX, Citem.rY)};
+            if (pSurface) _scene.Add(Citem.eLayer, *pSurface, sdlRectItem.x, sdlRectItem.y);
+            break;
+        }
+        case EItem::ITEM_SPRITE:
+        {
+            SDL_Rect sdlRectItem{_screenLayout.Place(ScreenLayout::ANCHOR_CENTRE, Citem.rX, Citem.rY)};
+            _scene.Add(Citem.eLayer, *_pAtlasUI, Citem.sprite, sdlRectItem.x, sdlRectItem.y);
+            break;
+        }
+        case EItem::ITEM_BUTTON:
+        {
+            const Button* CpButton{_registryButtons[Citem.handleButton]};
+            if (CpButton == nullptr || !IsButtonShown(Citem.handleButton)) break;
+
+            bool bIsHovered{Citem.bHasHover && CpButton->IsInside(CvectorMouse)};
+            _scene.Add(Citem.eLayer, *_pAtlasUI, (bIsHovered ? Citem.spriteHover : Citem.sprite),
+                CpButton->GetTopLeft().fX, CpButton->GetTopLeft().fY);
+            break;
+        }
+        case EItem::ITEM_BOARD:
+        {
+            // The winning markers blink over the scene, see RenderScene
+            Surface* pSurfaceBoard{_boardLayer.Update(_grid)};
+            if (pSurfaceBoard) _scene.Add(Citem.eLayer, *pSurfaceBoard);
+            break;
+        }
+        case EItem::ITEM_RESULT:
+        {
+            Atlas::Sprite spriteResult{_spriteDraw};
+            if (_grid.CheckWinner() == Grid::EPlayerMark::PLAYER1) spriteResult = _spriteWinPlayer1;
+            else if (_grid.CheckWinner() == Grid::EPlayerMark::PLAYER2) spriteResult = _spriteWinPlayer2;
+
+            int16_t rX = (Globals::SCurAppWidth >> 1) - (_pAtlasUI->GetRect(_spriteWinPlayer1).w >> 1);
+            SDL_Rect sdlRectItem{_screenLayout.Place(ScreenLayout::ANCHOR_TOP, rX, Citem.rY)};
+            _scene.Add(Citem.eLayer, *_pAtlasUI, spriteResult, sdlRectItem.x, sdlRectItem.y);
+            break;
+        }
+        }
+    }
+
+    _scene.Composite(*_pSurfaceDisplay);
+}
+
+
+/**
+ * @brief Checks whether a button can be pressed on the current screen, the settings hide the buttons that
+ * would take a value out of its range
+ *
+ * @param handleButton the button
+ * @return true if the button is drawn
+ */
+bool App::IsButtonShown(ButtonHandle handleButton) const noexcept
+{
+    if (handleButton == _handleButtonMinusWidth)
+        return _settingsGlobal.GetBoardWidth() > Globals::SCuyBoardWidthMin;
+    if (handleButton == _handleButtonPlusWidth)
+        return _settingsGlobal.GetBoardWidth() < Globals::SCuyBoardWidthMax;
+    if (handleButton == _handleButtonMinusHeight)
+        return _settingsGlobal.GetBoardHeight() > Globals::SCuyBoardHeightMin;
+    if (handleButton == _handleButtonPlusHeight)
+        return _settingsGlobal.GetBoardHeight() < Globals::SCuyBoardHeightMax;
+    if (handleButton == _handleButtonMinusStreak)
+        return _settingsGlobal.GetCellsToWin() > Globals::SCuyCellsToWinMin;
+    if (handleButton == _handleButtonPlusStreak)
+        return _settingsGlobal.GetCellsToWin() < std::max(_settingsGlobal.GetBoardWidth(),
+            _settingsGlobal.GetBoardHeight());
+    if (handleButton == _handleButtonMinusDifficulty)
+        return _settingsGlobal.GetAIDifficulty() > Globals::SCuyAIDifficultyMin;
+    if (handleButton == _handleButtonPlusDifficulty)
+        return _settingsGlobal.GetAIDifficulty() < Globals::SCuyAIDifficultyMax;
+
+    return true;
+}
+
+
+/**
+ * @brief Gets the region of the button under the cursor, which covers both of its looks
+ *
+ * @param CvectorMouse the position of the cursor
+ * @return SDL_Rect the region of the display, empty if no button that changes its look is hovered
+ */
+SDL_Rect App::GetHoverRect(const Vector3& CvectorMouse) const
+{
+    // Inside the game the exit button is the only one, and it is not part of a scene
+    const Button* CpButtonHovered{nullptr};
+    Atlas::Sprite sprite{_spriteHome}, spriteHover{_spriteHomeHover};
+    if (_eStateCurrent == EState::STATE_INGAME)
+    {
+        const Button* CpButton{_registryButtons[_handleButtonExit]};
+        if (CpButton && CpButton->IsInside(CvectorMouse)) CpButtonHovered = CpButton;
+    }
+
+    for (const SceneItem& CsceneItem : _avectorSceneItems[_eStateCurrent])
+    {
+        if (CpButtonHovered) break;
+        if (CsceneItem.uyItem != EItem::ITEM_BUTTON || !CsceneItem.bHasHover) continue;
+
+        const Button* CpButton{_registryButtons[CsceneItem.handleButton]};
+        if (CpButton == nullptr || !CpButton->IsInside(CvectorMouse) || !IsButtonShown(CsceneItem.handleButton))
+            continue;
+
+        CpButtonHovered = CpButton;
+        sprite = CsceneItem.sprite;
+        spriteHover = CsceneItem.spriteHover;
+    }
+    if (CpButtonHovered == nullptr) return SDL_Rect{0, 0, 0, 0};
+
+    // Both looks are drawn from the top left corner of the button, and may be larger than it
+    const SDL_Rect& CsdlRectSprite{_pAtlasUI->GetRect(sprite)};
+    const SDL_Rect& CsdlRectSpriteHover{_pAtlasUI->GetRect(spriteHover)};
+    const Vector3& CvectorTopLeft{CpButtonHovered->GetTopLeft()};
+    const Vector3& CvectorBottomRight{CpButtonHovered->GetBottomRight()};
+
+    return SDL_Rect{static_cast<Sint16>(CvectorTopLeft.fX), static_cast<Sint16>(CvectorTopLeft.fY),
+        std::max({static_cast<Uint16>(CvectorBottomRight.fX - CvectorTopLeft.fX), CsdlRectSprite.w,
+            CsdlRectSpriteHover.w}),
+        std::max({static_cast<Uint16>(CvectorBottomRight.fY - CvectorTopLeft.fY), CsdlRectSprite.h,
+            CsdlRectSpriteHover.h})};
+}
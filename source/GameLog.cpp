@@ -0,0 +1,160 @@
+/*
+GameLog.cpp --- Append-only log of played games
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <fstream>
+#include <ios>
+
+#include "../include/GameLog.hpp"
+#include "../include/GameRecord.hpp"
+#include "../include/Grid.hpp"
+
+
+/**
+ * @brief Construct a new game log
+ *
+ * @param CsPath the path of the log file, new games are appended to it
+ */
+GameLog::GameLog(const std::string& CsPath) : _sLogPath{CsPath} {}
+
+
+/**
+ * @brief Reads the first game of a log file
+ *
+ * @param CsPath the path of the log file
+ * @return Game the game read, including all its moves
+ */
+GameLog::Game GameLog::Load(const std::string& CsPath)
+{
+    std::ifstream ifstreamLog{CsPath};
+    if (!ifstreamLog) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    Game game{};
+    bool bGameFound{false};
+    std::string sLine{};
+
+    while (std::getline(ifstreamLog, sLine))
+    {
+        std::istringstream issLine{sLine};
+        std::string sTag{};
+        issLine >> sTag;
+
+        if (sTag == "GAME")
+        {
+            if (bGameFound) break;  // Only the first game is read
+
+            std::string sBoard{}, sPlayer{};
+            uint32_t uiDifficulty{};
+            issLine >> game.uiSeed >> sBoard >> uiDifficulty >> sPlayer;
+
+            // The board is written with the same header as the text game records
+            std::string sHeader{sBoard + ':'};
+            GameRecordView gameRecordView{std::string_view(sHeader)};
+            game.uyWidth = gameRecordView.GetWidth();
+            game.uyHeight = gameRecordView.GetHeight();
+            game.uyCellsToWin = gameRecordView.GetCellsToWin();
+            game.uyAIDifficulty = static_cast<uint8_t>(uiDifficulty);
+            game.bSinglePlayer = (sPlayer == "AI");
+            bGameFound = true;
+        }
+        else if (sTag == "MOVE" && bGameFound)
+        {
+            uint32_t uiMark{}, uiColumn{};
+            std::string sPlayer{};
+            Move move{};
+
+            issLine >> move.uiTime >> uiMark >> sPlayer >> uiColumn;
+            if (!issLine || uiColumn == 0 || uiColumn > game.uyWidth)
+                throw std::ios_base::failure("Malformed move in " + CsPath + ": " + sLine);
+
+            move.ePlayerMark = static_cast<Grid::EPlayerMark>(uiMark);
+            move.bIsAI = (sPlayer == "AI");
+            move.uyColumn = static_cast<uint8_t>(uiColumn - 1);
+            game.vectorMoves.push_back(move);
+        }
+        else if (sTag == "END" && bGameFound) break;
+    }
+
+    if (!bGameFound) throw std::ios_base::failure("No game found in " + CsPath);
+
+    return game;
+}
+
+
+/**
+ * @brief Logs the start of a game
+ *
+ * @param Cgame the game that starts, its moves are ignored
+ */
+void GameLog::StartGame(const Game& Cgame) const
+{
+    std::ostringstream ossLine{};
+    ossLine << "GAME " << Cgame.uiSeed << ' ' << static_cast<uint32_t>(Cgame.uyWidth) << 'x' <<
+        static_cast<uint32_t>(Cgame.uyHeight) << 'x' << static_cast<uint32_t>(Cgame.uyCellsToWin) << ' ' <<
+        static_cast<uint32_t>(Cgame.uyAIDifficulty) << ' ' << (Cgame.bSinglePlayer ? "AI" : "Human");
+    Append(ossLine.str());
+}
+
+
+/**
+ * @brief Logs a move of the current game
+ *
+ * @param Cmove the move played
+ */
+void GameLog::RecordMove(const Move& Cmove) const
+{
+    std::ostringstream ossLine{};
+    ossLine << "MOVE " << Cmove.uiTime << ' ' << static_cast<uint32_t>(Cmove.ePlayerMark) << ' ' <<
+        (Cmove.bIsAI ? "AI" : "Human") << ' ' << static_cast<uint32_t>(Cmove.uyColumn) + 1;
+    Append(ossLine.str());
+}
+
+
+/**
+ * @brief Logs the end of the current game
+ *
+ * @param CePlayerMarkWinner the mark of the player that won, or empty on a draw
+ * @param CgameRecord the record of the whole game
+ */
+void GameLog::EndGame(const Grid::EPlayerMark& CePlayerMarkWinner, const GameRecord& CgameRecord) const
+{
+    std::ostringstream ossLine{};
+    ossLine << "END " << static_cast<uint32_t>(CePlayerMarkWinner) << ' ' << CgameRecord.ToString();
+    Append(ossLine.str());
+}
+
+
+/**
+ * @brief Appends a line to the log file
+ *
+ * @param CsLine the line to append
+ */
+void GameLog::Append(const std::string& CsLine) const
+{
+    std::ofstream ofstreamLog{_sLogPath, std::ios_base::out | std::ios_base::app};
+
+    if (!ofstreamLog) throw std::ios_base::failure("Error opening file " + _sLogPath);
+
+    ofstreamLog << CsLine << std::endl;
+    ofstreamLog.close();
+}
@@ -0,0 +1,201 @@
+/*
+GameRecord.cpp --- Compact game records for ConnectX
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <stdexcept>
+#include <algorithm>
+
+#include "../include/GameRecord.hpp"
+#include "../include/Grid.hpp"
+
+
+/**
+ * @brief Parses a binary record at the start of a buffer
+ *
+ * @param CspanuyData the buffer holding the record, it may hold more records after this one
+ */
+GameRecordView::GameRecordView(std::span<const uint8_t> CspanuyData) : _puyMoves{nullptr}, _uSize{0},
+    _uyWidth{0}, _uyHeight{0}, _uyCellsToWin{0}, _uyMoveCount{0}, _bIsText{false}
+{
+    if (CspanuyData.size() < SCuyBinaryHeaderSize) throw std::length_error("Game record is truncated");
+
+    _uyWidth = CspanuyData[0] >> 4;
+    _uyHeight = CspanuyData[0] & 0x0F;
+    _uyCellsToWin = CspanuyData[1];
+    _uyMoveCount = CspanuyData[2];
+    _uSize = SCuyBinaryHeaderSize + ((_uyMoveCount + 1) >> 1);
+
+    if (_uyWidth == 0 || _uyHeight == 0 || _uyCellsToWin == 0 ||
+        _uyCellsToWin > std::max(_uyWidth, _uyHeight) || _uyMoveCount > _uyWidth * _uyHeight)
+        throw std::invalid_argument("Game record header is not valid");
+    if (CspanuyData.size() < _uSize) throw std::length_error("Game record is truncated");
+
+    _puyMoves = CspanuyData.data() + SCuyBinaryHeaderSize;
+
+    // Every move is a column of the grid, otherwise replaying the record would write outside it
+    for (uint8_t i = 0; i < _uyMoveCount; ++i)
+        if (GetMove(i) >= _uyWidth) throw std::invalid_argument("Game record move is not valid");
+}
+
+
+/**
+ * @brief Parses a text record
+ *
+ * @param CsvText the text holding the record
+ */
+GameRecordView::GameRecordView(std::string_view CsvText) : _puyMoves{nullptr}, _uSize{0}, _uyWidth{0},
+    _uyHeight{0}, _uyCellsToWin{0}, _uyMoveCount{0}, _bIsText{true}
+{
+    // The header is always "WxHxK:" as every dimension is a single digit
+    if (CsvText.size() < 6 || CsvText[1] != 'x' || CsvText[3] != 'x' || CsvText[5] != ':' ||
+        CsvText[0] < '1' || CsvText[0] > '9' || CsvText[2] < '1' || CsvText[2] > '9' ||
+        CsvText[4] < '1' || CsvText[4] > '9')
+        throw std::invalid_argument("Game record header is not valid");
+
+    _uyWidth = CsvText[0] - '0';
+    _uyHeight = CsvText[2] - '0';
+    _uyCellsToWin = CsvText[4] - '0';
+    if (_uyCellsToWin > std::max(_uyWidth, _uyHeight))
+        throw std::invalid_argument("Game record header is not valid");
+
+    // Moves run until the end of the text and each one must be a 1-based column of the grid
+    std::size_t uMoveCount{CsvText.size() - 6};
+    for (std::size_t i = 6; i < CsvText.size(); ++i)
+    {
+        if (CsvText[i] < '1' || CsvText[i] - '1' >= _uyWidth)
+            throw std::invalid_argument("Game record move is not valid");
+    }
+    if (uMoveCount > static_cast<std::size_t>(_uyWidth * _uyHeight))
+        throw std::invalid_argument("Game record has too many moves");
+
+    _uyMoveCount = static_cast<uint8_t>(uMoveCount);
+    _uSize = 6 + uMoveCount;
+    _puyMoves = reinterpret_cast<const uint8_t*>(CsvText.data()) + 6;
+}
+
+
+/**
+ * @brief Builds the grid that results from playing every move of the record
+ *
+ * @return Grid the final position of the record
+ */
+Grid GameRecordView::ToGrid() const
+{
+    Grid grid(_uyWidth, _uyHeight, _uyCellsToWin);
+
+    for (uint8_t i = 0; i < _uyMoveCount; ++i)
+        grid.MakeMove(i & 1 ? Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1, GetMove(i));
+
+    return grid;
+}
+
+
+/**
+ * @brief Construct a new empty record
+ *
+ * @param uyWidth the width of the grid
+ * @param uyHeight the height of the grid
+ * @param uyCellsToWin the number of cells in a row required to win
+ */
+GameRecord::GameRecord(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin) : _uyWidth{uyWidth},
+    _uyHeight{uyHeight}, _uyCellsToWin{uyCellsToWin}, _vectoruyMoves{}
+{
+    if (_uyWidth == 0 || _uyWidth > 9 || _uyHeight == 0 || _uyHeight > 9 || _uyCellsToWin == 0 ||
+        _uyCellsToWin > std::max(_uyWidth, _uyHeight))
+        throw std::length_error("Grid dimensions cannot be recorded");
+
+    _vectoruyMoves.reserve(_uyWidth * _uyHeight);
+}
+
+
+/**
+ * @brief Construct a new record from a parsed one
+ *
+ * @param CgameRecordView the parsed record to copy
+ */
+GameRecord::GameRecord(const GameRecordView& CgameRecordView) : GameRecord(CgameRecordView.GetWidth(),
+    CgameRecordView.GetHeight(), CgameRecordView.GetCellsToWin())
+{
+    for (uint8_t i = 0; i < CgameRecordView.GetMoveCount(); ++i)
+        _vectoruyMoves.push_back(CgameRecordView.GetMove(i));
+}
+
+
+/**
+ * @brief Appends a move to the record
+ *
+ * @param uyColumn the 0-based column of the move
+ */
+void GameRecord::AddMove(uint8_t uyColumn)
+{
+    if (uyColumn >= _uyWidth) throw std::domain_error("Play is not valid");
+    if (_vectoruyMoves.size() >= static_cast<std::size_t>(_uyWidth * _uyHeight))
+        throw std::length_error("Game record is full");
+
+    _vectoruyMoves.push_back(uyColumn);
+}
+
+
+/**
+ * @brief Writes the binary encoding of this record
+ *
+ * @param spanuyBuffer the buffer where the record will be written
+ * @return std::size_t the number of bytes written
+ */
+std::size_t GameRecord::Serialise(std::span<uint8_t> spanuyBuffer) const
+{
+    std::size_t uSize{GetBinarySize()};
+    if (spanuyBuffer.size() < uSize) throw std::length_error("Buffer is too small for the game record");
+
+    spanuyBuffer[0] = (_uyWidth << 4) | _uyHeight;
+    spanuyBuffer[1] = _uyCellsToWin;
+    spanuyBuffer[2] = static_cast<uint8_t>(_vectoruyMoves.size());
+
+    uint8_t* puyMoves{spanuyBuffer.data() + GameRecordView::SCuyBinaryHeaderSize};
+    for (std::size_t i = 0; i < _vectoruyMoves.size(); i += 2)
+    {
+        uint8_t uyLow = (i + 1 < _vectoruyMoves.size() ? _vectoruyMoves[i + 1] : 0);
+        puyMoves[i >> 1] = (_vectoruyMoves[i] << 4) | uyLow;
+    }
+
+    return uSize;
+}
+
+
+/**
+ * @brief Gets the text encoding of this record
+ *
+ * @return std::string the move string of the record
+ */
+std::string GameRecord::ToString() const
+{
+    std::string sText{static_cast<char>('0' + _uyWidth), 'x', static_cast<char>('0' + _uyHeight), 'x',
+        static_cast<char>('0' + _uyCellsToWin), ':'};
+
+    sText.reserve(sText.size() + _vectoruyMoves.size());
+    for (uint8_t uyColumn : _vectoruyMoves) sText.push_back(static_cast<char>('1' + uyColumn));
+
+    return sText;
+}
@@ -23,24 +23,56 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "../include/Globals.hpp"
 
 
+#ifndef APP_ROOT_PATH
+    #define APP_ROOT_PATH "/apps/ConnectXWii/"  // Where the Homebrew Channel installs the application
+#endif
+
+
 /** Default path for storing the application's settings */
-const std::string Globals::SCsSettingsDefaultPath{std::filesystem::path("/apps/ConnectXWii/settings.json")
+const std::string Globals::SCsSettingsDefaultPath{std::filesystem::path(APP_ROOT_PATH "settings.json")
     .lexically_normal().string()};
 
 /** Default path for storing the application's log */
-const std::string Globals::SCsLogDefaultPath{std::filesystem::path("/apps/ConnectXWii/log.txt")
+const std::string Globals::SCsLogDefaultPath{std::filesystem::path(APP_ROOT_PATH "log.txt")
     .lexically_normal().string()};
 
 /**< Default path for storing the application's graphics */
-const std::string Globals::SCsGraphicsDefaultPath{std::filesystem::path("/apps/ConnectXWii/gfx/")
+const std::string Globals::SCsGraphicsDefaultPath{std::filesystem::path(APP_ROOT_PATH "gfx/")
+    .lexically_normal().string()};
+
+const std::string Globals::SCsAudioDefaultPath{std::filesystem::path(APP_ROOT_PATH "audio/")
+    .lexically_normal().string()};
+
+const std::string Globals::SCsFontsDefaultPath{std::filesystem::path(APP_ROOT_PATH "fonts/")
+    .lexically_normal().string()};
+
+/** Default path for storing the log of played games */
+const std::string Globals::SCsGameLogDefaultPath{std::filesystem::path(APP_ROOT_PATH "games.log")
     .lexically_normal().string()};
 
-const std::string Globals::SCsAudioDefaultPath{std::filesystem::path("/apps/ConnectXWii/audio/")
+/** Default path for storing the tablebases */
+const std::string Globals::SCsTablebasesDefaultPath{std::filesystem::path(APP_ROOT_PATH "tablebases/")
     .lexically_normal().string()};
 
-const std::string Globals::SCsFontsDefaultPath{std::filesystem::path("/apps/ConnectXWii/fonts/")
+/** Default path for storing the evaluation weights */
+const std::string Globals::SCsWeightsDefaultPath{std::filesystem::path(APP_ROOT_PATH "weights.bin")
+    .lexically_normal().string()};
+
+/** Default path for caching converted textures */
+const std::string Globals::SCsTextureCacheDefaultPath{std::filesystem::path(APP_ROOT_PATH "cache/")
+    .lexically_normal().string()};
+
+/** Default path for dumping the frame times */
+const std::string Globals::SCsProfileDefaultPath{std::filesystem::path(APP_ROOT_PATH "profile.csv")
+    .lexically_normal().string()};
+
+/** Default path for writing the event trace */
+const std::string Globals::SCsTraceDefaultPath{std::filesystem::path(APP_ROOT_PATH "trace.json")
     .lexically_normal().string()};
 
 /**< Default custom path for storing the application's graphics */
-const std::string Globals::SCsGraphicsCustomPath{std::filesystem::path("/apps/ConnectXWii/gfx/custom/")
+const std::string Globals::SCsGraphicsCustomPath{std::filesystem::path(APP_ROOT_PATH "gfx/custom/")
     .lexically_normal().string()};
+
+/** Default game log to play back, empty to disable */
+const std::string Globals::SCsPlaybackDefaultPath{};
@@ -26,6 +26,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <sstream>
 
 #include "../include/Grid.hpp"
+#include "../include/GridListener.hpp"
 
 
 /**
@@ -41,13 +42,92 @@ Grid::Grid(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin) : _uyWidth{u
     std::vector<EPlayerMark>(_uyWidth, EMPTY))}, 
     _ayNextCell{std::vector<int8_t>(_uyWidth, _uyHeight - 1)}, 
     _uyEmptyCells{static_cast<uint8_t>(_uyWidth * _uyHeight)}, _ePlayerMarkWinner{EPlayerMark::EMPTY},
-    _pairWinCell{}, _pairWinDirection{}
+    _pairWinCell{}, _pairWinDirection{}, _pGridListener{nullptr}
 { 
     if (_uyCellsToWin > _uyWidth && _uyCellsToWin > _uyHeight) 
         throw std::length_error("Number of cells to win is too big"); 
 }
 
 
+/**
+ * @brief Copy constructor, the copy has no listener
+ *
+ * @param CgridOther the grid to be copied
+ */
+Grid::Grid(const Grid& CgridOther) : _uyWidth{CgridOther._uyWidth}, _uyHeight{CgridOther._uyHeight},
+    _uyCellsToWin{CgridOther._uyCellsToWin}, _vector2playerMarkCells{CgridOther._vector2playerMarkCells},
+    _ayNextCell{CgridOther._ayNextCell}, _uyEmptyCells{CgridOther._uyEmptyCells},
+    _ePlayerMarkWinner{CgridOther._ePlayerMarkWinner}, _pairWinCell{CgridOther._pairWinCell},
+    _pairWinDirection{CgridOther._pairWinDirection}, _pGridListener{nullptr}
+{}
+
+
+/**
+ * @brief Move constructor, the new grid has no listener
+ *
+ * @param gridOther the grid to be moved
+ */
+Grid::Grid(Grid&& gridOther) noexcept : _uyWidth{gridOther._uyWidth}, _uyHeight{gridOther._uyHeight},
+    _uyCellsToWin{gridOther._uyCellsToWin},
+    _vector2playerMarkCells{std::move(gridOther._vector2playerMarkCells)},
+    _ayNextCell{std::move(gridOther._ayNextCell)}, _uyEmptyCells{gridOther._uyEmptyCells},
+    _ePlayerMarkWinner{gridOther._ePlayerMarkWinner}, _pairWinCell{gridOther._pairWinCell},
+    _pairWinDirection{gridOther._pairWinDirection}, _pGridListener{nullptr}
+{}
+
+
+/**
+ * @brief Copy assignment operator, the listener is kept and told about the new contents
+ *
+ * @param CgridOther the grid to be copied
+ * @return Grid& this grid
+ */
+Grid& Grid::operator =(const Grid& CgridOther)
+{
+    if (this != &CgridOther)
+    {
+        _uyWidth = CgridOther._uyWidth;
+        _uyHeight = CgridOther._uyHeight;
+        _uyCellsToWin = CgridOther._uyCellsToWin;
+        _vector2playerMarkCells = CgridOther._vector2playerMarkCells;
+        _ayNextCell = CgridOther._ayNextCell;
+        _uyEmptyCells = CgridOther._uyEmptyCells;
+        _ePlayerMarkWinner = CgridOther._ePlayerMarkWinner;
+        _pairWinCell = CgridOther._pairWinCell;
+        _pairWinDirection = CgridOther._pairWinDirection;
+
+        if (_pGridListener != nullptr) _pGridListener->OnReset(*this);
+    }
+    return *this;
+}
+
+
+/**
+ * @brief Move assignment operator, the listener is kept and told about the new contents
+ *
+ * @param gridOther the grid to be moved
+ * @return Grid& this grid
+ */
+Grid& Grid::operator =(Grid&& gridOther) noexcept
+{
+    if (this != &gridOther)
+    {
+        _uyWidth = gridOther._uyWidth;
+        _uyHeight = gridOther._uyHeight;
+        _uyCellsToWin = gridOther._uyCellsToWin;
+        _vector2playerMarkCells = std::move(gridOther._vector2playerMarkCells);
+        _ayNextCell = std::move(gridOther._ayNextCell);
+        _uyEmptyCells = gridOther._uyEmptyCells;
+        _ePlayerMarkWinner = gridOther._ePlayerMarkWinner;
+        _pairWinCell = gridOther._pairWinCell;
+        _pairWinDirection = gridOther._pairWinDirection;
+
+        if (_pGridListener != nullptr) _pGridListener->OnReset(*this);
+    }
+    return *this;
+}
+
+
 /**
  * @brief Makes a play in the grid
  *
@@ -58,11 +138,14 @@ void Grid::MakeMove(const EPlayerMark& CePlayerMark, uint8_t uyPlayColumn)
 {
     if (!IsValidMove(uyPlayColumn)) throw std::domain_error("Play is not valid");
 
-    _vector2playerMarkCells[_ayNextCell[uyPlayColumn]][uyPlayColumn] = CePlayerMark;
+    uint8_t uyPlayRow = _ayNextCell[uyPlayColumn];
+    _vector2playerMarkCells[uyPlayRow][uyPlayColumn] = CePlayerMark;
     --_ayNextCell[uyPlayColumn];
     --_uyEmptyCells;
 
     if (IsWinnerMove(CePlayerMark, uyPlayColumn)) _ePlayerMarkWinner = CePlayerMark;
+
+    if (_pGridListener != nullptr) _pGridListener->OnMove(*this, uyPlayRow, uyPlayColumn);
 }
 
 
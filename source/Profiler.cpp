@@ -0,0 +1,242 @@
+/*
+Profiler.cpp --- Per-frame timing of the main loop
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <ios>
+
+#include "../include/Profiler.hpp"
+
+
+/**
+ * @brief Starts timing a section
+ *
+ * @param profiler the profiler of the frame
+ * @param eSection the section
+ */
+Profiler::ScopedTimer::ScopedTimer(Profiler& profiler, ESection eSection) noexcept : _profiler{profiler},
+    _eSection{eSection}, _timeStart{}
+{
+    if (_profiler._bEnabled) _timeStart = std::chrono::steady_clock::now();
+}
+
+
+/**
+ * @brief Destructor, adds the elapsed time
+ */
+Profiler::ScopedTimer::~ScopedTimer() noexcept
+{
+    if (_profiler._bEnabled)
+    {
+        _profiler.Add(_eSection, static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - _timeStart).count()));
+    }
+}
+
+
+/**
+ * @brief Default constructor
+ */
+Profiler::Profiler() noexcept : _bEnabled{false}, _aframes{}, _urNext{0}, _urCount{0}, _frameCurrent{},
+    _timeFrameStart{}
+{}
+
+
+/**
+ * @brief Gets the name of a section, as written in the dumps
+ *
+ * @param eSection the section
+ * @return const char* the name
+ */
+const char* Profiler::GetSectionName(ESection eSection) noexcept
+{
+    switch (eSection)
+    {
+    case ESection::SECTION_EVENTS:          return "Events";
+    case ESection::SECTION_LOOP:            return "OnLoop";
+    case ESection::SECTION_RENDER_START:    return "RenderStart";
+    case ESection::SECTION_RENDER_SETTINGS: return "RenderSettings";
+    case ESection::SECTION_RENDER_LOADING:  return "RenderLoading";
+    case ESection::SECTION_RENDER_INGAME:   return "RenderInGame";
+    case ESection::SECTION_RENDER_PROMPT:   return "RenderPrompt";
+    case ESection::SECTION_RENDER_END:      return "RenderEnd";
+    case ESection::SECTION_GRID:            return "RenderGrid";
+    case ESection::SECTION_PRESENT:         return "Present";
+    default:                                return "Unknown";
+    }
+}
+
+
+/**
+ * @brief Starts timing a frame
+ */
+void Profiler::BeginFrame() noexcept
+{
+    if (!_bEnabled) return;
+
+    _frameCurrent = Frame{};
+    _timeFrameStart = std::chrono::steady_clock::now();
+}
+
+
+/**
+ * @brief Stops timing the current frame and stores it in the ring buffer
+ */
+void Profiler::EndFrame() noexcept
+{
+    if (!_bEnabled) return;
+
+    _frameCurrent.uiTotal = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _timeFrameStart).count());
+
+    _aframes[_urNext] = _frameCurrent;
+    _urNext = (_urNext + 1) % SCurFrames;
+    if (_urCount < SCurFrames) ++_urCount;
+}
+
+
+/**
+ * @brief Adds time to a section of the current frame
+ *
+ * @param eSection the section
+ * @param uiMicroseconds the time to add
+ */
+void Profiler::Add(ESection eSection, uint32_t uiMicroseconds) noexcept
+{
+    _frameCurrent.auiSections[eSection] += uiMicroseconds;
+}
+
+
+/**
+ * @brief Gets the time of a stored frame
+ *
+ * @param urAge 0 for the last frame, 1 for the one before and so on, it must be below GetFrameCount
+ * @return uint32_t the time from BeginFrame to EndFrame, in microseconds
+ */
+uint32_t Profiler::GetFrameTime(uint16_t urAge) const noexcept
+{
+    return _aframes[(_urNext + SCurFrames - 1 - urAge) % SCurFrames].uiTotal;
+}
+
+
+/**
+ * @brief Summarises the time of whole frames
+ *
+ * @return Stats the summary over the stored frames
+ */
+Profiler::Stats Profiler::GetFrameStats() const { return GetStats(-1); }
+
+
+/**
+ * @brief Summarises the time of a section
+ *
+ * @param eSection the section
+ * @return Stats the summary over the stored frames
+ */
+Profiler::Stats Profiler::GetSectionStats(ESection eSection) const { return GetStats(eSection); }
+
+
+/**
+ * @brief Writes the stored frames and their summary as CSV
+ *
+ * @param CsPath the path of the file, which is overwritten
+ */
+void Profiler::Dump(const std::string& CsPath) const
+{
+    std::ofstream ofstreamDump{CsPath, std::ios_base::out | std::ios_base::trunc};
+    if (!ofstreamDump) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    // One row per section with its summary in milliseconds
+    ofstreamDump << "section,min_ms,avg_ms,p99_ms\n";
+    Stats stats{GetFrameStats()};
+    ofstreamDump << "Frame," << stats.fMin << ',' << stats.fAverage << ',' << stats.fP99 << '\n';
+    for (int32_t i = 0; i < ESection::SECTION_COUNT; ++i)
+    {
+        stats = GetSectionStats(static_cast<ESection>(i));
+        ofstreamDump << GetSectionName(static_cast<ESection>(i)) << ',' << stats.fMin << ',' <<
+            stats.fAverage << ',' << stats.fP99 << '\n';
+    }
+
+    // Then every frame from the oldest, in microseconds
+    ofstreamDump << "\nframe,total_us";
+    for (int32_t i = 0; i < ESection::SECTION_COUNT; ++i)
+        ofstreamDump << ',' << GetSectionName(static_cast<ESection>(i)) << "_us";
+    ofstreamDump << '\n';
+
+    for (uint16_t i = 0; i < _urCount; ++i)
+    {
+        const Frame& Cframe{_aframes[(_urNext + SCurFrames - _urCount + i) % SCurFrames]};
+        ofstreamDump << i << ',' << Cframe.uiTotal;
+        for (uint32_t uiSection : Cframe.auiSections) ofstreamDump << ',' << uiSection;
+        ofstreamDump << '\n';
+    }
+
+    if (!ofstreamDump) throw std::ios_base::failure("Error writing file " + CsPath);
+}
+
+
+/**
+ * @brief Summarises one time of every stored frame
+ *
+ * @param iSection the section, or -1 for the whole frame
+ * @return Stats the summary
+ */
+Profiler::Stats Profiler::GetStats(int32_t iSection) const
+{
+    if (_urCount == 0) return Stats{0.0f, 0.0f, 0.0f};
+
+    std::vector<uint32_t> vectoruiTimes{};
+    vectoruiTimes.reserve(_urCount);
+    for (uint16_t i = 0; i < _urCount; ++i)
+    {
+        const Frame& Cframe{_aframes[(_urNext + SCurFrames - 1 - i) % SCurFrames]};
+        vectoruiTimes.push_back(iSection < 0 ? Cframe.uiTotal : Cframe.auiSections[iSection]);
+    }
+
+    return Summarise(vectoruiTimes);
+}
+
+
+/**
+ * @brief Summarises any number of times, for runs longer than the ring buffer
+ *
+ * @param vectoruiTimes the times, in microseconds, which are reordered
+ * @return Stats the summary
+ */
+Profiler::Stats Profiler::Summarise(std::vector<uint32_t>& vectoruiTimes)
+{
+    if (vectoruiTimes.empty()) return Stats{0.0f, 0.0f, 0.0f};
+
+    uint64_t uSum{0};
+    for (uint32_t uiTime : vectoruiTimes) uSum += uiTime;
+
+    // The 99th percentile is the smallest time that at least 99% of the frames do not exceed
+    std::size_t uP99{(vectoruiTimes.size() * 99 + 99) / 100 - 1};
+    std::nth_element(vectoruiTimes.begin(), vectoruiTimes.begin() + uP99, vectoruiTimes.end());
+    uint32_t uiP99{vectoruiTimes[uP99]};
+
+    return Stats{*std::min_element(vectoruiTimes.begin(), vectoruiTimes.end()) / 1000.0f,
+        static_cast<float>(uSum) / vectoruiTimes.size() / 1000.0f, uiP99 / 1000.0f};
+}
@@ -32,9 +32,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
  * @brief Creates an object with the default settings
  */
 Settings::Settings(uint8_t uyBoardWidth, uint8_t uyBoardHeight, uint8_t uyCellsToWin,
-	uint8_t uyAIDifficulty, const std::string& sCustomPath, bool bIsDev) noexcept : 
-	_uyBoardWidth{uyBoardWidth}, _uyBoardHeight{uyBoardHeight}, _uyCellsToWin{uyCellsToWin},
-	_uyAIDifficulty{uyAIDifficulty}, _sCustomPath{sCustomPath}, _bIsDev{bIsDev} {}
+	uint8_t uyAIDifficulty, const std::string& sCustomPath, bool bIsDev, 
+	const std::string& sPlaybackPath) noexcept : _uyBoardWidth{uyBoardWidth}, 
+	_uyBoardHeight{uyBoardHeight}, _uyCellsToWin{uyCellsToWin}, _uyAIDifficulty{uyAIDifficulty}, 
+	_sCustomPath{sCustomPath}, _bIsDev{bIsDev}, _sPlaybackPath{sPlaybackPath} {}
 
 
 /**
@@ -45,7 +46,7 @@ Settings::Settings(uint8_t uyBoardWidth, uint8_t uyBoardHeight, uint8_t uyCellsT
 Settings::Settings(const std::string& CsFilePath) : _uyBoardWidth{Globals::SCuyBoardWidthDefault}, 
 	_uyBoardHeight{Globals::SCuyBoardHeightDefault}, _uyCellsToWin{Globals::SCuyCellsToWinDefault}, 
 	_uyAIDifficulty{Globals::SCuyAIDifficultyDefault}, _sCustomPath{Globals::SCsGraphicsCustomPath}, 
-	_bIsDev{Globals::SCbIsDev}
+	_bIsDev{Globals::SCbIsDev}, _sPlaybackPath{Globals::SCsPlaybackDefaultPath}
 {
     json_t* pJsonRoot{nullptr};			// Root object of the JSON file
     json_error_t jsonError{};			// Error handler
@@ -87,6 +88,8 @@ Settings::Settings(const std::string& CsFilePath) : _uyBoardWidth{Globals::SCuyB
 	if (json_is_string(pJsonField)) _sCustomPath = json_string_value(pJsonField);
 	pJsonField = json_object_get(pJsonSettings, "Enable dev tools");
 	if (json_is_boolean(pJsonField)) _bIsDev = json_boolean_value(pJsonField);
+	pJsonField = json_object_get(pJsonSettings, "Playback file");
+	if (json_is_string(pJsonField)) _sPlaybackPath = json_string_value(pJsonField);
 
 	/* Validation */
 	if (_uyBoardWidth < Globals::SCuyBoardWidthMin) _uyBoardWidth = Globals::SCuyBoardWidthMin;
@@ -124,6 +127,7 @@ void Settings::Dump(const std::string& CsPath) const
     json_object_set_new(pJsonSettings, "AI Difficulty", json_integer(_uyAIDifficulty));
 	json_object_set_new(pJsonSettings, "Custom path for sprites", json_string(_sCustomPath.c_str()));
 	json_object_set_new(pJsonSettings, "Enable dev tools", json_boolean(_bIsDev));
+	json_object_set_new(pJsonSettings, "Playback file", json_string(_sPlaybackPath.c_str()));
 
 	// Attach the settings to the root
     json_object_set_new(pJsonRoot, "Settings", pJsonSettings);
@@ -0,0 +1,343 @@
+/*
+Tablebase.cpp --- Solved positions for small boards
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <algorithm>
+
+#include <zlib.h>
+
+#ifndef __wii__
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include "../include/Tablebase.hpp"
+#include "../include/Grid.hpp"
+
+
+namespace
+{
+    /* The file is little-endian on every platform */
+
+    uint32_t ReadUInt32(const uint8_t* CpuyData) noexcept
+    {
+        return static_cast<uint32_t>(CpuyData[0]) | (static_cast<uint32_t>(CpuyData[1]) << 8) |
+            (static_cast<uint32_t>(CpuyData[2]) << 16) | (static_cast<uint32_t>(CpuyData[3]) << 24);
+    }
+
+    uint64_t ReadUInt64(const uint8_t* CpuyData) noexcept
+    {
+        return static_cast<uint64_t>(ReadUInt32(CpuyData)) | 
+            (static_cast<uint64_t>(ReadUInt32(CpuyData + 4)) << 32);
+    }
+
+    void WriteUInt32(std::vector<uint8_t>& vectoruyData, uint32_t uiValue)
+    { for (uint8_t i = 0; i < 4; ++i) vectoruyData.push_back(static_cast<uint8_t>(uiValue >> (i << 3))); }
+
+    void WriteUInt64(std::vector<uint8_t>& vectoruyData, uint64_t uValue)
+    { for (uint8_t i = 0; i < 8; ++i) vectoruyData.push_back(static_cast<uint8_t>(uValue >> (i << 3))); }
+}
+
+
+/**
+ * @brief Opens a tablebase file
+ *
+ * @param CsPath the path of the tablebase file
+ */
+Tablebase::Tablebase(const std::string& CsPath) : _uyWidth{0}, _uyHeight{0}, _uyCellsToWin{0},
+    _uEntryCount{0}, _vectoruiBlockOffsets{},
+#ifdef __wii__
+    _pFile{nullptr},
+#else
+    _puyMapping{nullptr}, _uMappingSize{0},
+#endif
+    _vectoruyBlock(SCuiBlockEntries), _lBlockCached{-1}
+{
+    uint8_t auyHeader[SCuyHeaderSize]{};
+
+#ifdef __wii__
+    if ((_pFile = std::fopen(CsPath.c_str(), "rb")) == nullptr)
+        throw std::ios_base::failure("Error opening file " + CsPath);
+
+    if (std::fread(auyHeader, 1, SCuyHeaderSize, _pFile) != SCuyHeaderSize)
+    {
+        std::fclose(_pFile);
+        throw std::ios_base::failure("Tablebase file is truncated");
+    }
+#else
+    int32_t iFile{open(CsPath.c_str(), O_RDONLY)};
+    if (iFile == -1) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    struct stat statFile{};
+    if (fstat(iFile, &statFile) == -1 || statFile.st_size < SCuyHeaderSize)
+    {
+        close(iFile);
+        throw std::ios_base::failure("Tablebase file is truncated");
+    }
+
+    _uMappingSize = static_cast<std::size_t>(statFile.st_size);
+    void* pMapping{mmap(nullptr, _uMappingSize, PROT_READ, MAP_PRIVATE, iFile, 0)};
+    close(iFile);   // The mapping keeps the file open
+    if (pMapping == MAP_FAILED) throw std::ios_base::failure("Error mapping file " + CsPath);
+
+    _puyMapping = static_cast<const uint8_t*>(pMapping);
+    std::memcpy(auyHeader, _puyMapping, SCuyHeaderSize);
+#endif
+
+    try
+    {
+        if (std::memcmp(auyHeader, "CXTB", 4) != 0 || auyHeader[4] != SCuyVersion)
+            throw std::ios_base::failure("Not a tablebase file: " + CsPath);
+
+        _uyWidth = auyHeader[5];
+        _uyHeight = auyHeader[6];
+        _uyCellsToWin = auyHeader[7];
+        _uEntryCount = ReadUInt64(auyHeader + 8);
+        uint32_t uiBlockCount{ReadUInt32(auyHeader + 20)};
+
+        if (ReadUInt32(auyHeader + 16) != SCuiBlockEntries ||
+            _uEntryCount != GetEntryCount(_uyWidth, _uyHeight) ||
+            uiBlockCount != (_uEntryCount + SCuiBlockEntries - 1) / SCuiBlockEntries)
+            throw std::ios_base::failure("Tablebase header is not valid: " + CsPath);
+
+        // Read the block index
+        std::vector<uint8_t> vectoruyOffsets((uiBlockCount + 1) << 2);
+#ifdef __wii__
+        if (std::fread(vectoruyOffsets.data(), 1, vectoruyOffsets.size(), _pFile) != vectoruyOffsets.size())
+            throw std::ios_base::failure("Tablebase file is truncated");
+#else
+        if (_uMappingSize < SCuyHeaderSize + vectoruyOffsets.size())
+            throw std::ios_base::failure("Tablebase file is truncated");
+        std::memcpy(vectoruyOffsets.data(), _puyMapping + SCuyHeaderSize, vectoruyOffsets.size());
+#endif
+
+        // Blocks follow the index in order, so a block never has a negative size when it is probed
+        uint32_t uiOffsetMin{static_cast<uint32_t>(SCuyHeaderSize + vectoruyOffsets.size())};
+        _vectoruiBlockOffsets.reserve(uiBlockCount + 1);
+        for (uint32_t i = 0; i <= uiBlockCount; ++i)
+        {
+            uint32_t uiOffset{ReadUInt32(vectoruyOffsets.data() + (i << 2))};
+            if (uiOffset < uiOffsetMin)
+                throw std::ios_base::failure("Tablebase block index is not valid: " + CsPath);
+
+            _vectoruiBlockOffsets.push_back(uiOffset);
+            uiOffsetMin = uiOffset;
+        }
+
+#ifdef __wii__
+        long lFileSize{std::fseek(_pFile, 0, SEEK_END) == 0 ? std::ftell(_pFile) : -1};
+        if (lFileSize < 0 || static_cast<unsigned long>(lFileSize) < _vectoruiBlockOffsets.back())
+            throw std::ios_base::failure("Tablebase file is truncated");
+#else
+        if (_vectoruiBlockOffsets.back() > _uMappingSize) 
+            throw std::ios_base::failure("Tablebase file is truncated");
+#endif
+    }
+    catch (...)
+    {
+#ifdef __wii__
+        std::fclose(_pFile);
+#else
+        munmap(const_cast<uint8_t*>(_puyMapping), _uMappingSize);
+#endif
+        throw;
+    }
+}
+
+
+/**
+ * @brief Destructor
+ */
+Tablebase::~Tablebase() noexcept
+{
+#ifdef __wii__
+    if (_pFile) std::fclose(_pFile);
+#else
+    if (_puyMapping) munmap(const_cast<uint8_t*>(_puyMapping), _uMappingSize);
+#endif
+}
+
+
+/**
+ * @brief Gets the entry of a position
+ *
+ * @param Cgrid the position to look up, it must match the configuration of the table
+ * @return uint8_t the entry of the position, or 0 if it is not in the table
+ */
+uint8_t Tablebase::Probe(const Grid& Cgrid) const
+{
+    if (Cgrid.GetWidth() != _uyWidth || Cgrid.GetHeight() != _uyHeight ||
+        Cgrid.GetCellsToWin() != _uyCellsToWin) return 0;
+
+    uint64_t uIndex{GetIndex(Cgrid)};
+    int64_t lBlock{static_cast<int64_t>(uIndex / SCuiBlockEntries)};
+
+    if (lBlock != _lBlockCached)
+    {
+        uint32_t uiOffset{_vectoruiBlockOffsets[lBlock]};
+        uLongf ulBlockSize{SCuiBlockEntries};
+        uLong ulCompressedSize{_vectoruiBlockOffsets[lBlock + 1] - uiOffset};
+
+#ifdef __wii__
+        std::vector<uint8_t> vectoruyCompressed(ulCompressedSize);
+        if (std::fseek(_pFile, uiOffset, SEEK_SET) != 0 ||
+            std::fread(vectoruyCompressed.data(), 1, ulCompressedSize, _pFile) != ulCompressedSize)
+            throw std::ios_base::failure("Error reading tablebase block");
+        const uint8_t* CpuyCompressed{vectoruyCompressed.data()};
+#else
+        const uint8_t* CpuyCompressed{_puyMapping + uiOffset};
+#endif
+
+        _lBlockCached = -1;
+        if (uncompress(_vectoruyBlock.data(), &ulBlockSize, CpuyCompressed, ulCompressedSize) != Z_OK)
+            throw std::ios_base::failure("Corrupted tablebase block");
+        _lBlockCached = lBlock;
+    }
+
+    return _vectoruyBlock[uIndex % SCuiBlockEntries];
+}
+
+
+/**
+ * @brief Gets the index of a position inside the table. Every column is coded as a 1 followed by
+ * one bit per marker, from the bottom up, and the columns are combined as digits of a mixed radix number
+ *
+ * @param Cgrid the position
+ * @return uint64_t the index of the position
+ */
+uint64_t Tablebase::GetIndex(const Grid& Cgrid) noexcept
+{
+    const uint64_t CuBase{(1ull << (Cgrid.GetHeight() + 1)) - 1};
+    uint64_t uIndex{0};
+
+    for (int8_t i = Cgrid.GetWidth() - 1; i >= 0; --i)
+    {
+        uint8_t uyMarkers{static_cast<uint8_t>(Cgrid.GetHeight() - 1 - Cgrid.GetNextCell(i))};
+        uint32_t uiCode{1u << uyMarkers};
+
+        for (uint8_t j = 0; j < uyMarkers; ++j)
+            if (Cgrid[Cgrid.GetHeight() - 1 - j][i] == Grid::EPlayerMark::PLAYER2) uiCode |= 1u << j;
+
+        uIndex = uIndex * CuBase + (uiCode - 1);
+    }
+
+    return uIndex;
+}
+
+
+/**
+ * @brief Gets the number of entries of a table
+ *
+ * @param uyWidth the width of the grid
+ * @param uyHeight the height of the grid
+ * @return uint64_t the number of entries, or 0 if the table would be bigger than SCuMaxEntries
+ */
+uint64_t Tablebase::GetEntryCount(uint8_t uyWidth, uint8_t uyHeight) noexcept
+{
+    const uint64_t CuBase{(1ull << (uyHeight + 1)) - 1};
+    uint64_t uEntryCount{1};
+
+    for (uint8_t i = 0; i < uyWidth; ++i)
+        if ((uEntryCount *= CuBase) > SCuMaxEntries) return 0;
+
+    return uEntryCount;
+}
+
+
+/**
+ * @brief Gets the name of the file of a table
+ *
+ * @param uyWidth the width of the grid
+ * @param uyHeight the height of the grid
+ * @param uyCellsToWin the number of cells in a row required to win
+ * @return std::string the file name, without directory
+ */
+std::string Tablebase::GetFileName(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin)
+{
+    std::ostringstream ossName{"tb_", std::ios_base::ate};
+    ossName << static_cast<uint32_t>(uyWidth) << 'x' << static_cast<uint32_t>(uyHeight) << 'x' <<
+        static_cast<uint32_t>(uyCellsToWin) << ".bin";
+    return ossName.str();
+}
+
+
+/**
+ * @brief Compresses and writes a table to a file
+ *
+ * @param CsPath the path of the tablebase file
+ * @param uyWidth the width of the grid
+ * @param uyHeight the height of the grid
+ * @param uyCellsToWin the number of cells in a row required to win
+ * @param CvectoruyEntries the entries of every position, indexed as GetIndex
+ */
+void Tablebase::Write(const std::string& CsPath, uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin,
+    const std::vector<uint8_t>& CvectoruyEntries)
+{
+    uint64_t uEntryCount{GetEntryCount(uyWidth, uyHeight)};
+    if (uEntryCount == 0 || CvectoruyEntries.size() != uEntryCount)
+        throw std::length_error("Tablebase size does not match the board");
+
+    uint32_t uiBlockCount{static_cast<uint32_t>((uEntryCount + SCuiBlockEntries - 1) / SCuiBlockEntries)};
+
+    std::vector<uint8_t> vectoruyHeader{'C', 'X', 'T', 'B', SCuyVersion, uyWidth, uyHeight, uyCellsToWin};
+    WriteUInt64(vectoruyHeader, uEntryCount);
+    WriteUInt32(vectoruyHeader, SCuiBlockEntries);
+    WriteUInt32(vectoruyHeader, uiBlockCount);
+
+    // Compress every block, the offsets are known once all of them are done
+    std::vector<uint8_t> vectoruyData{};
+    std::vector<uint32_t> vectoruiOffsets{};
+    std::vector<uint8_t> vectoruyCompressed(compressBound(SCuiBlockEntries));
+    uint32_t uiDataStart{static_cast<uint32_t>(SCuyHeaderSize + ((uiBlockCount + 1) << 2))};
+
+    for (uint32_t i = 0; i < uiBlockCount; ++i)
+    {
+        uint64_t uFirst{static_cast<uint64_t>(i) * SCuiBlockEntries};
+        uLong ulBlockSize{static_cast<uLong>(std::min<uint64_t>(SCuiBlockEntries, uEntryCount - uFirst))};
+        uLongf ulCompressedSize{static_cast<uLongf>(vectoruyCompressed.size())};
+
+        if (compress2(vectoruyCompressed.data(), &ulCompressedSize, CvectoruyEntries.data() + uFirst,
+            ulBlockSize, Z_BEST_COMPRESSION) != Z_OK) throw std::runtime_error("Error compressing tablebase");
+
+        vectoruiOffsets.push_back(uiDataStart + static_cast<uint32_t>(vectoruyData.size()));
+        vectoruyData.insert(vectoruyData.end(), vectoruyCompressed.begin(),
+            vectoruyCompressed.begin() + ulCompressedSize);
+    }
+    vectoruiOffsets.push_back(uiDataStart + static_cast<uint32_t>(vectoruyData.size()));
+
+    for (uint32_t uiOffset : vectoruiOffsets) WriteUInt32(vectoruyHeader, uiOffset);
+
+    std::ofstream ofstreamTablebase{CsPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc};
+    if (!ofstreamTablebase) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    ofstreamTablebase.write(reinterpret_cast<const char*>(vectoruyHeader.data()), vectoruyHeader.size());
+    ofstreamTablebase.write(reinterpret_cast<const char*>(vectoruyData.data()), vectoruyData.size());
+    if (!ofstreamTablebase) throw std::ios_base::failure("I/O Error");
+}
@@ -0,0 +1,334 @@
+/*
+Trace.cpp --- Event tracing of every thread in the Chrome trace format
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <new>
+#include <chrono>
+#include <fstream>
+#include <ios>
+
+#include <SDL_thread.h>
+
+#include "../include/Trace.hpp"
+
+
+namespace
+{
+    /* Every thread claims a buffer the first time it traces, and it is the only one that writes to it. The
+    buffers are found by the SDL id of the thread, since thread-local storage is not available everywhere.
+    A thread that ends releases its buffer, which keeps its events for Flush until another thread claims it,
+    preferably one with the same name so the games that start a new thread keep tracing in the same track */
+
+    enum EBufferState : uint8_t {BUFFER_FREE, BUFFER_CLAIMING, BUFFER_READY, BUFFER_RELEASED};
+
+    struct Event
+    {
+        const char* CpName;
+        uint64_t uTime;     /**< Microseconds since the start of the program */
+        int64_t lValue;
+        char cPhase;
+    };
+
+    struct Buffer
+    {
+        std::atomic<uint8_t> uyState;
+        uint32_t uiThreadID;
+        std::atomic<const char*> CpName;
+        std::atomic<uint64_t> uHead;    /**< Events ever written, the next goes to uHead % SCuiBufferEvents */
+        std::atomic<Event*> pEvents;    /**< Allocated on the first event, so naming a thread costs nothing */
+
+        ~Buffer() noexcept { delete[] pEvents.load(std::memory_order_relaxed); }
+    };
+
+    std::atomic<bool> SbEnabled{false};
+    std::array<Buffer, Trace::SCuyMaxThreads> SabufferThreads{};
+    const std::chrono::steady_clock::time_point SCtimeStart{std::chrono::steady_clock::now()};
+
+
+    /**
+     * @brief Finds the buffer claimed by the calling thread
+     *
+     * @return Buffer* the buffer, or nullptr if the thread has not claimed one
+     */
+    Buffer* FindBuffer() noexcept
+    {
+        uint32_t uiThreadID{SDL_ThreadID()};
+        for (Buffer& buffer : SabufferThreads)
+        {
+            if (buffer.uyState.load(std::memory_order_acquire) == BUFFER_READY &&
+                buffer.uiThreadID == uiThreadID) return &buffer;
+        }
+
+        return nullptr;
+    }
+
+
+    /**
+     * @brief Claims a buffer for the calling thread if it is in a given state
+     *
+     * @param buffer the buffer
+     * @param uyState the state it must be in, free or released
+     * @param CpName the name of the thread, or nullptr to keep the one of the buffer
+     * @return bool true if the buffer was claimed
+     */
+    bool ClaimBuffer(Buffer& buffer, uint8_t uyState, const char* CpName) noexcept
+    {
+        if (!buffer.uyState.compare_exchange_strong(uyState, BUFFER_CLAIMING, std::memory_order_acquire))
+            return false;
+
+        buffer.uiThreadID = SDL_ThreadID();
+        if (CpName != nullptr) buffer.CpName.store(CpName, std::memory_order_relaxed);
+        buffer.uyState.store(BUFFER_READY, std::memory_order_release);
+        return true;
+    }
+
+
+    /**
+     * @brief Gets the buffer of the calling thread, claiming one the first time. A released buffer of a thread
+     * with the same name comes first, then a free one and then the buffer of any thread that has ended
+     *
+     * @param CpName the name of the thread, or nullptr if it is not known
+     * @return Buffer* the buffer, or nullptr if there are no buffers left
+     */
+    Buffer* GetBuffer(const char* CpName = nullptr) noexcept
+    {
+        if (Buffer* pBuffer = FindBuffer()) return pBuffer;
+
+        if (CpName != nullptr)
+        {
+            for (Buffer& buffer : SabufferThreads)
+            {
+                if (buffer.CpName.load(std::memory_order_relaxed) == CpName &&
+                    ClaimBuffer(buffer, BUFFER_RELEASED, CpName)) return &buffer;
+            }
+        }
+
+        for (Buffer& buffer : SabufferThreads)
+            if (ClaimBuffer(buffer, BUFFER_FREE, CpName)) return &buffer;
+
+        for (Buffer& buffer : SabufferThreads)
+            if (ClaimBuffer(buffer, BUFFER_RELEASED, CpName)) return &buffer;
+
+        return nullptr;
+    }
+
+
+    /**
+     * @brief Writes a name as a JSON string
+     *
+     * @param ofstreamTrace the file
+     * @param CpName the name
+     */
+    void WriteName(std::ofstream& ofstreamTrace, const char* CpName)
+    {
+        ofstreamTrace << '"';
+        for (const char* CpChar = CpName; *CpChar != '\0'; ++CpChar)
+        {
+            if (*CpChar == '"' || *CpChar == '\\') ofstreamTrace << '\\';
+            ofstreamTrace << *CpChar;
+        }
+        ofstreamTrace << '"';
+    }
+}
+
+
+/**
+ * @brief Begins the span
+ *
+ * @param CpName the name of the span
+ */
+Trace::Scope::Scope(const char* CpName) noexcept : _CpName{CpName}, _bBegun{IsEnabled()}
+{
+    if (_bBegun) Write('B', _CpName, 0);
+}
+
+
+/**
+ * @brief Destructor, ends the span
+ */
+Trace::Scope::~Scope() noexcept
+{
+    if (_bBegun) Write('E', _CpName, 0);
+}
+
+
+bool Trace::IsEnabled() noexcept { return SbEnabled.load(std::memory_order_relaxed); }
+void Trace::SetEnabled(bool bEnabled) noexcept { SbEnabled.store(bEnabled, std::memory_order_relaxed); }
+
+
+/**
+ * @brief Names the calling thread in the trace. No buffer is claimed while tracing is disabled, so the
+ * threads name themselves whenever they start some work
+ *
+ * @param CpName the name of the thread
+ */
+void Trace::SetThreadName(const char* CpName) noexcept
+{
+    Buffer* pBuffer{IsEnabled() ? GetBuffer(CpName) : FindBuffer()};
+    if (pBuffer != nullptr) pBuffer->CpName.store(CpName, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Releases the buffer of the calling thread, which must not trace anymore. Its events are still
+ * written by Flush until another thread claims the buffer
+ */
+void Trace::ReleaseThread() noexcept
+{
+    if (Buffer* pBuffer = FindBuffer()) pBuffer->uyState.store(BUFFER_RELEASED, std::memory_order_release);
+}
+
+
+/**
+ * @brief Begins a span in the calling thread
+ *
+ * @param CpName the name of the span
+ */
+void Trace::Begin(const char* CpName) noexcept
+{
+    if (IsEnabled()) Write('B', CpName, 0);
+}
+
+
+/**
+ * @brief Ends the last span begun in the calling thread, even if tracing has been disabled since then
+ *
+ * @param CpName the name of the span
+ */
+void Trace::End(const char* CpName) noexcept { Write('E', CpName, 0); }
+
+
+/**
+ * @brief Marks an instant in the calling thread
+ *
+ * @param CpName the name of the event
+ */
+void Trace::Instant(const char* CpName) noexcept
+{
+    if (IsEnabled()) Write('i', CpName, 0);
+}
+
+
+/**
+ * @brief Records the value of a counter
+ *
+ * @param CpName the name of the counter
+ * @param lValue the value
+ */
+void Trace::Counter(const char* CpName, int64_t lValue) noexcept
+{
+    if (IsEnabled()) Write('C', CpName, lValue);
+}
+
+
+/**
+ * @brief Writes the events of every thread as a Chrome trace. The threads may keep tracing meanwhile,
+ * the events they overwrite while they are read are left out
+ *
+ * @param CsPath the path of the file, which is overwritten
+ */
+void Trace::Flush(const std::string& CsPath)
+{
+    std::ofstream ofstreamTrace{CsPath, std::ios_base::out | std::ios_base::trunc};
+    if (!ofstreamTrace) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    ofstreamTrace << "{\"traceEvents\":[\n";
+    bool bFirst{true};
+    std::vector<Event> vectorEvents{};
+
+    for (uint8_t i = 0; i < SCuyMaxThreads; ++i)
+    {
+        Buffer& buffer{SabufferThreads[i]};
+        uint8_t uyState{buffer.uyState.load(std::memory_order_acquire)};
+        if (uyState != BUFFER_READY && uyState != BUFFER_RELEASED) continue;
+
+        // Copy the events first, then drop the ones the thread may have overwritten during the copy
+        uint64_t uHead{buffer.uHead.load(std::memory_order_acquire)};
+        uint64_t uFirst{uHead > SCuiBufferEvents ? uHead - SCuiBufferEvents : 0};
+        const Event* CpEvents{buffer.pEvents.load(std::memory_order_acquire)};
+        vectorEvents.clear();
+        for (uint64_t j = uFirst; CpEvents && j < uHead; ++j)
+            vectorEvents.push_back(CpEvents[j % SCuiBufferEvents]);
+
+        // The slot of the event being written when the copy ended may be half written too
+        uint64_t uHeadAfter{buffer.uHead.load(std::memory_order_acquire) + 1};
+        uint64_t uSkipped{uHeadAfter > SCuiBufferEvents + uFirst ?
+            uHeadAfter - SCuiBufferEvents - uFirst : 0};
+        if (uSkipped > vectorEvents.size()) uSkipped = vectorEvents.size();
+
+        if (const char* CpName = buffer.CpName.load(std::memory_order_relaxed))
+        {
+            ofstreamTrace << (bFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1," <<
+                "\"tid\":" << i + 1 << ",\"args\":{\"name\":";
+            WriteName(ofstreamTrace, CpName);
+            ofstreamTrace << "}}";
+            bFirst = false;
+        }
+
+        for (std::size_t j = uSkipped; j < vectorEvents.size(); ++j)
+        {
+            const Event& Cevent{vectorEvents[j]};
+            ofstreamTrace << (bFirst ? "" : ",\n") << "{\"name\":";
+            WriteName(ofstreamTrace, Cevent.CpName);
+            ofstreamTrace << ",\"ph\":\"" << Cevent.cPhase << "\",\"ts\":" << Cevent.uTime <<
+                ",\"pid\":1,\"tid\":" << i + 1;
+
+            if (Cevent.cPhase == 'C') ofstreamTrace << ",\"args\":{\"value\":" << Cevent.lValue << '}';
+            else if (Cevent.cPhase == 'i') ofstreamTrace << ",\"s\":\"t\"";
+            ofstreamTrace << '}';
+            bFirst = false;
+        }
+    }
+
+    ofstreamTrace << "\n]}\n";
+    if (!ofstreamTrace) throw std::ios_base::failure("Error writing file " + CsPath);
+}
+
+
+/**
+ * @brief Stores an event in the buffer of the calling thread
+ *
+ * @param cPhase the type of the event in the Chrome trace format
+ * @param CpName the name of the event
+ * @param lValue the value of a counter
+ */
+void Trace::Write(char cPhase, const char* CpName, int64_t lValue) noexcept
+{
+    // Only the end of a span is written while disabled, and only by a thread that traced before
+    Buffer* pBuffer{IsEnabled() ? GetBuffer() : FindBuffer()};
+    if (pBuffer == nullptr) return;
+
+    Event* pEvents{pBuffer->pEvents.load(std::memory_order_relaxed)};
+    if (pEvents == nullptr)
+    {
+        if ((pEvents = new (std::nothrow) Event[SCuiBufferEvents]) == nullptr) return;
+        pBuffer->pEvents.store(pEvents, std::memory_order_release);
+    }
+
+    uint64_t uHead{pBuffer->uHead.load(std::memory_order_relaxed)};
+    pEvents[uHead % SCuiBufferEvents] = Event{CpName, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - SCtimeStart)
+        .count()), lValue, cPhase};
+    pBuffer->uHead.store(uHead + 1, std::memory_order_release);   // Publishes the event to Flush
+}
@@ -27,10 +27,12 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "../../include/audio/SamplePlayer.hpp"
 #include "../../include/audio/Sample.hpp"
+#include "../../include/Trace.hpp"
 
 
 void SamplePlayer::SetSample(Sample* pSample) noexcept 
 {
+    TRACE_SCOPE("SamplePlayer::SetSample");
     _pSample = pSample; 
 
     if (pSample != nullptr)
@@ -90,6 +92,7 @@ SamplePlayer::~SamplePlayer() noexcept
  */
 void SamplePlayer::Play(int32_t iDuration, int32_t iFadeInTime, int32_t iLoops) 
 {
+    TRACE_SCOPE("SamplePlayer::Play");
     if (_pSample == nullptr) throw std::runtime_error("Sample is null");
 
     if (_iChannel >= 0 && *_pSample == Mix_GetChunk(_iChannel) && Mix_Playing(_iChannel))
@@ -146,6 +149,7 @@ void SamplePlayer::Pause() const noexcept
  */
 void SamplePlayer::Stop(int32_t iFadeOutTime)
 { 
+    TRACE_SCOPE("SamplePlayer::Stop");
     if (_iChannel >= 0 && _pSample != nullptr && *_pSample == Mix_GetChunk(_iChannel) && 
         Mix_Playing(_iChannel)) 
     {
@@ -220,3 +224,16 @@ void SamplePlayer::SetReverseStereo(bool bReverse)
         !Mix_SetReverseStereo(_iChannel, bReverse) && std::strcmp(Mix_GetError(), 
         "No such effect registered")) throw std::runtime_error(Mix_GetError());
 }
+
+
+/**
+ * @brief Callback of SDL_mixer when a channel stops playing, run from the audio thread, so it must not
+ * call SDL_mixer
+ * 
+ * @param iChannel the channel that stopped
+ */
+void SamplePlayer::OnChannelFinished(int32_t iChannel) noexcept
+{
+    TRACE_THREAD_NAME("Audio");
+    TRACE_INSTANT("Mix::ChannelFinished");
+}
@@ -18,12 +18,11 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <cstdint>
+#include <cstdio>
 #include <exception>
+#include <string>
 
 #ifdef __wii__
-	#include <string>
-	#include <cstdio>
-
 	#include <ogc/video.h>
 	#include <wiiuse/wpad.h>
 	#include <ogc/pad.h>
@@ -32,6 +31,9 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 	#include <ogc/system.h>
 	#include <ogc/consol.h>
 	#include <ogc/video_types.h>
+#else
+	#include <cstdlib>
+	#include <stdexcept>
 #endif
 
 #include "../include/App.hpp"
@@ -41,13 +43,48 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #ifdef __wii__
 	void EmergencyInitialise();
 	void ShowFatalError(const std::string& CsFatalError);
+#else
+	/**
+	 * @brief Options of automated runs, given in the command line:
+	 * --headless uses the dummy video and audio drivers of SDL, so no window nor sound device is needed
+	 * --benchmark <frames> draws every screen for the given frames and exits, see App::OnBenchmark
+	 * --script <path> feeds the input events of a script to the benchmark
+	 * --checksums <path> writes the checksum of every frame of the benchmark
+	 */
+	struct Options
+	{
+		uint32_t uiBenchmarkFrames;
+		std::string sScriptPath;
+		std::string sChecksumPath;
+	};
+
+	bool ParseOptions(int32_t argc, char** argv, Options& options);
+	void PrintUsage(const char* CpProgram);
 #endif
 
 
 int32_t main(int32_t argc, char** argv)
 {
 	try
-	{ App::GetInstance().OnExecute(); }
+	{
+		#ifdef __wii__
+			App::GetInstance().OnExecute();
+		#else
+			Options options{0, {}, {}};
+			if (!ParseOptions(argc, argv, options))
+			{
+				PrintUsage(argv[0]);
+				return 1;
+			}
+
+			if (options.uiBenchmarkFrames > 0)
+			{
+				App::GetInstance().OnBenchmark(options.uiBenchmarkFrames, options.sScriptPath,
+					options.sChecksumPath);
+			}
+			else App::GetInstance().OnExecute();
+		#endif
+	}
 	catch (const std::exception& Cexception)
 	{
 		try
@@ -125,4 +162,57 @@ int32_t main(int32_t argc, char** argv)
 		} while (!(WPAD_ButtonsDown(WPAD_CHAN_0) & WPAD_BUTTON_HOME) &&
 			!(PAD_ButtonsDown(PAD_CHAN0) & PAD_BUTTON_START));
 	}
+#else
+	/**
+	 * @brief Reads the options of automated runs, which must be done before the application starts SDL
+	 *
+	 * @param argc the number of arguments
+	 * @param argv the arguments
+	 * @param options receives the options given
+	 * @return bool false if an option is unknown or lacks its value
+	 */
+	bool ParseOptions(int32_t argc, char** argv, Options& options)
+	{
+		for (int32_t i = 1; i < argc; ++i)
+		{
+			std::string sArgument{argv[i]};
+			bool bHasValue{i + 1 < argc};
+
+			if (sArgument == "--headless")
+			{
+				setenv("SDL_VIDEODRIVER", "dummy", 1);
+				setenv("SDL_AUDIODRIVER", "dummy", 1);
+			}
+			else if (sArgument == "--benchmark" && bHasValue)
+			{
+				std::string sFrames{argv[++i]};
+				std::size_t uParsed{0};
+				try { options.uiBenchmarkFrames = static_cast<uint32_t>(std::stoul(sFrames, &uParsed)); }
+				catch (const std::logic_error& ClogicError) { return false; }
+
+				if (uParsed != sFrames.size() || options.uiBenchmarkFrames == 0) return false;
+			}
+			else if (sArgument == "--script" && bHasValue) options.sScriptPath = argv[++i];
+			else if (sArgument == "--checksums" && bHasValue) options.sChecksumPath = argv[++i];
+			else return false;
+		}
+
+		return true;
+	}
+
+
+	/**
+	 * @brief Prints the options of automated runs
+	 *
+	 * @param CpProgram the name the program was run with
+	 */
+	void PrintUsage(const char* CpProgram)
+	{
+		std::fprintf(stderr, "Usage: %s [--headless] [--benchmark <frames> [--script <path>] "
+			"[--checksums <path>]]\n"
+			"  --headless            use the dummy video and audio drivers of SDL\n"
+			"  --benchmark <frames>  draw every screen for the given frames and exit\n"
+			"  --script <path>       feed the input events of a script to the benchmark\n"
+			"  --checksums <path>    write the checksum of every frame of the benchmark\n", CpProgram);
+	}
 #endif
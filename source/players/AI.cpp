@@ -21,66 +21,147 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <limits>
 #include <algorithm>
 #include <stdexcept>
-#include <queue>
-#include <cmath>
-#include <sstream>
 
 #include <SDL_mutex.h>
+#include <SDL_events.h>
 
 #include "../../include/players/AI.hpp"
 #include "../../include/players/Player.hpp"
+#include "../../include/players/Evaluation.hpp"
 #include "../../include/Grid.hpp"
 #include "../../include/App.hpp"
+#include "../../include/Globals.hpp"
+#include "../../include/Trace.hpp"
 
 
 /**
  * @brief Construct a new AI player
  *
  * @param CePlayerMark the mark assigned to this player
- * @param uySearchLimit the depth of levels that the AI will explore
+ * @param uiNodeBudget the number of nodes that the AI will explore per move on a reference board
  */
-AI::AI(const Grid::EPlayerMark& CePlayerMark, uint8_t uySearchLimit) : Player(CePlayerMark),
-    _uySearchLimit{uySearchLimit} {}
+AI::AI(const Grid::EPlayerMark& CePlayerMark, uint32_t uiNodeBudget) : Player(CePlayerMark),
+    _uiNodeBudget{uiNodeBudget}, _pTablebase{nullptr}, _evaluation{} {}
 
 
 /**
  * @brief Makes the AI choose a play on the board
  *
  * @param grid the main game board
+ * @return uint8_t the column played, or the width of the board if no move was possible
  */
-void AI::ChooseMove(Grid& grid) const noexcept
+uint8_t AI::ChooseMove(Grid& grid) const noexcept
 {
+    TRACE_SCOPE("AI::ChooseMove");
+
+    // Solved boards are played perfectly without searching
+    uint8_t uyTablebaseMove{ProbeTablebase(grid)};
+    if (uyTablebaseMove < grid.GetWidth())
+    {
+        grid.MakeMove(__ePlayerMark, uyTablebaseMove);
+        return uyTablebaseMove;
+    }
+
+    // Every node costs time proportional to the board size, so scale the budget to keep the response
+    // time of each difficulty level the same on every board
+    uint32_t uiNodeBudget{static_cast<uint32_t>(std::clamp<uint64_t>(static_cast<uint64_t>(_uiNodeBudget) *
+        Globals::SCuyAINodeBudgetCells / (grid.GetWidth() * grid.GetHeight()), 1, 
+        std::numeric_limits<uint32_t>::max()))};
+    uint32_t uiNodeCount{0};
+
+    uint8_t uyEmptyCells{0};
+    for (uint8_t i = 0; i < grid.GetWidth(); ++i) uyEmptyCells += grid.GetNextCell(i) + 1;
+
     int32_t iAlpha = std::numeric_limits<int32_t>::min();
     uint8_t uyBestMove = 0;
 
-    for (uint8_t i = 0; i < _uySearchLimit && iAlpha < std::numeric_limits<int32_t>::max(); ++i)    // Iterative deepening search
+    for (uint8_t i = 1; i <= uyEmptyCells && iAlpha < std::numeric_limits<int32_t>::max(); ++i)    // Iterative deepening search
     {
-        iAlpha = std::numeric_limits<int32_t>::min();
-        uyBestMove = 0;
+        int32_t iIterationAlpha = std::numeric_limits<int32_t>::min();
+        uint8_t uyIterationMove = 0;
 
-        for (uint8_t j = 0; j < grid.GetWidth() && iAlpha < std::numeric_limits<int32_t>::max(); ++j)
+        for (uint8_t j = 0; j < grid.GetWidth() && iIterationAlpha < std::numeric_limits<int32_t>::max(); ++j)
         {
             if (grid.IsValidMove(j))
             {
                 Grid gridAttempt = grid;
                 gridAttempt.MakeMove(__ePlayerMark, j);
-                int32_t iMinimaxValue = AlphaBetaPruning(gridAttempt, NextPlayer(__ePlayerMark), 1, i + 1,
-                    iAlpha, std::numeric_limits<int32_t>::max(), true);
+                int32_t iMinimaxValue = AlphaBetaPruning(gridAttempt, NextPlayer(__ePlayerMark), 1, i,
+                    iIterationAlpha, std::numeric_limits<int32_t>::max(), true, uiNodeCount, uiNodeBudget);
+
+                if (uiNodeCount > uiNodeBudget) break;  // The budget ran out, this iteration is incomplete
 
-                if (iMinimaxValue > iAlpha)
+                if (iMinimaxValue > iIterationAlpha)
                 {
-                    iAlpha = iMinimaxValue;
-                    uyBestMove = j;
+                    iIterationAlpha = iMinimaxValue;
+                    uyIterationMove = j;
                 }
             }
         }
+
+        // Only a fully searched depth is trusted, so the result is the same for a given budget on any hardware
+        if (uiNodeCount > uiNodeBudget) break;
+
+        iAlpha = iIterationAlpha;
+        uyBestMove = uyIterationMove;
     }
+    TRACE_COUNTER("AI nodes", uiNodeCount);
 
     /* Check the position chosen is valid, otherwise use the first valid one */
     uint8_t i = 0;
     while (i < grid.GetWidth() && !(grid.IsValidMove((uyBestMove + i) % grid.GetWidth()))) ++i;
     
-    if (i < grid.GetWidth()) grid.MakeMove(__ePlayerMark, (uyBestMove + i) % grid.GetWidth());
+    if (i >= grid.GetWidth()) return grid.GetWidth();
+
+    grid.MakeMove(__ePlayerMark, (uyBestMove + i) % grid.GetWidth());
+    return (uyBestMove + i) % grid.GetWidth();
+}
+
+
+/**
+ * @brief Looks up the best move in the tablebase
+ *
+ * @param Cgrid the main game board
+ * @return uint8_t the best column, or the width of the board if the position is not in the tablebase
+ */
+uint8_t AI::ProbeTablebase(const Grid& Cgrid) const noexcept
+{
+    if (!_pTablebase) return Cgrid.GetWidth();
+
+    int16_t rBestScore{std::numeric_limits<int16_t>::min()};
+    uint8_t uyBestMove{Cgrid.GetWidth()};
+
+    try
+    {
+        for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
+        {
+            if (Cgrid.IsValidMove(i))
+            {
+                Grid gridAttempt = Cgrid;
+                gridAttempt.MakeMove(__ePlayerMark, i);
+                uint8_t uyEntry{_pTablebase->Probe(gridAttempt)};
+
+                // The entries are for the opponent: win as fast as possible and lose as late as possible
+                int16_t rScore{};
+                switch (Tablebase::GetResult(uyEntry))
+                {
+                case Tablebase::EResult::RESULT_LOSS: rScore = 1000 - Tablebase::GetDepth(uyEntry);  break;
+                case Tablebase::EResult::RESULT_DRAW: rScore = 0;                                    break;
+                case Tablebase::EResult::RESULT_WIN:  rScore = Tablebase::GetDepth(uyEntry) - 1000;  break;
+                default: return Cgrid.GetWidth();   // The position is missing, search instead
+                }
+
+                if (rScore > rBestScore)
+                {
+                    rBestScore = rScore;
+                    uyBestMove = i;
+                }
+            }
+        }
+    }
+    catch (...) { return Cgrid.GetWidth(); }
+
+    return uyBestMove;
 }
 
 
@@ -94,11 +175,16 @@ void AI::ChooseMove(Grid& grid) const noexcept
  * @param iAlpha alpha value for the AB-Pruning algorithm
  * @param iBeta beta value for the AB-Pruning algorithm
  * @param bIsMinNode signals if the current node is a Min node
+ * @param uiNodeCount the number of nodes explored so far in the current move
+ * @param uiNodeBudget the maximum number of nodes to explore in the current move
  * @return int32_t the value of the current node
  */
 int32_t AI::AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, uint8_t uyCurrentDepth, 
-    uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode) const noexcept
+    uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode, uint32_t& uiNodeCount, 
+    uint32_t uiNodeBudget) const noexcept
 {
+    ++uiNodeCount;  // The leaves are evaluated too, so they count against the budget
+
     if (Cgrid.CheckWinner() != Grid::EPlayerMark::EMPTY)
     {
         if (Cgrid.CheckWinner() == __ePlayerMark) return std::numeric_limits<int32_t>::max();
@@ -106,30 +192,31 @@ int32_t AI::AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlaye
     }
     else if (Cgrid.IsFull()) return 0;
     else if (uyCurrentDepth >= uyMaxDepth) return Heuristic(Cgrid);
+    else if (uiNodeCount > uiNodeBudget) return 0;  // Out of budget, the caller discards this value
     else if (bIsMinNode)    // Min node
     {
-        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta; ++i)
+        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta && uiNodeCount <= uiNodeBudget; ++i)
         {
             if (Cgrid.IsValidMove(i))
             {
                 Grid gridAttempt = Cgrid;
                 gridAttempt.MakeMove(CePlayerMark, i);
                 iBeta = std::min(iBeta, AlphaBetaPruning(gridAttempt, NextPlayer(CePlayerMark), 
-                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, false));
+                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, false, uiNodeCount, uiNodeBudget));
             }
         }
         return iBeta;
     }
     else                    // Max node
     {
-        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta; ++i)
+        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta && uiNodeCount <= uiNodeBudget; ++i)
         {
             if (Cgrid.IsValidMove(i))
             {
                 Grid gridAttempt = Cgrid;
                 gridAttempt.MakeMove(CePlayerMark, i);
                 iAlpha = std::max(iAlpha, AlphaBetaPruning(gridAttempt, NextPlayer(CePlayerMark), 
-                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, true));
+                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, true, uiNodeCount, uiNodeBudget));
             }
         }
         return iAlpha;
@@ -145,184 +232,8 @@ int32_t AI::AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlaye
  */
 int32_t AI::Heuristic(const Grid& Cgrid) const noexcept
 {
-    int32_t iHeuristic = 0;
-
-    Grid::EPlayerMark ePlayerMarkLast{};
-    uint8_t uySamePlayerMarkCount{}, uyEmptyCellCount{};
-    std::queue<Grid::EPlayerMark> quPlayerMarks{};
-
-    // Upwards check
-    if (Cgrid.GetHeight() >= Cgrid.GetCellsToWin())
-    {
-        for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
-        {
-            if (Cgrid.GetNextCell(i) < Cgrid.GetHeight() - 1)
-            {
-                ePlayerMarkLast = Cgrid[Cgrid.GetHeight() - 1][i];
-                uySamePlayerMarkCount = 1;
-                uyEmptyCellCount = 0;
-                quPlayerMarks = std::queue<Grid::EPlayerMark>();
-                quPlayerMarks.push(ePlayerMarkLast);
-
-                for (int8_t j = Cgrid.GetHeight() - 2;
-                    j >= std::max(0, Cgrid.GetNextCell(i) - Cgrid.GetCellsToWin() + 2); --j)
-                    iHeuristic += EvaluateSector(Cgrid, j, i, quPlayerMarks, ePlayerMarkLast,
-                        uySamePlayerMarkCount, uyEmptyCellCount);
-            }
-        }
-    }
-
-    // Horizontal check
-    int8_t yMaxColumnHeight = Cgrid.GetNextCell(0);
-    for (uint8_t i = 1; i < Cgrid.GetWidth(); ++i)
-        if (Cgrid.GetNextCell(i) < yMaxColumnHeight) yMaxColumnHeight = Cgrid.GetNextCell(i);
-    ++yMaxColumnHeight;
-
-    if (Cgrid.GetWidth() >= Cgrid.GetCellsToWin())
-    {
-        for (uint8_t i = yMaxColumnHeight; i < Cgrid.GetHeight(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < Cgrid.GetWidth(); ++j)
-                iHeuristic += EvaluateSector(Cgrid, i, j, quPlayerMarks, ePlayerMarkLast,
-                    uySamePlayerMarkCount, uyEmptyCellCount);
-        }
-    }
-
-    if (Cgrid.GetHeight() >= Cgrid.GetCellsToWin() && Cgrid.GetWidth() >= Cgrid.GetCellsToWin())
-    {
-        // Diagonal up right check
-        for (uint8_t i = std::max(static_cast<int8_t>(Cgrid.GetCellsToWin() - 1), yMaxColumnHeight);
-            i < Cgrid.GetHeight(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(Cgrid.GetWidth(), static_cast<uint8_t>(i - std::max(0,
-                yMaxColumnHeight - Cgrid.GetCellsToWin()))); ++j)
-                iHeuristic += EvaluateSector(Cgrid, i - j, j, quPlayerMarks, ePlayerMarkLast,
-                    uySamePlayerMarkCount, uyEmptyCellCount);
-        }
-
-        for (uint8_t i = 1; i <= Cgrid.GetWidth() - Cgrid.GetCellsToWin(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0;
-                j < std::min(static_cast<uint8_t>(Cgrid.GetWidth() - i), std::min(Cgrid.GetHeight(),
-                    static_cast<uint8_t>(Cgrid.GetHeight() - yMaxColumnHeight + 
-                    Cgrid.GetCellsToWin() - 1))); ++j)
-                iHeuristic += EvaluateSector(Cgrid, Cgrid.GetHeight() - 1 - j, i + j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
-        }
-
-        // Diagonal up left check
-        for (uint8_t i = Cgrid.GetCellsToWin() - 1; i < Cgrid.GetWidth(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(static_cast<uint8_t>(i + 1), std::min(Cgrid.GetHeight(),
-                    static_cast<uint8_t>(Cgrid.GetHeight() -
-                    yMaxColumnHeight + Cgrid.GetCellsToWin() - 1))); ++j)
-                iHeuristic += EvaluateSector(Cgrid, Cgrid.GetHeight() - 1 - j, i - j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
-        }
-
-        for (uint8_t i = Cgrid.GetHeight() - 2;
-            i >= std::max(static_cast<int8_t>(Cgrid.GetCellsToWin() - 1), yMaxColumnHeight); --i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(i, Cgrid.GetWidth()); ++j)
-                iHeuristic += EvaluateSector(Cgrid, i - j, Cgrid.GetWidth() - 1 - j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
-        }
-    }
-
-    return iHeuristic;
-}
-
-
-/**
- * @brief Helper function for the heuristic function. Used to build and keep track of free sectors, 
- * where there is only one type of player marker and where such player still has the chance to win
- * 
- * @param Cgrid the main game board
- * @param uyRow the row of the next cell to be added to the sector
- * @param uyColumn the column of the next cell to be added to the sector
- * @param quPlayerMarks the queue of cells that form the sector
- * @param ePlayerMarkLast the type of the last  non-empty cell that was found
- * @param uySamePlayerMarkCount the number of player marks of the same type that have been found in the
- *  current sector
- * @param uyEmptyCellCount the number of empty cells that have been found since the last non-empty cell
- * @return int32_t the heuristic evaluation for the current sector
- */
-int32_t AI::EvaluateSector(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn,
-    std::queue<Grid::EPlayerMark>& quPlayerMarks, Grid::EPlayerMark& ePlayerMarkLast,
-    uint8_t& uySamePlayerMarkCount, uint8_t& uyEmptyCellCount) const noexcept
-{
-    if (Cgrid[uyRow][uyColumn] != Grid::EPlayerMark::EMPTY &&
-        ePlayerMarkLast != Grid::EPlayerMark::EMPTY &&
-        Cgrid[uyRow][uyColumn] != ePlayerMarkLast)
-    {
-        quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-        ePlayerMarkLast = Cgrid[uyRow][uyColumn];
-        uySamePlayerMarkCount = 1;
-
-        for (uint8_t i = 0; i < uyEmptyCellCount; ++i)
-            quPlayerMarks.push(Grid::EPlayerMark::EMPTY);
-
-        quPlayerMarks.push(ePlayerMarkLast);
-        uyEmptyCellCount = 0;
-    }
-    else
-    {
-        quPlayerMarks.push(Cgrid[uyRow][uyColumn]);
-
-        if (Cgrid[uyRow][uyColumn] == Grid::EPlayerMark::EMPTY) ++uyEmptyCellCount;
-        else
-        {
-            uyEmptyCellCount = 0;
-            ++uySamePlayerMarkCount;
-            if (ePlayerMarkLast == Grid::EPlayerMark::EMPTY)
-                ePlayerMarkLast = Cgrid[uyRow][uyColumn];
-        }
-    }
-
-    if (quPlayerMarks.size() - 1 > Cgrid.GetCellsToWin())
-    {
-        if (quPlayerMarks.front() == ePlayerMarkLast &&
-            ePlayerMarkLast != Grid::EPlayerMark::EMPTY) --uySamePlayerMarkCount;
-        quPlayerMarks.pop();
-    }
-
-    if (quPlayerMarks.size() >= Cgrid.GetCellsToWin())
-    {
-        if (uySamePlayerMarkCount >= Cgrid.GetCellsToWin() || 
-            (uySamePlayerMarkCount == Cgrid.GetCellsToWin() - 1 && 
-            quPlayerMarks.front() == Grid::EPlayerMark::EMPTY && 
-            quPlayerMarks.back() == Grid::EPlayerMark::EMPTY)) 
-            return 1000000 * PlayerMark2Heuristic(ePlayerMarkLast);
-        else return std::pow(uySamePlayerMarkCount, uySamePlayerMarkCount) * 
-            PlayerMark2Heuristic(ePlayerMarkLast);
-    }
-
-    return 0;
+    TRACE_SCOPE("AI::Heuristic");
+    return _evaluation.Evaluate(Cgrid, __ePlayerMark);
 }
 
 
@@ -340,20 +251,6 @@ Grid::EPlayerMark AI::NextPlayer(const Grid::EPlayerMark& CePlayerMark) const no
 }
 
 
-/**
- * @brief Converts a player mark into a value for the evaluation function
- *
- * @param CePlayerMark the player mark to convert
- * @return int8_t a numeric representation of the player mark for the evaluation function
- */
-int8_t AI::PlayerMark2Heuristic(const Grid::EPlayerMark& CePlayerMark) const noexcept
-{
-    if (CePlayerMark == __ePlayerMark) return 1;
-    else if (CePlayerMark == Grid::EPlayerMark::EMPTY) return 0;
-    else return -1;
-}
-
-
 /**
  * @brief Callback for running the AI algorithm in a separate thread
  *
@@ -363,7 +260,6 @@ int8_t AI::PlayerMark2Heuristic(const Grid::EPlayerMark& CePlayerMark) const noe
 int32_t SDLCALL RunAI(void* pData)
 {
     App& app{App::GetInstance()};
-    Sample* pSampleWaiting{app._htSamples.at("WaitingLoop")};
 
     while (!(app._bStopThreads))  // Thread termination
     {
@@ -371,48 +267,21 @@ int32_t SDLCALL RunAI(void* pData)
 
         if (!(app._bStopThreads))
         {
+            TRACE_THREAD_NAME("AI");
             if (const AI* CpAI = dynamic_cast<AI*>(app._vectorpPlayers[app._uyCurrentPlayer]))
             {
-                app._samplePlayerGlobal.SetSample(pSampleWaiting);
-                app._samplePlayerGlobal.Play(-1, 0, -1);
-
-                CpAI->ChooseMove(app._grid);
-
-                // If the game is won or there is a draw go to the corresponding state
-                if (app._grid.CheckWinner() != Grid::EPlayerMark::EMPTY || app._grid.IsFull())
-                {
-                    app._samplePlayerGlobal.SetSample(pSampleWaiting);
-                    app._samplePlayerGlobal.Stop();
-                    
-                    std::ostringstream ossSound{"error", std::ios_base::ate};
-                    int32_t iRandom{app._uniformDistribution(app._randomDeviceGenerator)};
-                    ossSound << (iRandom > 2 ? iRandom / 3 : iRandom);
-                    app._samplePlayerGlobal.SetSample(app._htSamples.at(ossSound.str()));
-                    app._samplePlayerGlobal.Play();
-
-                    app._eStateCurrent = App::EState::STATE_END;
-                }
-                else
-                {
-                    std::ostringstream ossSound{"select", std::ios_base::ate};
-                    ossSound << app._uniformDistribution(app._randomDeviceGenerator);
-                    app._samplePlayerGlobal.SetSample(app._htSamples.at(ossSound.str()));
-                    app._samplePlayerGlobal.Play();
-
-                    ++(app._uyCurrentPlayer) %= app._vectorpPlayers.size(); // Move turn
-
-                    // Check if next player is another AI
-                    if (typeid(*(app._vectorpPlayers[app._uyCurrentPlayer])) == typeid(AI))
-                        while (SDL_SemPost(app._pSdlSemaphoreAI) == -1);
-                    else 
-                    {
-                        app._samplePlayerGlobal.SetSample(pSampleWaiting);
-                        app._samplePlayerGlobal.Stop();
-                    }
-                }
+                // The search works on a copy, the main thread plays the move in OnLoop like any other one
+                Grid gridSearch{app._grid};
+                app._rAIMove = CpAI->ChooseMove(gridSearch);
+
+                // The main loop may be blocked waiting for events now that nothing animates
+                SDL_Event sdlEventMove{};
+                sdlEventMove.type = SDL_USEREVENT;
+                SDL_PushEvent(&sdlEventMove);
             }
         }
     }
 
+    TRACE_THREAD_RELEASE();     // A new AI thread is started for every game
     return 0;
 }
@@ -0,0 +1,195 @@
+/*
+Evaluation.cpp --- Weighted-feature evaluation of positions
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <array>
+#include <string>
+#include <fstream>
+#include <ios>
+
+#include "../../include/players/Evaluation.hpp"
+#include "../../include/Grid.hpp"
+#include "../../include/Globals.hpp"
+
+
+/** Weights used when no weights file is available, tuned by tools/EvaluationTuner on the default board. The
+odd distances to the centre only happen on boards of even width, so they keep their hand-picked values */
+const Evaluation::Weights Evaluation::SCaiDefaultWeights{
+    22, 13, 6, 1, 0, 0, 0, 0,               // Open windows missing 1 to 8 cells
+    98, 27, 48, 118,                        // Threats of the first player on odd and even rows, then the second
+    -35, 5, -32, 3, -40, 1, -62, 0, 0       // Markers by distance to the centre
+};
+
+
+/**
+ * @brief Creates an evaluation with the default weights
+ */
+Evaluation::Evaluation() noexcept : _aiWeights{SCaiDefaultWeights} {}
+
+
+/**
+ * @brief Creates an evaluation by reading a weights file
+ *
+ * @param CsFilePath the path to the binary file holding the weights
+ */
+Evaluation::Evaluation(const std::string& CsFilePath) : _aiWeights{SCaiDefaultWeights}
+{
+    std::ifstream ifstreamWeights{CsFilePath, std::ios_base::in | std::ios_base::binary};
+    if (!ifstreamWeights) throw std::ios_base::failure("Error opening file " + CsFilePath);
+
+    // Magic, version and number of weights, then every weight as a little-endian 32-bit integer
+    uint8_t auyData[6 + (SCuyFeatureCount << 2)]{};
+    ifstreamWeights.read(reinterpret_cast<char*>(auyData), sizeof(auyData));
+
+    if (!ifstreamWeights || std::memcmp(auyData, "CXEW", 4) != 0 || auyData[4] != 1 ||
+        auyData[5] != SCuyFeatureCount) throw std::ios_base::failure("Not a weights file: " + CsFilePath);
+
+    for (uint8_t i = 0; i < SCuyFeatureCount; ++i)
+    {
+        const uint8_t* CpuyWeight{auyData + 6 + (i << 2)};
+        _aiWeights[i] = static_cast<int32_t>(static_cast<uint32_t>(CpuyWeight[0]) |
+            (static_cast<uint32_t>(CpuyWeight[1]) << 8) | (static_cast<uint32_t>(CpuyWeight[2]) << 16) |
+            (static_cast<uint32_t>(CpuyWeight[3]) << 24));
+    }
+}
+
+
+/**
+ * @brief Saves the weights on disk
+ *
+ * @param CsPath the path where the weights are to be stored
+ */
+void Evaluation::Dump(const std::string& CsPath) const
+{
+    uint8_t auyData[6 + (SCuyFeatureCount << 2)]{'C', 'X', 'E', 'W', 1, SCuyFeatureCount};
+
+    for (uint8_t i = 0; i < SCuyFeatureCount; ++i)
+        for (uint8_t j = 0; j < 4; ++j)
+            auyData[6 + (i << 2) + j] = static_cast<uint8_t>(static_cast<uint32_t>(_aiWeights[i]) >> (j << 3));
+
+    std::ofstream ofstreamWeights{CsPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc};
+    if (!ofstreamWeights) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    ofstreamWeights.write(reinterpret_cast<const char*>(auyData), sizeof(auyData));
+    if (!ofstreamWeights) throw std::ios_base::failure("I/O Error");
+}
+
+
+/**
+ * @brief Evaluates a position
+ *
+ * @param Cgrid the position to evaluate
+ * @param CePlayerMark the mark of the player that evaluates
+ * @return int32_t the evaluation, positive if the position favours the player
+ */
+int32_t Evaluation::Evaluate(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark) const noexcept
+{
+    Features arFeatures{};
+    ExtractFeatures(Cgrid, CePlayerMark, arFeatures);
+
+    int32_t iEvaluation{0};
+    for (uint8_t i = 0; i < SCuyFeatureCount; ++i) iEvaluation += _aiWeights[i] * arFeatures[i];
+
+    return iEvaluation;
+}
+
+
+/**
+ * @brief Computes the features of a position
+ *
+ * @param Cgrid the position
+ * @param CePlayerMark the mark of the player that evaluates
+ * @param arFeatures the features of the position
+ */
+void Evaluation::ExtractFeatures(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark,
+    Features& arFeatures) noexcept
+{
+    static const int8_t SCayDirections[4][2]{{0, 1}, {1, 0}, {1, 1}, {1, -1}};  // Row and column steps
+
+    const int8_t CyWidth = Cgrid.GetWidth(), CyHeight = Cgrid.GetHeight(), CyLast = Cgrid.GetCellsToWin() - 1;
+
+    // Cells that would complete a window, for the first and the second player
+    bool abThreats[2][Globals::SCuyBoardWidthMax * Globals::SCuyBoardHeightMax]{};
+
+    arFeatures.fill(0);
+
+    for (const int8_t (&CayDirection)[2] : SCayDirections)
+    {
+        for (int8_t i = 0; i < CyHeight; ++i)
+        {
+            for (int8_t j = 0; j < CyWidth; ++j)
+            {
+                int8_t yEndRow = i + CyLast * CayDirection[0], yEndColumn = j + CyLast * CayDirection[1];
+                if (yEndRow >= CyHeight || yEndColumn < 0 || yEndColumn >= CyWidth) continue;
+
+                uint8_t auyMarkers[3]{};    // Indexed by player mark
+                int8_t yEmptyRow{-1}, yEmptyColumn{-1};
+
+                for (int8_t k = 0; k <= CyLast; ++k)
+                {
+                    int8_t yRow = i + k * CayDirection[0], yColumn = j + k * CayDirection[1];
+                    ++auyMarkers[Cgrid[yRow][yColumn]];
+                    if (Cgrid[yRow][yColumn] == Grid::EPlayerMark::EMPTY)
+                    {
+                        yEmptyRow = yRow;
+                        yEmptyColumn = yColumn;
+                    }
+                }
+
+                // Only windows that one player can still complete count
+                if ((auyMarkers[Grid::EPlayerMark::PLAYER1] == 0) == (auyMarkers[Grid::EPlayerMark::PLAYER2] == 0))
+                    continue;
+
+                Grid::EPlayerMark ePlayerMarkOwner{auyMarkers[Grid::EPlayerMark::PLAYER1] != 0 ?
+                    Grid::EPlayerMark::PLAYER1 : Grid::EPlayerMark::PLAYER2};
+                uint8_t uyMissing{auyMarkers[Grid::EPlayerMark::EMPTY]};
+                if (uyMissing == 0) continue;   // A won game is scored by the search
+
+                arFeatures[SCuyFirstMissing + uyMissing - 1] += (ePlayerMarkOwner == CePlayerMark ? 1 : -1);
+
+                if (uyMissing == 1)
+                    abThreats[ePlayerMarkOwner - Grid::EPlayerMark::PLAYER1]
+                        [yEmptyRow * CyWidth + yEmptyColumn] = true;
+            }
+        }
+    }
+
+    for (int8_t i = 0; i < CyHeight; ++i)
+    {
+        for (int8_t j = 0; j < CyWidth; ++j)
+        {
+            // Rows are counted from the bottom, starting at one
+            uint8_t uyParity = (CyHeight - i) % 2 == 0;
+
+            for (uint8_t k = 0; k < 2; ++k)
+            {
+                if (abThreats[k][i * CyWidth + j])
+                    arFeatures[SCuyFirstThreat + (k << 1) + uyParity] +=
+                        (k + Grid::EPlayerMark::PLAYER1 == CePlayerMark ? 1 : -1);
+            }
+
+            if (Cgrid[i][j] != Grid::EPlayerMark::EMPTY)
+                arFeatures[SCuyFirstColumn + std::abs((j << 1) - (CyWidth - 1))] +=
+                    (Cgrid[i][j] == CePlayerMark ? 1 : -1);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ScriptedInput.cpp --- Input events read from a script, for automated runs
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <ios>
+
+#include <SDL_events.h>
+#include <SDL_mouse.h>
+#include <SDL_keyboard.h>
+
+#include "../../include/players/ScriptedInput.hpp"
+
+
+/**
+ * @brief Default constructor, an empty script
+ */
+ScriptedInput::ScriptedInput() noexcept : _vectorActions{}, _uNext{0} {}
+
+
+/**
+ * @brief Reads a script
+ *
+ * @param CsPath the path of the script file
+ */
+ScriptedInput::ScriptedInput(const std::string& CsPath) : _vectorActions{}, _uNext{0}
+{
+    std::ifstream ifstreamScript{CsPath};
+    if (!ifstreamScript) throw std::ios_base::failure("Error opening file " + CsPath);
+
+    std::string sLine{};
+    while (std::getline(ifstreamScript, sLine))
+    {
+        std::istringstream issLine{sLine};
+        Action action{};
+        std::string sTag{};
+
+        if (!(issLine >> action.uiFrame >> sTag))
+        {
+            issLine.clear();
+            issLine.seekg(0);
+            if (!(issLine >> sTag) || sTag[0] == '#') continue;     // Empty line or comment
+            throw std::ios_base::failure("Malformed action in " + CsPath + ": " + sLine);
+        }
+
+        if (sTag == "MOVE") action.eAction = EAction::ACTION_MOVE;
+        else if (sTag == "CLICK") action.eAction = EAction::ACTION_CLICK;
+        else if (sTag == "KEY") action.eAction = EAction::ACTION_KEY;
+        else if (sTag == "BUTTON") action.eAction = EAction::ACTION_BUTTON;
+        else throw std::ios_base::failure("Unknown action in " + CsPath + ": " + sLine);
+
+        issLine >> action.iFirst;
+        if (action.eAction != EAction::ACTION_KEY) issLine >> action.iSecond;
+        if (!issLine) throw std::ios_base::failure("Malformed action in " + CsPath + ": " + sLine);
+
+        _vectorActions.push_back(action);
+    }
+
+    // Actions of the same frame keep the order they were written in
+    std::stable_sort(_vectorActions.begin(), _vectorActions.end());
+}
+
+
+/**
+ * @brief Pushes the events of the actions due up to a frame
+ *
+ * @param uiFrame the frame about to be processed
+ */
+void ScriptedInput::Inject(uint32_t uiFrame) noexcept
+{
+    for (; _uNext < _vectorActions.size() && _vectorActions[_uNext].uiFrame <= uiFrame; ++_uNext)
+    {
+        const Action& Caction{_vectorActions[_uNext]};
+        SDL_Event sdlEvent{};
+
+        switch (Caction.eAction)
+        {
+        case EAction::ACTION_MOVE:  // SDL updates the cursor state and queues the motion itself
+            SDL_WarpMouse(static_cast<Uint16>(Caction.iFirst), static_cast<Uint16>(Caction.iSecond));
+            break;
+        case EAction::ACTION_CLICK:
+        {
+            SDL_WarpMouse(static_cast<Uint16>(Caction.iFirst), static_cast<Uint16>(Caction.iSecond));
+
+            sdlEvent.button.button = SDL_BUTTON_LEFT;
+            sdlEvent.button.x = static_cast<Uint16>(Caction.iFirst);
+            sdlEvent.button.y = static_cast<Uint16>(Caction.iSecond);
+
+            sdlEvent.type = SDL_MOUSEBUTTONDOWN;
+            sdlEvent.button.state = SDL_PRESSED;
+            SDL_PushEvent(&sdlEvent);
+
+            sdlEvent.type = SDL_MOUSEBUTTONUP;
+            sdlEvent.button.state = SDL_RELEASED;
+            SDL_PushEvent(&sdlEvent);
+            break;
+        }
+        case EAction::ACTION_KEY:
+        {
+            sdlEvent.key.keysym.sym = static_cast<SDLKey>(Caction.iFirst);
+            sdlEvent.key.keysym.mod = KMOD_NONE;
+
+            sdlEvent.type = SDL_KEYDOWN;
+            sdlEvent.key.state = SDL_PRESSED;
+            SDL_PushEvent(&sdlEvent);
+
+            sdlEvent.type = SDL_KEYUP;
+            sdlEvent.key.state = SDL_RELEASED;
+            SDL_PushEvent(&sdlEvent);
+            break;
+        }
+        case EAction::ACTION_BUTTON:
+        {
+            sdlEvent.jbutton.which = static_cast<Uint8>(Caction.iFirst);
+            sdlEvent.jbutton.button = static_cast<Uint8>(Caction.iSecond);
+
+            sdlEvent.type = SDL_JOYBUTTONDOWN;
+            sdlEvent.jbutton.state = SDL_PRESSED;
+            SDL_PushEvent(&sdlEvent);
+
+            sdlEvent.type = SDL_JOYBUTTONUP;
+            sdlEvent.jbutton.state = SDL_RELEASED;
+            SDL_PushEvent(&sdlEvent);
+            break;
+        }
+        }
+    }
+}
@@ -21,39 +21,50 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <cstdint>
 #include <stdexcept>
 
-#include <SDL_timer.h>
-
 #include "../../include/video/Animation.hpp"
-#include "../../include/video/Time.hpp"
 
 
 /**
  * @brief Construct a new Animation
  * 
  * @param uyMaxFrames the number of frames the animation has
- * @param urInterval the time between frame changes, in milliseconds
+ * @param urInterval the time between frame changes, in milliseconds, it must not be 0
  * @param bOscillate signals if the animation goes back and forth
  * @param yFrameIncrement the distance between frames in the animation
+ * @param bLoop false to stop on the last frame instead of going back to the first one
  */
 Animation::Animation(uint8_t uyMaxFrames, uint16_t urInterval, bool bOscillate, 
-    int8_t yFrameIncrement) noexcept : _uyMaxFrames{uyMaxFrames}, _urInterval{urInterval}, 
-    _bOscillate{bOscillate}, _yCurrentFrame{0}, _yFrameIncrement{yFrameIncrement}, _uiOldTime{0}
+    int8_t yFrameIncrement, bool bLoop) noexcept : _uyMaxFrames{uyMaxFrames}, _urInterval{urInterval}, 
+    _bOscillate{bOscillate}, _yCurrentFrame{0}, _yFrameIncrement{yFrameIncrement}, _bLoop{bLoop}, 
+    _uiElapsed{0}
 {}
 
 
 /**
- * @brief Goes to the next frame if enough time has passed
+ * @brief Moves the animation forward, going through every frame change that falls in the time given
+ *
+ * @param uiDeltaTime the time that has passed, in milliseconds
  */
-void Animation::OnAnimate() noexcept
+void Animation::Advance(uint32_t uiDeltaTime) noexcept
 {
-    if(_uiOldTime + _urInterval > Time::GetInstance().GetTime()) return;
+    if (_urInterval == 0) return;
+
+    // The time left over stays in the current frame, so the frames keep their pace at any frame rate
+    _uiElapsed += uiDeltaTime;
+    for (; _uiElapsed >= _urInterval; _uiElapsed -= _urInterval)
+    {
+        if (IsFinished())   // It rests on the last frame, and the time spent there is not counted
+        {
+            _uiElapsed = 0;
+            break;
+        }
 
-    if(_bOscillate && ((_yFrameIncrement > 0 && _yCurrentFrame + _yFrameIncrement >= _uyMaxFrames) || 
-        (_yFrameIncrement < 0 && _yCurrentFrame + _yFrameIncrement < 0))) 
-        _yFrameIncrement = -_yFrameIncrement;
+        if(_bOscillate && ((_yFrameIncrement > 0 && _yCurrentFrame + _yFrameIncrement >= _uyMaxFrames) || 
+            (_yFrameIncrement < 0 && _yCurrentFrame + _yFrameIncrement < 0))) 
+            _yFrameIncrement = -_yFrameIncrement;
 
-    _yCurrentFrame = (_yCurrentFrame + _yFrameIncrement) % _uyMaxFrames;
-    _uiOldTime = Time::GetInstance().GetTime();
+        _yCurrentFrame = (_yCurrentFrame + _yFrameIncrement) % _uyMaxFrames;
+    }
 }
  
 
@@ -66,4 +77,5 @@ void Animation::SetCurrentFrame(int8_t yFrame)
 {
     if (yFrame < 0 || yFrame >= _uyMaxFrames) throw std::out_of_range("Invalid frame");
     _yCurrentFrame = yFrame;
+    _uiElapsed = 0;
 }
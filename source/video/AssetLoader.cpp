@@ -0,0 +1,289 @@
+/*
+AssetLoader.cpp --- Background decoding and scaling of textures
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <exception>
+#include <ios>
+#include <initializer_list>
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_error.h>
+#include <SDL_image.h>
+#include <SDL_video.h>
+
+#include "../../include/video/AssetLoader.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/TextureCache.hpp"
+#include "../../include/Trace.hpp"
+
+
+/**
+ * @brief Constructor
+ *
+ * @param CpTextureCache the cache of converted textures, nullptr to always decode them
+ */
+AssetLoader::AssetLoader(const TextureCache* CpTextureCache) : _pSdlThread{nullptr},
+    _pSdlMutex{SDL_CreateMutex()}, _pSdlSemaphore{SDL_CreateSemaphore(0)}, _bStop{false},
+    _pTextureCache{CpTextureCache}, _sdlPixelFormatDisplay{}, _sdlPixelFormatDisplayAlpha{}, _dequeRequests{},
+    _dequeEntries{}, _vectorResults{},
+    _uiQueued{0}, _uiCompleted{0}
+{
+    if (_pSdlMutex == nullptr || _pSdlSemaphore == nullptr)
+    {
+        if (_pSdlMutex) SDL_DestroyMutex(_pSdlMutex);
+        if (_pSdlSemaphore) SDL_DestroySemaphore(_pSdlSemaphore);
+        throw std::runtime_error(SDL_GetError());
+    }
+}
+
+
+/**
+ * @brief Destructor
+ */
+AssetLoader::~AssetLoader() noexcept
+{
+    Stop();
+
+    SDL_DestroySemaphore(_pSdlSemaphore);
+    SDL_DestroyMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Queues a texture, starting the worker thread the first time
+ *
+ * @param Crequest the texture to load
+ */
+void AssetLoader::Queue(const Request& Crequest)
+{
+    if (_pSdlThread == nullptr)
+    {
+        // The worker only reads the formats, so they are copied before the worker starts
+        const SDL_Surface* CpSdlSurfaceVideo{SDL_GetVideoSurface()};
+        _sdlPixelFormatDisplay = (CpSdlSurfaceVideo ? *CpSdlSurfaceVideo->format : SDL_PixelFormat{});
+        _sdlPixelFormatDisplay.palette = nullptr;
+        _sdlPixelFormatDisplayAlpha = Surface::GetDisplayAlphaFormat();
+
+        _bStop = false;
+        if ((_pSdlThread = SDL_CreateThread(Run, this)) == nullptr) throw std::runtime_error(SDL_GetError());
+    }
+
+    SDL_LockMutex(_pSdlMutex);
+    _dequeRequests.push_back(Crequest);
+    SDL_UnlockMutex(_pSdlMutex);
+
+    ++_uiQueued;
+    while (SDL_SemPost(_pSdlSemaphore) == -1);
+}
+
+
+/**
+ * @brief Converts the textures finished by the worker and stores them, from the main thread
+ *
+ * @param registrySurfaces the registry that receives the textures
+ */
+void AssetLoader::Collect(ResourceRegistry<Surface>& registrySurfaces)
+{
+    TRACE_SCOPE("AssetLoader::Collect");
+    std::vector<Result> vectorResults{};
+
+    SDL_LockMutex(_pSdlMutex);
+    vectorResults.swap(_vectorResults);
+    SDL_UnlockMutex(_pSdlMutex);
+
+    std::string sError{};
+    for (Result& result : vectorResults)
+    {
+        ++_uiCompleted;
+
+        if (result.pSurface == nullptr)
+        {
+            if (sError.empty()) sError = result.sError;
+            continue;
+        }
+
+        try
+        {
+            if (!result.bConverted)
+            {
+                result.pSurface->ConvertToDisplay();
+
+                // Only the pixels are copied here, the worker writes them when it has nothing to decode
+                TextureCache::Entry entry{};
+                if (_pTextureCache && _pTextureCache->Prepare(result.sPath, result.urFitWidth,
+                    result.urFitHeight, *result.pSurface, entry))
+                {
+                    SDL_LockMutex(_pSdlMutex);
+                    _dequeEntries.push_back(std::move(entry));
+                    SDL_UnlockMutex(_pSdlMutex);
+                    while (SDL_SemPost(_pSdlSemaphore) == -1);
+                }
+            }
+            registrySurfaces.Set(result.handle, result.pSurface);
+        }
+        catch (const std::exception& Cexception)
+        {
+            delete result.pSurface;
+            if (sError.empty()) sError = Cexception.what();
+        }
+    }
+
+    if (IsDone()) _uiQueued = _uiCompleted = 0;
+    if (!sError.empty()) throw std::ios_base::failure(sError);
+}
+
+
+/**
+ * @brief Stops the worker thread and drops every pending texture, which must be done before SDL_Quit
+ */
+void AssetLoader::Stop() noexcept
+{
+    if (_pSdlThread)
+    {
+        _bStop = true;
+        while (SDL_SemPost(_pSdlSemaphore) == -1);
+        SDL_WaitThread(_pSdlThread, nullptr);
+        _pSdlThread = nullptr;
+    }
+
+    // The worker is gone, so the queues are no longer shared, the textures not cached yet are decoded again
+    _dequeRequests.clear();
+    _dequeEntries.clear();
+    for (Result& result : _vectorResults) delete result.pSurface;
+    _vectorResults.clear();
+    while (SDL_SemTryWait(_pSdlSemaphore) == 0);
+
+    _uiQueued = _uiCompleted = 0;
+}
+
+
+/**
+ * @brief Loop of the worker thread
+ *
+ * @param pData the loader
+ * @return int32_t error code of the thread
+ */
+int32_t SDLCALL AssetLoader::Run(void* pData)
+{
+    AssetLoader& assetLoader{*static_cast<AssetLoader*>(pData)};
+
+    while (!assetLoader._bStop)
+    {
+        while (SDL_SemWait(assetLoader._pSdlSemaphore) == -1);  // Wait for a request or an entry
+        if (assetLoader._bStop) break;
+        TRACE_THREAD_NAME("AssetLoader");
+
+        // The textures the game waits for come before the ones waiting to be cached
+        SDL_LockMutex(assetLoader._pSdlMutex);
+        if (assetLoader._dequeRequests.empty())
+        {
+            bool bHasEntry{!assetLoader._dequeEntries.empty()};
+            TextureCache::Entry entry{};
+            if (bHasEntry)
+            {
+                entry = std::move(assetLoader._dequeEntries.front());
+                assetLoader._dequeEntries.pop_front();
+            }
+            SDL_UnlockMutex(assetLoader._pSdlMutex);
+
+            if (bHasEntry)
+            {
+                TRACE_SCOPE("AssetLoader::Cache");
+                assetLoader._pTextureCache->Write(entry);
+            }
+            continue;
+        }
+        Request request{assetLoader._dequeRequests.front()};
+        assetLoader._dequeRequests.pop_front();
+        SDL_UnlockMutex(assetLoader._pSdlMutex);
+
+        Result result{request.handle, nullptr, {}, {}, request.urFitWidth, request.urFitHeight, false};
+        try { assetLoader.Decode(request, result); }
+        catch (const std::exception& Cexception) { result.sError = Cexception.what(); }
+
+        SDL_LockMutex(assetLoader._pSdlMutex);
+        assetLoader._vectorResults.push_back(result);
+        SDL_UnlockMutex(assetLoader._pSdlMutex);
+    }
+
+    TRACE_THREAD_RELEASE();     // A new loader is started for every game
+    return 0;
+}
+
+
+/**
+ * @brief Loads a texture from the cache, or else decodes and scales it, from the worker thread
+ *
+ * @param Crequest the texture to load
+ * @param result receives the texture, in the format of the display only if it came from the cache
+ */
+void AssetLoader::Decode(const Request& Crequest, Result& result) const
+{
+    TRACE_SCOPE("AssetLoader::Decode");
+    SDL_Surface* pSdlSurfaceDecoded{nullptr};
+    for (const std::string& CsPath : Crequest.vectorsPaths)
+    {
+        // The entry is kept in the format the texture was converted to, which depends on its alpha channel
+        for (const SDL_PixelFormat* CpSdlPixelFormat : {&_sdlPixelFormatDisplayAlpha, &_sdlPixelFormatDisplay})
+        {
+            if (_pTextureCache && (result.pSurface = _pTextureCache->Load(CsPath, Crequest.urFitWidth,
+                Crequest.urFitHeight, *CpSdlPixelFormat)) != nullptr)
+            {
+                result.sPath = CsPath;
+                result.bConverted = true;
+                return;
+            }
+        }
+
+        if ((pSdlSurfaceDecoded = IMG_Load(CsPath.c_str())) != nullptr)
+        {
+            result.sPath = CsPath;
+            break;
+        }
+    }
+
+    if (pSdlSurfaceDecoded == nullptr)
+        throw std::ios_base::failure("Error loading " + (Crequest.vectorsPaths.empty() ? std::string{} :
+            Crequest.vectorsPaths.back()) + ": " + IMG_GetError());
+
+    Surface* pSurfaceDecoded{new Surface(pSdlSurfaceDecoded)};
+
+    if (Crequest.urFitWidth > 0 && Crequest.urFitHeight > 0)
+    {
+        uint16_t urScale{static_cast<uint16_t>(std::max(1, std::min(Crequest.urFitWidth /
+            pSurfaceDecoded->GetWidth(), Crequest.urFitHeight / pSurfaceDecoded->GetHeight())))};
+
+        try { if (urScale > 1) pSurfaceDecoded->Scale(urScale, urScale, false); }
+        catch (...)
+        {
+            delete pSurfaceDecoded;
+            throw;
+        }
+    }
+
+    result.pSurface = pSurfaceDecoded;
+}
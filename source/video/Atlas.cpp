@@ -0,0 +1,151 @@
+/*
+Atlas.cpp --- Texture atlas with named sprites
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <ios>
+#include <utility>
+
+#include <SDL_video.h>
+
+#include "../../include/video/Atlas.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+
+
+/**
+ * @brief Loads an atlas from the filesystem
+ *
+ * @param CsImagePath the path to the image of the atlas
+ * @param CsIndexPath the path to the index of the atlas
+ */
+Atlas::Atlas(const std::string& CsImagePath, const std::string& CsIndexPath) : _surfaceAtlas{CsImagePath},
+    _vectorSdlRects{}, _vectorsFiles{}, _vectorSdlRectsFiles{}, _htSprites{}
+{
+    std::ifstream ifstreamIndex{CsIndexPath};
+    if (!ifstreamIndex) throw std::ios_base::failure("Error opening file " + CsIndexPath);
+
+    for (std::string sLine{}; std::getline(ifstreamIndex, sLine);)
+    {
+        if (sLine.empty()) continue;
+
+        std::istringstream issLine{sLine};
+        std::string sName{};
+        int32_t iX{}, iY{}, iWidth{}, iHeight{};
+        if (!(issLine >> sName >> iX >> iY >> iWidth >> iHeight) || iX < 0 || iY < 0 || iWidth <= 0 ||
+            iHeight <= 0 || iX + iWidth > _surfaceAtlas.GetWidth() || iY + iHeight > _surfaceAtlas.GetHeight())
+            throw std::runtime_error("Bad sprite in " + CsIndexPath + ": " + sLine);
+
+        if (!_htSprites.insert(std::make_pair(sName, static_cast<uint16_t>(_vectorSdlRects.size()))).second)
+            throw std::runtime_error("Repeated sprite in " + CsIndexPath + ": " + sName);
+        _vectorSdlRects.push_back(SDL_Rect{static_cast<Sint16>(iX), static_cast<Sint16>(iY),
+            static_cast<Uint16>(iWidth), static_cast<Uint16>(iHeight)});
+
+        // Indexes written by hand may leave out the file of the sprite
+        std::string sFile{};
+        int32_t iFileX{}, iFileY{};
+        if (!(issLine >> sFile >> iFileX >> iFileY) || iFileX < 0 || iFileY < 0)
+        {
+            sFile.clear();
+            iFileX = iFileY = 0;
+        }
+        _vectorsFiles.push_back(sFile);
+        _vectorSdlRectsFiles.push_back(SDL_Rect{static_cast<Sint16>(iFileX), static_cast<Sint16>(iFileY),
+            static_cast<Uint16>(iWidth), static_cast<Uint16>(iHeight)});
+    }
+}
+
+
+/**
+ * @brief Finds a sprite by its name, which is meant to be done once after loading the atlas
+ *
+ * @param CsName the name of the sprite
+ * @return Sprite the sprite, valid for the lifetime of the atlas
+ */
+Atlas::Sprite Atlas::Resolve(const std::string& CsName) const
+{
+    std::unordered_map<std::string, uint16_t>::const_iterator i = _htSprites.find(CsName);
+    if (i == _htSprites.end()) throw std::out_of_range("Sprite " + CsName + " is not in the atlas");
+
+    return Sprite{i->second};
+}
+
+
+/**
+ * @brief Overwrites a sprite with the same rectangle of another copy of the file it was packed from
+ *
+ * @param sprite the sprite
+ * @param surfaceFile the other copy of the file, in the format of the atlas, which loses its blending
+ * @return true if the sprite was overwritten
+ * @return false if the file is too small to hold the sprite where it was packed from
+ */
+bool Atlas::Replace(Sprite sprite, Surface& surfaceFile)
+{
+    SDL_Rect sdlRectFile{_vectorSdlRectsFiles[sprite.urIndex]};
+    SDL_Rect sdlRectAtlas{_vectorSdlRects[sprite.urIndex]};
+    if (sdlRectFile.x + sdlRectFile.w > surfaceFile.GetWidth() ||
+        sdlRectFile.y + sdlRectFile.h > surfaceFile.GetHeight())
+        return false;
+
+    // The pixels are copied as they are, alpha included, instead of being blended over the default sprite
+    if (SDL_SetAlpha(surfaceFile, 0, SDL_ALPHA_OPAQUE) == -1 ||
+        SDL_BlitSurface(surfaceFile, &sdlRectFile, _surfaceAtlas, &sdlRectAtlas) != 0)
+        throw std::runtime_error(SDL_GetError());
+
+    return true;
+}
+
+
+/**
+ * @brief Blits a sprite into another surface
+ *
+ * @param sprite the sprite
+ * @param surfaceDestination the destination surface
+ * @param rDestinationX the X component of the top left coordinate where the sprite will be blitted
+ * @param rDestinationY the Y component of the top left coordinate where the sprite will be blitted
+ */
+void Atlas::OnDraw(Sprite sprite, Surface& surfaceDestination, int16_t rDestinationX, int16_t rDestinationY)
+{
+    const SDL_Rect& CsdlRect{_vectorSdlRects[sprite.urIndex]};
+    _surfaceAtlas.OnDraw(surfaceDestination, rDestinationX, rDestinationY, CsdlRect.x, CsdlRect.y, CsdlRect.w,
+        CsdlRect.h);
+}
+
+
+/**
+ * @brief Records a blit of a sprite on the display
+ *
+ * @param sprite the sprite
+ * @param renderCommandList the list of the frame
+ * @param rDestinationX the X component of the top left coordinate where the sprite will be blitted
+ * @param rDestinationY the Y component of the top left coordinate where the sprite will be blitted
+ */
+void Atlas::OnDraw(Sprite sprite, RenderCommandList& renderCommandList, int16_t rDestinationX,
+    int16_t rDestinationY) const
+{
+    const SDL_Rect& CsdlRect{_vectorSdlRects[sprite.urIndex]};
+    renderCommandList.Blit(_surfaceAtlas, rDestinationX, rDestinationY, CsdlRect.x, CsdlRect.y, CsdlRect.w,
+        CsdlRect.h);
+}
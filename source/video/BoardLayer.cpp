@@ -0,0 +1,311 @@
+/*
+BoardLayer.cpp --- Pre-composited surface of the board
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include <SDL_error.h>
+#include <SDL_mutex.h>
+
+#include "../../include/video/BoardLayer.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+#include "../../include/video/DirtyRects.hpp"
+#include "../../include/video/PieceDrop.hpp"
+#include "../../include/video/Timeline.hpp"
+#include "../../include/Grid.hpp"
+
+
+/**
+ * @brief Construct a new Board Layer
+ *
+ * @param timeline the timeline that plays the falling markers
+ */
+BoardLayer::BoardLayer(Timeline& timeline) : GridListener(), _pSurfaceBoard{nullptr},
+    _pSurfaceBackground{nullptr}, _pSurfaceEmptyCell{nullptr}, _pSurfaceMarker1{nullptr},
+    _pSurfaceMarker2{nullptr}, _rInitialX{0}, _rInitialY{0}, _timeline{timeline}, _vectorpPieceDrops{},
+    _vectorSdlRectsLanded{}, _pSdlMutex{SDL_CreateMutex()}, _vectorpairPendingCells{}, _bIsStale{true}
+{
+    if (_pSdlMutex == nullptr) throw std::runtime_error(SDL_GetError());
+}
+
+
+/**
+ * @brief Destructor
+ */
+BoardLayer::~BoardLayer() noexcept
+{
+    for (PieceDrop* pPieceDrop : _vectorpPieceDrops) delete pPieceDrop;
+    delete _pSurfaceBoard;
+    SDL_DestroyMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Sets the surfaces the board is made of, which forces the board to be composited again
+ *
+ * @param pSurfaceBackground the background of the screen
+ * @param pSurfaceEmptyCell an empty cell
+ * @param pSurfaceMarker1 a cell with a marker of the first player
+ * @param pSurfaceMarker2 a cell with a marker of the second player
+ * @param rInitialX the X coordinate of the top left cell
+ * @param rInitialY the Y coordinate of the top left cell
+ */
+void BoardLayer::SetSurfaces(Surface* pSurfaceBackground, Surface* pSurfaceEmptyCell, Surface* pSurfaceMarker1,
+    Surface* pSurfaceMarker2, int16_t rInitialX, int16_t rInitialY)
+{
+    SDL_LockMutex(_pSdlMutex);
+    _pSurfaceBackground = pSurfaceBackground;
+    _pSurfaceEmptyCell = pSurfaceEmptyCell;
+    _pSurfaceMarker1 = pSurfaceMarker1;
+    _pSurfaceMarker2 = pSurfaceMarker2;
+    _rInitialX = rInitialX;
+    _rInitialY = rInitialY;
+    _bIsStale = true;
+    SDL_UnlockMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Handles a marker being placed on the grid
+ *
+ * @param Cgrid the grid that changed
+ * @param uyRow the row of the new marker
+ * @param uyColumn the column of the new marker
+ */
+void BoardLayer::OnMove(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn)
+{
+    SDL_LockMutex(_pSdlMutex);
+    _vectorpairPendingCells.push_back(std::make_pair(uyRow, uyColumn));
+    SDL_UnlockMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Handles the grid being replaced by another one
+ *
+ * @param Cgrid the grid that changed
+ */
+void BoardLayer::OnReset(const Grid& Cgrid)
+{
+    SDL_LockMutex(_pSdlMutex);
+    _bIsStale = true;
+    SDL_UnlockMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Brings the board up to date
+ *
+ * @param Cgrid the grid that is drawn
+ * @param bDropMarkers true to let the new markers fall before they are composited, false to composite
+ * every marker at once, the falling ones included
+ * @return Surface* the composited board, nullptr if the surfaces were not set
+ */
+Surface* BoardLayer::Update(const Grid& Cgrid, bool bDropMarkers)
+{
+    std::vector<std::pair<uint8_t, uint8_t> > vectorpairCells{};
+
+    SDL_LockMutex(_pSdlMutex);
+    bool bIsStale{_bIsStale};
+    _bIsStale = false;
+    vectorpairCells.swap(_vectorpairPendingCells);
+    SDL_UnlockMutex(_pSdlMutex);
+
+    if (_pSurfaceBackground == nullptr) return nullptr;
+
+    if (bIsStale || _pSurfaceBoard == nullptr)
+    {
+        // The markers falling belong to the previous grid
+        for (PieceDrop* pPieceDrop : _vectorpPieceDrops)
+        {
+            _timeline.SetPlaying(pPieceDrop->GetAnimation(), false);
+            delete pPieceDrop;
+        }
+        _vectorpPieceDrops.clear();
+
+        delete _pSurfaceBoard;
+        _pSurfaceBoard = new Surface(*_pSurfaceBackground);
+
+        for (uint8_t i = 0; i < Cgrid.GetHeight(); ++i)
+            for (uint8_t j = 0; j < Cgrid.GetWidth(); ++j) DrawCell(Cgrid, i, j, true, *_pSurfaceBoard);
+    }
+    else
+    {
+        for (const std::pair<uint8_t, uint8_t>& CpairCell : vectorpairCells)
+        {
+            if (!bDropMarkers)
+            {
+                DrawCell(Cgrid, CpairCell.first, CpairCell.second, true, *_pSurfaceBoard);
+                continue;
+            }
+
+            // A marker still falling down the same column lands at once, or the new one would fall through it
+            Land(Cgrid, false, CpairCell.second);
+
+            SDL_Rect sdlRectCell{GetCellRect(CpairCell.first, CpairCell.second)};
+            PieceDrop* pPieceDrop{new PieceDrop(CpairCell.first, CpairCell.second, _rInitialY, sdlRectCell.y,
+                sdlRectCell.h)};
+            _vectorpPieceDrops.push_back(pPieceDrop);
+            _timeline.SetPlaying(pPieceDrop->GetAnimation(), true);
+        }
+    }
+
+    Land(Cgrid, bDropMarkers);
+
+    return _pSurfaceBoard;
+}
+
+
+/**
+ * @brief Marks the regions of the board changed by the falling markers, which are the columns they fall
+ * down, from the last time they were marked
+ *
+ * @param dirtyRects the regions of the display to redraw
+ */
+void BoardLayer::MarkChanged(DirtyRects& dirtyRects)
+{
+    for (const PieceDrop* CpPieceDrop : _vectorpPieceDrops)
+    {
+        SDL_Rect sdlRectColumn{GetColumnRect(CpPieceDrop->GetRow(), CpPieceDrop->GetColumn())};
+        dirtyRects.Add(sdlRectColumn.x, sdlRectColumn.y, sdlRectColumn.w, sdlRectColumn.h);
+    }
+
+    for (const SDL_Rect& CsdlRectColumn : _vectorSdlRectsLanded)
+        dirtyRects.Add(CsdlRectColumn.x, CsdlRectColumn.y, CsdlRectColumn.w, CsdlRectColumn.h);
+    _vectorSdlRectsLanded.clear();
+}
+
+
+/**
+ * @brief Brings the board up to date, letting the new markers fall, and records a blit of it and of the
+ * falling markers
+ *
+ * @param Cgrid the grid that is drawn
+ * @param renderCommandList the list of the frame
+ */
+void BoardLayer::OnDraw(const Grid& Cgrid, RenderCommandList& renderCommandList)
+{
+    const Surface* CpSurfaceBoard{Update(Cgrid, true)};
+    if (CpSurfaceBoard == nullptr) return;
+
+    renderCommandList.Blit(*CpSurfaceBoard);
+
+    // The falling markers only read their position from the table of their drop
+    for (const PieceDrop* CpPieceDrop : _vectorpPieceDrops)
+    {
+        const Surface* CpSurfaceMarker{Cgrid[CpPieceDrop->GetRow()][CpPieceDrop->GetColumn()] == 
+            Grid::EPlayerMark::PLAYER1 ? _pSurfaceMarker1 : _pSurfaceMarker2};
+        SDL_Rect sdlRectCell{GetCellRect(CpPieceDrop->GetRow(), CpPieceDrop->GetColumn())};
+        renderCommandList.Blit(*CpSurfaceMarker, sdlRectCell.x, CpPieceDrop->GetY());
+    }
+}
+
+
+/**
+ * @brief Gets the region of the screen covered by a cell
+ *
+ * @param uyRow the row of the cell
+ * @param uyColumn the column of the cell
+ * @return SDL_Rect the region of the cell
+ */
+SDL_Rect BoardLayer::GetCellRect(uint8_t uyRow, uint8_t uyColumn) const noexcept
+{
+    uint16_t urWidth = _pSurfaceEmptyCell->GetWidth();
+    uint16_t urHeight = _pSurfaceEmptyCell->GetHeight();
+
+    return SDL_Rect{static_cast<Sint16>(_rInitialX + uyColumn * urWidth),
+        static_cast<Sint16>(_rInitialY + uyRow * urHeight), urWidth, urHeight};
+}
+
+
+/**
+ * @brief Draws one cell as an empty cell or with its marker, straight on a surface
+ *
+ * @param Cgrid the grid that is drawn
+ * @param uyRow the row of the cell
+ * @param uyColumn the column of the cell
+ * @param bShowMarker false to draw the cell empty whatever it holds
+ * @param surfaceDestination the destination surface
+ */
+void BoardLayer::DrawCell(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn, bool bShowMarker,
+    Surface& surfaceDestination) const
+{
+    int16_t rX = _rInitialX + uyColumn * _pSurfaceEmptyCell->GetWidth();
+    int16_t rY = _rInitialY + uyRow * _pSurfaceEmptyCell->GetHeight();
+
+    // The background goes first so the cells are blended as if they were drawn over it
+    _pSurfaceBackground->OnDraw(surfaceDestination, rX, rY, rX, rY, _pSurfaceEmptyCell->GetWidth(),
+        _pSurfaceEmptyCell->GetHeight());
+
+    if (bShowMarker && Cgrid[uyRow][uyColumn] == Grid::EPlayerMark::PLAYER1)
+        _pSurfaceMarker1->OnDraw(surfaceDestination, rX, rY);
+    else if (bShowMarker && Cgrid[uyRow][uyColumn] == Grid::EPlayerMark::PLAYER2)
+        _pSurfaceMarker2->OnDraw(surfaceDestination, rX, rY);
+    else _pSurfaceEmptyCell->OnDraw(surfaceDestination, rX, rY);
+}
+
+
+/**
+ * @brief Gets the region of the screen a marker falls through, from the top of the board to its cell
+ *
+ * @param uyRow the row of the cell of the marker
+ * @param uyColumn the column of the marker
+ * @return SDL_Rect the region of the column
+ */
+SDL_Rect BoardLayer::GetColumnRect(uint8_t uyRow, uint8_t uyColumn) const noexcept
+{
+    SDL_Rect sdlRectCell{GetCellRect(uyRow, uyColumn)};
+
+    return SDL_Rect{sdlRectCell.x, _rInitialY, sdlRectCell.w,
+        static_cast<Uint16>(sdlRectCell.y + sdlRectCell.h - _rInitialY)};
+}
+
+
+/**
+ * @brief Composites the falling markers that reached their cell, or all of them
+ *
+ * @param Cgrid the grid that is drawn
+ * @param bOnlyFinished false to composite every falling marker at once
+ * @param yColumn the only column whose marker is composited, -1 for every column
+ */
+void BoardLayer::Land(const Grid& Cgrid, bool bOnlyFinished, int8_t yColumn)
+{
+    for (std::vector<PieceDrop*>::iterator i = _vectorpPieceDrops.begin(); i != _vectorpPieceDrops.end();)
+    {
+        PieceDrop* pPieceDrop{*i};
+        if ((bOnlyFinished && !pPieceDrop->IsFinished()) ||
+            (yColumn >= 0 && pPieceDrop->GetColumn() != static_cast<uint8_t>(yColumn)))
+        {
+            ++i;
+            continue;
+        }
+
+        // The last frame of the drop is the cell, so the column looks the same once it is composited
+        _timeline.SetPlaying(pPieceDrop->GetAnimation(), false);
+        DrawCell(Cgrid, pPieceDrop->GetRow(), pPieceDrop->GetColumn(), true, *_pSurfaceBoard);
+        _vectorSdlRectsLanded.push_back(GetColumnRect(pPieceDrop->GetRow(), pPieceDrop->GetColumn()));
+
+        delete pPieceDrop;
+        i = _vectorpPieceDrops.erase(i);
+    }
+}
@@ -0,0 +1,143 @@
+/*
+CursorOverlay.cpp --- Pixels saved under the cursor
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+
+#include <SDL_video.h>
+#include <SDL_error.h>
+
+#include "../../include/video/CursorOverlay.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+CursorOverlay::CursorOverlay() noexcept : _asaveds{}, _uyBuffer{0} {}
+
+
+/**
+ * @brief Destructor
+ */
+CursorOverlay::~CursorOverlay() noexcept
+{
+    for (Saved& saved : _asaveds) delete saved.pSurface;
+}
+
+
+/**
+ * @brief Records giving back the pixels under the cursor drawn the last time on the buffer being drawn,
+ * which must be done before anything else is drawn in the frame
+ *
+ * @param renderCommandList the list of the frame
+ * @param CsurfaceDisplay the display surface
+ * @param vectorSdlRectsPresent the regions sent to the screen, which receive the region given back
+ */
+void CursorOverlay::Restore(RenderCommandList& renderCommandList, const Surface& CsurfaceDisplay,
+    std::vector<SDL_Rect>& vectorSdlRectsPresent)
+{
+    Saved& saved{_asaveds[_uyBuffer]};
+    if (!saved.bIsSaved) return;
+
+    renderCommandList.Blit(*saved.pSurface, saved.sdlRect.x, saved.sdlRect.y, 0, 0, saved.sdlRect.w,
+        saved.sdlRect.h);
+    AddClipped(saved.sdlRect, CsurfaceDisplay, vectorSdlRectsPresent);
+    saved.bIsSaved = false;
+}
+
+
+/**
+ * @brief Records saving the pixels under the cursor, which must be done after the rest of the frame is
+ * drawn and right before the cursor
+ *
+ * @param renderCommandList the list of the frame
+ * @param CsdlRectCursor the region where the cursor is drawn
+ * @param CsurfaceDisplay the display surface, whose format the copy takes
+ * @param vectorSdlRectsPresent the regions sent to the screen, which receive the region of the cursor
+ */
+void CursorOverlay::Save(RenderCommandList& renderCommandList, const SDL_Rect& CsdlRectCursor,
+    const Surface& CsurfaceDisplay, std::vector<SDL_Rect>& vectorSdlRectsPresent)
+{
+    Saved& saved{_asaveds[_uyBuffer]};
+
+    if (saved.pSurface == nullptr || saved.pSurface->GetWidth() < CsdlRectCursor.w ||
+        saved.pSurface->GetHeight() < CsdlRectCursor.h)
+    {
+        // Never shrinks, the cursors of every screen end up sharing the copy
+        const SDL_PixelFormat* CpSdlPixelFormat{CsurfaceDisplay.GetPixelFormat()};
+        int32_t iWidth{saved.pSurface ? std::max<int32_t>(saved.pSurface->GetWidth(), CsdlRectCursor.w) :
+            CsdlRectCursor.w};
+        int32_t iHeight{saved.pSurface ? std::max<int32_t>(saved.pSurface->GetHeight(), CsdlRectCursor.h) :
+            CsdlRectCursor.h};
+
+        SDL_Surface* pSdlSurfaceSaved{SDL_CreateRGBSurface(SDL_SWSURFACE, iWidth, iHeight,
+            CpSdlPixelFormat->BitsPerPixel, CpSdlPixelFormat->Rmask, CpSdlPixelFormat->Gmask,
+            CpSdlPixelFormat->Bmask, 0)};
+        if (pSdlSurfaceSaved == nullptr) throw std::runtime_error(SDL_GetError());
+
+        delete saved.pSurface;
+        saved.pSurface = new Surface(pSdlSurfaceSaved);
+    }
+
+    renderCommandList.Save(*saved.pSurface, CsdlRectCursor);
+    AddClipped(CsdlRectCursor, CsurfaceDisplay, vectorSdlRectsPresent);
+    saved.sdlRect = CsdlRectCursor;
+    saved.bIsSaved = true;
+}
+
+
+/**
+ * @brief Starts a new frame
+ *
+ * @param CsurfaceDisplay the display surface
+ * @param bIsPresented whether the frame was sent to the screen, which swaps the buffers of a double
+ * buffered display
+ */
+void CursorOverlay::EndFrame(const Surface& CsurfaceDisplay, bool bIsPresented) noexcept
+{
+    if (bIsPresented && (static_cast<SDL_Surface*>(CsurfaceDisplay)->flags & SDL_DOUBLEBUF) != 0)
+        _uyBuffer ^= 1;
+}
+
+
+/**
+ * @brief Cuts a region to the display
+ *
+ * @param CsdlRect the region
+ * @param CsurfaceDisplay the display surface
+ * @param vectorSdlRects receives the region if any of it is on the display
+ */
+void CursorOverlay::AddClipped(const SDL_Rect& CsdlRect, const Surface& CsurfaceDisplay,
+    std::vector<SDL_Rect>& vectorSdlRects)
+{
+    int32_t iLeft{std::max<int32_t>(CsdlRect.x, 0)};
+    int32_t iTop{std::max<int32_t>(CsdlRect.y, 0)};
+    int32_t iRight{std::min<int32_t>(CsdlRect.x + CsdlRect.w, CsurfaceDisplay.GetWidth())};
+    int32_t iBottom{std::min<int32_t>(CsdlRect.y + CsdlRect.h, CsurfaceDisplay.GetHeight())};
+
+    if (iRight > iLeft && iBottom > iTop)
+        vectorSdlRects.push_back(SDL_Rect{static_cast<Sint16>(iLeft), static_cast<Sint16>(iTop),
+            static_cast<Uint16>(iRight - iLeft), static_cast<Uint16>(iBottom - iTop)});
+}
@@ -0,0 +1,163 @@
+/*
+DirtyRects.cpp --- Tracking of the display regions that changed between frames
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <SDL_video.h>
+
+#include "../../include/video/DirtyRects.hpp"
+#include "../../include/video/Surface.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+DirtyRects::DirtyRects() noexcept : _vectorSdlRectsMarked{}, _vectorSdlRectsPrevious{}, _vectorSdlRects{},
+    _bIsFull{true}, _bWasFull{true} {}
+
+
+/**
+ * @brief Marks a region of the display as changed
+ *
+ * @param iX the X coordinate of the top left corner of the region
+ * @param iY the Y coordinate of the top left corner of the region
+ * @param iWidth the width of the region
+ * @param iHeight the height of the region
+ */
+void DirtyRects::Add(int32_t iX, int32_t iY, int32_t iWidth, int32_t iHeight)
+{
+    if (_bIsFull) return;
+
+    // Regions partially off the top or left of the display are cut, the rest is cut in Prepare
+    if (iX < 0) { iWidth += iX; iX = 0; }
+    if (iY < 0) { iHeight += iY; iY = 0; }
+    if (iWidth <= 0 || iHeight <= 0) return;
+
+    _vectorSdlRectsMarked.push_back(SDL_Rect{static_cast<Sint16>(std::min(iX, INT16_MAX)),
+        static_cast<Sint16>(std::min(iY, INT16_MAX)), static_cast<Uint16>(std::min(iWidth, UINT16_MAX)),
+        static_cast<Uint16>(std::min(iHeight, UINT16_MAX))});
+}
+
+
+/**
+ * @brief Marks the whole display as changed
+ */
+void DirtyRects::Invalidate() noexcept
+{
+    _bIsFull = true;
+    _vectorSdlRectsMarked.clear();
+}
+
+
+/**
+ * @brief Builds the list of regions to redraw in this frame
+ *
+ * @param CsurfaceDisplay the display surface
+ */
+void DirtyRects::Prepare(const Surface& CsurfaceDisplay)
+{
+    const SDL_Rect CsdlRectDisplay{0, 0, static_cast<Uint16>(CsurfaceDisplay.GetWidth()),
+        static_cast<Uint16>(CsurfaceDisplay.GetHeight())};
+    const bool CbIsDoubleBuffered{(static_cast<SDL_Surface*>(CsurfaceDisplay)->flags & SDL_DOUBLEBUF) != 0};
+
+    _vectorSdlRects.clear();
+
+    if (_bIsFull || (CbIsDoubleBuffered && _bWasFull))
+    {
+        _vectorSdlRects.push_back(CsdlRectDisplay);
+        return;
+    }
+
+    _vectorSdlRects = _vectorSdlRectsMarked;
+    if (CbIsDoubleBuffered)
+        _vectorSdlRects.insert(_vectorSdlRects.end(), _vectorSdlRectsPrevious.cbegin(),
+            _vectorSdlRectsPrevious.cend());
+
+    // Cut the regions to the display, dropping the ones that fall outside
+    std::erase_if(_vectorSdlRects, [&CsdlRectDisplay](SDL_Rect& sdlRect)
+    {
+        if (sdlRect.x >= CsdlRectDisplay.w || sdlRect.y >= CsdlRectDisplay.h) return true;
+        sdlRect.w = std::min<int32_t>(sdlRect.w, CsdlRectDisplay.w - sdlRect.x);
+        sdlRect.h = std::min<int32_t>(sdlRect.h, CsdlRectDisplay.h - sdlRect.y);
+        return false;
+    });
+
+    Merge();
+
+    if (_vectorSdlRects.size() > SCuyMaxRects)
+    {
+        _vectorSdlRects.clear();
+        _vectorSdlRects.push_back(CsdlRectDisplay);
+    }
+}
+
+
+/**
+ * @brief Starts a new frame, once the regions of this one were recorded to be sent to the screen
+ */
+void DirtyRects::EndFrame() noexcept
+{
+    _vectorSdlRectsPrevious.swap(_vectorSdlRectsMarked);
+    _vectorSdlRectsMarked.clear();
+    _bWasFull = _bIsFull;
+    _bIsFull = false;
+}
+
+
+/**
+ * @brief Merges every pair of overlapping regions into their bounding box until none overlap
+ */
+void DirtyRects::Merge() noexcept
+{
+    bool bMerged{true};
+    while (bMerged)
+    {
+        bMerged = false;
+        for (std::size_t i = 0; i < _vectorSdlRects.size() && !bMerged; ++i)
+        {
+            for (std::size_t j = i + 1; j < _vectorSdlRects.size() && !bMerged; ++j)
+            {
+                SDL_Rect& sdlRectFirst{_vectorSdlRects[i]};
+                const SDL_Rect& CsdlRectSecond{_vectorSdlRects[j]};
+
+                if (sdlRectFirst.x < CsdlRectSecond.x + CsdlRectSecond.w &&
+                    CsdlRectSecond.x < sdlRectFirst.x + sdlRectFirst.w &&
+                    sdlRectFirst.y < CsdlRectSecond.y + CsdlRectSecond.h &&
+                    CsdlRectSecond.y < sdlRectFirst.y + sdlRectFirst.h)
+                {
+                    int32_t iRight{std::max(sdlRectFirst.x + sdlRectFirst.w,
+                        CsdlRectSecond.x + CsdlRectSecond.w)};
+                    int32_t iBottom{std::max(sdlRectFirst.y + sdlRectFirst.h,
+                        CsdlRectSecond.y + CsdlRectSecond.h)};
+
+                    sdlRectFirst.x = std::min(sdlRectFirst.x, CsdlRectSecond.x);
+                    sdlRectFirst.y = std::min(sdlRectFirst.y, CsdlRectSecond.y);
+                    sdlRectFirst.w = static_cast<Uint16>(iRight - sdlRectFirst.x);
+                    sdlRectFirst.h = static_cast<Uint16>(iBottom - sdlRectFirst.y);
+
+                    _vectorSdlRects.erase(_vectorSdlRects.begin() + j);
+                    bMerged = true;
+                }
+            }
+        }
+    }
+}
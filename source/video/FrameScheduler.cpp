@@ -0,0 +1,67 @@
+/*
+FrameScheduler.cpp --- Frame pacing of the main loop
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+
+#include <SDL_timer.h>
+
+#include "../../include/video/FrameScheduler.hpp"
+
+
+/**
+ * @brief Constructor
+ *
+ * @param urTargetFPS the frames per second to pace the loop to, it must not be 0
+ */
+FrameScheduler::FrameScheduler(uint16_t urTargetFPS) noexcept : _urTargetFPS{urTargetFPS},
+    _uiRunStart{SDL_GetTicks()}, _uiRunFrames{0}, _uiOverruns{0}, _uiLastLateness{0}
+{}
+
+
+/**
+ * @brief Sleeps until the deadline of the next frame, or counts an overrun if it has already passed
+ */
+void FrameScheduler::WaitForNextFrame() noexcept
+{
+    ++_uiRunFrames;
+    uint32_t uiDeadline{_uiRunStart + static_cast<uint32_t>(static_cast<uint64_t>(_uiRunFrames) * 1000 /
+        _urTargetFPS)};
+    uint32_t uiTime{SDL_GetTicks()};
+
+    // Compared as a difference so the wrap of the tick counter does not matter
+    int32_t iRemaining{static_cast<int32_t>(uiDeadline - uiTime)};
+    if (iRemaining > 0) SDL_Delay(static_cast<uint32_t>(iRemaining));
+    else if (iRemaining < 0)
+    {
+        ++_uiOverruns;
+        _uiLastLateness = static_cast<uint32_t>(-iRemaining);
+        Resync();
+    }
+}
+
+
+/**
+ * @brief Starts a new run of frames from now, after the loop has been blocked waiting for events
+ */
+void FrameScheduler::Resync() noexcept
+{
+    _uiRunStart = SDL_GetTicks();
+    _uiRunFrames = 0;
+}
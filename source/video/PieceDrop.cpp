@@ -0,0 +1,69 @@
+/*
+PieceDrop.cpp --- Trajectory of a marker falling down a column
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <array>
+
+#include "../../include/video/PieceDrop.hpp"
+#include "../../include/video/Animation.hpp"
+
+
+/**
+ * @brief Construct a new Piece Drop, working out its trajectory
+ *
+ * @param uyRow the row of the cell of the marker
+ * @param uyColumn the column of the marker
+ * @param rStartY the Y coordinate the marker falls from
+ * @param rEndY the Y coordinate of the cell of the marker
+ * @param urCellHeight the height of a cell, which sets the gravity so every board falls alike
+ */
+PieceDrop::PieceDrop(uint8_t uyRow, uint8_t uyColumn, int16_t rStartY, int16_t rEndY,
+    uint16_t urCellHeight) noexcept : _uyRow{uyRow}, _uyColumn{uyColumn}, _uyFrames{0}, _arY{},
+    _animation{1, SCurFrameInterval, false, 1, false}
+{
+    // Distances in pixels and speeds in pixels per frame, the gravity pulls a marker down a six row board
+    // in about ten frames
+    const float CfDistance{static_cast<float>(rEndY - rStartY)};
+    const float CfGravity{urCellHeight * 0.12f};
+    const float CfBounce{0.3f};     // The share of the speed kept after hitting the cell below
+    float fY{0.0f}, fSpeed{0.0f};
+    uint8_t uyBounces{2};
+
+    // The last frame is always the cell, even if the table is too short for the whole fall
+    _arY[_uyFrames++] = rStartY;
+    while (_uyFrames < SCuyMaxFrames - 1)
+    {
+        fSpeed += CfGravity;
+        fY += fSpeed;
+
+        if (fY >= CfDistance)
+        {
+            // Bounces too small to be seen are not played
+            fSpeed *= -CfBounce;
+            if (uyBounces-- == 0 || -fSpeed < CfGravity) break;
+            fY = CfDistance;
+        }
+
+        _arY[_uyFrames++] = static_cast<int16_t>(rStartY + static_cast<int16_t>(fY));
+    }
+    _arY[_uyFrames++] = rEndY;
+
+    _animation.SetMaxFrames(_uyFrames);
+}
@@ -0,0 +1,386 @@
+/*
+PixelBlend.cpp --- Blending of premultiplied-alpha pixel buffers
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+#include "../../include/video/PixelBlend.hpp"
+
+
+namespace
+{
+    /**
+     * @brief Divides by 255 with rounding, exact for every product of two components
+     *
+     * @param uiValue the value, up to 255 * 255
+     * @return uint32_t the quotient
+     */
+    inline uint32_t Divide255(uint32_t uiValue) noexcept
+    {
+        uiValue += 128;
+        return (uiValue + (uiValue >> 8)) >> 8;
+    }
+
+
+    /**
+     * @brief Multiplies the four bytes of a pixel by a factor and divides them by 255, two bytes at a time
+     * with each one in its own 16-bit lane
+     *
+     * @param uiPixel the pixel
+     * @param uiFactor the factor, from 0 to 255
+     * @return uint32_t the scaled pixel
+     */
+    inline uint32_t ScaleBytes(uint32_t uiPixel, uint32_t uiFactor) noexcept
+    {
+        uint32_t uiEven{(uiPixel & 0x00FF00FFu) * uiFactor + 0x00800080u};
+        uint32_t uiOdd{((uiPixel >> 8) & 0x00FF00FFu) * uiFactor + 0x00800080u};
+
+        uiEven = ((uiEven + ((uiEven >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        uiOdd = (uiOdd + ((uiOdd >> 8) & 0x00FF00FFu)) & 0xFF00FF00u;
+
+        return uiEven | uiOdd;
+    }
+
+
+    /**
+     * @brief Blends one premultiplied pixel over another one, adding byte by byte so a carry never reaches
+     * the next component
+     *
+     * @param uiSource the source pixel
+     * @param uiDestination the destination pixel
+     * @param uiAlpha the alpha of the source
+     * @return uint32_t the blended pixel
+     */
+    inline uint32_t BlendPixel(uint32_t uiSource, uint32_t uiDestination, uint32_t uiAlpha) noexcept
+    {
+        uint32_t uiScaled{ScaleBytes(uiDestination, 255 - uiAlpha)};
+        return (((uiSource & 0x00FF00FFu) + (uiScaled & 0x00FF00FFu)) & 0x00FF00FFu) |
+            (((uiSource & 0xFF00FF00u) + (uiScaled & 0xFF00FF00u)) & 0xFF00FF00u);
+    }
+
+
+    /**
+     * @brief Blends a row one pixel at a time
+     *
+     * @param CpuiSource the first pixel of the source row
+     * @param puiDestination the first pixel of the destination row
+     * @param uiWidth the width in pixels of the row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     */
+    void BlendRowScalar(const uint32_t* CpuiSource, uint32_t* puiDestination, uint32_t uiWidth,
+        uint8_t uyAlphaShift) noexcept
+    {
+        for (uint32_t i = 0; i < uiWidth; ++i)
+        {
+            uint32_t uiAlpha{(CpuiSource[i] >> uyAlphaShift) & 0xFF};
+            if (uiAlpha == 0) continue;
+
+            puiDestination[i] = (uiAlpha == 255 ? CpuiSource[i] :
+                BlendPixel(CpuiSource[i], puiDestination[i], uiAlpha));
+        }
+    }
+
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    /**
+     * @brief Blends a row four pixels at a time with vector instructions. Groups that are fully transparent
+     * are skipped and fully opaque ones are copied, which is what most of a sprite is, and the remaining
+     * pixels are done one at a time
+     *
+     * @param CpuiSource the first pixel of the source row
+     * @param puiDestination the first pixel of the destination row
+     * @param uiWidth the width in pixels of the row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     */
+    void BlendRow32(const uint32_t* CpuiSource, uint32_t* puiDestination, uint32_t uiWidth,
+        uint8_t uyAlphaShift) noexcept
+    {
+        uint32_t i{0};
+
+    #if defined(__SSE2__)
+        const __m128i Cm128iZero{_mm_setzero_si128()};
+        const __m128i Cm128iMask{_mm_set1_epi32(0xFF)};
+        const __m128i Cm128iOnes{_mm_set1_epi32(-1)};
+        const __m128i Cm128iRound{_mm_set1_epi16(128)};
+        const __m128i Cm128iShift{_mm_cvtsi32_si128(uyAlphaShift)};
+
+        for (; i + 4 <= uiWidth; i += 4)
+        {
+            __m128i m128iSource{_mm_loadu_si128(reinterpret_cast<const __m128i*>(CpuiSource + i))};
+            __m128i m128iAlpha{_mm_and_si128(_mm_srl_epi32(m128iSource, Cm128iShift), Cm128iMask)};
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(m128iAlpha, Cm128iZero)) == 0xFFFF) continue;
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(m128iAlpha, Cm128iMask)) == 0xFFFF)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(puiDestination + i), m128iSource);
+                continue;
+            }
+
+            // The alpha is copied into the four bytes of its pixel and inverted, 255 - a being ~a
+            __m128i m128iInverse{_mm_or_si128(m128iAlpha, _mm_slli_epi32(m128iAlpha, 8))};
+            m128iInverse = _mm_or_si128(m128iInverse, _mm_slli_epi32(m128iInverse, 16));
+            m128iInverse = _mm_xor_si128(m128iInverse, Cm128iOnes);
+
+            __m128i m128iDestination{_mm_loadu_si128(reinterpret_cast<const __m128i*>(puiDestination + i))};
+            __m128i m128iLow{_mm_mullo_epi16(_mm_unpacklo_epi8(m128iDestination, Cm128iZero),
+                _mm_unpacklo_epi8(m128iInverse, Cm128iZero))};
+            __m128i m128iHigh{_mm_mullo_epi16(_mm_unpackhi_epi8(m128iDestination, Cm128iZero),
+                _mm_unpackhi_epi8(m128iInverse, Cm128iZero))};
+
+            m128iLow = _mm_add_epi16(m128iLow, Cm128iRound);
+            m128iLow = _mm_srli_epi16(_mm_add_epi16(m128iLow, _mm_srli_epi16(m128iLow, 8)), 8);
+            m128iHigh = _mm_add_epi16(m128iHigh, Cm128iRound);
+            m128iHigh = _mm_srli_epi16(_mm_add_epi16(m128iHigh, _mm_srli_epi16(m128iHigh, 8)), 8);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(puiDestination + i),
+                _mm_add_epi8(_mm_packus_epi16(m128iLow, m128iHigh), m128iSource));
+        }
+    #else
+        const uint32x4_t Cu32x4Mask{vdupq_n_u32(0xFF)};
+        const uint16x8_t Cu16x8Round{vdupq_n_u16(128)};
+        const int32x4_t Ci32x4Shift{vdupq_n_s32(-static_cast<int32_t>(uyAlphaShift))};
+
+        for (; i + 4 <= uiWidth; i += 4)
+        {
+            uint32x4_t u32x4Source{vld1q_u32(CpuiSource + i)};
+            uint32x4_t u32x4Alpha{vandq_u32(vshlq_u32(u32x4Source, Ci32x4Shift), Cu32x4Mask)};
+
+            // Pairwise maximum and minimum, as the reductions across the vector only exist on AArch64
+            uint32x2_t u32x2Max{vpmax_u32(vget_low_u32(u32x4Alpha), vget_high_u32(u32x4Alpha))};
+            uint32x2_t u32x2Min{vpmin_u32(vget_low_u32(u32x4Alpha), vget_high_u32(u32x4Alpha))};
+            if (vget_lane_u32(vpmax_u32(u32x2Max, u32x2Max), 0) == 0) continue;
+            if (vget_lane_u32(vpmin_u32(u32x2Min, u32x2Min), 0) == 255)
+            {
+                vst1q_u32(puiDestination + i, u32x4Source);
+                continue;
+            }
+
+            uint8x16_t u8x16Inverse{vreinterpretq_u8_u32(vmvnq_u32(vmulq_n_u32(u32x4Alpha, 0x01010101u)))};
+            uint8x16_t u8x16Destination{vreinterpretq_u8_u32(vld1q_u32(puiDestination + i))};
+
+            uint16x8_t u16x8Low{vmull_u8(vget_low_u8(u8x16Destination), vget_low_u8(u8x16Inverse))};
+            uint16x8_t u16x8High{vmull_u8(vget_high_u8(u8x16Destination), vget_high_u8(u8x16Inverse))};
+
+            u16x8Low = vaddq_u16(u16x8Low, Cu16x8Round);
+            u16x8Low = vaddq_u16(u16x8Low, vshrq_n_u16(u16x8Low, 8));
+            u16x8High = vaddq_u16(u16x8High, Cu16x8Round);
+            u16x8High = vaddq_u16(u16x8High, vshrq_n_u16(u16x8High, 8));
+
+            uint8x16_t u8x16Blended{vcombine_u8(vshrn_n_u16(u16x8Low, 8), vshrn_n_u16(u16x8High, 8))};
+            vst1q_u32(puiDestination + i,
+                vreinterpretq_u32_u8(vaddq_u8(u8x16Blended, vreinterpretq_u8_u32(u32x4Source))));
+        }
+    #endif
+
+        BlendRowScalar(CpuiSource + i, puiDestination + i, uiWidth - i, uyAlphaShift);
+    }
+#endif
+
+
+    /**
+     * @brief Blends a buffer row by row
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the blended region
+     * @param uiHeight the height in pixels of the blended region
+     * @param pDestination the first pixel of the destination
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+     * @param bVector true to blend the rows with vector instructions if there are any
+     */
+    void Blend(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+        void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift, bool bVector) noexcept
+    {
+        const uint8_t* CpuySource{static_cast<const uint8_t*>(CpSource)};
+        uint8_t* puyDestination{static_cast<uint8_t*>(pDestination)};
+
+        for (uint32_t i = 0; i < uiHeight; ++i)
+        {
+            const uint32_t* CpuiSourceRow{reinterpret_cast<const uint32_t*>(CpuySource +
+                static_cast<std::size_t>(i) * uiSourcePitch)};
+            uint32_t* puiDestinationRow{reinterpret_cast<uint32_t*>(puyDestination +
+                static_cast<std::size_t>(i) * uiDestinationPitch)};
+
+        #if defined(__SSE2__) || defined(__ARM_NEON)
+            if (bVector) BlendRow32(CpuiSourceRow, puiDestinationRow, uiWidth, uyAlphaShift);
+            else
+        #endif
+            BlendRowScalar(CpuiSourceRow, puiDestinationRow, uiWidth, uyAlphaShift);
+        }
+    }
+}
+
+
+/**
+ * @brief Multiplies the colour components of a 32-bit buffer by their alpha, in place
+ *
+ * @param pPixels the first pixel of the buffer
+ * @param uiPitch the length in bytes of a row
+ * @param uiWidth the width in pixels of the buffer
+ * @param uiHeight the height in pixels of the buffer
+ * @param uyAlphaShift the shift of the alpha component inside the pixel value
+ */
+void PixelBlend::Premultiply(void* pPixels, uint32_t uiPitch, uint32_t uiWidth, uint32_t uiHeight,
+    uint8_t uyAlphaShift) noexcept
+{
+    const uint32_t CuiAlphaMask{0xFFu << uyAlphaShift};
+    uint8_t* puyPixels{static_cast<uint8_t*>(pPixels)};
+
+    for (uint32_t i = 0; i < uiHeight; ++i)
+    {
+        uint32_t* puiRow{reinterpret_cast<uint32_t*>(puyPixels + static_cast<std::size_t>(i) * uiPitch)};
+        for (uint32_t j = 0; j < uiWidth; ++j)
+        {
+            uint32_t uiAlpha{(puiRow[j] >> uyAlphaShift) & 0xFF};
+            if (uiAlpha != 255)
+                puiRow[j] = (ScaleBytes(puiRow[j], uiAlpha) & ~CuiAlphaMask) | (puiRow[j] & CuiAlphaMask);
+        }
+    }
+}
+
+
+/**
+ * @brief Blends a premultiplied 32-bit buffer over a 32-bit buffer with the same colour components, with the
+ * fastest path available
+ *
+ * @param CpSource the first pixel of the source
+ * @param uiSourcePitch the length in bytes of a source row
+ * @param uiWidth the width in pixels of the blended region
+ * @param uiHeight the height in pixels of the blended region
+ * @param pDestination the first pixel of the destination
+ * @param uiDestinationPitch the length in bytes of a destination row
+ * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+ */
+void PixelBlend::BlendOver(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+    void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift) noexcept
+{ Blend(CpSource, uiSourcePitch, uiWidth, uiHeight, pDestination, uiDestinationPitch, uyAlphaShift, true); }
+
+
+/**
+ * @brief Blends a premultiplied 32-bit buffer over a 32-bit buffer without vector instructions, which gives
+ * the same result as BlendOver
+ *
+ * @param CpSource the first pixel of the source
+ * @param uiSourcePitch the length in bytes of a source row
+ * @param uiWidth the width in pixels of the blended region
+ * @param uiHeight the height in pixels of the blended region
+ * @param pDestination the first pixel of the destination
+ * @param uiDestinationPitch the length in bytes of a destination row
+ * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+ */
+void PixelBlend::BlendOverScalar(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth,
+    uint32_t uiHeight, void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift) noexcept
+{ Blend(CpSource, uiSourcePitch, uiWidth, uiHeight, pDestination, uiDestinationPitch, uyAlphaShift, false); }
+
+
+/**
+ * @brief Blends a premultiplied 32-bit buffer over a 16-bit RGB565 buffer, widening every destination
+ * component to 8 bits and dropping the low bits of the result, as SDL does
+ *
+ * @param CpSource the first pixel of the source
+ * @param uiSourcePitch the length in bytes of a source row
+ * @param uiWidth the width in pixels of the blended region
+ * @param uiHeight the height in pixels of the blended region
+ * @param pDestination the first pixel of the destination
+ * @param uiDestinationPitch the length in bytes of a destination row
+ * @param uyAlphaShift the shift of the alpha component inside the source pixel value
+ * @param uyRedShift the shift of the red component inside the source pixel value
+ * @param uyGreenShift the shift of the green component inside the source pixel value
+ * @param uyBlueShift the shift of the blue component inside the source pixel value
+ */
+void PixelBlend::BlendOver565(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+    void* pDestination, uint32_t uiDestinationPitch, uint8_t uyAlphaShift, uint8_t uyRedShift,
+    uint8_t uyGreenShift, uint8_t uyBlueShift) noexcept
+{
+    const uint8_t* CpuySource{static_cast<const uint8_t*>(CpSource)};
+    uint8_t* puyDestination{static_cast<uint8_t*>(pDestination)};
+
+    for (uint32_t i = 0; i < uiHeight; ++i)
+    {
+        const uint32_t* CpuiSourceRow{reinterpret_cast<const uint32_t*>(CpuySource +
+            static_cast<std::size_t>(i) * uiSourcePitch)};
+        uint16_t* purDestinationRow{reinterpret_cast<uint16_t*>(puyDestination +
+            static_cast<std::size_t>(i) * uiDestinationPitch)};
+
+        for (uint32_t j = 0; j < uiWidth; ++j)
+        {
+            uint32_t uiSource{CpuiSourceRow[j]};
+            uint32_t uiAlpha{(uiSource >> uyAlphaShift) & 0xFF};
+            if (uiAlpha == 0) continue;
+
+            uint32_t uiRed{(uiSource >> uyRedShift) & 0xFF};
+            uint32_t uiGreen{(uiSource >> uyGreenShift) & 0xFF};
+            uint32_t uiBlue{(uiSource >> uyBlueShift) & 0xFF};
+
+            if (uiAlpha != 255)
+            {
+                // Every component is widened repeating its high bits, so white stays white
+                uint32_t uiDestination{purDestinationRow[j]};
+                uint32_t uiInverse{255 - uiAlpha};
+                uint32_t uiDestinationRed{((uiDestination >> 8) & 0xF8) | (uiDestination >> 13)};
+                uint32_t uiDestinationGreen{((uiDestination >> 3) & 0xFC) | ((uiDestination >> 9) & 0x03)};
+                uint32_t uiDestinationBlue{((uiDestination << 3) & 0xF8) | ((uiDestination >> 2) & 0x07)};
+
+                uiRed += Divide255(uiDestinationRed * uiInverse);
+                uiGreen += Divide255(uiDestinationGreen * uiInverse);
+                uiBlue += Divide255(uiDestinationBlue * uiInverse);
+            }
+
+            purDestinationRow[j] = static_cast<uint16_t>((uiRed & 0xF8) << 8 | (uiGreen & 0xFC) << 3 |
+                uiBlue >> 3);
+        }
+    }
+}
+
+
+/**
+ * @brief Blends one premultiplied component over another one
+ *
+ * @param uySource the source component, already multiplied by its alpha
+ * @param uyDestination the destination component
+ * @param uyAlpha the alpha of the source
+ * @return uint8_t the blended component
+ */
+uint8_t PixelBlend::BlendComponent(uint8_t uySource, uint8_t uyDestination, uint8_t uyAlpha) noexcept
+{ return static_cast<uint8_t>(uySource + Divide255(uyDestination * (255u - uyAlpha))); }
+
+
+/**
+ * @brief Gets the name of the vector instructions used by BlendOver
+ *
+ * @return const char* "SSE2", "NEON" or "scalar"
+ */
+const char* PixelBlend::GetPath() noexcept
+{
+#if defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
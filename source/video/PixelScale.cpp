@@ -0,0 +1,355 @@
+/*
+PixelScale.cpp --- Nearest-neighbour scaling of raw pixel buffers
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+#include "../../include/video/PixelScale.hpp"
+
+
+namespace
+{
+    /**
+     * @brief Expands a row copying every pixel urScaleX times, one pixel at a time
+     *
+     * @param CpuySource the first pixel of the source row
+     * @param puyDestination the first pixel of the destination row
+     * @param uiWidth the width in pixels of the source row
+     * @param uyBytesPerPixel the size of a pixel
+     * @param urScaleX the scale factor for the X axis
+     */
+    void ExpandRowScalar(const uint8_t* CpuySource, uint8_t* puyDestination, uint32_t uiWidth,
+        uint8_t uyBytesPerPixel, uint16_t urScaleX)
+    {
+        switch (uyBytesPerPixel)
+        {
+        case 1:
+            for (uint32_t i = 0; i < uiWidth; ++i)
+                std::memset(puyDestination + i * urScaleX, CpuySource[i], urScaleX);
+            break;
+        case 2:
+        {
+            const uint16_t* CpurSource{reinterpret_cast<const uint16_t*>(CpuySource)};
+            uint16_t* purDestination{reinterpret_cast<uint16_t*>(puyDestination)};
+            for (uint32_t i = 0; i < uiWidth; ++i)
+                std::fill_n(purDestination + i * urScaleX, urScaleX, CpurSource[i]);
+            break;
+        }
+        case 3:
+            for (uint32_t i = 0; i < uiWidth; ++i)
+                for (uint16_t j = 0; j < urScaleX; ++j)
+                    std::memcpy(puyDestination + (i * urScaleX + j) * 3, CpuySource + i * 3, 3);
+            break;
+        case 4:
+        {
+            const uint32_t* CpuiSource{reinterpret_cast<const uint32_t*>(CpuySource)};
+            uint32_t* puiDestination{reinterpret_cast<uint32_t*>(puyDestination)};
+            for (uint32_t i = 0; i < uiWidth; ++i)
+                std::fill_n(puiDestination + i * urScaleX, urScaleX, CpuiSource[i]);
+            break;
+        }
+        default: break;
+        }
+    }
+
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    /**
+     * @brief Tells whether the vector expansion of a row beats the scalar one. Measured with the scale
+     * benchmark on 48 pixel cells: 16-bit pixels only gain when doubling, quadrupling or from a factor of 8,
+     * and 32-bit pixels at every factor but 3, where the overlapping stores cost more than they save
+     *
+     * @param uyBytesPerPixel the size of a pixel
+     * @param urScaleX the scale factor for the X axis
+     * @return true if the row should be expanded with vector instructions
+     */
+    bool IsVectorFaster(uint8_t uyBytesPerPixel, uint16_t urScaleX) noexcept
+    {
+        switch (uyBytesPerPixel)
+        {
+        case 2: return urScaleX == 2 || urScaleX == 4 || urScaleX >= 8;
+        case 4: return urScaleX == 2 || urScaleX >= 4;
+        default: return false;
+        }
+    }
+
+
+    /**
+     * @brief Expands a row of 16-bit pixels with vector instructions. Doubling interleaves the pixels with
+     * themselves, large factors store one broadcast pixel per block and the rest is done one pixel at a time
+     *
+     * @param CpurSource the first pixel of the source row
+     * @param purDestination the first pixel of the destination row
+     * @param uiWidth the width in pixels of the source row
+     * @param urScaleX the scale factor for the X axis
+     */
+    void ExpandRow16(const uint16_t* CpurSource, uint16_t* purDestination, uint32_t uiWidth, uint16_t urScaleX)
+    {
+        uint32_t i{0};
+
+        if (urScaleX == 2 || urScaleX == 4)
+        {
+            for (; i + 8 <= uiWidth; i += 8)
+            {
+                uint16_t* purBlock{purDestination + i * urScaleX};
+            #if defined(__SSE2__)
+                __m128i m128iPixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(CpurSource + i))};
+                __m128i m128iLow{_mm_unpacklo_epi16(m128iPixels, m128iPixels)};
+                __m128i m128iHigh{_mm_unpackhi_epi16(m128iPixels, m128iPixels)};
+                if (urScaleX == 2)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock), m128iLow);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + 8), m128iHigh);
+                }
+                else
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock),
+                        _mm_unpacklo_epi32(m128iLow, m128iLow));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + 8),
+                        _mm_unpackhi_epi32(m128iLow, m128iLow));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + 16),
+                        _mm_unpacklo_epi32(m128iHigh, m128iHigh));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + 24),
+                        _mm_unpackhi_epi32(m128iHigh, m128iHigh));
+                }
+            #else
+                uint16x8_t u16x8Pixels{vld1q_u16(CpurSource + i)};
+                uint16x8x2_t u16x8x2Doubled{vzipq_u16(u16x8Pixels, u16x8Pixels)};
+                if (urScaleX == 2)
+                {
+                    vst1q_u16(purBlock, u16x8x2Doubled.val[0]);
+                    vst1q_u16(purBlock + 8, u16x8x2Doubled.val[1]);
+                }
+                else
+                {
+                    uint16x8x2_t u16x8x2Low{vzipq_u16(u16x8x2Doubled.val[0], u16x8x2Doubled.val[0])};
+                    uint16x8x2_t u16x8x2High{vzipq_u16(u16x8x2Doubled.val[1], u16x8x2Doubled.val[1])};
+                    vst1q_u16(purBlock, u16x8x2Low.val[0]);
+                    vst1q_u16(purBlock + 8, u16x8x2Low.val[1]);
+                    vst1q_u16(purBlock + 16, u16x8x2High.val[0]);
+                    vst1q_u16(purBlock + 24, u16x8x2High.val[1]);
+                }
+            #endif
+            }
+        }
+        else if (urScaleX >= 8)
+        {
+            for (; i < uiWidth; ++i)
+            {
+                uint16_t* purBlock{purDestination + i * urScaleX};
+            #if defined(__SSE2__)
+                __m128i m128iPixel{_mm_set1_epi16(static_cast<int16_t>(CpurSource[i]))};
+                uint16_t j{0};
+                for (; j + 8 <= urScaleX; j += 8)
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + j), m128iPixel);
+                if (j < urScaleX)   // The last store overlaps the previous one instead of leaving the block
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(purBlock + urScaleX - 8), m128iPixel);
+            #else
+                uint16x8_t u16x8Pixel{vdupq_n_u16(CpurSource[i])};
+                uint16_t j{0};
+                for (; j + 8 <= urScaleX; j += 8) vst1q_u16(purBlock + j, u16x8Pixel);
+                if (j < urScaleX) vst1q_u16(purBlock + urScaleX - 8, u16x8Pixel);
+            #endif
+            }
+        }
+
+        for (; i < uiWidth; ++i) std::fill_n(purDestination + i * urScaleX, urScaleX, CpurSource[i]);
+    }
+
+
+    /**
+     * @brief Expands a row of 32-bit pixels with vector instructions. Doubling interleaves the pixels with
+     * themselves, large factors store one broadcast pixel per block and the rest is done one pixel at a time
+     *
+     * @param CpuiSource the first pixel of the source row
+     * @param puiDestination the first pixel of the destination row
+     * @param uiWidth the width in pixels of the source row
+     * @param urScaleX the scale factor for the X axis
+     */
+    void ExpandRow32(const uint32_t* CpuiSource, uint32_t* puiDestination, uint32_t uiWidth, uint16_t urScaleX)
+    {
+        uint32_t i{0};
+
+        if (urScaleX == 2)
+        {
+            for (; i + 4 <= uiWidth; i += 4)
+            {
+            #if defined(__SSE2__)
+                __m128i m128iPixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(CpuiSource + i))};
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(puiDestination + 2 * i),
+                    _mm_unpacklo_epi32(m128iPixels, m128iPixels));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(puiDestination + 2 * i + 4),
+                    _mm_unpackhi_epi32(m128iPixels, m128iPixels));
+            #else
+                uint32x4_t u32x4Pixels{vld1q_u32(CpuiSource + i)};
+                uint32x4x2_t u32x4x2Doubled{vzipq_u32(u32x4Pixels, u32x4Pixels)};
+                vst1q_u32(puiDestination + 2 * i, u32x4x2Doubled.val[0]);
+                vst1q_u32(puiDestination + 2 * i + 4, u32x4x2Doubled.val[1]);
+            #endif
+            }
+        }
+        else if (urScaleX >= 4)
+        {
+            for (; i < uiWidth; ++i)
+            {
+                uint32_t* puiBlock{puiDestination + i * urScaleX};
+            #if defined(__SSE2__)
+                __m128i m128iPixel{_mm_set1_epi32(static_cast<int32_t>(CpuiSource[i]))};
+                uint16_t j{0};
+                for (; j + 4 <= urScaleX; j += 4)
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(puiBlock + j), m128iPixel);
+                if (j < urScaleX)   // The last store overlaps the previous one instead of leaving the block
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(puiBlock + urScaleX - 4), m128iPixel);
+            #else
+                uint32x4_t u32x4Pixel{vdupq_n_u32(CpuiSource[i])};
+                uint16_t j{0};
+                for (; j + 4 <= urScaleX; j += 4) vst1q_u32(puiBlock + j, u32x4Pixel);
+                if (j < urScaleX) vst1q_u32(puiBlock + urScaleX - 4, u32x4Pixel);
+            #endif
+            }
+        }
+
+        for (; i < uiWidth; ++i) std::fill_n(puiDestination + i * urScaleX, urScaleX, CpuiSource[i]);
+    }
+#endif
+
+
+    /**
+     * @brief Upscales a buffer expanding each source row once and copying it into the rest of its block
+     *
+     * @param CpSource the first pixel of the source
+     * @param uiSourcePitch the length in bytes of a source row
+     * @param uiWidth the width in pixels of the source
+     * @param uiHeight the height in pixels of the source
+     * @param pDestination the first pixel of the destination
+     * @param uiDestinationPitch the length in bytes of a destination row
+     * @param uyBytesPerPixel the size of a pixel, from 1 to 4 bytes
+     * @param urScaleX the scale factor for the X axis
+     * @param urScaleY the scale factor for the Y axis
+     * @param bVector true to expand the rows with vector instructions if there are any and they are faster
+     */
+    void Scale(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+        void* pDestination, uint32_t uiDestinationPitch, uint8_t uyBytesPerPixel, uint16_t urScaleX,
+        uint16_t urScaleY, bool bVector)
+    {
+        if (uyBytesPerPixel < 1 || uyBytesPerPixel > 4) throw std::invalid_argument("Unknown bytes per pixel");
+        if (urScaleX == 0 || urScaleY == 0) throw std::invalid_argument("Scale factor is zero");
+
+        const uint8_t* CpuySource{static_cast<const uint8_t*>(CpSource)};
+        uint8_t* puyDestination{static_cast<uint8_t*>(pDestination)};
+        std::size_t uRowSize{static_cast<std::size_t>(uiWidth) * urScaleX * uyBytesPerPixel};
+    #if defined(__SSE2__) || defined(__ARM_NEON)
+        const bool CbVectorRow{bVector && IsVectorFaster(uyBytesPerPixel, urScaleX)};
+    #endif
+
+        for (uint32_t i = 0; i < uiHeight; ++i)
+        {
+            const uint8_t* CpuySourceRow{CpuySource + static_cast<std::size_t>(i) * uiSourcePitch};
+            uint8_t* puyDestinationRow{puyDestination +
+                static_cast<std::size_t>(i) * urScaleY * uiDestinationPitch};
+
+            if (urScaleX == 1) std::memcpy(puyDestinationRow, CpuySourceRow, uRowSize);
+        #if defined(__SSE2__) || defined(__ARM_NEON)
+            else if (CbVectorRow && uyBytesPerPixel == 2)
+                ExpandRow16(reinterpret_cast<const uint16_t*>(CpuySourceRow),
+                    reinterpret_cast<uint16_t*>(puyDestinationRow), uiWidth, urScaleX);
+            else if (CbVectorRow && uyBytesPerPixel == 4)
+                ExpandRow32(reinterpret_cast<const uint32_t*>(CpuySourceRow),
+                    reinterpret_cast<uint32_t*>(puyDestinationRow), uiWidth, urScaleX);
+        #endif
+            else ExpandRowScalar(CpuySourceRow, puyDestinationRow, uiWidth, uyBytesPerPixel, urScaleX);
+
+            for (uint16_t j = 1; j < urScaleY; ++j)  // The other rows of the block are the same
+                std::memcpy(puyDestinationRow + j * uiDestinationPitch, puyDestinationRow, uRowSize);
+        }
+    }
+}
+
+
+/**
+ * @brief Upscales a buffer with the fastest path available
+ *
+ * @param CpSource the first pixel of the source
+ * @param uiSourcePitch the length in bytes of a source row
+ * @param uiWidth the width in pixels of the source
+ * @param uiHeight the height in pixels of the source
+ * @param pDestination the first pixel of the destination, of at least uiWidth * urScaleX by
+ * uiHeight * urScaleY pixels
+ * @param uiDestinationPitch the length in bytes of a destination row
+ * @param uyBytesPerPixel the size of a pixel, from 1 to 4 bytes
+ * @param urScaleX the scale factor for the X axis
+ * @param urScaleY the scale factor for the Y axis
+ */
+void PixelScale::ScaleNearest(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth, uint32_t uiHeight,
+    void* pDestination, uint32_t uiDestinationPitch, uint8_t uyBytesPerPixel, uint16_t urScaleX,
+    uint16_t urScaleY)
+{
+    Scale(CpSource, uiSourcePitch, uiWidth, uiHeight, pDestination, uiDestinationPitch, uyBytesPerPixel,
+        urScaleX, urScaleY, true);
+}
+
+
+/**
+ * @brief Upscales a buffer without vector instructions, which gives the same result as ScaleNearest
+ *
+ * @param CpSource the first pixel of the source
+ * @param uiSourcePitch the length in bytes of a source row
+ * @param uiWidth the width in pixels of the source
+ * @param uiHeight the height in pixels of the source
+ * @param pDestination the first pixel of the destination, of at least uiWidth * urScaleX by
+ * uiHeight * urScaleY pixels
+ * @param uiDestinationPitch the length in bytes of a destination row
+ * @param uyBytesPerPixel the size of a pixel, from 1 to 4 bytes
+ * @param urScaleX the scale factor for the X axis
+ * @param urScaleY the scale factor for the Y axis
+ */
+void PixelScale::ScaleNearestScalar(const void* CpSource, uint32_t uiSourcePitch, uint32_t uiWidth,
+    uint32_t uiHeight, void* pDestination, uint32_t uiDestinationPitch, uint8_t uyBytesPerPixel,
+    uint16_t urScaleX, uint16_t urScaleY)
+{
+    Scale(CpSource, uiSourcePitch, uiWidth, uiHeight, pDestination, uiDestinationPitch, uyBytesPerPixel,
+        urScaleX, urScaleY, false);
+}
+
+
+/**
+ * @brief Gets the name of the vector instructions used by ScaleNearest
+ *
+ * @return const char* "SSE2", "NEON" or "scalar"
+ */
+const char* PixelScale::GetPath() noexcept
+{
+#if defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,208 @@
+/*
+RenderCommandList.cpp --- Recorded drawing commands of a frame
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+
+#include <SDL_video.h>
+#include <SDL_error.h>
+
+#include "../../include/video/RenderCommandList.hpp"
+#include "../../include/video/Surface.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+RenderCommandList::RenderCommandList() noexcept : _vectorCommands{}, _vectorSdlRectsPresent{} {}
+
+
+/**
+ * @brief Destructor
+ */
+RenderCommandList::~RenderCommandList() noexcept { Clear(); }
+
+
+/**
+ * @brief Drops every command, releasing the references to the surfaces
+ */
+void RenderCommandList::Clear() noexcept
+{
+    for (const Command& Ccommand : _vectorCommands)
+        if (Ccommand.pSdlSurface) SDL_FreeSurface(Ccommand.pSdlSurface);    // Only frees the last reference
+
+    _vectorCommands.clear();
+    _vectorSdlRectsPresent.clear();
+}
+
+
+/**
+ * @brief Records a blit of part of a surface
+ *
+ * @param Csurface the source surface
+ * @param rDestinationX the X coordinate on the display of the top left corner
+ * @param rDestinationY the Y coordinate on the display of the top left corner
+ * @param rSourceX the X component of the origin coordinate of the portion of the source surface
+ * @param rSourceY the Y component of the origin coordinate of the portion of the source surface
+ * @param rSourceWidth the width of the portion of the source surface, -1 for the whole surface
+ * @param rSourceHeight the height of the portion of the source surface, -1 for the whole surface
+ */
+void RenderCommandList::Blit(const Surface& Csurface, int16_t rDestinationX, int16_t rDestinationY,
+    int16_t rSourceX, int16_t rSourceY, int16_t rSourceWidth, int16_t rSourceHeight)
+{
+    SDL_Surface* pSdlSurface{Csurface};
+    if (pSdlSurface == nullptr) throw std::invalid_argument("Surface is null");
+
+    Command command{};
+    command.eCommand = ECommand::COMMAND_BLIT;
+    command.pSdlSurface = pSdlSurface;
+    command.sdlRectSource = SDL_Rect{rSourceX, rSourceY,
+        static_cast<Uint16>(rSourceWidth >= 0 ? rSourceWidth : pSdlSurface->w),
+        static_cast<Uint16>(rSourceHeight >= 0 ? rSourceHeight : pSdlSurface->h)};
+    command.sdlRectDestination = SDL_Rect{rDestinationX, rDestinationY, 0, 0};
+    command.bIsPremultiplied = Csurface.IsPremultiplied();
+
+    _vectorCommands.push_back(command);
+    ++pSdlSurface->refcount;    // Released by Clear, so the surface outlives its owner if needed
+}
+
+
+/**
+ * @brief Records a copy of a region of the display into a surface, which reads what the commands before it
+ * drew
+ *
+ * @param surfaceDestination the surface that receives the region at its top left corner
+ * @param CsdlRect the region of the display
+ */
+void RenderCommandList::Save(Surface& surfaceDestination, const SDL_Rect& CsdlRect)
+{
+    SDL_Surface* pSdlSurface{surfaceDestination};
+    if (pSdlSurface == nullptr) throw std::invalid_argument("Surface is null");
+
+    Command command{};
+    command.eCommand = ECommand::COMMAND_SAVE;
+    command.pSdlSurface = pSdlSurface;
+    command.sdlRectSource = CsdlRect;
+
+    _vectorCommands.push_back(command);
+    ++pSdlSurface->refcount;
+}
+
+
+/**
+ * @brief Records a fill with a solid colour
+ *
+ * @param CpSdlRect the region to fill, nullptr for the whole clipping region
+ * @param uiColour the colour, in the pixel format of the display
+ */
+void RenderCommandList::Fill(const SDL_Rect* CpSdlRect, uint32_t uiColour)
+{
+    Command command{};
+    command.eCommand = ECommand::COMMAND_FILL;
+    if (CpSdlRect) command.sdlRectDestination = *CpSdlRect;
+    command.uiColour = uiColour;
+    command.bWholeClip = (CpSdlRect == nullptr);
+
+    _vectorCommands.push_back(command);
+}
+
+
+/**
+ * @brief Records a change of the clipping region of the display
+ *
+ * @param CpSdlRect the region the following commands are clipped to, nullptr for the whole display
+ */
+void RenderCommandList::SetClip(const SDL_Rect* CpSdlRect)
+{
+    Command command{};
+    command.eCommand = (CpSdlRect ? ECommand::COMMAND_CLIP : ECommand::COMMAND_CLIP_NONE);
+    if (CpSdlRect) command.sdlRectDestination = *CpSdlRect;
+
+    _vectorCommands.push_back(command);
+}
+
+
+/**
+ * @brief Sets the regions sent to the screen after the commands are executed
+ *
+ * @param CvectorSdlRects the regions, an empty list leaves the screen as it is
+ */
+void RenderCommandList::SetPresentRects(const std::vector<SDL_Rect>& CvectorSdlRects)
+{ _vectorSdlRectsPresent = CvectorSdlRects; }
+
+
+/**
+ * @brief Runs the commands on the display and presents the changed regions
+ *
+ * @param surfaceDisplay the display surface
+ */
+void RenderCommandList::Execute(Surface& surfaceDisplay)
+{
+    SDL_Surface* pSdlSurfaceDisplay{surfaceDisplay};
+
+    for (const Command& Ccommand : _vectorCommands)
+    {
+        switch (Ccommand.eCommand)
+        {
+        case ECommand::COMMAND_BLIT:
+        {
+            if (Ccommand.bIsPremultiplied)
+            {
+                Surface::BlitPremultiplied(Ccommand.pSdlSurface, Ccommand.sdlRectSource, surfaceDisplay,
+                    Ccommand.sdlRectDestination.x, Ccommand.sdlRectDestination.y);
+                break;
+            }
+
+            // SDL writes the clipped region back into the rectangles, so they are copied. A surface whose
+            // video memory was lost is skipped, it can only be loaded again by the thread that owns it
+            SDL_Rect sdlRectSource{Ccommand.sdlRectSource}, sdlRectDestination{Ccommand.sdlRectDestination};
+            if (SDL_BlitSurface(Ccommand.pSdlSurface, &sdlRectSource, pSdlSurfaceDisplay,
+                &sdlRectDestination) == -1) throw std::runtime_error(SDL_GetError());
+            break;
+        }
+        case ECommand::COMMAND_SAVE:
+        {
+            // Reading the display is clipped to its bounds, and the destination is moved along
+            SDL_Rect sdlRectSource{Ccommand.sdlRectSource}, sdlRectDestination{0, 0, 0, 0};
+            if (SDL_BlitSurface(pSdlSurfaceDisplay, &sdlRectSource, Ccommand.pSdlSurface,
+                &sdlRectDestination) == -1) throw std::runtime_error(SDL_GetError());
+            break;
+        }
+        case ECommand::COMMAND_FILL:
+        {
+            SDL_Rect sdlRect{Ccommand.sdlRectDestination};
+            SDL_FillRect(pSdlSurfaceDisplay, Ccommand.bWholeClip ? nullptr : &sdlRect, Ccommand.uiColour);
+            break;
+        }
+        case ECommand::COMMAND_CLIP: SDL_SetClipRect(pSdlSurfaceDisplay, &Ccommand.sdlRectDestination); break;
+        case ECommand::COMMAND_CLIP_NONE: SDL_SetClipRect(pSdlSurfaceDisplay, nullptr); break;
+        }
+    }
+
+    if ((pSdlSurfaceDisplay->flags & SDL_DOUBLEBUF) != 0)
+    {
+        // Flipping swaps the buffers, there is nothing to do if neither of them changed
+        if (!_vectorSdlRectsPresent.empty()) SDL_Flip(pSdlSurfaceDisplay);
+    }
+    else if (!_vectorSdlRectsPresent.empty())
+        SDL_UpdateRects(pSdlSurfaceDisplay, static_cast<int>(_vectorSdlRectsPresent.size()),
+            _vectorSdlRectsPresent.data());
+}
@@ -0,0 +1,307 @@
+/*
+RenderThread.cpp --- Thread that executes the recorded frames on the display
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <exception>
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_events.h>
+#include <SDL_mouse.h>
+#include <SDL_timer.h>
+#include <SDL_error.h>
+
+#include "../../include/video/RenderThread.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/Trace.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+RenderThread::RenderThread() : _pSdlThread{nullptr}, _pSdlSemaphoreWork{SDL_CreateSemaphore(0)},
+    _pSdlSemaphoreIdle{SDL_CreateSemaphore(1)}, _bStop{false}, _pSurfaceDisplay{nullptr},
+    _arenderCommandLists{}, _uyBack{0}, _sError{}, _uyVideoOwner{EVideoOwner::VIDEO_OWNER_NONE},
+    _uiLastExecuteTime{0}
+{
+    if (_pSdlSemaphoreWork == nullptr || _pSdlSemaphoreIdle == nullptr)
+    {
+        if (_pSdlSemaphoreWork) SDL_DestroySemaphore(_pSdlSemaphoreWork);
+        if (_pSdlSemaphoreIdle) SDL_DestroySemaphore(_pSdlSemaphoreIdle);
+        throw std::runtime_error(SDL_GetError());
+    }
+}
+
+
+/**
+ * @brief Destructor
+ */
+RenderThread::~RenderThread() noexcept
+{
+    Stop();
+
+    SDL_DestroySemaphore(_pSdlSemaphoreIdle);
+    SDL_DestroySemaphore(_pSdlSemaphoreWork);
+}
+
+
+/**
+ * @brief Gets the list to record the next frame in, which must only be done while the thread is not busy
+ *
+ * @return RenderCommandList& the back list, empty
+ */
+RenderCommandList& RenderThread::BeginFrame() noexcept
+{
+    RenderCommandList& renderCommandList{_arenderCommandLists[_uyBack]};
+    renderCommandList.Clear();
+
+    return renderCommandList;
+}
+
+
+/**
+ * @brief Hands the back list to the thread to be executed, starting the thread the first time
+ *
+ * @param surfaceDisplay the display surface
+ */
+void RenderThread::Submit(Surface& surfaceDisplay)
+{
+    while (SDL_SemWait(_pSdlSemaphoreIdle) == -1);  // Only blocks if the caller did not check IsBusy
+
+    if (!_sError.empty())
+    {
+        std::string sError{};
+        sError.swap(_sError);
+        while (SDL_SemPost(_pSdlSemaphoreIdle) == -1);
+        throw std::runtime_error(sError);
+    }
+
+    if (_pSdlThread == nullptr)
+    {
+        _bStop = false;
+        if ((_pSdlThread = SDL_CreateThread(Run, this)) == nullptr)
+        {
+            while (SDL_SemPost(_pSdlSemaphoreIdle) == -1);
+            throw std::runtime_error(SDL_GetError());
+        }
+    }
+
+    // The thread executes the list that is not the back one
+    _pSurfaceDisplay = &surfaceDisplay;
+    _uyBack ^= 1;
+    while (SDL_SemPost(_pSdlSemaphoreWork) == -1);
+}
+
+
+/**
+ * @brief Waits until the last list submitted is on the screen
+ */
+void RenderThread::Wait() noexcept
+{
+    while (SDL_SemWait(_pSdlSemaphoreIdle) == -1);
+    while (SDL_SemPost(_pSdlSemaphoreIdle) == -1);
+}
+
+
+/**
+ * @brief Replaces SDL_PollEvent, new events are only pumped while the display is not being drawn
+ *
+ * @param pSdlEvent receives the event
+ * @return true if there was an event
+ */
+bool RenderThread::PollEvent(SDL_Event* pSdlEvent) noexcept
+{
+    if (TryClaimVideo())
+    {
+        SDL_PumpEvents();
+        ReleaseVideo();
+    }
+
+    return SDL_PeepEvents(pSdlEvent, 1, SDL_GETEVENT, SDL_ALLEVENTS) > 0;
+}
+
+
+/**
+ * @brief Replaces SDL_WaitEvent
+ *
+ * @param pSdlEvent receives the event
+ * @return true if there was an event, false on error
+ */
+bool RenderThread::WaitEvent(SDL_Event* pSdlEvent) noexcept
+{
+    // The same polling SDL_WaitEvent does, but without pumping while the display is busy
+    while (true)
+    {
+        if (TryClaimVideo())
+        {
+            SDL_PumpEvents();
+            ReleaseVideo();
+        }
+
+        switch (SDL_PeepEvents(pSdlEvent, 1, SDL_GETEVENT, SDL_ALLEVENTS))
+        {
+        case -1: return false;
+        case 0: SDL_Delay(10); break;
+        default: return true;
+        }
+    }
+}
+
+
+/**
+ * @brief Replaces SDL_WaitEvent, giving up after a while
+ *
+ * @param pSdlEvent receives the event
+ * @param uiTimeout the longest wait, in milliseconds
+ * @return true if there was an event, false on error or if the time ran out
+ */
+bool RenderThread::WaitEventTimeout(SDL_Event* pSdlEvent, uint32_t uiTimeout) noexcept
+{
+    uint32_t uiStart{SDL_GetTicks()};
+
+    while (true)
+    {
+        if (TryClaimVideo())
+        {
+            SDL_PumpEvents();
+            ReleaseVideo();
+        }
+
+        switch (SDL_PeepEvents(pSdlEvent, 1, SDL_GETEVENT, SDL_ALLEVENTS))
+        {
+        case -1: return false;
+        case 0:
+        {
+            // Slept in the same steps as WaitEvent, the last one only for what is left of the timeout
+            uint32_t uiWaited{SDL_GetTicks() - uiStart};
+            if (uiWaited >= uiTimeout) return false;
+            SDL_Delay(std::min<uint32_t>(uiTimeout - uiWaited, 10));
+            break;
+        }
+        default: return true;
+        }
+    }
+}
+
+
+/**
+ * @brief Replaces SDL_WarpMouse, which waits for the display to be free
+ *
+ * @param urX the X coordinate of the cursor
+ * @param urY the Y coordinate of the cursor
+ */
+void RenderThread::WarpMouse(uint16_t urX, uint16_t urY) noexcept
+{
+    while (!TryClaimVideo()) SDL_Delay(1);
+    SDL_WarpMouse(urX, urY);
+    ReleaseVideo();
+}
+
+
+/**
+ * @brief Stops the thread and drops both lists, which must be done before the surfaces are freed
+ */
+void RenderThread::Stop() noexcept
+{
+    if (_pSdlThread)
+    {
+        _bStop = true;
+        while (SDL_SemPost(_pSdlSemaphoreWork) == -1);
+        SDL_WaitThread(_pSdlThread, nullptr);
+        _pSdlThread = nullptr;
+    }
+
+    // The thread is gone, so the lists are no longer shared and give back their surfaces
+    for (RenderCommandList& renderCommandList : _arenderCommandLists) renderCommandList.Clear();
+    while (SDL_SemTryWait(_pSdlSemaphoreWork) == 0);
+    while (SDL_SemTryWait(_pSdlSemaphoreIdle) == 0);
+    while (SDL_SemPost(_pSdlSemaphoreIdle) == -1);
+
+    _sError.clear();
+}
+
+
+/**
+ * @brief Loop of the render thread
+ *
+ * @param pData the render thread
+ * @return int32_t error code of the thread
+ */
+int32_t SDLCALL RenderThread::Run(void* pData)
+{
+    RenderThread& renderThread{*static_cast<RenderThread*>(pData)};
+
+    while (!renderThread._bStop)
+    {
+        while (SDL_SemWait(renderThread._pSdlSemaphoreWork) == -1);   // Wait for a list
+        if (renderThread._bStop) break;
+        TRACE_THREAD_NAME("Render");
+
+        // The main thread only pumps events for a moment, so it is worth waiting for it
+        uint8_t uyOwner{EVideoOwner::VIDEO_OWNER_NONE};
+        while (!renderThread._uyVideoOwner.compare_exchange_weak(uyOwner, EVideoOwner::VIDEO_OWNER_RENDER))
+        {
+            uyOwner = EVideoOwner::VIDEO_OWNER_NONE;
+            SDL_Delay(1);
+        }
+
+        std::chrono::steady_clock::time_point timeStart{std::chrono::steady_clock::now()};
+        try
+        {
+            TRACE_SCOPE("RenderThread::Execute");
+            renderThread._arenderCommandLists[renderThread._uyBack ^ 1].Execute(*renderThread._pSurfaceDisplay);
+        }
+        catch (const std::exception& Cexception) { renderThread._sError = Cexception.what(); }
+
+        renderThread._uiLastExecuteTime = static_cast<uint32_t>(std::chrono::duration_cast<
+            std::chrono::microseconds>(std::chrono::steady_clock::now() - timeStart).count());
+
+        renderThread._uyVideoOwner = EVideoOwner::VIDEO_OWNER_NONE;
+        while (SDL_SemPost(renderThread._pSdlSemaphoreIdle) == -1);
+    }
+
+    TRACE_THREAD_RELEASE();
+    return 0;
+}
+
+
+/**
+ * @brief Tries to take the display for the main thread
+ *
+ * @return true if the display was free
+ */
+bool RenderThread::TryClaimVideo() noexcept
+{
+    uint8_t uyOwner{EVideoOwner::VIDEO_OWNER_NONE};
+    return _uyVideoOwner.compare_exchange_strong(uyOwner, EVideoOwner::VIDEO_OWNER_MAIN);
+}
+
+
+/**
+ * @brief Frees the display taken by the main thread
+ */
+void RenderThread::ReleaseVideo() noexcept { _uyVideoOwner = EVideoOwner::VIDEO_OWNER_NONE; }
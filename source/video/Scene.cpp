@@ -0,0 +1,177 @@
+/*
+Scene.cpp --- Screen made of layers composited in advance
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <stdexcept>
+
+#include <SDL_video.h>
+#include <SDL_error.h>
+
+#include "../../include/video/Scene.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/Atlas.hpp"
+#include "../../include/video/RenderCommandList.hpp"
+#include "../../include/Trace.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+Scene::Scene() noexcept : _alayers{} {}
+
+
+/**
+ * @brief Destructor
+ */
+Scene::~Scene() noexcept
+{
+    for (Layer& layer : _alayers) delete layer.pSurfaceCache;
+}
+
+
+/**
+ * @brief Checks whether a layer changed, emptying it if it did so its elements are added again
+ *
+ * @param eLayer the layer
+ * @param uKey summary of everything the elements of the layer depend on
+ * @return true if the key is not the one the layer was described with, and the layer was emptied
+ */
+bool Scene::BeginLayer(ELayer eLayer, uint64_t uKey) noexcept
+{
+    Layer& layer{_alayers[eLayer]};
+    if (layer.bHasKey && layer.uKey == uKey) return false;
+
+    layer.vectorElements.clear();
+    layer.uKey = uKey;
+    layer.bHasKey = true;
+    layer.bIsStale = true;
+
+    return true;
+}
+
+
+/**
+ * @brief Adds part of a surface to a layer being described
+ *
+ * @param eLayer the layer
+ * @param surface the surface, which must live until the layer is described again
+ * @param rDestinationX the X coordinate on the screen of the top left corner
+ * @param rDestinationY the Y coordinate on the screen of the top left corner
+ * @param rSourceX the X component of the origin coordinate of the portion of the surface
+ * @param rSourceY the Y component of the origin coordinate of the portion of the surface
+ * @param rSourceWidth the width of the portion of the surface, -1 for the whole surface
+ * @param rSourceHeight the height of the portion of the surface, -1 for the whole surface
+ */
+void Scene::Add(ELayer eLayer, Surface& surface, int16_t rDestinationX, int16_t rDestinationY,
+    int16_t rSourceX, int16_t rSourceY, int16_t rSourceWidth, int16_t rSourceHeight)
+{
+    _alayers[eLayer].vectorElements.push_back(Element{&surface, rDestinationX, rDestinationY, rSourceX,
+        rSourceY, rSourceWidth, rSourceHeight});
+}
+
+
+/**
+ * @brief Adds a sprite to a layer being described
+ *
+ * @param eLayer the layer
+ * @param atlas the atlas of the sprite, which must live until the layer is described again
+ * @param sprite the sprite
+ * @param rDestinationX the X coordinate on the screen of the top left corner
+ * @param rDestinationY the Y coordinate on the screen of the top left corner
+ */
+void Scene::Add(ELayer eLayer, Atlas& atlas, Atlas::Sprite sprite, int16_t rDestinationX, int16_t rDestinationY)
+{
+    const SDL_Rect& CsdlRect{atlas.GetRect(sprite)};
+    Add(eLayer, atlas.GetSurface(), rDestinationX, rDestinationY, CsdlRect.x, CsdlRect.y, CsdlRect.w,
+        CsdlRect.h);
+}
+
+
+/**
+ * @brief Forgets every layer, so all of them are described again, which must be done before the surfaces
+ * of the elements are freed
+ */
+void Scene::Invalidate() noexcept
+{
+    for (Layer& layer : _alayers)
+    {
+        layer.vectorElements.clear();
+        layer.bHasKey = false;
+        layer.bIsStale = true;
+    }
+}
+
+
+/**
+ * @brief Composites the layers that changed and the ones above them
+ *
+ * @param CsurfaceDisplay the display surface, whose format and size the caches take
+ */
+void Scene::Composite(const Surface& CsurfaceDisplay)
+{
+    const SDL_PixelFormat* CpSdlPixelFormat{CsurfaceDisplay.GetPixelFormat()};
+    bool bIsStale{false};
+
+    for (uint8_t i = 0; i < LAYER_COUNT; ++i)
+    {
+        Layer& layer{_alayers[i]};
+        bIsStale = bIsStale || layer.bIsStale || layer.pSurfaceCache == nullptr;
+        if (!bIsStale) continue;
+
+        TRACE_SCOPE("Scene::Composite");
+        if (layer.pSurfaceCache == nullptr || layer.pSurfaceCache->GetWidth() != CsurfaceDisplay.GetWidth() ||
+            layer.pSurfaceCache->GetHeight() != CsurfaceDisplay.GetHeight())
+        {
+            // Without alpha, so blitting the cache is a plain copy and blending into it matches the display
+            SDL_Surface* pSdlSurfaceCache{SDL_CreateRGBSurface(SDL_SWSURFACE, CsurfaceDisplay.GetWidth(),
+                CsurfaceDisplay.GetHeight(), CpSdlPixelFormat->BitsPerPixel, CpSdlPixelFormat->Rmask,
+                CpSdlPixelFormat->Gmask, CpSdlPixelFormat->Bmask, 0)};
+            if (pSdlSurfaceCache == nullptr) throw std::runtime_error(SDL_GetError());
+
+            delete layer.pSurfaceCache;
+            layer.pSurfaceCache = new Surface(pSdlSurfaceCache);
+        }
+
+        if (i == 0) SDL_FillRect(*layer.pSurfaceCache, nullptr, SDL_MapRGB(CpSdlPixelFormat, 0, 0, 0));
+        else _alayers[i - 1].pSurfaceCache->OnDraw(*layer.pSurfaceCache);
+
+        for (const Element& Celement : layer.vectorElements)
+        {
+            Celement.pSurface->OnDraw(*layer.pSurfaceCache, Celement.rDestinationX, Celement.rDestinationY,
+                Celement.rSourceX, Celement.rSourceY, Celement.rSourceWidth, Celement.rSourceHeight);
+        }
+
+        layer.bIsStale = false;
+    }
+}
+
+
+/**
+ * @brief Records a blit of the whole scene
+ *
+ * @param renderCommandList the list of the frame
+ */
+void Scene::OnDraw(RenderCommandList& renderCommandList) const
+{
+    const Surface* CpSurfaceTop{_alayers[LAYER_COUNT - 1].pSurfaceCache};
+    if (CpSurfaceTop) renderCommandList.Blit(*CpSurfaceTop);
+}
@@ -0,0 +1,81 @@
+/*
+ScreenLayout.cpp --- Placement of the screen elements for any display size
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <array>
+
+#include <SDL_video.h>
+
+#include "../../include/video/ScreenLayout.hpp"
+#include "../../include/Globals.hpp"
+
+
+/**
+ * @brief Default constructor, for the preferred display
+ */
+ScreenLayout::ScreenLayout() noexcept : _urWidth{Globals::SCurAppWidth}, _urHeight{Globals::SCurAppHeight},
+    _arShiftsX{}, _arShiftsY{}
+{}
+
+
+/**
+ * @brief Sets the size of the display, working out the shift of every anchor if it changed
+ *
+ * @param urWidth the width of the display
+ * @param urHeight the height of the display
+ * @return true if the size changed, so whatever was placed before must be placed again
+ */
+bool ScreenLayout::Resize(uint16_t urWidth, uint16_t urHeight) noexcept
+{
+    if (urWidth == _urWidth && urHeight == _urHeight) return false;
+
+    _urWidth = urWidth;
+    _urHeight = urHeight;
+
+    // The anchors are laid out in rows of three, from the top left corner to the bottom right one, and each
+    // of them moves by none, half or all of what the display grew
+    int16_t rGrowthX{static_cast<int16_t>(urWidth - Globals::SCurAppWidth)};
+    int16_t rGrowthY{static_cast<int16_t>(urHeight - Globals::SCurAppHeight)};
+    for (uint8_t i = 0; i < ANCHOR_COUNT; ++i)
+    {
+        _arShiftsX[i] = static_cast<int16_t>(rGrowthX * (i % 3) / 2);
+        _arShiftsY[i] = static_cast<int16_t>(rGrowthY * (i / 3) / 2);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Places an element on the display
+ *
+ * @param eAnchor the point of the display the element keeps its distance to
+ * @param rX the X coordinate of the top left corner of the element on the preferred display
+ * @param rY the Y coordinate of the top left corner of the element on the preferred display
+ * @param urWidth the width of the element
+ * @param urHeight the height of the element
+ * @return SDL_Rect the region of the element on the display
+ */
+SDL_Rect ScreenLayout::Place(EAnchor eAnchor, int16_t rX, int16_t rY, uint16_t urWidth, 
+    uint16_t urHeight) const noexcept
+{
+    return SDL_Rect{static_cast<Sint16>(rX + _arShiftsX[eAnchor]),
+        static_cast<Sint16>(rY + _arShiftsY[eAnchor]), urWidth, urHeight};
+}
@@ -22,6 +22,9 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdexcept>
 #include <ios>
 #include <string>
+#include <type_traits>
+#include <array>
+#include <algorithm>
 
 #include <SDL_config.h>
 #include <SDL_endian.h>
@@ -31,6 +34,29 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <SDL_timer.h>
 
 #include "../../include/video/Surface.hpp"
+#include "../../include/video/PixelScale.hpp"
+#include "../../include/video/PixelBlend.hpp"
+#include "../../include/video/PixelView.hpp"
+
+
+namespace
+{
+    /* CRC-32 with the reflected polynomial of zlib, one table entry per byte value */
+
+    constexpr std::array<uint32_t, 256> MakeCRCTable() noexcept
+    {
+        std::array<uint32_t, 256> auiTable{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t uiCRC{i};
+            for (uint8_t j = 0; j < 8; ++j) uiCRC = (uiCRC & 1 ? 0xEDB88320u ^ (uiCRC >> 1) : uiCRC >> 1);
+            auiTable[i] = uiCRC;
+        }
+        return auiTable;
+    }
+
+    constexpr std::array<uint32_t, 256> SCauiCRCTable{MakeCRCTable()};
+}
 
 
 /**
@@ -39,37 +65,18 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
  * @param CsFilePath the path to the bitmap image
  */
 Surface::Surface(const std::string& CsFilePath, uint8_t uyAlpha, int16_t rColourKeyRed, 
-    int16_t rColourKeyGreen, int16_t rColourKeyBlue) : _sPath{CsFilePath}, _pSdlSurface{nullptr}
+    int16_t rColourKeyGreen, int16_t rColourKeyBlue) : _sPath{CsFilePath}, _pSdlSurface{nullptr},
+    _bIsPremultiplied{false}
 {
-    SDL_Surface* pSdlSurfaceTemp{nullptr};
-
-    if((pSdlSurfaceTemp = IMG_Load(CsFilePath.c_str())) == nullptr)
+    if((_pSdlSurface = IMG_Load(CsFilePath.c_str())) == nullptr)
         throw std::ios_base::failure(IMG_GetError());
 
-    if (SDL_SetAlpha(pSdlSurfaceTemp, SDL_SRCALPHA | SDL_RLEACCEL, uyAlpha) == -1)
-    {
-        SDL_FreeSurface(pSdlSurfaceTemp);
-        throw std::runtime_error(SDL_GetError());
-    }
-
-    /* Convert the loaded surface to the same format as the display */
-    if (pSdlSurfaceTemp->format->Amask) _pSdlSurface = SDL_DisplayFormatAlpha(pSdlSurfaceTemp); // Surface has an alpha channel
-    else
+    try { ConvertToDisplay(uyAlpha, rColourKeyRed, rColourKeyGreen, rColourKeyBlue); }
+    catch (...)
     {
-        if (rColourKeyRed >= 0 && rColourKeyGreen >= 0 && rColourKeyBlue >= 0)
-        {
-            if (SDL_SetColorKey(pSdlSurfaceTemp, SDL_SRCCOLORKEY | SDL_RLEACCEL, 
-                SDL_MapRGB(pSdlSurfaceTemp->format, rColourKeyRed, rColourKeyBlue, rColourKeyGreen)) == -1)
-            {
-                SDL_FreeSurface(pSdlSurfaceTemp);
-                throw std::runtime_error(SDL_GetError());
-            }
-        }
-        _pSdlSurface = SDL_DisplayFormat(pSdlSurfaceTemp);
+        SDL_FreeSurface(_pSdlSurface);
+        throw;
     }
-    SDL_FreeSurface(pSdlSurfaceTemp);
-
-    if (_pSdlSurface == nullptr) throw std::ios_base::failure(SDL_GetError());
 }
 
 
@@ -78,7 +85,8 @@ Surface::Surface(const std::string& CsFilePath, uint8_t uyAlpha, int16_t rColour
  *
  * @param pSdlSurface the raw surface
  */
-Surface::Surface(SDL_Surface* pSdlSurface) noexcept : _sPath{}, _pSdlSurface{pSdlSurface}
+Surface::Surface(SDL_Surface* pSdlSurface) noexcept : _sPath{}, _pSdlSurface{pSdlSurface},
+    _bIsPremultiplied{false}
 {}
 
 
@@ -87,7 +95,8 @@ Surface::Surface(SDL_Surface* pSdlSurface) noexcept : _sPath{}, _pSdlSurface{pSd
  *
  * @param CsurfaceOther the surface to be copied
  */
-Surface::Surface(const Surface& CsurfaceOther) : _sPath{CsurfaceOther._sPath}, _pSdlSurface{nullptr}
+Surface::Surface(const Surface& CsurfaceOther) : _sPath{CsurfaceOther._sPath}, _pSdlSurface{nullptr},
+    _bIsPremultiplied{CsurfaceOther._bIsPremultiplied}
 {
     if ((_pSdlSurface = SDL_ConvertSurface(CsurfaceOther._pSdlSurface,
         CsurfaceOther._pSdlSurface->format, CsurfaceOther._pSdlSurface->flags)) == nullptr)
@@ -101,7 +110,7 @@ Surface::Surface(const Surface& CsurfaceOther) : _sPath{CsurfaceOther._sPath}, _
  * @param surfaceOther the surface to be moved
  */
 Surface::Surface(Surface&& surfaceOther) noexcept : _sPath{surfaceOther._sPath}, 
-    _pSdlSurface{surfaceOther._pSdlSurface}
+    _pSdlSurface{surfaceOther._pSdlSurface}, _bIsPremultiplied{surfaceOther._bIsPremultiplied}
 { surfaceOther._pSdlSurface = nullptr; }
 
 
@@ -129,6 +138,7 @@ Surface& Surface::operator =(const Surface& CsurfaceOther)
     if (this != &CsurfaceOther)
     {
         _sPath = CsurfaceOther._sPath;
+        _bIsPremultiplied = CsurfaceOther._bIsPremultiplied;
 
         SDL_FreeSurface(_pSdlSurface);
         if ((_pSdlSurface = SDL_ConvertSurface(CsurfaceOther._pSdlSurface,
@@ -150,6 +160,7 @@ Surface& Surface::operator =(Surface&& surfaceOther) noexcept
     if (this != &surfaceOther)
     {
         _sPath = surfaceOther._sPath;
+        _bIsPremultiplied = surfaceOther._bIsPremultiplied;
 
         SDL_FreeSurface(_pSdlSurface);
         _pSdlSurface = surfaceOther._pSdlSurface;
@@ -169,6 +180,7 @@ Surface& Surface::operator =(SDL_Surface* pSdlSurface) noexcept
 {
     SDL_FreeSurface(_pSdlSurface);
     _pSdlSurface = pSdlSurface;
+    _bIsPremultiplied = false;
 
     return *this;
 }
@@ -203,30 +215,7 @@ void Surface::ReadPixel(uint16_t urX, uint16_t urY, uint8_t* puyRed, uint8_t* pu
 {
     if (!puyRed || !puyGreen || !puyBlue || !puyAlpha) throw std::invalid_argument("Pointer is null");
 
-    Lock();
-
-    /* Get the address to the pixel we want to retrieve */
-    uint8_t* puyPixel{static_cast<uint8_t*>(_pSdlSurface->pixels) + urY * _pSdlSurface->pitch + 
-        urX * _pSdlSurface->format->BytesPerPixel};
-
-    uint32_t uiPixelValue{};
-
-    switch(_pSdlSurface->format->BytesPerPixel)
-    {
-    case 1: uiPixelValue = *puyPixel; break;
-    case 2: uiPixelValue = *(reinterpret_cast<uint16_t*>(puyPixel)); break;
-    case 3:
-        if (SDL_BYTEORDER == SDL_BIG_ENDIAN) 
-            uiPixelValue = puyPixel[0] << 16 | puyPixel[1] << 8 | puyPixel[2];
-        else uiPixelValue = puyPixel[0] | puyPixel[1] << 8 | puyPixel[2] << 16;
-        break;
-    case 4: uiPixelValue = *(reinterpret_cast<uint32_t*>(puyPixel)); break;
-    default:
-        Unlock();
-        throw std::runtime_error("Unknown bytes per pixel");
-    }
-
-    Unlock();
+    uint32_t uiPixelValue{VisitPixels(*this, [urX, urY](const auto& Cview) { return Cview.Read(urX, urY); })};
     SDL_GetRGBA(uiPixelValue, _pSdlSurface->format, puyRed, puyGreen, puyBlue, puyAlpha);
 }
 
@@ -242,39 +231,8 @@ void Surface::ReadPixel(uint16_t urX, uint16_t urY, uint8_t* puyRed, uint8_t* pu
  */
 void Surface::DrawPixel(uint16_t urX, uint16_t urY, uint8_t uyRed, uint8_t uyGreen, uint8_t uyBlue)
 {
-    Lock();
-
-    /* Get the address to the pixel we want to set */
-    uint8_t* puyPixel = static_cast<uint8_t*>(_pSdlSurface->pixels) + urY * _pSdlSurface->pitch +
-        urX * _pSdlSurface->format->BytesPerPixel;
-
     uint32_t uiPixelValue{SDL_MapRGB(_pSdlSurface->format, uyRed, uyGreen, uyBlue)};
-
-    switch(_pSdlSurface->format->BytesPerPixel)
-    {
-    case 1: *puyPixel = uiPixelValue; break;
-    case 2: *(reinterpret_cast<uint16_t*>(puyPixel)) = uiPixelValue; break;
-    case 3:
-        if(SDL_BYTEORDER == SDL_BIG_ENDIAN)
-        {
-            puyPixel[0] = (uiPixelValue >> 16) & 0xFF;
-            puyPixel[1] = (uiPixelValue >> 8) & 0xFF;
-            puyPixel[2] = uiPixelValue & 0xFF;
-        }
-        else
-        {
-            puyPixel[0] = uiPixelValue & 0xFF;
-            puyPixel[1] = (uiPixelValue >> 8) & 0xFF;
-            puyPixel[2] = (uiPixelValue >> 16) & 0xFF;
-        }
-        break;
-    case 4: *(reinterpret_cast<uint32_t*>(puyPixel)) = uiPixelValue; break;
-    default:
-        Unlock();
-        throw std::runtime_error("Unknown bytes per pixel");
-    }
-
-    Unlock();
+    VisitPixels(*this, [urX, urY, uiPixelValue](auto& view) { view.Write(urX, urY, uiPixelValue); });
 }
 
 
@@ -294,55 +252,114 @@ void Surface::SetTransparentPixel(uint8_t uyRed, uint8_t uyGreen, uint8_t uyBlue
 }
 
 
+/**
+ * @brief Converts the surface to the pixel format of the display, which must be done from the main thread
+ *
+ * @param uyAlpha the alpha value of the whole surface
+ * @param rColourKeyRed the red RGB component of the colour key, -1 to keep the current one
+ * @param rColourKeyGreen the green RGB component of the colour key, -1 to keep the current one
+ * @param rColourKeyBlue the blue RGB component of the colour key, -1 to keep the current one
+ */
+void Surface::ConvertToDisplay(uint8_t uyAlpha, int16_t rColourKeyRed, int16_t rColourKeyGreen,
+    int16_t rColourKeyBlue)
+{
+    if (SDL_SetAlpha(_pSdlSurface, SDL_SRCALPHA | SDL_RLEACCEL, uyAlpha) == -1)
+        throw std::runtime_error(SDL_GetError());
+
+    SDL_Surface* pSdlSurfaceTemp{nullptr};
+
+    /* Convert the surface to the same format as the display */
+    if (_pSdlSurface->format->Amask) pSdlSurfaceTemp = SDL_DisplayFormatAlpha(_pSdlSurface); // Surface has an alpha channel
+    else
+    {
+        if (rColourKeyRed >= 0 && rColourKeyGreen >= 0 && rColourKeyBlue >= 0)
+        {
+            if (SDL_SetColorKey(_pSdlSurface, SDL_SRCCOLORKEY | SDL_RLEACCEL, 
+                SDL_MapRGB(_pSdlSurface->format, rColourKeyRed, rColourKeyBlue, rColourKeyGreen)) == -1)
+                throw std::runtime_error(SDL_GetError());
+        }
+        pSdlSurfaceTemp = SDL_DisplayFormat(_pSdlSurface);
+    }
+
+    if (pSdlSurfaceTemp == nullptr) throw std::ios_base::failure(SDL_GetError());
+
+    SDL_FreeSurface(_pSdlSurface);
+    _pSdlSurface = pSdlSurfaceTemp;
+}
+
+
 /**
  * @brief Upscales a surface
  *
  * @param urScaleX the scale factor for the X axis
  * @param urScaleY the scale factor for the Y axis
+ * @param bDisplayFormat true to convert the result to the format of the display, false to keep the format,
+ * which lets surfaces be scaled outside the main thread
  */
-void Surface::Scale(uint16_t urScaleX, uint16_t urScaleY)
+void Surface::Scale(uint16_t urScaleX, uint16_t urScaleY, bool bDisplayFormat)
 {
     SDL_Surface* pSdlSurfaceTemp{nullptr};
-    SDL_Rect sdlRectScale{};
-    sdlRectScale.w = urScaleX;
-    sdlRectScale.h = urScaleY;
 
     if ((pSdlSurfaceTemp = SDL_CreateRGBSurface(_pSdlSurface->flags, _pSdlSurface->w * urScaleX,
         _pSdlSurface->h * urScaleY, _pSdlSurface->format->BitsPerPixel, _pSdlSurface->format->Rmask,
         _pSdlSurface->format->Gmask, _pSdlSurface->format->Bmask, _pSdlSurface->format->Amask)) == nullptr)
         throw std::runtime_error(SDL_GetError());
 
-    uint8_t uyRed{0}, uyGreen{0}, uyBlue{0}, uyAlpha{0};
+    Surface surfaceTemp{pSdlSurfaceTemp};
+    if (_pSdlSurface->format->palette)
+        SDL_SetColors(pSdlSurfaceTemp, _pSdlSurface->format->palette->colors, 0,
+            _pSdlSurface->format->palette->ncolors);
 
-    for (int32_t i = 0; i < _pSdlSurface->h; i++)        // Run across all Y pixels.
+    // Both surfaces share the pixel format, so the pixel values are copied as they are
+    VisitPixels(*this, [&surfaceTemp, urScaleX, urScaleY](const auto& CviewSource)
     {
-        sdlRectScale.y = i * urScaleY;
-        for (int32_t j = 0; j < _pSdlSurface->w; j++)    // Run across all X pixels.
-        {
-            sdlRectScale.x = j * urScaleX;
-            ReadPixel(j, i, &uyRed, &uyGreen, &uyBlue, &uyAlpha);
-            uint32_t uiPixelValue{SDL_MapRGBA(_pSdlSurface->format, uyRed, uyGreen, uyBlue, uyAlpha)};
+        typedef typename std::remove_cvref_t<decltype(CviewSource)>::Pixel Pixel;
+        PixelView<Pixel> viewDestination{surfaceTemp};
 
-            if (SDL_FillRect(pSdlSurfaceTemp, &sdlRectScale, uiPixelValue) == -1) 
-                throw std::runtime_error(SDL_GetError());
-        }
-    }
+        PixelScale::ScaleNearest(CviewSource[0].data(), CviewSource.GetPitch(), CviewSource.GetWidth(),
+            CviewSource.GetHeight(), viewDestination[0].data(), viewDestination.GetPitch(),
+            PixelTraits<Pixel>::SCuyBytesPerPixel, urScaleX, urScaleY);
+    });
 
-    if (_pSdlSurface->format->Amask)
-    {
-        SDL_FreeSurface(_pSdlSurface);
-        _pSdlSurface = SDL_DisplayFormatAlpha(pSdlSurfaceTemp); // Surface has an alpha channel
-    }
-    else
-    {
+    bool bHasAlpha{_pSdlSurface->format->Amask != 0};
+    if (!bHasAlpha)
         SDL_SetColorKey(pSdlSurfaceTemp, SDL_SRCCOLORKEY | SDL_RLEACCEL, _pSdlSurface->format->colorkey);   // Keep the color key
-        SDL_FreeSurface(_pSdlSurface);
-        _pSdlSurface = SDL_DisplayFormat(pSdlSurfaceTemp);
+
+    SDL_Surface* pSdlSurfaceNew{pSdlSurfaceTemp};
+    if (bDisplayFormat)
+    {
+        pSdlSurfaceNew = (bHasAlpha ? SDL_DisplayFormatAlpha(pSdlSurfaceTemp) : 
+            SDL_DisplayFormat(pSdlSurfaceTemp));
+        if (pSdlSurfaceNew == nullptr) throw std::runtime_error(SDL_GetError());
     }
+    else surfaceTemp._pSdlSurface = nullptr;    // The scaled surface is kept as it is
+
+    SDL_FreeSurface(_pSdlSurface);
+    _pSdlSurface = pSdlSurfaceNew;
+}
+
+
+/**
+ * @brief Multiplies the colour components by the alpha, so the surface is blended by BlitPremultiplied
+ * instead of SDL. Only 32-bit surfaces with an alpha channel can be premultiplied
+ */
+void Surface::Premultiply()
+{
+    if (_pSdlSurface == nullptr) throw std::invalid_argument("Surface is null");
+    if (_bIsPremultiplied) return;
+    if (_pSdlSurface->format->BytesPerPixel != 4 || _pSdlSurface->format->Amask == 0)
+        throw std::invalid_argument("Only 32-bit surfaces with alpha can be premultiplied");
 
-    SDL_FreeSurface(pSdlSurfaceTemp);
+    // SDL never blits the surface again, so it is kept without run-length encoding for direct pixel access
+    if (SDL_SetAlpha(_pSdlSurface, SDL_SRCALPHA, SDL_ALPHA_OPAQUE) == -1)
+        throw std::runtime_error(SDL_GetError());
+
+    Lock();
+    PixelBlend::Premultiply(_pSdlSurface->pixels, _pSdlSurface->pitch, _pSdlSurface->w, _pSdlSurface->h,
+        _pSdlSurface->format->Ashift);
+    Unlock();
 
-    if (_pSdlSurface == nullptr) throw std::runtime_error(SDL_GetError());
+    _bIsPremultiplied = true;
 }
 
 
@@ -379,6 +396,12 @@ void Surface::OnDraw(Surface& sdlSurfaceDestination, int16_t rDestinationX, int1
     sdlRectDestination.x = rDestinationX;
     sdlRectDestination.y = rDestinationY;
 
+    if (_bIsPremultiplied)
+    {
+        BlitPremultiplied(_pSdlSurface, sdlRectSource, sdlSurfaceDestination, rDestinationX, rDestinationY);
+        return;
+    }
+
     int32_t iError{};
     while ((iError = SDL_BlitSurface(_pSdlSurface, &sdlRectSource, sdlSurfaceDestination._pSdlSurface,
         &sdlRectDestination)) < 0)
@@ -390,3 +413,189 @@ void Surface::OnDraw(Surface& sdlSurfaceDestination, int16_t rDestinationX, int1
         if (_pSdlSurface->flags & SDL_HWSURFACE) *this = Surface(_sPath);
     }
 }
+
+
+/**
+ * @brief Makes another surface over the same pixels, counted by SDL so they are freed along with the
+ * last surface using them. Neither surface may be changed from then on, since both would change
+ *
+ * @return Surface* the new surface, owned by the caller
+ */
+Surface* Surface::Share() const
+{
+    if (_pSdlSurface == nullptr) throw std::invalid_argument("Surface is null");
+
+    Surface* pSurfaceShared{new Surface(_pSdlSurface)};
+    pSurfaceShared->_sPath = _sPath;
+    pSurfaceShared->_bIsPremultiplied = _bIsPremultiplied;
+    ++_pSdlSurface->refcount;
+
+    return pSurfaceShared;
+}
+
+
+/**
+ * @brief Computes the CRC-32 of the pixels, leaving out the padding at the end of the rows
+ *
+ * @return uint32_t the checksum, the same one zlib computes for the same bytes
+ */
+uint32_t Surface::GetChecksum() noexcept
+{
+    if (_pSdlSurface == nullptr) return 0;
+
+    uint32_t uiCRC{0xFFFFFFFFu};
+    uint32_t uiRowBytes{static_cast<uint32_t>(_pSdlSurface->w) * _pSdlSurface->format->BytesPerPixel};
+
+    Lock();
+    for (int32_t i = 0; i < _pSdlSurface->h; ++i)
+    {
+        const uint8_t* CpuyRow{static_cast<const uint8_t*>(_pSdlSurface->pixels) + i * _pSdlSurface->pitch};
+        for (uint32_t j = 0; j < uiRowBytes; ++j)
+            uiCRC = SCauiCRCTable[(uiCRC ^ CpuyRow[j]) & 0xFF] ^ (uiCRC >> 8);
+    }
+    Unlock();
+
+    return uiCRC ^ 0xFFFFFFFFu;
+}
+
+
+/**
+ * @brief Blends part of a premultiplied surface into another surface, clipped like SDL_BlitSurface. 32-bit
+ * destinations with the same colour components and RGB565 ones have their own kernels, any other format is
+ * blended one pixel at a time
+ *
+ * @param pSdlSurfaceSource the premultiplied source surface
+ * @param CsdlRectSource the portion of the source surface
+ * @param surfaceDestination the destination surface
+ * @param rDestinationX the X component of the top left coordinate where the portion will be blended
+ * @param rDestinationY the Y component of the top left coordinate where the portion will be blended
+ */
+void Surface::BlitPremultiplied(SDL_Surface* pSdlSurfaceSource, const SDL_Rect& CsdlRectSource,
+    Surface& surfaceDestination, int16_t rDestinationX, int16_t rDestinationY)
+{
+    SDL_Surface* pSdlSurfaceDestination{surfaceDestination._pSdlSurface};
+    if (pSdlSurfaceSource == nullptr || pSdlSurfaceDestination == nullptr)
+        throw std::invalid_argument("Surface is null");
+
+    int32_t iSourceX{CsdlRectSource.x}, iSourceY{CsdlRectSource.y};
+    int32_t iDestinationX{rDestinationX}, iDestinationY{rDestinationY};
+    int32_t iWidth{CsdlRectSource.w}, iHeight{CsdlRectSource.h};
+
+    // Clipped to the source first and then to the clipping region of the destination
+    if (iSourceX < 0) { iDestinationX -= iSourceX; iWidth += iSourceX; iSourceX = 0; }
+    if (iSourceY < 0) { iDestinationY -= iSourceY; iHeight += iSourceY; iSourceY = 0; }
+    iWidth = std::min(iWidth, pSdlSurfaceSource->w - iSourceX);
+    iHeight = std::min(iHeight, pSdlSurfaceSource->h - iSourceY);
+
+    const SDL_Rect& CsdlRectClip{pSdlSurfaceDestination->clip_rect};
+    if (iDestinationX < CsdlRectClip.x)
+    {
+        iSourceX += CsdlRectClip.x - iDestinationX;
+        iWidth -= CsdlRectClip.x - iDestinationX;
+        iDestinationX = CsdlRectClip.x;
+    }
+    if (iDestinationY < CsdlRectClip.y)
+    {
+        iSourceY += CsdlRectClip.y - iDestinationY;
+        iHeight -= CsdlRectClip.y - iDestinationY;
+        iDestinationY = CsdlRectClip.y;
+    }
+    iWidth = std::min(iWidth, CsdlRectClip.x + CsdlRectClip.w - iDestinationX);
+    iHeight = std::min(iHeight, CsdlRectClip.y + CsdlRectClip.h - iDestinationY);
+
+    if (iWidth <= 0 || iHeight <= 0) return;
+
+    const SDL_PixelFormat* CpSdlPixelFormatSource{pSdlSurfaceSource->format};
+    if (SDL_MUSTLOCK(pSdlSurfaceSource)) while (SDL_LockSurface(pSdlSurfaceSource) == -1) SDL_Delay(10);
+    const uint8_t* CpuySource{static_cast<const uint8_t*>(pSdlSurfaceSource->pixels) +
+        iSourceY * pSdlSurfaceSource->pitch + iSourceX * 4};
+
+    try
+    {
+        VisitPixels(surfaceDestination, [&](auto& viewDestination)
+        {
+            typedef typename std::remove_cvref_t<decltype(viewDestination)>::Pixel Pixel;
+            SDL_PixelFormat* pSdlPixelFormat{viewDestination.GetPixelFormat()};
+
+            if constexpr (std::is_same_v<Pixel, uint32_t>)
+            {
+                if (pSdlPixelFormat->Rmask == CpSdlPixelFormatSource->Rmask &&
+                    pSdlPixelFormat->Gmask == CpSdlPixelFormatSource->Gmask &&
+                    pSdlPixelFormat->Bmask == CpSdlPixelFormatSource->Bmask)
+                {
+                    PixelBlend::BlendOver(CpuySource, pSdlSurfaceSource->pitch, iWidth, iHeight,
+                        viewDestination[iDestinationY].data() + iDestinationX, viewDestination.GetPitch(),
+                        CpSdlPixelFormatSource->Ashift);
+                    return;
+                }
+            }
+            else if constexpr (std::is_same_v<Pixel, uint16_t>)
+            {
+                if (pSdlPixelFormat->Rmask == 0xF800 && pSdlPixelFormat->Gmask == 0x07E0 &&
+                    pSdlPixelFormat->Bmask == 0x001F)
+                {
+                    PixelBlend::BlendOver565(CpuySource, pSdlSurfaceSource->pitch, iWidth, iHeight,
+                        viewDestination[iDestinationY].data() + iDestinationX, viewDestination.GetPitch(),
+                        CpSdlPixelFormatSource->Ashift, CpSdlPixelFormatSource->Rshift,
+                        CpSdlPixelFormatSource->Gshift, CpSdlPixelFormatSource->Bshift);
+                    return;
+                }
+            }
+
+            // Any other format goes through the colour components of every pixel
+            for (int32_t i = 0; i < iHeight; ++i)
+            {
+                const uint32_t* CpuiSourceRow{reinterpret_cast<const uint32_t*>(CpuySource +
+                    i * pSdlSurfaceSource->pitch)};
+                for (int32_t j = 0; j < iWidth; ++j)
+                {
+                    uint8_t uyRed{}, uyGreen{}, uyBlue{}, uyAlpha{};
+                    SDL_GetRGBA(CpuiSourceRow[j], pSdlSurfaceSource->format, &uyRed, &uyGreen, &uyBlue,
+                        &uyAlpha);
+                    if (uyAlpha == 0) continue;
+
+                    uint8_t uyDestinationRed{}, uyDestinationGreen{}, uyDestinationBlue{};
+                    SDL_GetRGB(viewDestination.Read(iDestinationX + j, iDestinationY + i),
+                        pSdlPixelFormat, &uyDestinationRed, &uyDestinationGreen, &uyDestinationBlue);
+                    viewDestination.Write(iDestinationX + j, iDestinationY + i,
+                        SDL_MapRGB(pSdlPixelFormat,
+                        PixelBlend::BlendComponent(uyRed, uyDestinationRed, uyAlpha),
+                        PixelBlend::BlendComponent(uyGreen, uyDestinationGreen, uyAlpha),
+                        PixelBlend::BlendComponent(uyBlue, uyDestinationBlue, uyAlpha)));
+                }
+            }
+        });
+    }
+    catch (...)
+    {
+        if (SDL_MUSTLOCK(pSdlSurfaceSource)) SDL_UnlockSurface(pSdlSurfaceSource);
+        throw;
+    }
+
+    if (SDL_MUSTLOCK(pSdlSurfaceSource)) SDL_UnlockSurface(pSdlSurfaceSource);
+}
+
+
+/**
+ * @brief Gets the pixel format that surfaces with an alpha channel take when they are converted to the
+ * display, which must be done from the main thread
+ *
+ * @return SDL_PixelFormat the format, without a palette
+ */
+SDL_PixelFormat Surface::GetDisplayAlphaFormat()
+{
+    // SDL picks the format from the display, so converting one pixel tells which one it is
+    SDL_Surface* pSdlSurfaceProbe{SDL_CreateRGBSurface(SDL_SWSURFACE, 1, 1, 32, 0x00FF0000, 0x0000FF00,
+        0x000000FF, 0xFF000000)};
+    if (pSdlSurfaceProbe == nullptr) throw std::runtime_error(SDL_GetError());
+
+    SDL_Surface* pSdlSurfaceConverted{SDL_DisplayFormatAlpha(pSdlSurfaceProbe)};
+    SDL_FreeSurface(pSdlSurfaceProbe);
+    if (pSdlSurfaceConverted == nullptr) throw std::runtime_error(SDL_GetError());
+
+    SDL_PixelFormat sdlPixelFormat{*pSdlSurfaceConverted->format};
+    sdlPixelFormat.palette = nullptr;
+    SDL_FreeSurface(pSdlSurfaceConverted);
+
+    return sdlPixelFormat;
+}
@@ -0,0 +1,261 @@
+/*
+TextRenderer.cpp --- Text rendering with cached glyphs and strings
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <list>
+#include <vector>
+#include <span>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <SDL_video.h>
+#include <SDL_error.h>
+#include <SDL_ttf.h>
+
+#include "../../include/video/TextRenderer.hpp"
+#include "../../include/video/Surface.hpp"
+#include "../../include/video/PixelView.hpp"
+
+
+namespace
+{
+    /**
+     * @brief Gets the number of bytes of the UTF-8 sequence that starts with a byte
+     *
+     * @param cLead the first byte of the sequence
+     * @return std::size_t the length of the sequence, 1 for stray bytes
+     */
+    std::size_t GetSequenceLength(char cLead) noexcept
+    {
+        uint8_t uyLead{static_cast<uint8_t>(cLead)};
+
+        if (uyLead >= 0xF0) return 4;
+        if (uyLead >= 0xE0) return 3;
+        if (uyLead >= 0xC0) return 2;
+        return 1;
+    }
+
+
+    /**
+     * @brief Decodes a UTF-8 sequence of the Basic Multilingual Plane, the only plane SDL_ttf measures
+     * glyph by glyph
+     *
+     * @param CsSequence the bytes of the sequence
+     * @param urCodepoint the decoded codepoint
+     * @return true if the sequence fits in 16 bits
+     * @return false otherwise
+     */
+    bool DecodeSequence(const std::string& CsSequence, uint16_t& urCodepoint) noexcept
+    {
+        const uint8_t* CpuyBytes{reinterpret_cast<const uint8_t*>(CsSequence.data())};
+
+        switch (CsSequence.size())
+        {
+        case 1: urCodepoint = CpuyBytes[0]; return true;
+        case 2: urCodepoint = (CpuyBytes[0] & 0x1F) << 6 | (CpuyBytes[1] & 0x3F); return true;
+        case 3:
+            urCodepoint = (CpuyBytes[0] & 0x0F) << 12 | (CpuyBytes[1] & 0x3F) << 6 | (CpuyBytes[2] & 0x3F);
+            return true;
+        default: return false;
+        }
+    }
+}
+
+
+/**
+ * @brief Default constructor
+ */
+TextRenderer::TextRenderer() noexcept : _listStrings{}, _htStrings{}, _htGlyphs{} {}
+
+
+/**
+ * @brief Renders a string
+ *
+ * @param CsText the UTF-8 text
+ * @param pTtfFont the font
+ * @param CsdlColor the colour of the text
+ * @return Surface* a surface with the text on a transparent background, owned by the caller, which
+ * shares its pixels with the cache and must not be changed
+ */
+Surface* TextRenderer::Render(const std::string& CsText, TTF_Font* pTtfFont, const SDL_Color& CsdlColor)
+{
+    std::string sKey{MakeKey(CsText, pTtfFont, CsdlColor)};
+
+    std::unordered_map<std::string, std::list<StringEntry>::iterator>::iterator i = _htStrings.find(sKey);
+    if (i != _htStrings.end())
+    {
+        _listStrings.splice(_listStrings.begin(), _listStrings, i->second);
+        return i->second->second.Share();
+    }
+
+    _listStrings.emplace_front(sKey, Compose(CsText, pTtfFont, CsdlColor));
+    _htStrings.insert(std::make_pair(sKey, _listStrings.begin()));
+
+    if (_listStrings.size() > SCuStringCapacity)
+    {
+        _htStrings.erase(_listStrings.back().first);
+        _listStrings.pop_back();
+    }
+
+    return _listStrings.front().second.Share();
+}
+
+
+/**
+ * @brief Drops every cached glyph and string, which must be done before closing a font
+ */
+void TextRenderer::Clear() noexcept
+{
+    _htStrings.clear();
+    _listStrings.clear();
+    _htGlyphs.clear();
+}
+
+
+/**
+ * @brief Makes the key of a text in a font and colour
+ *
+ * @param CsText the UTF-8 text
+ * @param pTtfFont the font
+ * @param CsdlColor the colour of the text
+ * @return std::string the key
+ */
+std::string TextRenderer::MakeKey(const std::string& CsText, const TTF_Font* pTtfFont,
+    const SDL_Color& CsdlColor)
+{
+    std::string sKey{CsText};
+    sKey.push_back('\0');
+    sKey.append(reinterpret_cast<const char*>(&pTtfFont), sizeof(pTtfFont));
+    sKey.push_back(static_cast<char>(CsdlColor.r));
+    sKey.push_back(static_cast<char>(CsdlColor.g));
+    sKey.push_back(static_cast<char>(CsdlColor.b));
+
+    return sKey;
+}
+
+
+/**
+ * @brief Gets a glyph, rendering it the first time
+ *
+ * @param CsGlyph the UTF-8 bytes of the glyph
+ * @param pTtfFont the font
+ * @param CsdlColor the colour of the text
+ * @return Surface& the glyph on a transparent background, rendered on its own
+ */
+Surface& TextRenderer::GetGlyph(const std::string& CsGlyph, TTF_Font* pTtfFont, const SDL_Color& CsdlColor)
+{
+    std::string sKey{MakeKey(CsGlyph, pTtfFont, CsdlColor)};
+
+    std::unordered_map<std::string, Surface>::iterator i = _htGlyphs.find(sKey);
+    if (i != _htGlyphs.end()) return i->second;
+
+    SDL_Surface* pSdlSurfaceGlyph{TTF_RenderUTF8_Blended(pTtfFont, CsGlyph.c_str(), CsdlColor)};
+    if (!pSdlSurfaceGlyph) throw std::runtime_error(TTF_GetError());
+
+    return _htGlyphs.emplace(sKey, Surface{pSdlSurfaceGlyph}).first->second;
+}
+
+
+/**
+ * @brief Composes a string from its glyphs
+ *
+ * @param CsText the UTF-8 text
+ * @param pTtfFont the font
+ * @param CsdlColor the colour of the text
+ * @return Surface the text on a transparent background
+ */
+Surface TextRenderer::Compose(const std::string& CsText, TTF_Font* pTtfFont, const SDL_Color& CsdlColor)
+{
+    // Split the text and measure every glyph before drawing anything, adding the kerning with the next glyph
+    // to the advance of each one as SDL_ttf does when it renders the whole text
+    std::vector<std::pair<std::string, int32_t>> vectorGlyphs{};
+    const bool CbKerning{TTF_GetFontKerning(pTtfFont) != 0};
+    int32_t iPreviousIndex{0};
+    for (std::size_t i = 0; i < CsText.size();)
+    {
+        std::string sGlyph{CsText.substr(i, GetSequenceLength(CsText[i]))};
+        i += sGlyph.size();
+
+        uint16_t urCodepoint{0};
+        int32_t iAdvance{0};
+        if (!DecodeSequence(sGlyph, urCodepoint) ||
+            TTF_GlyphMetrics(pTtfFont, urCodepoint, nullptr, nullptr, nullptr, nullptr, &iAdvance) == -1)
+        {
+            // Glyphs out of the Basic Multilingual Plane are left to SDL_ttf, along with the rest of the text
+            SDL_Surface* pSdlSurfaceText{TTF_RenderUTF8_Blended(pTtfFont, CsText.c_str(), CsdlColor)};
+            if (!pSdlSurfaceText) throw std::runtime_error(TTF_GetError());
+
+            return Surface{pSdlSurfaceText};
+        }
+
+        int32_t iIndex{TTF_GlyphIsProvided(pTtfFont, urCodepoint)};
+        if (CbKerning && iPreviousIndex != 0 && iIndex != 0)
+            vectorGlyphs.back().second += TTF_GetFontKerningSize(pTtfFont, iPreviousIndex, iIndex);
+        iPreviousIndex = iIndex;
+
+        vectorGlyphs.push_back(std::make_pair(sGlyph, iAdvance));
+    }
+
+    int32_t iWidth{0}, iHeight{0};
+    if (TTF_SizeUTF8(pTtfFont, CsText.c_str(), &iWidth, &iHeight) == -1)
+        throw std::runtime_error(TTF_GetError());
+    if (iWidth <= 0) throw std::runtime_error("Text has zero width");
+
+    // The same pixel format as the surfaces made by SDL_ttf, with the colour of the text on every pixel
+    SDL_Surface* pSdlSurfaceText{SDL_CreateRGBSurface(SDL_SWSURFACE, iWidth, iHeight, 32, 0x00FF0000,
+        0x0000FF00, 0x000000FF, 0xFF000000)};
+    if (!pSdlSurfaceText) throw std::runtime_error(SDL_GetError());
+
+    Surface surfaceText{pSdlSurfaceText};
+    {
+        PixelView<uint32_t> viewText{surfaceText};
+        const uint32_t CuiAlphaMask{viewText.GetPixelFormat()->Amask};
+        viewText.Fill(SDL_MapRGBA(viewText.GetPixelFormat(), CsdlColor.r, CsdlColor.g, CsdlColor.b,
+            SDL_ALPHA_TRANSPARENT));
+
+        int32_t iPenX{0};
+        for (const std::pair<std::string, int32_t>& Cglyph : vectorGlyphs)
+        {
+            PixelView<uint32_t> viewGlyph{GetGlyph(Cglyph.first, pTtfFont, CsdlColor)};
+            int32_t iRight{std::min(iPenX + viewGlyph.GetWidth(), iWidth)};
+            int32_t iBottom{std::min(viewGlyph.GetHeight(), iHeight)};
+
+            // Glyphs may overlap their neighbours, where the most opaque pixel is kept
+            for (int32_t i = 0; i < iBottom; ++i)
+            {
+                std::span<uint32_t> spanGlyph{viewGlyph[i]}, spanText{viewText[i]};
+                for (int32_t j = std::max(iPenX, 0); j < iRight; ++j)
+                {
+                    uint32_t uiGlyphPixel{spanGlyph[j - iPenX]};
+                    if ((uiGlyphPixel & CuiAlphaMask) > (spanText[j] & CuiAlphaMask))
+                        spanText[j] = uiGlyphPixel;
+                }
+            }
+
+            iPenX += Cglyph.second;
+        }
+    }
+
+    return surfaceText;
+}
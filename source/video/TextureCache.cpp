@@ -0,0 +1,347 @@
+/*
+TextureCache.cpp --- On-disk cache of converted textures
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include <new>
+#include <initializer_list>
+
+#include <SDL_video.h>
+
+#ifndef __wii__
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include "../../include/video/TextureCache.hpp"
+#include "../../include/video/Surface.hpp"
+
+
+namespace
+{
+    /* The entries are little-endian on every platform */
+
+    uint32_t ReadUInt32(const uint8_t* CpuyData) noexcept
+    {
+        return static_cast<uint32_t>(CpuyData[0]) | (static_cast<uint32_t>(CpuyData[1]) << 8) |
+            (static_cast<uint32_t>(CpuyData[2]) << 16) | (static_cast<uint32_t>(CpuyData[3]) << 24);
+    }
+
+    uint64_t ReadUInt64(const uint8_t* CpuyData) noexcept
+    {
+        return static_cast<uint64_t>(ReadUInt32(CpuyData)) |
+            (static_cast<uint64_t>(ReadUInt32(CpuyData + 4)) << 32);
+    }
+
+    void WriteUInt32(std::vector<uint8_t>& vectoruyData, uint32_t uiValue)
+    { for (uint8_t i = 0; i < 4; ++i) vectoruyData.push_back(static_cast<uint8_t>(uiValue >> (i << 3))); }
+
+    void WriteUInt64(std::vector<uint8_t>& vectoruyData, uint64_t uValue)
+    { for (uint8_t i = 0; i < 8; ++i) vectoruyData.push_back(static_cast<uint8_t>(uValue >> (i << 3))); }
+
+    const uint8_t SCuyFlagAlpha{1};         /**< The texture blends with its alpha channel */
+    const uint8_t SCuyFlagColourKey{2};     /**< The texture has a transparent colour */
+}
+
+
+/**
+ * @brief Constructor
+ *
+ * @param CsDirectory the directory of the entries, created on the first store
+ */
+TextureCache::TextureCache(const std::string& CsDirectory) : _sDirectory{CsDirectory} {}
+
+
+/**
+ * @brief Loads a texture stored by an earlier run
+ *
+ * @param CsPath the path of the image file
+ * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+ * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+ * @param CsdlPixelFormat the pixel format the texture was converted to
+ * @return Surface* the texture, nullptr if there is no entry or the image changed since it was stored
+ */
+Surface* TextureCache::Load(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+    const SDL_PixelFormat& CsdlPixelFormat) const noexcept
+{
+    if (CsdlPixelFormat.BitsPerPixel <= 8) return nullptr;  // Paletted displays are not cached
+
+    uint64_t uTime{0};
+    if (!GetModificationTime(CsPath, uTime)) return nullptr;
+
+    std::string sEntryPath{};
+    try { sEntryPath = GetEntryPath(CsPath, urFitWidth, urFitHeight, CsdlPixelFormat); }
+    catch (...) { return nullptr; }
+
+    uint8_t auyHeader[SCuyHeaderSize]{};
+
+#ifdef __wii__
+    std::FILE* pFile{std::fopen(sEntryPath.c_str(), "rb")};
+    if (pFile == nullptr) return nullptr;
+
+    if (std::fread(auyHeader, 1, SCuyHeaderSize, pFile) != SCuyHeaderSize)
+    {
+        std::fclose(pFile);
+        return nullptr;
+    }
+#else
+    int32_t iFile{open(sEntryPath.c_str(), O_RDONLY)};
+    if (iFile == -1) return nullptr;
+
+    struct stat statFile{};
+    if (fstat(iFile, &statFile) == -1 || statFile.st_size < SCuyHeaderSize)
+    {
+        close(iFile);
+        return nullptr;
+    }
+
+    std::size_t uMappingSize{static_cast<std::size_t>(statFile.st_size)};
+    void* pMapping{mmap(nullptr, uMappingSize, PROT_READ, MAP_PRIVATE, iFile, 0)};
+    close(iFile);   // The mapping keeps the file open
+    if (pMapping == MAP_FAILED) return nullptr;
+
+    const uint8_t* CpuyMapping{static_cast<const uint8_t*>(pMapping)};
+    std::memcpy(auyHeader, CpuyMapping, SCuyHeaderSize);
+#endif
+
+    // A changed image or display leaves the entry stale until it is stored again
+    uint32_t uiWidth{ReadUInt32(auyHeader + 16)};
+    uint32_t uiHeight{ReadUInt32(auyHeader + 20)};
+    std::size_t uRowSize{static_cast<std::size_t>(uiWidth) * CsdlPixelFormat.BytesPerPixel};
+
+    bool bValid{std::memcmp(auyHeader, "CXTC", 4) == 0 && auyHeader[4] == SCuyVersion &&
+        auyHeader[5] == CsdlPixelFormat.BitsPerPixel && ReadUInt64(auyHeader + 8) == uTime &&
+        uiWidth > 0 && uiWidth <= UINT16_MAX && uiHeight > 0 && uiHeight <= UINT16_MAX &&
+        ReadUInt32(auyHeader + 24) == CsdlPixelFormat.Rmask &&
+        ReadUInt32(auyHeader + 28) == CsdlPixelFormat.Gmask &&
+        ReadUInt32(auyHeader + 32) == CsdlPixelFormat.Bmask &&
+        ReadUInt32(auyHeader + 36) == CsdlPixelFormat.Amask};
+#ifndef __wii__
+    bValid = bValid && uMappingSize == SCuyHeaderSize + uRowSize * uiHeight;
+#endif
+
+    SDL_Surface* pSdlSurface{nullptr};
+    if (bValid)
+    {
+        pSdlSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, uiWidth, uiHeight, CsdlPixelFormat.BitsPerPixel,
+            CsdlPixelFormat.Rmask, CsdlPixelFormat.Gmask, CsdlPixelFormat.Bmask, CsdlPixelFormat.Amask);
+
+        if (pSdlSurface && SDL_LockSurface(pSdlSurface) == 0)
+        {
+            // The rows are packed in the entry, the surface may pad them
+            uint8_t* puyPixels{static_cast<uint8_t*>(pSdlSurface->pixels)};
+            for (uint32_t i = 0; i < uiHeight && bValid; ++i)
+            {
+#ifdef __wii__
+                bValid = std::fread(puyPixels + i * pSdlSurface->pitch, 1, uRowSize, pFile) == uRowSize;
+#else
+                std::memcpy(puyPixels + i * pSdlSurface->pitch, CpuyMapping + SCuyHeaderSize + i * uRowSize,
+                    uRowSize);
+#endif
+            }
+            SDL_UnlockSurface(pSdlSurface);
+        }
+        else bValid = false;
+    }
+
+#ifdef __wii__
+    std::fclose(pFile);
+#else
+    munmap(pMapping, uMappingSize);
+#endif
+
+    if (bValid && (auyHeader[6] & SCuyFlagAlpha))
+        bValid = SDL_SetAlpha(pSdlSurface, SDL_SRCALPHA | SDL_RLEACCEL, auyHeader[7]) == 0;
+    if (bValid && (auyHeader[6] & SCuyFlagColourKey))
+        bValid = SDL_SetColorKey(pSdlSurface, SDL_SRCCOLORKEY | SDL_RLEACCEL, ReadUInt32(auyHeader + 40)) == 0;
+
+    Surface* pSurfaceLoaded{bValid ? new (std::nothrow) Surface(pSdlSurface) : nullptr};
+    if (pSurfaceLoaded == nullptr && pSdlSurface) SDL_FreeSurface(pSdlSurface);
+
+    return pSurfaceLoaded;
+}
+
+
+/**
+ * @brief Stores a texture converted to the format of the display, errors are ignored
+ *
+ * @param CsPath the path of the image file
+ * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+ * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+ * @param Csurface the texture
+ */
+void TextureCache::Store(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+    const Surface& Csurface) const noexcept
+{
+    Entry entry{};
+    if (Prepare(CsPath, urFitWidth, urFitHeight, Csurface, entry)) Write(entry);
+}
+
+
+/**
+ * @brief Copies a texture converted to the format of the display into an entry, to be written later
+ *
+ * @param CsPath the path of the image file
+ * @param urFitWidth the width the texture was scaled to fit, 0 if it was not scaled
+ * @param urFitHeight the height the texture was scaled to fit, 0 if it was not scaled
+ * @param Csurface the texture
+ * @param entry receives the entry
+ * @return bool false if the texture cannot be cached
+ */
+bool TextureCache::Prepare(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+    const Surface& Csurface, Entry& entry) const noexcept
+{
+    SDL_Surface* pSdlSurface{Csurface};
+    const SDL_PixelFormat* CpSdlPixelFormat{pSdlSurface->format};
+    if (CpSdlPixelFormat->BitsPerPixel <= 8) return false;
+
+    uint64_t uTime{0};
+    if (!GetModificationTime(CsPath, uTime)) return false;
+
+    try
+    {
+        std::size_t uRowSize{static_cast<std::size_t>(pSdlSurface->w) * CpSdlPixelFormat->BytesPerPixel};
+
+        std::vector<uint8_t> vectoruyEntry{'C', 'X', 'T', 'C', SCuyVersion, CpSdlPixelFormat->BitsPerPixel,
+            static_cast<uint8_t>(((pSdlSurface->flags & SDL_SRCALPHA) ? SCuyFlagAlpha : 0) |
+            ((pSdlSurface->flags & SDL_SRCCOLORKEY) ? SCuyFlagColourKey : 0)), CpSdlPixelFormat->alpha};
+        vectoruyEntry.reserve(SCuyHeaderSize + uRowSize * pSdlSurface->h);
+
+        WriteUInt64(vectoruyEntry, uTime);
+        WriteUInt32(vectoruyEntry, pSdlSurface->w);
+        WriteUInt32(vectoruyEntry, pSdlSurface->h);
+        WriteUInt32(vectoruyEntry, CpSdlPixelFormat->Rmask);
+        WriteUInt32(vectoruyEntry, CpSdlPixelFormat->Gmask);
+        WriteUInt32(vectoruyEntry, CpSdlPixelFormat->Bmask);
+        WriteUInt32(vectoruyEntry, CpSdlPixelFormat->Amask);
+        WriteUInt32(vectoruyEntry, CpSdlPixelFormat->colorkey);
+
+        // Locking also decodes a surface that was RLE accelerated
+        if (SDL_LockSurface(pSdlSurface) == -1) return false;
+        const uint8_t* CpuyPixels{static_cast<const uint8_t*>(pSdlSurface->pixels)};
+        for (int32_t i = 0; i < pSdlSurface->h; ++i)
+            vectoruyEntry.insert(vectoruyEntry.end(), CpuyPixels + i * pSdlSurface->pitch,
+                CpuyPixels + i * pSdlSurface->pitch + uRowSize);
+        SDL_UnlockSurface(pSdlSurface);
+
+        entry.sPath = GetEntryPath(CsPath, urFitWidth, urFitHeight, *CpSdlPixelFormat);
+        entry.vectoruyData.swap(vectoruyEntry);
+    }
+    catch (...) { return false; }
+
+    return true;
+}
+
+
+/**
+ * @brief Writes an entry, replacing the one of an older image, errors are ignored
+ *
+ * @param Centry the entry
+ */
+void TextureCache::Write(const Entry& Centry) const noexcept
+{
+    try
+    {
+        std::error_code errorCode{};
+        std::filesystem::create_directories(_sDirectory, errorCode);
+
+        // Written aside and renamed, so an interrupted store never leaves a truncated entry
+        std::string sTempPath{Centry.sPath + ".tmp"};
+        {
+            std::ofstream ofstreamEntry{sTempPath, std::ios_base::out | std::ios_base::binary |
+                std::ios_base::trunc};
+            ofstreamEntry.write(reinterpret_cast<const char*>(Centry.vectoruyData.data()),
+                Centry.vectoruyData.size());
+            if (!ofstreamEntry) return;
+        }
+        std::filesystem::rename(sTempPath, Centry.sPath, errorCode);
+        if (errorCode) std::filesystem::remove(sTempPath, errorCode);
+    }
+    catch (...) {}  // The texture is simply decoded again on the next run
+}
+
+
+/**
+ * @brief Gets the path of the entry of a texture
+ *
+ * @param CsPath the path of the image file
+ * @param urFitWidth the width the texture was scaled to fit
+ * @param urFitHeight the height the texture was scaled to fit
+ * @param CsdlPixelFormat the pixel format of the texture
+ * @return std::string the path of the entry
+ */
+std::string TextureCache::GetEntryPath(const std::string& CsPath, uint16_t urFitWidth, uint16_t urFitHeight,
+    const SDL_PixelFormat& CsdlPixelFormat) const
+{
+    // FNV-1a, which is stable between builds unlike std::hash
+    uint64_t uHash{14695981039346656037ull};
+    for (char cCharacter : std::filesystem::path(CsPath).lexically_normal().string())
+    {
+        uHash ^= static_cast<uint8_t>(cCharacter);
+        uHash *= 1099511628211ull;
+    }
+
+    // Displays of the same depth may order their channels differently, so the masks are hashed too
+    uint64_t uHashFormat{14695981039346656037ull};
+    for (uint32_t uiMask : {CsdlPixelFormat.Rmask, CsdlPixelFormat.Gmask, CsdlPixelFormat.Bmask,
+        CsdlPixelFormat.Amask})
+    {
+        for (uint8_t i = 0; i < 4; ++i)
+        {
+            uHashFormat ^= static_cast<uint8_t>(uiMask >> (i << 3));
+            uHashFormat *= 1099511628211ull;
+        }
+    }
+
+    std::ostringstream ossEntry{};
+    ossEntry << std::hex << uHash << std::dec << '_' << urFitWidth << 'x' << urFitHeight << '_' <<
+        static_cast<uint32_t>(CsdlPixelFormat.BitsPerPixel) << '_' << std::hex <<
+        static_cast<uint32_t>(uHashFormat) << ".tex";
+
+    return (std::filesystem::path(_sDirectory) / ossEntry.str()).lexically_normal().string();
+}
+
+
+/**
+ * @brief Gets the modification time of a file
+ *
+ * @param CsPath the path of the file
+ * @param uTime the modification time, in the units of the filesystem clock
+ * @return bool false if the file could not be read
+ */
+bool TextureCache::GetModificationTime(const std::string& CsPath, uint64_t& uTime) noexcept
+{
+    std::error_code errorCode{};
+    std::filesystem::file_time_type timeWrite{std::filesystem::last_write_time(CsPath, errorCode)};
+    if (errorCode) return false;
+
+    uTime = static_cast<uint64_t>(timeWrite.time_since_epoch().count());
+    return true;
+}
@@ -34,6 +34,7 @@ Time& Time::GetInstance()
  */
 void Time::OnLoop() 
 {
+    if (_urFixedStep != 0) _uiFixedTime += _urFixedStep;
     uint32_t uiTime{GetTime()};
 
     if (_uiOldTime + 1000 < uiTime)     // A full second has elapsed
@@ -53,5 +54,19 @@ void Time::OnLoop()
 /**
  * @brief Default constructor
  */
-Time::Time() noexcept : _uiOldTime{}, _uiLastTime{}, _fDeltaTime{}, _urNumFrames{}, _urFrameCount{}
+Time::Time() noexcept : _uiOldTime{}, _uiLastTime{}, _fDeltaTime{}, _urNumFrames{}, _urFrameCount{},
+    _urFixedStep{0}, _uiFixedTime{0}
 {}
+
+
+/**
+ * @brief Makes the time advance by a fixed step on every frame instead of following the clock, so
+ * the frames of automated runs are the same every time
+ * 
+ * @param urStep the milliseconds per frame, 0 to follow the clock again
+ */
+void Time::SetFixedStep(uint16_t urStep) noexcept
+{
+    _uiFixedTime = GetTime();   // The fixed steps continue from the current time
+    _urFixedStep = urStep;
+}
@@ -0,0 +1,98 @@
+/*
+Timeline.cpp --- Clock shared by the animations on screen
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "../../include/video/Timeline.hpp"
+#include "../../include/video/Animation.hpp"
+
+
+/**
+ * @brief Default constructor
+ */
+Timeline::Timeline() noexcept : _vectorpAnimations{}, _uiTime{0} {}
+
+
+/**
+ * @brief Starts or stops playing an animation. A new animation starts counting from the last time the
+ * timeline was moved
+ *
+ * @param animation the animation, which must live until it is stopped or the timeline is cleared
+ * @param bIsPlaying true to play the animation, false to stop it where it is
+ */
+void Timeline::SetPlaying(Animation& animation, bool bIsPlaying)
+{
+    std::vector<Animation*>::iterator i{std::find(_vectorpAnimations.begin(), _vectorpAnimations.end(),
+        &animation)};
+
+    if (bIsPlaying && i == _vectorpAnimations.end()) _vectorpAnimations.push_back(&animation);
+    else if (!bIsPlaying && i != _vectorpAnimations.end()) _vectorpAnimations.erase(i);
+}
+
+
+/**
+ * @brief Tells whether an animation is being played
+ *
+ * @param Canimation the animation
+ * @return true if the animation is advanced by the timeline
+ */
+bool Timeline::IsPlaying(const Animation& Canimation) const noexcept
+{
+    return std::find(_vectorpAnimations.begin(), _vectorpAnimations.end(), &Canimation) !=
+        _vectorpAnimations.end();
+}
+
+
+/**
+ * @brief Stops every animation, which must be done before they are freed
+ */
+void Timeline::Clear() noexcept { _vectorpAnimations.clear(); }
+
+
+/**
+ * @brief Moves the timeline to a time, advancing every animation being played by the time passed since it
+ * was last moved
+ *
+ * @param uiTime the current time in milliseconds
+ */
+void Timeline::Advance(uint32_t uiTime) noexcept
+{
+    uint32_t uiDeltaTime{uiTime - _uiTime};     // Unsigned, so the wrap of the tick counter does not matter
+    _uiTime = uiTime;
+
+    for (Animation* pAnimation : _vectorpAnimations) pAnimation->Advance(uiDeltaTime);
+}
+
+
+/**
+ * @brief Gets the time of the next frame change of any animation being played
+ *
+ * @return uint32_t the time in milliseconds, only meaningful if the timeline is not idle
+ */
+uint32_t Timeline::GetNextDeadline() const noexcept
+{
+    uint32_t uiTimeToNextFrame{UINT32_MAX};
+    for (const Animation* CpAnimation : _vectorpAnimations)
+        uiTimeToNextFrame = std::min(uiTimeToNextFrame, CpAnimation->GetTimeToNextFrame());
+
+    return _uiTime + uiTimeToNextFrame;
+}
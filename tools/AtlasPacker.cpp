@@ -0,0 +1,217 @@
+/*
+AtlasPacker.cpp --- Offline packer of the UI sprites into one texture atlas
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <unordered_map>
+#include <stdexcept>
+#include <ios>
+#include <exception>
+#include <algorithm>
+
+#include <png.h>
+
+
+namespace
+{
+    const uint32_t SCuiPadding{1};  /**< Transparent pixels between sprites */
+
+
+    /**
+     * @brief An RGBA image in memory
+     */
+    struct Image
+    {
+        uint32_t uiWidth;
+        uint32_t uiHeight;
+        std::vector<uint8_t> vectoruyPixels;
+    };
+
+
+    /**
+     * @brief A sprite of the manifest and its place in the atlas
+     */
+    struct Sprite
+    {
+        std::string sName;
+        std::string sFile;
+        uint32_t uiSourceX, uiSourceY, uiWidth, uiHeight;
+        uint32_t uiX, uiY;
+    };
+
+
+    /**
+     * @brief Reads a PNG file as RGBA
+     *
+     * @param CsPath the path of the file
+     * @return Image the decoded image
+     */
+    Image ReadImage(const std::string& CsPath)
+    {
+        png_image pngImage{};
+        pngImage.version = PNG_IMAGE_VERSION;
+
+        if (!png_image_begin_read_from_file(&pngImage, CsPath.c_str()))
+            throw std::ios_base::failure("Error reading " + CsPath + ": " + pngImage.message);
+
+        pngImage.format = PNG_FORMAT_RGBA;
+        Image image{pngImage.width, pngImage.height, std::vector<uint8_t>(PNG_IMAGE_SIZE(pngImage))};
+
+        if (!png_image_finish_read(&pngImage, nullptr, image.vectoruyPixels.data(), 0, nullptr))
+            throw std::ios_base::failure("Error decoding " + CsPath + ": " + pngImage.message);
+
+        return image;
+    }
+
+
+    /**
+     * @brief Places the sprites on shelves, tallest first, and returns the height of the atlas
+     *
+     * @param vectorSprites the sprites to place
+     * @param uiWidth the width of the atlas
+     * @return uint32_t the height of the atlas
+     */
+    uint32_t Pack(std::vector<Sprite>& vectorSprites, uint32_t uiWidth)
+    {
+        std::vector<Sprite*> vectorpSprites{};
+        for (Sprite& sprite : vectorSprites) vectorpSprites.push_back(&sprite);
+        std::stable_sort(vectorpSprites.begin(), vectorpSprites.end(), [](const Sprite* CpSprite1,
+            const Sprite* CpSprite2) { return CpSprite1->uiHeight > CpSprite2->uiHeight; });
+
+        uint32_t uiShelfY{0}, uiShelfHeight{0}, uiX{0};
+        for (Sprite* pSprite : vectorpSprites)
+        {
+            if (pSprite->uiWidth > uiWidth)
+                throw std::length_error(pSprite->sName + " is wider than the atlas");
+
+            if (uiX + pSprite->uiWidth > uiWidth)    // Start a new shelf
+            {
+                uiShelfY += uiShelfHeight + SCuiPadding;
+                uiShelfHeight = 0;
+                uiX = 0;
+            }
+
+            pSprite->uiX = uiX;
+            pSprite->uiY = uiShelfY;
+            uiX += pSprite->uiWidth + SCuiPadding;
+            uiShelfHeight = std::max(uiShelfHeight, pSprite->uiHeight);
+        }
+
+        return uiShelfY + uiShelfHeight;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::fprintf(stderr, "Usage: %s <manifest> <source directory> <atlas image> <atlas index> [width]\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string sManifestPath{argv[1]};
+    std::string sSourceDirectory{argv[2]};
+    std::string sImagePath{argv[3]};
+    std::string sIndexPath{argv[4]};
+    uint32_t uiWidth{argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 512};
+
+    try
+    {
+        // Every line holds a name and a file, optionally followed by the rectangle to take from the file
+        std::ifstream ifstreamManifest{sManifestPath};
+        if (!ifstreamManifest) throw std::ios_base::failure("Error opening file " + sManifestPath);
+
+        std::vector<Sprite> vectorSprites{};
+        std::unordered_map<std::string, Image> htImages{};
+        for (std::string sLine{}; std::getline(ifstreamManifest, sLine);)
+        {
+            if (sLine.empty() || sLine[0] == '#') continue;
+
+            std::istringstream issLine{sLine};
+            Sprite sprite{};
+            if (!(issLine >> sprite.sName >> sprite.sFile)) throw std::runtime_error("Bad line: " + sLine);
+
+            if (!htImages.contains(sprite.sFile))
+                htImages.emplace(sprite.sFile, ReadImage(sSourceDirectory + "/" + sprite.sFile));
+            const Image& Cimage{htImages.at(sprite.sFile)};
+
+            if (!(issLine >> sprite.uiSourceX >> sprite.uiSourceY >> sprite.uiWidth >> sprite.uiHeight))
+            {
+                sprite.uiSourceX = sprite.uiSourceY = 0;
+                sprite.uiWidth = Cimage.uiWidth;
+                sprite.uiHeight = Cimage.uiHeight;
+            }
+            if (sprite.uiSourceX + sprite.uiWidth > Cimage.uiWidth ||
+                sprite.uiSourceY + sprite.uiHeight > Cimage.uiHeight)
+                throw std::out_of_range(sprite.sName + " falls outside " + sprite.sFile);
+
+            vectorSprites.push_back(sprite);
+        }
+
+        uint32_t uiHeight{Pack(vectorSprites, uiWidth)};
+
+        Image imageAtlas{uiWidth, uiHeight, std::vector<uint8_t>(uiWidth * uiHeight * 4, 0)};
+        std::ofstream ofstreamIndex{sIndexPath, std::ios_base::out | std::ios_base::trunc};
+        if (!ofstreamIndex) throw std::ios_base::failure("Error opening file " + sIndexPath);
+
+        uint32_t uiArea{0};
+        for (const Sprite& Csprite : vectorSprites)
+        {
+            const Image& Cimage{htImages.at(Csprite.sFile)};
+            for (uint32_t i = 0; i < Csprite.uiHeight; ++i)
+                std::memcpy(&imageAtlas.vectoruyPixels[((Csprite.uiY + i) * uiWidth + Csprite.uiX) * 4],
+                    &Cimage.vectoruyPixels[((Csprite.uiSourceY + i) * Cimage.uiWidth + Csprite.uiSourceX) * 4],
+                    Csprite.uiWidth * 4);
+
+            // The file the sprite came from lets the game patch the atlas with a custom copy of that file
+            ofstreamIndex << Csprite.sName << ' ' << Csprite.uiX << ' ' << Csprite.uiY << ' ' <<
+                Csprite.uiWidth << ' ' << Csprite.uiHeight << ' ' << Csprite.sFile << ' ' <<
+                Csprite.uiSourceX << ' ' << Csprite.uiSourceY << '\n';
+            uiArea += Csprite.uiWidth * Csprite.uiHeight;
+        }
+        if (!ofstreamIndex) throw std::ios_base::failure("I/O Error");
+
+        png_image pngImage{};
+        pngImage.version = PNG_IMAGE_VERSION;
+        pngImage.width = uiWidth;
+        pngImage.height = uiHeight;
+        pngImage.format = PNG_FORMAT_RGBA;
+        if (!png_image_write_to_file(&pngImage, sImagePath.c_str(), 0, imageAtlas.vectoruyPixels.data(), 0,
+            nullptr)) throw std::ios_base::failure("Error writing " + sImagePath + ": " + pngImage.message);
+
+        std::printf("Packed %zu sprites from %zu files into %ux%u, %u%% used\n", vectorSprites.size(),
+            htImages.size(), uiWidth, uiHeight, uiArea * 100 / (uiWidth * uiHeight));
+    }
+    catch (const std::exception& Cexception)
+    {
+        std::fprintf(stderr, "%s\n", Cexception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+/*
+BlendBenchmark.cpp --- Compares the premultiplied blend with SDL on the sprites of the game
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <ios>
+#include <exception>
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include "../include/video/PixelBlend.hpp"
+
+
+namespace
+{
+    const char* const SCapcSprites[]{"playermarker1.png", "playermarker2.png", "emptycell.png",
+        "cursorhand.png", "cursorshadow.png", "cursorplayer1.png", "cursorplayer2.png", "DefaultButton.png",
+        "HoverButton.png"};     /**< The sprites blended on every frame they change */
+
+
+    /**
+     * @brief Creates a surface with the given masks
+     *
+     * @param iWidth the width in pixels
+     * @param iHeight the height in pixels
+     * @param iBitsPerPixel the size of a pixel in bits
+     * @param uiRedMask the mask of the red component
+     * @param uiGreenMask the mask of the green component
+     * @param uiBlueMask the mask of the blue component
+     * @param uiAlphaMask the mask of the alpha component
+     * @return SDL_Surface* the surface
+     */
+    SDL_Surface* MakeSurface(int32_t iWidth, int32_t iHeight, int32_t iBitsPerPixel, uint32_t uiRedMask,
+        uint32_t uiGreenMask, uint32_t uiBlueMask, uint32_t uiAlphaMask)
+    {
+        SDL_Surface* pSdlSurface{SDL_CreateRGBSurface(SDL_SWSURFACE, iWidth, iHeight, iBitsPerPixel, uiRedMask,
+            uiGreenMask, uiBlueMask, uiAlphaMask)};
+        if (pSdlSurface == nullptr) throw std::runtime_error(SDL_GetError());
+
+        return pSdlSurface;
+    }
+
+
+    /**
+     * @brief Loads a sprite as 32-bit ARGB, the format SDL_DisplayFormatAlpha gives the game
+     *
+     * @param CsPath the path of the image
+     * @return SDL_Surface* the sprite, with straight alpha
+     */
+    SDL_Surface* LoadSprite(const std::string& CsPath)
+    {
+        SDL_Surface* pSdlSurfaceImage{IMG_Load(CsPath.c_str())};
+        if (pSdlSurfaceImage == nullptr) throw std::ios_base::failure(IMG_GetError());
+
+        SDL_Surface* pSdlSurfaceFormat{MakeSurface(1, 1, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)};
+        SDL_Surface* pSdlSurfaceSprite{SDL_ConvertSurface(pSdlSurfaceImage, pSdlSurfaceFormat->format,
+            SDL_SWSURFACE | SDL_SRCALPHA)};
+        SDL_FreeSurface(pSdlSurfaceFormat);
+        SDL_FreeSurface(pSdlSurfaceImage);
+        if (pSdlSurfaceSprite == nullptr) throw std::runtime_error(SDL_GetError());
+
+        return pSdlSurfaceSprite;
+    }
+
+
+    /**
+     * @brief Copies a surface
+     *
+     * @param pSdlSurface the surface
+     * @return SDL_Surface* the copy
+     */
+    SDL_Surface* Copy(SDL_Surface* pSdlSurface)
+    {
+        SDL_Surface* pSdlSurfaceCopy{SDL_ConvertSurface(pSdlSurface, pSdlSurface->format, pSdlSurface->flags)};
+        if (pSdlSurfaceCopy == nullptr) throw std::runtime_error(SDL_GetError());
+
+        return pSdlSurfaceCopy;
+    }
+
+
+    /**
+     * @brief Fills a surface with opaque noise, so no blend can be skipped because of the destination
+     *
+     * @param pSdlSurface the surface
+     * @param mersenneTwisterGenerator the random generator
+     */
+    void FillNoise(SDL_Surface* pSdlSurface, std::mt19937& mersenneTwisterGenerator)
+    {
+        std::uniform_int_distribution<uint32_t> uniformDistribution{0, 255};
+        for (int32_t i = 0; i < pSdlSurface->h; ++i)
+        {
+            for (int32_t j = 0; j < pSdlSurface->w; ++j)
+            {
+                uint32_t uiPixelValue{SDL_MapRGB(pSdlSurface->format,
+                    static_cast<uint8_t>(uniformDistribution(mersenneTwisterGenerator)),
+                    static_cast<uint8_t>(uniformDistribution(mersenneTwisterGenerator)),
+                    static_cast<uint8_t>(uniformDistribution(mersenneTwisterGenerator)))};
+                std::memcpy(static_cast<uint8_t*>(pSdlSurface->pixels) + i * pSdlSurface->pitch +
+                    j * pSdlSurface->format->BytesPerPixel, &uiPixelValue, pSdlSurface->format->BytesPerPixel);
+            }
+        }
+    }
+
+
+    /**
+     * @brief Compares the colour components of two surfaces of the same size and format
+     *
+     * @param pSdlSurfaceFirst the first surface
+     * @param pSdlSurfaceSecond the second surface
+     * @return uint8_t the largest difference between two components
+     */
+    uint8_t GetMaxDifference(SDL_Surface* pSdlSurfaceFirst, SDL_Surface* pSdlSurfaceSecond)
+    {
+        uint8_t uyMaxDifference{0};
+        uint8_t uyBytesPerPixel{pSdlSurfaceFirst->format->BytesPerPixel};
+
+        for (int32_t i = 0; i < pSdlSurfaceFirst->h; ++i)
+        {
+            for (int32_t j = 0; j < pSdlSurfaceFirst->w; ++j)
+            {
+                uint32_t uiFirst{0}, uiSecond{0};
+                std::memcpy(&uiFirst, static_cast<uint8_t*>(pSdlSurfaceFirst->pixels) +
+                    i * pSdlSurfaceFirst->pitch + j * uyBytesPerPixel, uyBytesPerPixel);
+                std::memcpy(&uiSecond, static_cast<uint8_t*>(pSdlSurfaceSecond->pixels) +
+                    i * pSdlSurfaceSecond->pitch + j * uyBytesPerPixel, uyBytesPerPixel);
+
+                uint8_t auyFirst[3]{}, auySecond[3]{};
+                SDL_GetRGB(uiFirst, pSdlSurfaceFirst->format, &auyFirst[0], &auyFirst[1], &auyFirst[2]);
+                SDL_GetRGB(uiSecond, pSdlSurfaceSecond->format, &auySecond[0], &auySecond[1], &auySecond[2]);
+                for (uint8_t k = 0; k < 3; ++k)
+                    uyMaxDifference = std::max<uint8_t>(uyMaxDifference,
+                        std::abs(auyFirst[k] - auySecond[k]));
+            }
+        }
+
+        return uyMaxDifference;
+    }
+
+
+    /**
+     * @brief Runs a blend many times
+     *
+     * @param Cfunction the blend
+     * @param uiIterations the number of runs
+     * @return double the time of one run in microseconds
+     */
+    double Time(const std::function<void()>& Cfunction, uint32_t uiIterations)
+    {
+        std::chrono::steady_clock::time_point timePointStart{std::chrono::steady_clock::now()};
+        for (uint32_t i = 0; i < uiIterations; ++i) Cfunction();
+
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - timePointStart)
+            .count() / uiIterations;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    std::string sGraphicsPath{argc > 1 ? argv[1] : "../data/gfx"};
+    uint32_t uiIterations{argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 2000};
+
+    try
+    {
+        std::mt19937 mersenneTwisterGenerator{1234};
+
+        std::printf("Vector path: %s\n\n", PixelBlend::GetPath());
+        std::printf("Microseconds per blit, and largest component difference with SDL\n");
+        std::printf("%-18s %7s %4s %9s %9s %9s %5s\n", "sprite", "size", "bpp", "SDL", "scalar", "vector",
+            "diff");
+
+        for (const char* CpcSprite : SCapcSprites)
+        {
+            SDL_Surface* pSdlSurfaceStraight{LoadSprite(sGraphicsPath + "/" + CpcSprite)};
+            SDL_Surface* pSdlSurfacePremultiplied{Copy(pSdlSurfaceStraight)};
+            int32_t iWidth{pSdlSurfaceStraight->w}, iHeight{pSdlSurfaceStraight->h};
+            std::string sSize{std::to_string(iWidth) + "x" + std::to_string(iHeight)};
+            uint32_t uiSourcePitch{pSdlSurfacePremultiplied->pitch};
+            uint8_t uyAlphaShift{pSdlSurfacePremultiplied->format->Ashift};
+
+            PixelBlend::Premultiply(pSdlSurfacePremultiplied->pixels, uiSourcePitch, iWidth, iHeight,
+                uyAlphaShift);
+
+            // 32-bit display, where the vector path must give the same pixels as the scalar one
+            SDL_Surface* pSdlSurfaceBackground{MakeSurface(iWidth, iHeight, 32, 0x00FF0000, 0x0000FF00,
+                0x000000FF, 0)};
+            FillNoise(pSdlSurfaceBackground, mersenneTwisterGenerator);
+            SDL_Surface* pSdlSurfaceSDL{Copy(pSdlSurfaceBackground)};
+            SDL_Surface* pSdlSurfaceScalar{Copy(pSdlSurfaceBackground)};
+            SDL_Surface* pSdlSurfaceVector{Copy(pSdlSurfaceBackground)};
+
+            SDL_BlitSurface(pSdlSurfaceStraight, nullptr, pSdlSurfaceSDL, nullptr);
+            PixelBlend::BlendOverScalar(pSdlSurfacePremultiplied->pixels, uiSourcePitch, iWidth, iHeight,
+                pSdlSurfaceScalar->pixels, pSdlSurfaceScalar->pitch, uyAlphaShift);
+            PixelBlend::BlendOver(pSdlSurfacePremultiplied->pixels, uiSourcePitch, iWidth, iHeight,
+                pSdlSurfaceVector->pixels, pSdlSurfaceVector->pitch, uyAlphaShift);
+
+            if (std::memcmp(pSdlSurfaceScalar->pixels, pSdlSurfaceVector->pixels,
+                static_cast<std::size_t>(pSdlSurfaceScalar->pitch) * iHeight) != 0)
+            {
+                std::fprintf(stderr, "Mismatch between the scalar and vector blends of %s\n", CpcSprite);
+                return EXIT_FAILURE;
+            }
+
+            uint8_t uyDifference{GetMaxDifference(pSdlSurfaceSDL, pSdlSurfaceScalar)};
+            double dSDL{Time([&]() { SDL_BlitSurface(pSdlSurfaceStraight, nullptr, pSdlSurfaceSDL, nullptr); },
+                uiIterations)};
+            double dScalar{Time([&]() { PixelBlend::BlendOverScalar(pSdlSurfacePremultiplied->pixels,
+                uiSourcePitch, iWidth, iHeight, pSdlSurfaceScalar->pixels, pSdlSurfaceScalar->pitch,
+                uyAlphaShift); }, uiIterations)};
+            double dVector{Time([&]() { PixelBlend::BlendOver(pSdlSurfacePremultiplied->pixels, uiSourcePitch,
+                iWidth, iHeight, pSdlSurfaceVector->pixels, pSdlSurfaceVector->pitch, uyAlphaShift); },
+                uiIterations)};
+            std::printf("%-18s %7s %4u %9.2f %9.2f %9.2f %5u\n", CpcSprite, sSize.c_str(), 32, dSDL, dScalar,
+                dVector, uyDifference);
+
+            SDL_FreeSurface(pSdlSurfaceVector);
+            SDL_FreeSurface(pSdlSurfaceScalar);
+            SDL_FreeSurface(pSdlSurfaceSDL);
+            SDL_FreeSurface(pSdlSurfaceBackground);
+
+            // RGB565 display, which only has the scalar path
+            pSdlSurfaceBackground = MakeSurface(iWidth, iHeight, 16, 0xF800, 0x07E0, 0x001F, 0);
+            FillNoise(pSdlSurfaceBackground, mersenneTwisterGenerator);
+            pSdlSurfaceSDL = Copy(pSdlSurfaceBackground);
+            pSdlSurfaceScalar = Copy(pSdlSurfaceBackground);
+
+            const SDL_PixelFormat* CpSdlPixelFormat{pSdlSurfacePremultiplied->format};
+            auto BlendOver565{[&]() { PixelBlend::BlendOver565(pSdlSurfacePremultiplied->pixels, uiSourcePitch,
+                iWidth, iHeight, pSdlSurfaceScalar->pixels, pSdlSurfaceScalar->pitch, uyAlphaShift,
+                CpSdlPixelFormat->Rshift, CpSdlPixelFormat->Gshift, CpSdlPixelFormat->Bshift); }};
+
+            SDL_BlitSurface(pSdlSurfaceStraight, nullptr, pSdlSurfaceSDL, nullptr);
+            BlendOver565();
+
+            uyDifference = GetMaxDifference(pSdlSurfaceSDL, pSdlSurfaceScalar);
+            dSDL = Time([&]() { SDL_BlitSurface(pSdlSurfaceStraight, nullptr, pSdlSurfaceSDL, nullptr); },
+                uiIterations);
+            dScalar = Time(BlendOver565, uiIterations);
+            std::printf("%-18s %7s %4u %9.2f %9.2f %9s %5u\n", CpcSprite, sSize.c_str(), 16, dSDL, dScalar, "-",
+                uyDifference);
+
+            SDL_FreeSurface(pSdlSurfaceScalar);
+            SDL_FreeSurface(pSdlSurfaceSDL);
+            SDL_FreeSurface(pSdlSurfaceBackground);
+            SDL_FreeSurface(pSdlSurfacePremultiplied);
+            SDL_FreeSurface(pSdlSurfaceStraight);
+        }
+    }
+    catch (const std::exception& Cexception)
+    {
+        std::fprintf(stderr, "%s\n", Cexception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
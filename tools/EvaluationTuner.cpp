@@ -0,0 +1,386 @@
+/*
+EvaluationTuner.cpp --- Offline tuner of the evaluation weights from self-play games
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <ios>
+#include <algorithm>
+
+#include "../include/Grid.hpp"
+#include "../include/GameRecord.hpp"
+#include "../include/players/Evaluation.hpp"
+
+
+namespace
+{
+    const int32_t SCiWinScore{1 << 24};     /**< Score of a won position, beyond any evaluation */
+    const uint8_t SCuySearchDepth{4};       /**< Depth of the self-play search */
+    const uint8_t SCuyOpeningMovesMax{6};   /**< Random moves played at the start of every game */
+    const uint32_t SCuiIterations{2000};    /**< Iterations of the gradient descent */
+    const double SCfLearningRate{2000.0};   /**< Step of the gradient descent */
+
+
+    /**
+     * @brief A position seen in a game, with the result for the player to move: 1 win, 0.5 draw, 0 loss
+     */
+    struct Sample
+    {
+        Evaluation::Features arFeatures;
+        float fResult;
+    };
+
+
+    Grid::EPlayerMark NextPlayer(const Grid::EPlayerMark& CePlayerMark) noexcept
+    {
+        return CePlayerMark == Grid::EPlayerMark::PLAYER1 ? Grid::EPlayerMark::PLAYER2 :
+            Grid::EPlayerMark::PLAYER1;
+    }
+
+
+    /**
+     * @brief Negamax search with alpha-beta pruning. The AI has its own search, but it is tied to the
+     * application through its thread, so self-play runs this lighter copy
+     *
+     * @param Cgrid the current position
+     * @param CePlayerMark the mark of the player to move
+     * @param Cevaluation the evaluation of the leaves
+     * @param uyDepth the remaining depth
+     * @param iAlpha alpha value
+     * @param iBeta beta value
+     * @return int32_t the value of the position for the player to move
+     */
+    int32_t Negamax(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, const Evaluation& Cevaluation,
+        uint8_t uyDepth, int32_t iAlpha, int32_t iBeta)
+    {
+        if (Cgrid.CheckWinner() != Grid::EPlayerMark::EMPTY) return -SCiWinScore - uyDepth;  // Faster is better
+        if (Cgrid.IsFull()) return 0;
+        if (uyDepth == 0) return Cevaluation.Evaluate(Cgrid, CePlayerMark);
+
+        int32_t iBest{-SCiWinScore - SCuySearchDepth - 1};
+        for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
+        {
+            // Centre columns first, they prune the most
+            uint8_t uyColumn = (Cgrid.GetWidth() >> 1) + (i & 1 ? -((i + 1) >> 1) : (i >> 1));
+            if (!Cgrid.IsValidMove(uyColumn)) continue;
+
+            Grid gridAttempt = Cgrid;
+            gridAttempt.MakeMove(CePlayerMark, uyColumn);
+            int32_t iValue = -Negamax(gridAttempt, NextPlayer(CePlayerMark), Cevaluation, uyDepth - 1,
+                -iBeta, -iAlpha);
+
+            iBest = std::max(iBest, iValue);
+            iAlpha = std::max(iAlpha, iValue);
+            if (iAlpha >= iBeta) break;
+        }
+
+        return iBest;
+    }
+
+
+    /**
+     * @brief Plays a game against itself, starting with a few random moves so the games differ
+     *
+     * @param uyWidth the width of the grid
+     * @param uyHeight the height of the grid
+     * @param uyCellsToWin the number of cells in a row required to win
+     * @param Cevaluation the evaluation used by both players
+     * @param mersenneTwisterGenerator the random generator of the calling thread
+     * @return GameRecord the moves of the game
+     */
+    GameRecord PlayGame(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin, const Evaluation& Cevaluation,
+        std::mt19937& mersenneTwisterGenerator)
+    {
+        Grid grid{uyWidth, uyHeight, uyCellsToWin};
+        GameRecord gameRecord{uyWidth, uyHeight, uyCellsToWin};
+        Grid::EPlayerMark ePlayerMark{Grid::EPlayerMark::PLAYER1};
+
+        std::uniform_int_distribution<uint32_t> uniformDistributionColumn(0, uyWidth - 1);
+        uint32_t uiOpeningMoves{std::uniform_int_distribution<uint32_t>(0, SCuyOpeningMovesMax)(
+            mersenneTwisterGenerator)};
+
+        for (uint8_t i = 0; grid.CheckWinner() == Grid::EPlayerMark::EMPTY && !grid.IsFull(); ++i)
+        {
+            uint8_t uyColumn{};
+            if (i < uiOpeningMoves)
+            {
+                do uyColumn = uniformDistributionColumn(mersenneTwisterGenerator);
+                while (!grid.IsValidMove(uyColumn));
+            }
+            else
+            {
+                // Ties are broken at random so the same position is not always played the same way
+                int32_t iBest{std::numeric_limits<int32_t>::min()};
+                uint32_t uiTies{0};
+                for (uint8_t j = 0; j < uyWidth; ++j)
+                {
+                    if (!grid.IsValidMove(j)) continue;
+
+                    Grid gridAttempt = grid;
+                    gridAttempt.MakeMove(ePlayerMark, j);
+                    int32_t iValue = -Negamax(gridAttempt, NextPlayer(ePlayerMark), Cevaluation,
+                        SCuySearchDepth - 1, -SCiWinScore - SCuySearchDepth - 1,
+                        SCiWinScore + SCuySearchDepth + 1);
+
+                    if (iValue > iBest) { iBest = iValue; uyColumn = j; uiTies = 1; }
+                    else if (iValue == iBest &&
+                        std::uniform_int_distribution<uint32_t>(0, uiTies++)(mersenneTwisterGenerator) == 0)
+                        uyColumn = j;
+                }
+            }
+
+            grid.MakeMove(ePlayerMark, uyColumn);
+            gameRecord.AddMove(uyColumn);
+            ePlayerMark = NextPlayer(ePlayerMark);
+        }
+
+        return gameRecord;
+    }
+
+
+    /**
+     * @brief Replays a game and collects its quiet positions, the ones where nobody can win on the spot
+     *
+     * @param CgameRecordView the game to replay
+     * @param vectorSamples the positions collected
+     */
+    void CollectSamples(const GameRecordView& CgameRecordView, std::vector<Sample>& vectorSamples)
+    {
+        Grid grid{CgameRecordView.GetWidth(), CgameRecordView.GetHeight(), CgameRecordView.GetCellsToWin()};
+        std::vector<Grid> vectorgridPositions{};
+
+        Grid::EPlayerMark ePlayerMark{Grid::EPlayerMark::PLAYER1};
+        for (uint8_t i = 0; i < CgameRecordView.GetMoveCount(); ++i)
+        {
+            vectorgridPositions.push_back(grid);
+            grid.MakeMove(ePlayerMark, CgameRecordView.GetMove(i));
+            ePlayerMark = NextPlayer(ePlayerMark);
+        }
+
+        Grid::EPlayerMark eWinner{grid.CheckWinner()};
+        ePlayerMark = Grid::EPlayerMark::PLAYER1;
+        for (const Grid& CgridPosition : vectorgridPositions)
+        {
+            bool bIsQuiet{true};
+            for (uint8_t i = 0; i < CgridPosition.GetWidth() && bIsQuiet; ++i)
+            {
+                if (!CgridPosition.IsValidMove(i)) continue;
+                for (const Grid::EPlayerMark& CePlayerMark :
+                    {Grid::EPlayerMark::PLAYER1, Grid::EPlayerMark::PLAYER2})
+                {
+                    Grid gridAttempt = CgridPosition;
+                    gridAttempt.MakeMove(CePlayerMark, i);
+                    if (gridAttempt.CheckWinner() != Grid::EPlayerMark::EMPTY) bIsQuiet = false;
+                }
+            }
+
+            if (bIsQuiet)
+            {
+                Sample sample{};
+                Evaluation::ExtractFeatures(CgridPosition, ePlayerMark, sample.arFeatures);
+                sample.fResult = (eWinner == Grid::EPlayerMark::EMPTY ? 0.5f :
+                    (eWinner == ePlayerMark ? 1.0f : 0.0f));
+                vectorSamples.push_back(sample);
+            }
+
+            ePlayerMark = NextPlayer(ePlayerMark);
+        }
+    }
+
+
+    /**
+     * @brief Computes the mean squared error of the predicted results and, optionally, its gradient
+     *
+     * @param CvectorSamples the positions
+     * @param CafWeights the weights
+     * @param fScale the scale that turns evaluations into winning chances
+     * @param uiThreads the number of threads to use
+     * @param pafGradient where to store the gradient, or null
+     * @return double the error
+     */
+    double ComputeError(const std::vector<Sample>& CvectorSamples,
+        const std::array<double, Evaluation::SCuyFeatureCount>& CafWeights, double fScale, uint32_t uiThreads,
+        std::array<double, Evaluation::SCuyFeatureCount>* pafGradient)
+    {
+        std::vector<double> vectorfErrors(uiThreads, 0.0);
+        std::vector<std::array<double, Evaluation::SCuyFeatureCount> > vectorafGradients(uiThreads);
+        std::vector<std::thread> vectorThreads{};
+
+        for (uint32_t i = 0; i < uiThreads; ++i)
+        {
+            vectorThreads.emplace_back([&, i]()
+            {
+                vectorafGradients[i].fill(0.0);
+                for (std::size_t j = i; j < CvectorSamples.size(); j += uiThreads)
+                {
+                    const Sample& Csample{CvectorSamples[j]};
+                    double fEvaluation{0.0};
+                    for (uint8_t k = 0; k < Evaluation::SCuyFeatureCount; ++k)
+                        fEvaluation += CafWeights[k] * Csample.arFeatures[k];
+
+                    double fPrediction = 1.0 / (1.0 + std::exp(-fScale * fEvaluation));
+                    double fDelta = fPrediction - Csample.fResult;
+                    vectorfErrors[i] += fDelta * fDelta;
+
+                    if (pafGradient != nullptr)
+                    {
+                        double fFactor = fDelta * fPrediction * (1.0 - fPrediction) * fScale;
+                        for (uint8_t k = 0; k < Evaluation::SCuyFeatureCount; ++k)
+                            vectorafGradients[i][k] += fFactor * Csample.arFeatures[k];
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : vectorThreads) thread.join();
+
+        double fError{0.0};
+        for (double fThreadError : vectorfErrors) fError += fThreadError;
+
+        if (pafGradient != nullptr)
+        {
+            pafGradient->fill(0.0);
+            for (const std::array<double, Evaluation::SCuyFeatureCount>& CafThreadGradient : vectorafGradients)
+                for (uint8_t k = 0; k < Evaluation::SCuyFeatureCount; ++k)
+                    (*pafGradient)[k] += 2.0 * CafThreadGradient[k] / CvectorSamples.size();
+        }
+
+        return fError / CvectorSamples.size();
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::fprintf(stderr, "Usage: %s <width> <height> <cells to win> <games> [weights file] [threads] "
+            "[records file]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t uyWidth{static_cast<uint8_t>(std::atoi(argv[1]))};
+    uint8_t uyHeight{static_cast<uint8_t>(std::atoi(argv[2]))};
+    uint8_t uyCellsToWin{static_cast<uint8_t>(std::atoi(argv[3]))};
+    uint32_t uiGames{static_cast<uint32_t>(std::atoi(argv[4]))};
+    std::string sWeightsPath{argc > 5 ? argv[5] : "weights.bin"};
+    uint32_t uiThreads{argc > 6 ? static_cast<uint32_t>(std::atoi(argv[6])) :
+        std::thread::hardware_concurrency()};
+    std::string sRecordsPath{argc > 7 ? argv[7] : ""};
+    if (uiThreads == 0) uiThreads = 1;
+
+    try
+    {
+        // Start from the weights of a previous run if there are any
+        Evaluation evaluation{};
+        try { evaluation = Evaluation{sWeightsPath}; }
+        catch (...) {}
+
+        std::vector<std::string> vectorsRecords{};
+        std::ifstream ifstreamRecords{sRecordsPath};
+        for (std::string sLine{}; ifstreamRecords && std::getline(ifstreamRecords, sLine);)
+            if (!sLine.empty()) vectorsRecords.push_back(sLine);
+
+        // Games already recorded are reused, only the missing ones are played
+        std::mutex mutexRecords{};
+        std::atomic<uint32_t> atomicNext{static_cast<uint32_t>(vectorsRecords.size())};
+        std::vector<std::thread> vectorThreads{};
+        for (uint32_t i = 0; i < uiThreads; ++i)
+        {
+            vectorThreads.emplace_back([&, i]()
+            {
+                std::mt19937 mersenneTwisterGenerator{std::random_device{}() + i};
+                while (atomicNext.fetch_add(1) < uiGames)
+                {
+                    std::string sRecord{PlayGame(uyWidth, uyHeight, uyCellsToWin, evaluation,
+                        mersenneTwisterGenerator).ToString()};
+                    std::lock_guard<std::mutex> lockGuard{mutexRecords};
+                    vectorsRecords.push_back(sRecord);
+                }
+            });
+        }
+        for (std::thread& thread : vectorThreads) thread.join();
+
+        if (!sRecordsPath.empty())
+        {
+            std::ofstream ofstreamRecords{sRecordsPath, std::ios_base::out | std::ios_base::trunc};
+            for (const std::string& CsRecord : vectorsRecords) ofstreamRecords << CsRecord << '\n';
+            if (!ofstreamRecords) throw std::ios_base::failure("Error writing file " + sRecordsPath);
+        }
+
+        std::vector<Sample> vectorSamples{};
+        for (const std::string& CsRecord : vectorsRecords)
+            CollectSamples(GameRecordView{CsRecord}, vectorSamples);
+        if (vectorSamples.empty()) throw std::runtime_error("No positions to tune with");
+
+        std::printf("Tuning %ux%ux%u: %zu games, %zu positions, %u threads\n", uyWidth, uyHeight, uyCellsToWin,
+            vectorsRecords.size(), vectorSamples.size(), uiThreads);
+
+        std::array<double, Evaluation::SCuyFeatureCount> afWeights{};
+        for (uint8_t i = 0; i < Evaluation::SCuyFeatureCount; ++i) afWeights[i] = evaluation.GetWeights()[i];
+
+        // The scale that best fits the current weights is kept for the whole descent
+        double fScale{0.01}, fBestError{ComputeError(vectorSamples, afWeights, fScale, uiThreads, nullptr)};
+        for (double fCandidate = 0.0005; fCandidate < 0.1; fCandidate *= 1.25)
+        {
+            double fError{ComputeError(vectorSamples, afWeights, fCandidate, uiThreads, nullptr)};
+            if (fError < fBestError) { fBestError = fError; fScale = fCandidate; }
+        }
+        std::printf("Scale %.5f, initial error %.6f\n", fScale, fBestError);
+
+        std::array<double, Evaluation::SCuyFeatureCount> afGradient{};
+        double fError{};
+        for (uint32_t i = 0; i < SCuiIterations; ++i)
+        {
+            fError = ComputeError(vectorSamples, afWeights, fScale, uiThreads, &afGradient);
+            for (uint8_t k = 0; k < Evaluation::SCuyFeatureCount; ++k)
+                afWeights[k] -= SCfLearningRate / (fScale * fScale * 1e4) * afGradient[k];
+            if (i % 200 == 0) std::printf("Iteration %u, error %.6f\n", i, fError);
+        }
+
+        Evaluation::Weights aiWeights{};
+        for (uint8_t i = 0; i < Evaluation::SCuyFeatureCount; ++i)
+            aiWeights[i] = static_cast<int32_t>(std::lround(afWeights[i]));
+        evaluation.SetWeights(aiWeights);
+        evaluation.Dump(sWeightsPath);
+
+        std::printf("Final error %.6f, weights:", fError);
+        for (int32_t iWeight : aiWeights) std::printf(" %d", iWeight);
+        std::printf("\nWritten %s\n", sWeightsPath.c_str());
+    }
+    catch (const std::exception& Cexception)
+    {
+        std::fprintf(stderr, "%s\n", Cexception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
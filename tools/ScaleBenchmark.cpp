@@ -0,0 +1,192 @@
+/*
+ScaleBenchmark.cpp --- Checks and times the nearest-neighbour scaler against the per-pixel scaler
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <exception>
+
+#include "../include/video/PixelScale.hpp"
+
+
+namespace
+{
+    /**
+     * @brief A pixel buffer laid out like an SDL surface, with rows padded to four bytes
+     */
+    struct Buffer
+    {
+        uint32_t uiWidth;
+        uint32_t uiHeight;
+        uint32_t uiPitch;
+        std::vector<uint8_t> vectoruyPixels;
+    };
+
+
+    /**
+     * @brief Creates a buffer
+     *
+     * @param uiWidth the width in pixels
+     * @param uiHeight the height in pixels
+     * @param uyBytesPerPixel the size of a pixel
+     * @return Buffer the buffer, filled with zeros
+     */
+    Buffer MakeBuffer(uint32_t uiWidth, uint32_t uiHeight, uint8_t uyBytesPerPixel)
+    {
+        uint32_t uiPitch{(uiWidth * uyBytesPerPixel + 3) & ~3u};
+        return Buffer{uiWidth, uiHeight, uiPitch, std::vector<uint8_t>(uiPitch * uiHeight, 0)};
+    }
+
+
+    /**
+     * @brief The scaler Surface::Scale used before, without SDL: every source pixel is read on its own and
+     * its block is filled pixel by pixel, as SDL_FillRect does. Reading the colour components back and mapping
+     * them again is left out, so the real cost of the old scaler was higher than this
+     *
+     * @param Csource the source buffer
+     * @param destination the destination buffer
+     * @param uyBytesPerPixel the size of a pixel
+     * @param urScaleX the scale factor for the X axis
+     * @param urScaleY the scale factor for the Y axis
+     */
+    void ScalePerPixel(const Buffer& Csource, Buffer& destination, uint8_t uyBytesPerPixel, uint16_t urScaleX,
+        uint16_t urScaleY)
+    {
+        for (uint32_t i = 0; i < Csource.uiHeight; ++i)
+        {
+            for (uint32_t j = 0; j < Csource.uiWidth; ++j)
+            {
+                uint32_t uiPixelValue{0};
+                std::memcpy(&uiPixelValue, &Csource.vectoruyPixels[i * Csource.uiPitch + j * uyBytesPerPixel],
+                    uyBytesPerPixel);
+
+                for (uint16_t k = 0; k < urScaleY; ++k)
+                    for (uint16_t l = 0; l < urScaleX; ++l)
+                        std::memcpy(&destination.vectoruyPixels[(i * urScaleY + k) * destination.uiPitch +
+                            (j * urScaleX + l) * uyBytesPerPixel], &uiPixelValue, uyBytesPerPixel);
+            }
+        }
+    }
+
+
+    /**
+     * @brief Runs a scaler many times
+     *
+     * @param Cfunction the scaler
+     * @param uiIterations the number of runs
+     * @return double the time of one run in microseconds
+     */
+    double Time(const std::function<void()>& Cfunction, uint32_t uiIterations)
+    {
+        std::chrono::steady_clock::time_point timePointStart{std::chrono::steady_clock::now()};
+        for (uint32_t i = 0; i < uiIterations; ++i) Cfunction();
+
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - timePointStart)
+            .count() / uiIterations;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t uiSize{argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 48};     // The size of a board cell
+    uint32_t uiIterations{argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 2000};
+
+    try
+    {
+        std::mt19937 mersenneTwisterGenerator{1234};
+        std::uniform_int_distribution<uint32_t> uniformDistribution{0, 255};
+
+        // Every path must give the same pixels as the per-pixel scaler, on odd sizes too
+        uint32_t uiMismatches{0};
+        for (uint8_t uyBytesPerPixel = 1; uyBytesPerPixel <= 4; ++uyBytesPerPixel)
+        {
+            for (uint32_t uiWidth : {1u, 7u, 8u, 13u, uiSize})
+            {
+                Buffer source{MakeBuffer(uiWidth, 5, uyBytesPerPixel)};
+                for (uint8_t& uyByte : source.vectoruyPixels)
+                    uyByte = static_cast<uint8_t>(uniformDistribution(mersenneTwisterGenerator));
+
+                for (uint16_t urScale = 1; urScale <= 11; ++urScale)
+                {
+                    Buffer reference{MakeBuffer(uiWidth * urScale, 5 * (urScale % 3 + 1), uyBytesPerPixel)};
+                    Buffer fast{reference}, scalar{reference};
+
+                    ScalePerPixel(source, reference, uyBytesPerPixel, urScale, urScale % 3 + 1);
+                    PixelScale::ScaleNearest(source.vectoruyPixels.data(), source.uiPitch, source.uiWidth,
+                        source.uiHeight, fast.vectoruyPixels.data(), fast.uiPitch, uyBytesPerPixel, urScale,
+                        urScale % 3 + 1);
+                    PixelScale::ScaleNearestScalar(source.vectoruyPixels.data(), source.uiPitch, source.uiWidth,
+                        source.uiHeight, scalar.vectoruyPixels.data(), scalar.uiPitch, uyBytesPerPixel, urScale,
+                        urScale % 3 + 1);
+
+                    if (fast.vectoruyPixels != reference.vectoruyPixels ||
+                        scalar.vectoruyPixels != reference.vectoruyPixels)
+                    {
+                        std::fprintf(stderr, "Mismatch at %u bytes per pixel, width %u, scale %u\n",
+                            uyBytesPerPixel, uiWidth, urScale);
+                        ++uiMismatches;
+                    }
+                }
+            }
+        }
+        if (uiMismatches > 0) return EXIT_FAILURE;
+
+        std::printf("Output matches the per-pixel scaler. Vector path: %s\n\n", PixelScale::GetPath());
+        std::printf("%ux%u cell, microseconds per scale\n", uiSize, uiSize);
+        std::printf("bpp scale  per-pixel     scalar     vector\n");
+
+        for (uint8_t uyBytesPerPixel : {2, 4})
+        {
+            Buffer source{MakeBuffer(uiSize, uiSize, uyBytesPerPixel)};
+            for (uint8_t& uyByte : source.vectoruyPixels)
+                uyByte = static_cast<uint8_t>(uniformDistribution(mersenneTwisterGenerator));
+
+            for (uint16_t urScale = 1; urScale <= 10; ++urScale)
+            {
+                Buffer destination{MakeBuffer(uiSize * urScale, uiSize * urScale, uyBytesPerPixel)};
+
+                double dPerPixel{Time([&]() { ScalePerPixel(source, destination, uyBytesPerPixel, urScale,
+                    urScale); }, uiIterations)};
+                double dScalar{Time([&]() { PixelScale::ScaleNearestScalar(source.vectoruyPixels.data(),
+                    source.uiPitch, uiSize, uiSize, destination.vectoruyPixels.data(), destination.uiPitch,
+                    uyBytesPerPixel, urScale, urScale); }, uiIterations)};
+                double dVector{Time([&]() { PixelScale::ScaleNearest(source.vectoruyPixels.data(),
+                    source.uiPitch, uiSize, uiSize, destination.vectoruyPixels.data(), destination.uiPitch,
+                    uyBytesPerPixel, urScale, urScale); }, uiIterations)};
+
+                std::printf("%3u %5u %10.2f %10.2f %10.2f\n", uyBytesPerPixel * 8, urScale, dPerPixel, dScalar,
+                    dVector);
+            }
+        }
+    }
+    catch (const std::exception& Cexception)
+    {
+        std::fprintf(stderr, "%s\n", Cexception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
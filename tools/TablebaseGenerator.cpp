@@ -0,0 +1,204 @@
+/*
+TablebaseGenerator.cpp --- Offline solver that builds the tablebases for small boards
+Copyright (C) 2025  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+#include <exception>
+#include <algorithm>
+
+#include "../include/Grid.hpp"
+#include "../include/Tablebase.hpp"
+
+
+namespace
+{
+    /**
+     * @brief Solves a position by a full memoised search. Every thread shares the table: two threads may
+     * solve the same position at once, but they store the same entry
+     *
+     * @param Cgrid the position to solve
+     * @param CePlayerMark the mark of the player to move
+     * @param vectoruyEntries the table being built
+     * @return uint8_t the entry of the position
+     */
+    uint8_t Solve(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, 
+        std::vector<uint8_t>& vectoruyEntries)
+    {
+        std::atomic_ref<uint8_t> atomicEntry{vectoruyEntries[Tablebase::GetIndex(Cgrid)]};
+        uint8_t uyEntry{atomicEntry.load(std::memory_order_relaxed)};
+        if (uyEntry != 0) return uyEntry;
+
+        if (Cgrid.CheckWinner() != Grid::EPlayerMark::EMPTY)    // The previous move won the game
+            uyEntry = Tablebase::MakeEntry(Tablebase::EResult::RESULT_LOSS, 0);
+        else if (Cgrid.IsFull()) uyEntry = Tablebase::MakeEntry(Tablebase::EResult::RESULT_DRAW, 0);
+        else
+        {
+            const Grid::EPlayerMark CePlayerMarkNext{CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+                Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1};
+            uint8_t uyWinDepth{UINT8_MAX}, uyLossDepth{0};
+            bool bCanDraw{false};
+
+            // Prefer the fastest win, then a draw, then the slowest loss
+            for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
+            {
+                if (Cgrid.IsValidMove(i))
+                {
+                    Grid gridAttempt = Cgrid;
+                    gridAttempt.MakeMove(CePlayerMark, i);
+                    uint8_t uyChild{Solve(gridAttempt, CePlayerMarkNext, vectoruyEntries)};
+                    uint8_t uyDepth = Tablebase::GetDepth(uyChild) + 1;
+
+                    switch (Tablebase::GetResult(uyChild))
+                    {
+                    case Tablebase::EResult::RESULT_LOSS: uyWinDepth = std::min(uyWinDepth, uyDepth);    break;
+                    case Tablebase::EResult::RESULT_WIN:  uyLossDepth = std::max(uyLossDepth, uyDepth);  break;
+                    default: bCanDraw = true; break;
+                    }
+                }
+            }
+
+            if (uyWinDepth != UINT8_MAX) 
+                uyEntry = Tablebase::MakeEntry(Tablebase::EResult::RESULT_WIN, uyWinDepth);
+            else if (bCanDraw) uyEntry = Tablebase::MakeEntry(Tablebase::EResult::RESULT_DRAW, 0);
+            else uyEntry = Tablebase::MakeEntry(Tablebase::EResult::RESULT_LOSS, uyLossDepth);
+        }
+
+        atomicEntry.store(uyEntry, std::memory_order_relaxed);
+        return uyEntry;
+    }
+
+
+    /**
+     * @brief Collects the distinct positions reached after a number of moves, they are the work units
+     * of the threads
+     *
+     * @param Cgrid the current position
+     * @param CePlayerMark the mark of the player to move
+     * @param uyPlies the number of moves left to play
+     * @param htuSeen the indexes of the positions already collected
+     * @param vectorgridWork the positions collected
+     */
+    void CollectWork(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, uint8_t uyPlies,
+        std::unordered_set<uint64_t>& htuSeen, std::vector<Grid>& vectorgridWork)
+    {
+        if (Cgrid.CheckWinner() != Grid::EPlayerMark::EMPTY || Cgrid.IsFull()) return;
+        if (uyPlies == 0)
+        {
+            if (htuSeen.insert(Tablebase::GetIndex(Cgrid)).second) vectorgridWork.push_back(Cgrid);
+            return;
+        }
+
+        for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
+        {
+            if (Cgrid.IsValidMove(i))
+            {
+                Grid gridAttempt = Cgrid;
+                gridAttempt.MakeMove(CePlayerMark, i);
+                CollectWork(gridAttempt, CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+                    Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1, uyPlies - 1, htuSeen, 
+                    vectorgridWork);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::fprintf(stderr, "Usage: %s <width> <height> <cells to win> [output directory] [threads]\n", 
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t uyWidth{static_cast<uint8_t>(std::atoi(argv[1]))};
+    uint8_t uyHeight{static_cast<uint8_t>(std::atoi(argv[2]))};
+    uint8_t uyCellsToWin{static_cast<uint8_t>(std::atoi(argv[3]))};
+    std::string sDirectory{argc > 4 ? argv[4] : "."};
+    uint32_t uiThreads{argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 
+        std::thread::hardware_concurrency()};
+    if (uiThreads == 0) uiThreads = 1;
+
+    try
+    {
+        uint64_t uEntryCount{Tablebase::GetEntryCount(uyWidth, uyHeight)};
+        if (uEntryCount == 0)
+        {
+            std::fprintf(stderr, "A %ux%u board is too big for a tablebase\n", uyWidth, uyHeight);
+            return EXIT_FAILURE;
+        }
+
+        Grid gridRoot{uyWidth, uyHeight, uyCellsToWin};
+        std::vector<uint8_t> vectoruyEntries(uEntryCount, 0);
+
+        // Split the tree a few moves deep so every thread gets plenty of independent subtrees
+        std::unordered_set<uint64_t> htuSeen{};
+        std::vector<Grid> vectorgridWork{};
+        CollectWork(gridRoot, Grid::EPlayerMark::PLAYER1, std::min(6, uyWidth * uyHeight / 2), htuSeen,
+            vectorgridWork);
+
+        std::printf("Solving %ux%ux%u: %llu entries, %zu subtrees, %u threads\n", uyWidth, uyHeight, 
+            uyCellsToWin, static_cast<unsigned long long>(uEntryCount), vectorgridWork.size(), uiThreads);
+
+        std::atomic<std::size_t> atomicNext{0};
+        std::vector<std::thread> vectorThreads{};
+        for (uint32_t i = 0; i < uiThreads; ++i)
+        {
+            vectorThreads.emplace_back([&]()
+            {
+                std::size_t uWork{};
+                while ((uWork = atomicNext.fetch_add(1)) < vectorgridWork.size())
+                {
+                    const Grid& CgridWork{vectorgridWork[uWork]};
+                    uint8_t uyMarkers{0};
+                    for (uint8_t j = 0; j < CgridWork.GetWidth(); ++j)
+                        uyMarkers += CgridWork.GetHeight() - 1 - CgridWork.GetNextCell(j);
+
+                    Solve(CgridWork, uyMarkers % 2 == 0 ? Grid::EPlayerMark::PLAYER1 : 
+                        Grid::EPlayerMark::PLAYER2, vectoruyEntries);
+                }
+            });
+        }
+        for (std::thread& thread : vectorThreads) thread.join();
+
+        uint8_t uyRoot{Solve(gridRoot, Grid::EPlayerMark::PLAYER1, vectoruyEntries)};
+        const char* CpcResults[]{"unknown", "loss", "draw", "win"};
+        std::printf("First player %s in %u moves\n", CpcResults[Tablebase::GetResult(uyRoot)],
+            Tablebase::GetDepth(uyRoot));
+
+        std::string sPath{sDirectory + "/" + Tablebase::GetFileName(uyWidth, uyHeight, uyCellsToWin)};
+        Tablebase::Write(sPath, uyWidth, uyHeight, uyCellsToWin, vectoruyEntries);
+        std::printf("Written %s\n", sPath.c_str());
+    }
+    catch (const std::exception& Cexception)
+    {
+        std::fprintf(stderr, "%s\n", Cexception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}